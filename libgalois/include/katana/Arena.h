@@ -0,0 +1,177 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#ifndef KATANA_LIBGALOIS_KATANA_ARENA_H_
+#define KATANA_LIBGALOIS_KATANA_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// An Arena is a bump allocator for short-lived temporaries. Allocating is
+/// bumping a pointer in the current block, and memory is only freed all at
+/// once by Reset() or, in stack order, by rewinding to a Mark.
+///
+/// An Arena is not thread-safe; each thread uses its own, see GetLoopArena().
+class KATANA_EXPORT Arena {
+public:
+  /// Size of the blocks bump allocation happens in. Larger allocations get
+  /// their own block.
+  static constexpr size_t kBlockSize = 256 * 1024;
+  /// Number of blocks kept for reuse by Reset()
+  static constexpr size_t kMaxCachedBlocks = 16;
+
+  /// A position in the arena to rewind to
+  struct Mark {
+    size_t block;
+    size_t offset;
+    size_t num_large;
+  };
+
+  Arena() = default;
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+  Arena(Arena&&) = delete;
+  Arena& operator=(Arena&&) = delete;
+
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    uintptr_t begin = reinterpret_cast<uintptr_t>(base_) + offset_;
+    uintptr_t aligned = (begin + alignment - 1) & ~(alignment - 1);
+    size_t offset = offset_ + (aligned - begin);
+    if (base_ && offset + size <= kBlockSize) {
+      offset_ = offset + size;
+      return base_ + offset;
+    }
+    return AllocateSlow(size, alignment);
+  }
+
+  /// Returns memory to the arena if it is the most recent allocation, which
+  /// lets a growing vector reuse its space; otherwise does nothing.
+  void deallocate(void* ptr, size_t size) {
+    char* p = static_cast<char*>(ptr);
+    if (base_ && p + size == base_ + offset_ && p >= base_) {
+      offset_ = p - base_;
+    }
+  }
+
+  Mark mark() const { return Mark{current_, offset_, large_.size()}; }
+
+  /// Frees everything allocated since m was taken
+  void rewind(const Mark& m);
+
+  /// Frees everything
+  void Reset();
+
+  /// @returns the number of bytes of the blocks the arena holds
+  size_t capacity() const;
+
+private:
+  void* AllocateSlow(size_t size, size_t alignment);
+
+  std::vector<char*> blocks_;
+  //! allocations too large for a block and their sizes
+  std::vector<std::pair<void*, size_t>> large_;
+  size_t large_bytes_{0};
+  size_t current_{0};
+  char* base_{nullptr};
+  size_t offset_{0};
+};
+
+/// @returns the Arena of the calling thread for the temporaries of the
+/// parallel loop it runs. The arena is emptied at the start of every parallel
+/// loop, so what is allocated from it must not outlive the loop.
+KATANA_EXPORT Arena& GetLoopArena();
+
+/// Frees the memory allocated from the loop arena of the calling thread during
+/// its lifetime, e.g., the temporaries of one iteration of a loop:
+///
+///     katana::do_all(katana::iterate(graph), [&](GNode n) {
+///       katana::ArenaScope scope;
+///       katana::gstl::ArenaMap<uint64_t, uint64_t> map;
+///       ...
+///     });
+///
+/// Containers that use the arena must be declared after the scope so that
+/// they are destroyed before it.
+class ArenaScope {
+public:
+  ArenaScope() : arena_(GetLoopArena()), mark_(arena_.mark()) {}
+  ~ArenaScope() { arena_.rewind(mark_); }
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+  Arena& arena_;
+  Arena::Mark mark_;
+};
+
+/// STL allocator that allocates from the loop arena of the thread that
+/// constructs it; see GetLoopArena(). No locks or atomic operations are
+/// involved.
+template <typename T>
+class ArenaAllocator {
+public:
+  using value_type = T;
+
+  ArenaAllocator() : arena_(&GetLoopArena()) {}
+  explicit ArenaAllocator(Arena* arena) noexcept : arena_(arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (n > size_t(-1) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept {
+    arena_->deallocate(ptr, n * sizeof(T));
+  }
+
+  Arena* arena() const noexcept { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const noexcept {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+    return arena_ != other.arena();
+  }
+
+private:
+  Arena* arena_;
+};
+
+}  // namespace katana
+
+#endif
@@ -81,7 +81,8 @@ KATANA_EXPORT std::unique_ptr<Barrier> CreateSimpleBarrier(unsigned);
 
 namespace internal {
 
-void SetBarrier(Barrier* barrier);
+/// Set the barrier of a thread pool partition
+void SetBarrier(Barrier* barrier, unsigned partition = 0);
 
 }  // namespace internal
 
@@ -67,7 +67,7 @@ public:
   typedef T value_type;
 
   BulkSynchronous()
-      : barrier(GetBarrier(activeThreads)), some(false), isEmpty(false) {}
+      : barrier(GetBarrier(getActiveThreads())), some(false), isEmpty(false) {}
 
   void push(const value_type& val) {
     wls[(tlds.getLocal()->round + 1) & 1].push(val);
@@ -23,6 +23,8 @@
 #include "katana/FixedSizeRing.h"
 #include "katana/Mem.h"
 #include "katana/PaddedLock.h"
+#include "katana/Statistics.h"
+#include "katana/Threads.h"
 #include "katana/WLCompileCheck.h"
 #include "katana/WorkListHelpers.h"
 #include "katana/config.h"
@@ -39,8 +41,9 @@ struct squeue {
   PS<TQ> queues;
   TQ& get(int i) { return *queues.getRemote(i); }
   TQ& get() { return *queues.getLocal(); }
+  TQ& getBySocket(unsigned s) { return *queues.getRemoteByPkg(s); }
   int myEffectiveID() { return ThreadPool::getTID(); }
-  int size() { return activeThreads; }
+  int size() { return getActiveThreads(); }
 };
 
 template <template <typename> class PS, typename TQ>
@@ -78,7 +81,10 @@ private:
   struct p {
     Chunk* cur;
     Chunk* next;
-    p() : cur(0), next(0) {}
+    //! chunks taken from the queue of this socket and of other sockets
+    size_t local_steals;
+    size_t remote_steals;
+    p() : cur(0), next(0), local_steals(0), remote_steals(0) {}
   };
 
   typedef QT<Chunk, Concurrent> LevelItem;
@@ -102,30 +108,36 @@ private:
     I.push(C);
   }
 
-  Chunk* popChunkByID(unsigned int i) {
-    LevelItem& I = Q.get(i);
-    return I.pop();
-  }
-
   Chunk* popChunk() {
-    int id = Q.myEffectiveID();
-    Chunk* r = popChunkByID(id);
-    if (r)
-      return r;
-
-    for (int i = id + 1; i < (int)Q.size(); ++i) {
-      r = popChunkByID(i);
-      if (r)
-        return r;
-    }
+    if constexpr (!Distributed) {
+      return Q.get().pop();
+    } else {
+      // Look in the queue of this socket first, a few times since other
+      // threads of the socket may be about to push, then in the queues of
+      // the other sockets, starting from the next one.
+      p& n = data.get();
+      const unsigned attempts = getSocketStealAttempts();
+      for (unsigned i = 0; i < attempts; ++i) {
+        if (Chunk* r = Q.get().pop()) {
+          ++n.local_steals;
+          return r;
+        }
+        asmPause();
+      }
 
-    for (int i = 0; i < id; ++i) {
-      r = popChunkByID(i);
-      if (r)
-        return r;
-    }
+      auto& tp = GetThreadPool();
+      const unsigned my_pack = ThreadPool::getSocket();
+      const unsigned num_packs =
+          tp.getCumulativeMaxSocket(getActiveThreads() - 1) + 1;
+      for (unsigned i = 1; i < num_packs; ++i) {
+        if (Chunk* r = Q.getBySocket((my_pack + i) % num_packs).pop()) {
+          ++n.remote_steals;
+          return r;
+        }
+      }
 
-    return 0;
+      return 0;
+    }
   }
 
   template <typename... Args>
@@ -148,6 +160,20 @@ public:
   ChunkMaster(const ChunkMaster&) = delete;
   ChunkMaster& operator=(const ChunkMaster&) = delete;
 
+  /**
+   * Report the number of chunks the calling thread took from the queue of its
+   * socket and from the queues of other sockets, and reset the counts.
+   */
+  void reportStats([[maybe_unused]] const char* loopname) {
+    if constexpr (Distributed) {
+      p& n = data.get();
+      ReportStatSum(loopname, "LocalSteals", n.local_steals);
+      ReportStatSum(loopname, "RemoteSteals", n.remote_steals);
+      n.local_steals = 0;
+      n.remote_steals = 0;
+    }
+  }
+
   void flush() {
     p& n = data.get();
     if (n.next)
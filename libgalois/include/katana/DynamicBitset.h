@@ -35,6 +35,7 @@
 
 #include "katana/AtomicWrapper.h"
 #include "katana/Galois.h"
+#include "katana/NUMAArray.h"
 #include "katana/PODVector.h"
 #include "katana/config.h"
 
@@ -280,6 +281,15 @@ public:
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_or(const DynamicBitset& other);
 
+  /**
+   * Does an IN-PLACE bitwise or of 2 passed in bitsets and saves to this
+   * bitset
+   *
+   * @param other1 Bitset to or with other 2
+   * @param other2 Bitset to or with other 1
+   */
+  void bitwise_or(const DynamicBitset& other1, const DynamicBitset& other2);
+
   // assumes bit_vector is not updated (set) in parallel
   void bitwise_not();
 
@@ -301,6 +311,23 @@ public:
    */
   void bitwise_and(const DynamicBitset& other1, const DynamicBitset& other2);
 
+  /**
+   * Does an IN-PLACE bitwise and-not of this bitset and another bitset,
+   * i.e., unsets the bits that are set in the other bitset
+   *
+   * @param other Bitset with the bits to unset
+   */
+  void bitwise_andnot(const DynamicBitset& other);
+
+  /**
+   * Saves other1 & ~other2 to this bitset
+   *
+   * @param other1 Bitset to take set bits from
+   * @param other2 Bitset with the bits to leave unset
+   */
+  void bitwise_andnot(
+      const DynamicBitset& other1, const DynamicBitset& other2);
+
   /**
    * Does an IN-PLACE bitwise xor of this bitset and another bitset
    *
@@ -333,6 +360,17 @@ public:
    */
   size_t SerialCount() const;
 
+  /**
+   * Checks if any bit is set in the bitset. Stops scanning once a set bit is
+   * found. Do not call in a parallel region as it uses a parallel loop.
+   *
+   * @returns true if at least one bit is set
+   */
+  bool any() const;
+
+  //! Opposite of any(); same restrictions apply
+  bool none() const { return !any(); }
+
   /**
    * Returns a vector containing the set bits in this bitset in order
    * from left to right.
@@ -351,6 +389,17 @@ public:
   template <typename integer>
   void AppendOffsets(std::vector<integer>* vec) const;
 
+  /**
+   * Writes the set bits in this bitset in order from left to right to the
+   * beginning of a preallocated array, e.g., a frontier reused across
+   * rounds. The array must have room for count() offsets.
+   * Do NOT call in a parallel region as it uses katana::on_each.
+   *
+   * @returns number of offsets written
+   */
+  template <typename integer>
+  size_t WriteOffsets(NUMAArray<integer>* offsets) const;
+
   //TODO(emcginnis): DynamicBitset is not actually memory copyable, remove this
   //! this is defined to
   using tt_is_copyable = int;
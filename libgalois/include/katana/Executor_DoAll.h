@@ -26,9 +26,11 @@
 #include "katana/OperatorReferenceTypes.h"
 #include "katana/PaddedLock.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/PerfCounters.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -58,8 +60,12 @@ class DoAllStealingExec {
     Iter shared_end;
     Diff_ty m_size;
     size_t num_iter;
+    //! position of this thread among the threads of its socket
+    unsigned socket_pos;
 
     // Stats
+    size_t num_local_steals;
+    size_t num_remote_steals;
 
     ThreadContext()
         : work_mutex(),
@@ -67,18 +73,24 @@ class DoAllStealingExec {
           shared_beg(),
           shared_end(),
           m_size(0),
-          num_iter(0) {
+          num_iter(0),
+          socket_pos(0),
+          num_local_steals(0),
+          num_remote_steals(0) {
       // TODO: fix this initialization problem,
       // see initThread
     }
 
-    ThreadContext(unsigned id, Iter beg, Iter end)
+    ThreadContext(unsigned id, unsigned socket_pos, Iter beg, Iter end)
         : work_mutex(),
           id(id),
           shared_beg(beg),
           shared_end(end),
           m_size(std::distance(beg, end)),
-          num_iter(0) {}
+          num_iter(0),
+          socket_pos(socket_pos),
+          num_local_steals(0),
+          num_remote_steals(0) {}
 
     bool doWork(F func, const unsigned chunk_size) {
       Iter beg(shared_beg);
@@ -267,15 +279,13 @@ private:
 
     const unsigned maxT = katana::getActiveThreads();
     const unsigned my_pack = ThreadPool::getSocket();
-    const unsigned per_pack = tp.getMaxThreads() / tp.getMaxSockets();
+    const unsigned per_pack = tp.getNumSocketThreads(my_pack);
 
-    const unsigned pack_beg = my_pack * per_pack;
-    const unsigned pack_end = (my_pack + 1) * per_pack;
-
-    for (unsigned i = 1; i < pack_end; ++i) {
-      // go around the socket in circle starting from the next thread
-      unsigned t = (poor.id + i) % per_pack + pack_beg;
-      KATANA_LOG_DEBUG_ASSERT((t >= pack_beg) && (t < pack_end));
+    for (unsigned i = 1; i < per_pack; ++i) {
+      // go around the socket in circle starting from the next thread, which
+      // visits the threads of the same NUMA node first
+      unsigned t =
+          tp.getSocketThread(my_pack, (poor.socket_pos + i) % per_pack);
 
       if (t < maxT) {
         if (workers.getRemote(t)->hasWorkWeak()) {
@@ -284,6 +294,9 @@ private:
           stoleWork = transferWork(*workers.getRemote(t), poor, HALF);
 
           if (stoleWork) {
+            if (NEED_STATS) {
+              ++poor.num_local_steals;
+            }
             break;
           }
         }
@@ -299,21 +312,32 @@ private:
     bool stoleWork = false;
 
     auto& tp = GetThreadPool();
-    unsigned myPkg = ThreadPool::getSocket();
-    // unsigned maxT = LL::getMaxThreads ();
-    unsigned maxT = katana::getActiveThreads();
-
-    for (unsigned i = 0; i < maxT; ++i) {
-      ThreadContext& rich = *(workers.getRemote((poor.id + i) % maxT));
+    const unsigned maxT = katana::getActiveThreads();
+    const unsigned my_pack = ThreadPool::getSocket();
+    const unsigned num_packs = tp.getCumulativeMaxSocket(maxT - 1) + 1;
+
+    // visit the other sockets in circle starting from the next one; within a
+    // socket, thieves start at different threads to spread out steals
+    for (unsigned i = 1; i < num_packs && !stoleWork; ++i) {
+      const unsigned pack = (my_pack + i) % num_packs;
+      const unsigned per_pack = tp.getNumSocketThreads(pack);
+
+      for (unsigned j = 0; j < per_pack; ++j) {
+        unsigned t = tp.getSocketThread(pack, (poor.socket_pos + j) % per_pack);
+        if (t >= maxT) {
+          continue;
+        }
 
-      if (tp.getSocket(rich.id) != myPkg) {
+        ThreadContext& rich = *(workers.getRemote(t));
         if (rich.hasWorkWeak()) {
           sawWork = true;
 
           stoleWork = transferWork(rich, poor, amt);
-          // stoleWork = transferWork (rich, poor, HALF);
 
           if (stoleWork) {
+            if (NEED_STATS) {
+              ++poor.num_remote_steals;
+            }
             break;
           }
         }
@@ -324,26 +348,20 @@ private:
   }
 
   KATANA_ATTRIBUTE_NOINLINE bool trySteal(ThreadContext& poor) {
-    bool ret = false;
-
-    ret = stealWithinSocket(poor);
-
-    if (ret) {
-      return true;
-    }
-
-    asmPause();
-
-    if (GetThreadPool().isLeader(poor.id)) {
-      ret = stealOutsideSocket(poor, HALF);
-
-      if (ret) {
+    // Steal within the socket first. The socket leader leaves the socket
+    // after one failure and brings back work that the others can steal from
+    // it; the others leave only after socket_steal_attempts failures.
+    const unsigned attempts =
+        GetThreadPool().isLeader(poor.id) ? 1 : socket_steal_attempts;
+
+    for (unsigned i = 0; i < attempts; ++i) {
+      if (stealWithinSocket(poor)) {
         return true;
       }
       asmPause();
     }
 
-    ret = stealOutsideSocket(poor, HALF);
+    bool ret = stealOutsideSocket(poor, HALF);
     if (ret) {
       return true;
     }
@@ -357,6 +375,7 @@ private:
   F func;
   const char* loopname;
   Diff_ty chunk_size;
+  unsigned socket_steal_attempts;
   PerThreadStorage<ThreadContext> workers;
 
   TerminationDetection& term;
@@ -374,7 +393,8 @@ public:
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        socket_steal_attempts(katana::getSocketStealAttempts()),
+        term(GetTerminationDetection(getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
@@ -391,8 +411,14 @@ public:
 
     unsigned id = ThreadPool::getTID();
 
-    *workers.getLocal(id) =
-        ThreadContext(id, range.local_begin(), range.local_end());
+    auto& tp = GetThreadPool();
+    unsigned socket_pos = 0;
+    while (tp.getSocketThread(ThreadPool::getSocket(), socket_pos) != id) {
+      ++socket_pos;
+    }
+
+    *workers.getLocal(id) = ThreadContext(
+        id, socket_pos, range.local_begin(), range.local_end());
 
     initTime.stop();
   }
@@ -455,7 +481,10 @@ public:
     KATANA_LOG_DEBUG_ASSERT(!ctx.hasWork());
 
     if (NEED_STATS) {
+      // steals are rare enough to count for every named loop
       katana::ReportStatSum(loopname, "Iterations", ctx.num_iter);
+      katana::ReportStatSum(loopname, "LocalSteals", ctx.num_local_steals);
+      katana::ReportStatSum(loopname, "RemoteSteals", ctx.num_remote_steals);
     }
   }
 };
@@ -468,10 +497,10 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(getActiveThreads());
 
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
+        getActiveThreads(), [&exec]() { exec.initThread(); },
         [&barrier]() { barrier.Wait(); }, std::ref(exec));
   }
 };
@@ -541,6 +570,7 @@ do_all_gen(const R& range, F&& func, const ArgsTuple& argsTuple) {
 
   constexpr bool TIME_IT = has_trait<loopname_tag, ArgsT>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(argsT));
+  LoopPerfCounters<TIME_IT> counters(katana::internal::getLoopName(argsT));
 
   timer.start();
 
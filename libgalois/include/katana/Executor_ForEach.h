@@ -31,6 +31,7 @@
 #include "katana/LoopStatistics.h"
 #include "katana/Mem.h"
 #include "katana/OperatorReferenceTypes.h"
+#include "katana/PerfCounters.h"
 #include "katana/Range.h"
 #include "katana/Simple.h"
 #include "katana/TerminationDetection.h"
@@ -297,6 +298,14 @@ protected:
     return wl.empty();
   }
 
+  void reportWorkListStats(WorkListTy&, ...) {}
+
+  template <typename WL>
+  auto reportWorkListStats(WL& wl, int)
+      -> decltype(wl.reportStats(loopname), void()) {
+    wl.reportStats(loopname);
+  }
+
   template <bool couldAbort, bool isLeader>
   void go() {
     execTime.start();
@@ -351,6 +360,8 @@ protected:
 
     if (couldAbort)
       setThreadContext(0);
+    if (MORE_STATS)
+      reportWorkListStats(wl, 0);
   }
 
   struct T1 {};
@@ -358,8 +369,8 @@ protected:
 
   template <typename... WArgsTy>
   ForEachExecutor(T2, FunctionTy f, const ArgsTy& args, WArgsTy... wargs)
-      : term(GetTerminationDetection(activeThreads)),
-        barrier(GetBarrier(activeThreads)),
+      : term(GetTerminationDetection(getActiveThreads())),
+        barrier(GetBarrier(getActiveThreads())),
         wl(std::forward<WArgsTy>(wargs)...),
         origFunction(f),
         loopname(katana::internal::getLoopName(args)),
@@ -401,7 +412,7 @@ public:
 
   void operator()() {
     bool isLeader = ThreadPool::isLeader();
-    bool couldAbort = needsAborts && activeThreads > 1;
+    bool couldAbort = needsAborts && getActiveThreads() > 1;
     if (couldAbort && isLeader)
       go<true, true>();
     else if (couldAbort && !isLeader)
@@ -450,12 +461,12 @@ for_each_impl(const RangeTy& range, FunctionTy&& fn, const ArgsTy& args) {
       OperatorReferenceType<decltype(std::forward<FunctionTy>(fn))>;
   typedef ForEachExecutor<WorkListTy, FuncRefType, ArgsTy> WorkTy;
 
-  auto& barrier = GetBarrier(activeThreads);
+  auto& barrier = GetBarrier(getActiveThreads());
   FuncRefType fn_ref = fn;
   WorkTy W(fn_ref, args);
   W.init(range);
   GetThreadPool().run(
-      activeThreads, [&W, &range]() { W.initThread(range); },
+      getActiveThreads(), [&W, &range]() { W.initThread(range); },
       [&barrier] { barrier.Wait(); }, std::ref(W));
 }
 
@@ -476,6 +487,7 @@ for_each_gen(const RangeTy& r, FunctionTy&& fn, const TupleTy& tpl) {
 
   constexpr bool TIME_IT = has_trait<loopname_tag, decltype(xtpl)>();
   CondStatTimer<TIME_IT> timer(katana::internal::getLoopName(xtpl));
+  LoopPerfCounters<TIME_IT> counters(katana::internal::getLoopName(xtpl));
 
   timer.start();
 
@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_EXECUTORONEACH_H_
 
 #include "katana/OperatorReferenceTypes.h"
+#include "katana/PerfCounters.h"
 #include "katana/ThreadPool.h"
 #include "katana/ThreadTimer.h"
 #include "katana/Threads.h"
@@ -46,6 +47,7 @@ on_each_impl(FunctionTy&& fn, const ArgsTy& argsTuple) {
   const char* const loopname = katana::internal::getLoopName(argsTuple);
 
   CondStatTimer<NEEDS_STATS> timer(loopname);
+  LoopPerfCounters<NEEDS_STATS> counters(loopname);
 
   PerThreadTimer<MORE_STATS> execTime(loopname, "Execute");
 
@@ -20,7 +20,10 @@
 #ifndef KATANA_LIBGALOIS_KATANA_NUMAARRAY_H_
 #define KATANA_LIBGALOIS_KATANA_NUMAARRAY_H_
 
+#include <iterator>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "katana/Galois.h"
 #include "katana/NumaMem.h"
@@ -41,6 +44,10 @@ namespace katana {
  * Allocation size must be known at runtime (allocation cannot grow dynamically).
  * Allocations and deallocations must occur on the main thread.
  *
+ * Huge pages back the allocation according to a HugePagePolicy, by default
+ * pages reserved with hugetlbfs if there are any left. getPageBacking tells
+ * which pages actually back an array and on which NUMA nodes they are.
+ *
  * If the allocation can be concurrent, check katana::gstl::Vector.
  * If the allocation must be uninitialized and resized, check katana::PODVector.
  * Read CONTRIBUTING.md for a more detailed comparison between these types.
@@ -53,21 +60,23 @@ class NUMAArray {
   T* data_{};
   size_t size_{};
 
-  void Allocate(size_t n, AllocType t) {
+  void Allocate(size_t n, AllocType t, HugePagePolicy policy) {
     KATANA_LOG_DEBUG_ASSERT(!data_);
     size_ = n;
     switch (t) {
     case AllocType::Blocked:
-      real_data_ = largeMallocBlocked(n * sizeof(T), activeThreads);
+      real_data_ =
+          largeMallocBlocked(n * sizeof(T), getActiveThreads(), policy);
       break;
     case AllocType::Interleaved:
-      real_data_ = largeMallocInterleaved(n * sizeof(T), activeThreads);
+      real_data_ =
+          largeMallocInterleaved(n * sizeof(T), getActiveThreads(), policy);
       break;
     case AllocType::Local:
-      real_data_ = largeMallocLocal(n * sizeof(T));
+      real_data_ = largeMallocLocal(n * sizeof(T), policy);
       break;
     case AllocType::Floating:
-      real_data_ = largeMallocFloating(n * sizeof(T));
+      real_data_ = largeMallocFloating(n * sizeof(T), policy);
       break;
     default:
       KATANA_LOG_DEBUG_ASSERT(false);
@@ -137,28 +146,43 @@ public:
 
   //! [allocatefunctions]
   //! Allocates interleaved across NUMA (memory) nodes.
-  void allocateInterleaved(size_type n) { Allocate(n, AllocType::Interleaved); }
+  void allocateInterleaved(
+      size_type n, HugePagePolicy policy = HugePagePolicy::kExplicit) {
+    Allocate(n, AllocType::Interleaved, policy);
+  }
 
   /**
    * Allocates using blocked memory policy
    *
    * @param  n         number of elements to allocate
+   * @param  policy    how huge pages back the allocation
    */
-  void allocateBlocked(size_type n) { Allocate(n, AllocType::Blocked); }
+  void allocateBlocked(
+      size_type n, HugePagePolicy policy = HugePagePolicy::kExplicit) {
+    Allocate(n, AllocType::Blocked, policy);
+  }
 
   /**
    * Allocates using Thread Local memory policy
    *
    * @param  n         number of elements to allocate
+   * @param  policy    how huge pages back the allocation
    */
-  void allocateLocal(size_type n) { Allocate(n, AllocType::Local); }
+  void allocateLocal(
+      size_type n, HugePagePolicy policy = HugePagePolicy::kExplicit) {
+    Allocate(n, AllocType::Local, policy);
+  }
 
   /**
    * Allocates using no memory policy (no pre alloc)
    *
    * @param  n         number of elements to allocate
+   * @param  policy    how huge pages back the allocation
    */
-  void allocateFloating(size_type n) { Allocate(n, AllocType::Floating); }
+  void allocateFloating(
+      size_type n, HugePagePolicy policy = HugePagePolicy::kExplicit) {
+    Allocate(n, AllocType::Floating, policy);
+  }
 
   /**
    * Allocate memory to threads based on a provided array specifying which
@@ -169,19 +193,62 @@ public:
    * @param num Number of elements to allocate space for
    * @param ranges An array specifying how elements should be split
    * among threads
+   * @param policy How huge pages back the allocation
    */
   template <typename RangeArray>
-  void allocateSpecified(size_type num, RangeArray& ranges) {
+  void allocateSpecified(
+      size_type num, RangeArray& ranges,
+      HugePagePolicy policy = HugePagePolicy::kExplicit) {
     KATANA_LOG_DEBUG_ASSERT(!data_);
 
-    real_data_ =
-        largeMallocSpecified(num * sizeof(T), activeThreads, ranges, sizeof(T));
+    real_data_ = largeMallocSpecified(
+        num * sizeof(T), getActiveThreads(), ranges, sizeof(T), policy);
 
     size_ = num;
     data_ = reinterpret_cast<T*>(real_data_.get());
   }
+
+  /**
+   * Allocates an array of edges of a CSR graph so that each thread faults in
+   * the edges of the nodes it gets in a blocked split of the nodes, which are
+   * the edges that a loop over the nodes of the graph has it read.
+   *
+   * @tparam AdjIndices The type of adj_indices
+   * @param num Number of elements to allocate space for
+   * @param adj_indices The end of the edges of each node
+   * @param policy How huge pages back the allocation
+   */
+  template <typename AdjIndices>
+  void allocateDegreeBlocked(
+      size_type num, const AdjIndices& adj_indices,
+      HugePagePolicy policy = HugePagePolicy::kExplicit) {
+    const uint64_t num_nodes = std::size(adj_indices);
+    const unsigned num_threads = getActiveThreads();
+    std::vector<uint64_t> ranges(num_threads + 1);
+    for (unsigned t = 0; t < num_threads; ++t) {
+      uint64_t node = block_range(uint64_t{0}, num_nodes, t, num_threads).first;
+      ranges[t] = node ? adj_indices[node - 1] : 0;
+    }
+    ranges[num_threads] = num;
+    allocateSpecified(num, ranges, policy);
+  }
   //! [allocatefunctions]
 
+  //! Name the array to report its pages in reportPageAlloc
+  void setName(std::string name) {
+    if (real_data_) {
+      setPageAllocName(real_data_.get(), std::move(name));
+    }
+  }
+
+  //! Return the pages that back the array
+  PageBacking getPageBacking() const {
+    if (!real_data_) {
+      return PageBacking{};
+    }
+    return katana::getPageBacking(data_, size_ * sizeof(T));
+  }
+
   template <typename... Args>
   void construct(Args&&... args) {
     for (T *ii = data_, *ei = data_ + size_; ii != ei; ++ii) {
@@ -287,12 +354,17 @@ public:
   iterator end() { return nullptr; }
   const_iterator end() const { return nullptr; }
 
-  void allocateInterleaved(size_type) {}
-  void allocateBlocked(size_type) {}
-  void allocateLocal(size_type) {}
-  void allocateFloating(size_type) {}
+  void allocateInterleaved(size_type, HugePagePolicy = {}) {}
+  void allocateBlocked(size_type, HugePagePolicy = {}) {}
+  void allocateLocal(size_type, HugePagePolicy = {}) {}
+  void allocateFloating(size_type, HugePagePolicy = {}) {}
   template <typename RangeArray>
-  void allocateSpecified(size_type, RangeArray) {}
+  void allocateSpecified(size_type, RangeArray, HugePagePolicy = {}) {}
+  template <typename AdjIndices>
+  void allocateDegreeBlocked(
+      size_type, const AdjIndices&, HugePagePolicy = {}) {}
+  void setName(std::string) {}
+  PageBacking getPageBacking() const { return PageBacking{}; }
 
   template <typename... Args>
   void construct(Args&&...) {}
@@ -24,6 +24,7 @@
 #include <memory>
 #include <vector>
 
+#include "katana/PageAlloc.h"
 #include "katana/config.h"
 
 namespace katana {
@@ -37,19 +38,28 @@ struct KATANA_EXPORT largeFreer {
 
 typedef std::unique_ptr<void, internal::largeFreer> LAptr;
 
-KATANA_EXPORT LAptr largeMallocLocal(size_t bytes);  // fault in locally
-KATANA_EXPORT LAptr
-largeMallocFloating(size_t bytes);  // leave numa mapping undefined
+// Huge pages back the allocations according to policy; see HugePagePolicy.
+
+// fault in locally
+KATANA_EXPORT LAptr largeMallocLocal(
+    size_t bytes, HugePagePolicy policy = HugePagePolicy::kExplicit);
+// leave numa mapping undefined
+KATANA_EXPORT LAptr largeMallocFloating(
+    size_t bytes, HugePagePolicy policy = HugePagePolicy::kExplicit);
 // fault in interleaved mapping
-KATANA_EXPORT LAptr largeMallocInterleaved(size_t bytes, unsigned numThreads);
+KATANA_EXPORT LAptr largeMallocInterleaved(
+    size_t bytes, unsigned numThreads,
+    HugePagePolicy policy = HugePagePolicy::kExplicit);
 // fault in block interleaved mapping
-KATANA_EXPORT LAptr largeMallocBlocked(size_t bytes, unsigned numThreads);
+KATANA_EXPORT LAptr largeMallocBlocked(
+    size_t bytes, unsigned numThreads,
+    HugePagePolicy policy = HugePagePolicy::kExplicit);
 
 // fault in specified regions for each thread (threadRanges)
 template <typename RangeArrayTy>
 KATANA_EXPORT LAptr largeMallocSpecified(
     size_t bytes, uint32_t numThreads, RangeArrayTy& threadRanges,
-    size_t elementSize);
+    size_t elementSize, HugePagePolicy policy = HugePagePolicy::kExplicit);
 
 }  // namespace katana
 
@@ -21,20 +21,73 @@
 #define KATANA_LIBGALOIS_KATANA_PAGEALLOC_H_
 
 #include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/config.h"
 
 namespace katana {
 
+//! How allocPages backs memory with huge pages
+enum class HugePagePolicy {
+  //! huge pages reserved with hugetlbfs (MAP_HUGETLB), or normal pages when
+  //! none are left; fallbacks are counted, see numHugePageFallbacks
+  kExplicit,
+  //! normal pages that the kernel may back with transparent huge pages
+  //! (madvise(MADV_HUGEPAGE))
+  kTransparent,
+  //! normal pages only
+  kNone,
+};
+
+//! Pages that back a range of memory returned by allocPages
+struct KATANA_EXPORT PageBacking {
+  size_t huge_bytes{0};
+  size_t normal_bytes{0};
+  //! bytes on each NUMA node, of the pages that have been faulted in,
+  //! sampled once every allocSize() bytes; empty if the node of pages cannot
+  //! be queried
+  std::vector<size_t> node_bytes;
+
+  PageBacking& operator+=(const PageBacking& o);
+};
+
 // size of pages
 KATANA_EXPORT size_t allocSize();
 
 // allocate contiguous pages, optionally faulting them in
-KATANA_EXPORT void* allocPages(unsigned num, bool preFault);
+KATANA_EXPORT void* allocPages(
+    unsigned num, bool preFault,
+    HugePagePolicy policy = HugePagePolicy::kExplicit);
 
 // free page range
 KATANA_EXPORT void freePages(void* ptr, unsigned num);
 
+//! size of the pages that back memory returned by allocPages, which is the
+//! granularity at which its pages are placed on NUMA nodes on first touch
+KATANA_EXPORT size_t pageSizeOf(const void* ptr);
+
+//! pages that back bytes bytes of memory, starting at ptr, of one allocation
+//! returned by allocPages
+KATANA_EXPORT PageBacking getPageBacking(const void* ptr, size_t bytes);
+
+//! pages that back all memory currently allocated with allocPages
+KATANA_EXPORT PageBacking getPageBacking();
+
+//! name the allocation returned by allocPages that starts at ptr, to report
+//! its pages in reportPageAlloc
+KATANA_EXPORT void setPageAllocName(const void* ptr, std::string name);
+
+//! pages that back each named allocation
+KATANA_EXPORT std::vector<std::pair<std::string, PageBacking>>
+getNamedPageBackings();
+
+//! number of allocations with HugePagePolicy::kExplicit that fell back to
+//! normal pages because huge pages were not available; always zero with
+//! jemalloc, which does not try huge pages
+KATANA_EXPORT size_t numHugePageFallbacks();
+
 }  // namespace katana
 
 #endif
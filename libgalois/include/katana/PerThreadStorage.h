@@ -70,11 +70,16 @@ public:
 
   unsigned allocOffset(unsigned size);
   void deallocOffset(unsigned offset, unsigned size);
+  // thread ids are relative to the thread pool partition of the caller
   void* getRemote(unsigned thread, unsigned offset);
+  // pool_thread is a thread id of the whole thread pool
+  void* getPoolRemote(unsigned pool_thread, unsigned offset);
   void* getLocal(unsigned offset, char* base) { return &base[offset]; }
   // faster when (1) you already know the id and (2) shared access to heads is
   // not to expensive; otherwise use getLocal(unsigned,char*)
-  void* getLocal(unsigned offset, unsigned id) { return &heads[id][offset]; }
+  void* getLocal(unsigned offset, unsigned id) {
+    return &heads[ThreadPool::getPoolTID(id)][offset];
+  }
 };
 
 extern thread_local char* ptsBase;
@@ -95,8 +100,8 @@ class PerThreadStorage {
       return;
     }
 
-    for (unsigned n = 0; n < GetThreadPool().getMaxThreads(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
+    for (unsigned n = 0; n < GetThreadPool().getMaxPoolThreads(); ++n) {
+      reinterpret_cast<T*>(b->getPoolRemote(n, offset))->~T();
     }
     b->deallocOffset(offset, sizeof(T));
     offset = ~0U;
@@ -141,8 +146,8 @@ public:
     auto& tp = GetThreadPool();
 
     offset = b->allocOffset(sizeof(T));
-    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
-      new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+    for (unsigned n = 0; n < tp.getMaxPoolThreads(); ++n) {
+      new (b->getPoolRemote(n, offset)) T(std::forward<Args>(args)...);
     }
   }
 
@@ -194,6 +199,13 @@ public:
     return reinterpret_cast<T*>(ditem);
   }
 
+  //! pool_thread is a thread id of the whole thread pool rather than of the
+  //! partition of the calling thread
+  const T* getPoolRemote(unsigned int pool_thread) const {
+    void* ditem = b->getPoolRemote(pool_thread, offset);
+    return reinterpret_cast<T*>(ditem);
+  }
+
   unsigned size() const { return GetThreadPool().getMaxThreads(); }
 
   iterator begin() { return iterator(*this, 0); }
@@ -212,8 +224,9 @@ class PerSocketStorage {
 
   void destruct() {
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
+    for (unsigned n = 0; n < tp.getMaxPoolSockets(); ++n) {
+      reinterpret_cast<T*>(
+          b->getPoolRemote(tp.getPoolLeaderForSocket(n), offset))
           ->~T();
     }
     b->deallocOffset(offset, sizeof(T));
@@ -228,8 +241,8 @@ public:
 
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
+    for (unsigned n = 0; n < tp.getMaxPoolSockets(); ++n) {
+      new (b->getPoolRemote(tp.getPoolLeaderForSocket(n), offset))
           T(std::forward<Args>(args)...);
     }
   }
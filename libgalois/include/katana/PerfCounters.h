@@ -0,0 +1,92 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+#define KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "katana/config.h"
+
+namespace katana {
+
+/// Hardware events counted for each thread of the pool
+enum class PerfEvent {
+  kCycles,
+  kInstructions,
+  kLLCMisses,
+  kDTLBMisses,
+};
+
+constexpr std::size_t kNumPerfEvents = 4;
+
+/// Counts of each PerfEvent
+struct PerfCounts {
+  std::array<uint64_t, kNumPerfEvents> counts{};
+
+  uint64_t& operator[](PerfEvent e) { return counts[std::size_t(e)]; }
+  uint64_t operator[](PerfEvent e) const { return counts[std::size_t(e)]; }
+
+  PerfCounts& operator+=(const PerfCounts& other) {
+    for (std::size_t i = 0; i < kNumPerfEvents; ++i) {
+      counts[i] += other.counts[i];
+    }
+    return *this;
+  }
+
+  PerfCounts& operator-=(const PerfCounts& other) {
+    for (std::size_t i = 0; i < kNumPerfEvents; ++i) {
+      counts[i] -= other.counts[i];
+    }
+    return *this;
+  }
+
+  /// @returns the name of event i, as reported in statistics
+  static const char* Name(std::size_t i);
+};
+
+/// @returns true if hardware events are counted, which is the case when
+/// KATANA_PERF_COUNTERS is set in the environment.
+///
+/// Events are counted with the Linux perf_event_open interface, so neither
+/// PAPI nor a special build is needed. Events the kernel does not allow to
+/// count, e.g., because of perf_event_paranoid or in a virtual machine, read
+/// as zero.
+KATANA_EXPORT bool PerfCountersEnabled();
+
+/// @returns the events counted for the calling thread so far; zero if
+/// PerfCountersEnabled() is false
+KATANA_EXPORT PerfCounts ReadThreadPerfCounts();
+
+/// Reports as statistics of a named loop the hardware events counted by the
+/// threads of the pool and the page pool pages allocated while the loop runs.
+/// Nothing is read or reported unless PerfCountersEnabled().
+template <bool Enabled>
+class LoopPerfCounters;
+
+template <>
+class KATANA_EXPORT LoopPerfCounters<true> {
+public:
+  explicit LoopPerfCounters(const char* loopname);
+  ~LoopPerfCounters();
+
+  LoopPerfCounters(const LoopPerfCounters&) = delete;
+  LoopPerfCounters& operator=(const LoopPerfCounters&) = delete;
+  LoopPerfCounters(LoopPerfCounters&&) = delete;
+  LoopPerfCounters& operator=(LoopPerfCounters&&) = delete;
+
+private:
+  const char* loopname_;
+  PerfCounts start_;
+  int start_pages_{0};
+  bool enabled_;
+};
+
+template <>
+class LoopPerfCounters<false> {
+public:
+  explicit LoopPerfCounters(const char*) {}
+};
+
+}  // namespace katana
+
+#endif
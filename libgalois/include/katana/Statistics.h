@@ -300,6 +300,15 @@ public:
   using param_const_iterator =
       typename internal::VecStatManager<Str>::const_iterator;
 
+  /// Formats that Print writes statistics in
+  enum class Format {
+    /// Comma-separated lines, one per statistic
+    kText,
+    /// JSON lines, one object per region, e.g., per named loop, holding
+    /// all the statistics of the region
+    kJson,
+  };
+
 protected:
   static constexpr const char* const kSep = ", ";
   static constexpr const char* const kThreadSep = "; ";
@@ -313,6 +322,9 @@ protected:
   /// ReadParam and ReadFP and print their own results here.
   virtual void PrintStats(std::ostream& out);
 
+  /// PrintStatsJson prints statistics to a stream in the kJson format.
+  virtual void PrintStatsJson(std::ostream& out);
+
   void MergeStats();
 
   bool IsPrintingThreadVals() const;
@@ -348,6 +360,10 @@ public:
 
   void SetStatFile(const std::string& outfile);
 
+  /// Sets the format of Print. The default is kJson if KATANA_STAT_FORMAT is
+  /// "json" in the environment and kText otherwise.
+  void SetStatFormat(Format format);
+
   void AddInt(
       const std::string& region, const std::string& category, int64_t val,
       const StatTotal::Type& type);
@@ -483,6 +499,8 @@ KATANA_EXPORT void PrintStats();
 
 KATANA_EXPORT void SetStatFile(const std::string& f);
 
+KATANA_EXPORT void SetStatFormat(StatManager::Format format);
+
 }  // end namespace katana
 
 #endif
@@ -109,7 +109,9 @@ public:
 };
 
 namespace internal {
-void SetTerminationDetection(TerminationDetection* term);
+/// Set the termination detection of a thread pool partition
+void SetTerminationDetection(
+    TerminationDetection* term, unsigned partition = 0);
 }  // end namespace internal
 
 }  // end namespace katana
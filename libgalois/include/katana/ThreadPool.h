@@ -25,12 +25,14 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <functional>
+#include <memory>
 #include <thread>
 #include <vector>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/HWTopo.h"
 #include "katana/Logging.h"
+#include "katana/PerfCounters.h"
 
 namespace katana::internal {
 
@@ -52,13 +54,72 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 namespace katana {
 
 class KATANA_EXPORT ThreadPool {
+public:
+  /// IdlePolicy is how the threads of the pool wait for the next parallel
+  /// section between sections.
+  enum class IdlePolicy {
+    /// Sleep on a condition variable; waking up a thread costs a system call
+    /// that may take tens of microseconds
+    kSleep,
+    /// Spin; wake-ups are cheapest, but idle threads keep their cores busy
+    kSpin,
+    /// Spin for a bounded number of iterations and then sleep on a futex, so
+    /// that sections that follow each other closely are woken up like kSpin
+    /// and idle periods cost like kSleep
+    kSpinThenSleep,
+  };
+
+  //! default number of spin iterations of kSpinThenSleep before sleeping
+  static constexpr unsigned kDefaultSpinIterations = 1U << 14;
+
+  /// A Partition is a subset of the threads of the pool that executes
+  /// parallel loops independently of the threads in other partitions.
+  ///
+  /// Threads, sockets and the other topology queries of the pool are
+  /// numbered relative to the partition of the calling thread, so a parallel
+  /// loop, and the per-thread and per-socket storage it uses, sees its
+  /// partition as if it were the whole machine.
+  class Partition {
+    friend class ThreadPool;
+
+    unsigned id_;
+    MachineTopoInfo mi_;
+    //! pool thread id of each thread of the partition
+    std::vector<unsigned> threads_;
+    //! topology of each thread of the partition, relative to the partition
+    std::vector<ThreadTopoInfo> topo_;
+    //! thread ids of the partition ordered by socket and then NUMA node
+    std::vector<unsigned> socket_threads_;
+    //! threads of socket s are socket_threads_[socket_begin_[s]] up to
+    //! socket_threads_[socket_begin_[s + 1]]
+    std::vector<unsigned> socket_begin_;
+    std::function<void(void)> work_;
+    IdlePolicy policy_{IdlePolicy::kSleep};
+    //! number of threads, from the first, whose idle policy is policy_
+    unsigned policy_threads_{0};
+    unsigned spin_iterations_{kDefaultSpinIterations};
+    unsigned active_threads_{1};
+    //! unique id of the parallel loop the partition runs or ran last
+    uint64_t loop_epoch_{0};
+    bool running_{false};
+    std::atomic<bool> occupied_{false};
+
+  public:
+    unsigned id() const { return id_; }
+    unsigned num_threads() const { return threads_.size(); }
+    unsigned num_sockets() const { return mi_.maxSockets; }
+    //! pool thread id of partition thread tid
+    unsigned pool_thread(unsigned tid) const { return threads_[tid]; }
+  };
+
 private:
   friend class GaloisRuntime;
 
   struct shutdown_ty {};  //! type for shutting down thread
-  struct fastmode_ty {
-    bool mode;
-  };  //! type for setting fastmode
+  struct policy_ty {
+    IdlePolicy policy;
+    unsigned spin_iterations;
+  };  //! type for setting the idle policy
   struct dedicated_ty {
     std::function<void(void)> fn;
   };  //! type to switch to dedicated mode
@@ -71,42 +132,87 @@ private:
     std::atomic<int> done;
     std::atomic<int> fastRelease;
     ThreadTopoInfo topo;
-
-    void wakeup(bool fastmode) {
-      if (fastmode) {
+    //! partition of this thread; null for threads outside the pool that have
+    //! not entered a partition, which see the whole pool
+    Partition* partition{nullptr};
+    //! hardware events counted while this thread ran parallel sections
+    PerfCounts perf_counts;
+
+    //! values of fastRelease
+    static constexpr int kWaiting = 0;
+    static constexpr int kReleased = 1;
+    static constexpr int kSleeping = 2;
+
+    void wakeup(IdlePolicy policy) {
+      switch (policy) {
+      case IdlePolicy::kSpin:
+        done = 0;
+        fastRelease = kReleased;
+        break;
+      case IdlePolicy::kSpinThenSleep:
         done = 0;
-        fastRelease = 1;
-      } else {
+        if (fastRelease.exchange(kReleased) == kSleeping) {
+          wakeSleeper();
+        }
+        break;
+      case IdlePolicy::kSleep: {
         std::lock_guard<std::mutex> lg(m);
         done = 0;
         cv.notify_one();
         // start.release();
+        break;
+      }
       }
     }
 
-    void wait(bool fastmode) {
-      if (fastmode) {
-        while (!fastRelease.load(std::memory_order_relaxed)) {
+    void wait(IdlePolicy policy, unsigned spin_iterations) {
+      switch (policy) {
+      case IdlePolicy::kSpin:
+        while (fastRelease.load(std::memory_order_relaxed) != kReleased) {
           asmPause();
         }
-        fastRelease = 0;
-      } else {
+        fastRelease = kWaiting;
+        break;
+      case IdlePolicy::kSpinThenSleep: {
+        for (unsigned i = 0; i < spin_iterations &&
+                             fastRelease.load(std::memory_order_acquire) !=
+                                 kReleased;
+             ++i) {
+          asmPause();
+        }
+        int expected = kWaiting;
+        if (fastRelease.compare_exchange_strong(expected, kSleeping)) {
+          sleepUntilReleased();
+        }
+        fastRelease = kWaiting;
+        break;
+      }
+      case IdlePolicy::kSleep: {
         std::unique_lock<std::mutex> lg(m);
         cv.wait(lg, [=] { return !done; });
         // start.acquire();
+        break;
+      }
       }
     }
+
+    //! kSpinThenSleep: block while fastRelease is kSleeping
+    void sleepUntilReleased();
+    //! kSpinThenSleep: wake up a thread blocked in sleepUntilReleased
+    void wakeSleeper();
   };
 
   thread_local static per_signal my_box;
 
   MachineTopoInfo mi;
+  std::vector<ThreadTopoInfo> poolTopo;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
+  //! the whole pool, which is the only partition until setPartitions
+  std::unique_ptr<Partition> whole;
+  std::vector<std::unique_ptr<Partition>> partitionStorage;
+  std::vector<Partition*> partitions;
   unsigned reserved;
-  unsigned masterFastmode;
-  bool running;
-  std::function<void(void)> work;
 
   //! destroy all threads
   void destroyCommon();
@@ -118,7 +224,7 @@ private:
   void threadLoop(unsigned tid);
 
   //! spin up for run
-  void cascade(bool fastmode);
+  void cascade(IdlePolicy policy);
 
   //! spin down after run
   void decascade();
@@ -126,6 +232,20 @@ private:
   //! execute work on num threads
   void runInternal(unsigned num);
 
+  //! make a partition of the pool threads in pool_threads
+  std::unique_ptr<Partition> makePartition(
+      unsigned id, std::vector<unsigned> pool_threads) const;
+
+  //! partition of the calling thread
+  static Partition& myPartition(const ThreadPool& tp) {
+    return my_box.partition ? *my_box.partition : *tp.whole;
+  }
+
+  //! mailbox of thread tid of the calling thread's partition
+  per_signal* signalOf(unsigned tid) const {
+    return signals[myPartition(*this).threads_[tid]];
+  }
+
   ThreadPool();
 
 public:
@@ -155,7 +275,7 @@ public:
     // paying for an indirection in work allows small-object optimization in
     // std::function to kick in and avoid a heap allocation
     ExecuteTuple lwork(std::forward<Args>(args)...);
-    work = std::ref(lwork);
+    myPartition(*this).work_ = std::ref(lwork);
     // work =
     // std::function<void(void)>(ExecuteTuple(std::forward<Args>(args)...));
     KATANA_LOG_DEBUG_ASSERT(num <= getMaxThreads());
@@ -170,14 +290,64 @@ public:
   // experimental: leave busy wait
   void beKind();
 
+  //! set how the threads of the partition of the calling thread wait between
+  //! parallel sections; spin_iterations only applies to kSpinThenSleep
+  void setIdlePolicy(
+      IdlePolicy policy, unsigned spin_iterations = kDefaultSpinIterations);
+  //! return the idle policy of the partition of the calling thread
+  IdlePolicy getIdlePolicy() const { return myPartition(*this).policy_; }
+
+  //! return an id of the parallel loop that the partition of the calling
+  //! thread runs, or ran last; every loop gets a new id
+  uint64_t getLoopEpoch() const { return myPartition(*this).loop_epoch_; }
+
+  //! return the hardware events counted while the threads of the partition
+  //! of the calling thread ran parallel sections; see PerfCountersEnabled()
+  PerfCounts getPerfCounts() const;
+
+  //! split the pool into num partitions, each made of whole sockets if there
+  //! are at least num sockets; returns the number of partitions made. Must
+  //! not be called while any partition is in use.
+  unsigned setPartitions(unsigned num);
+  //! return the number of partitions of the pool
+  unsigned getNumPartitions() const { return partitions.size(); }
+  //! return partition id
+  const Partition& getPartition(unsigned id) const { return *partitions[id]; }
+  //! make the calling thread, which must not be a pool thread, the first
+  //! thread of partition id until exitPartition, so that the parallel loops it
+  //! starts run on the threads of that partition. The partition must not be
+  //! entered by another thread or hold the thread that made the pool.
+  void enterPartition(unsigned id);
+  //! like enterPartition, but returns false instead of failing if the
+  //! partition is in use
+  bool tryEnterPartition(unsigned id);
+  //! leave the partition entered by enterPartition
+  void exitPartition();
+
   //! return the number of non-reserved threads in the pool
-  unsigned getMaxUsableThreads() const { return mi.maxThreads - reserved; }
+  unsigned getMaxUsableThreads() const {
+    return myPartition(*this).mi_.maxThreads - reserved;
+  }
   //! return the number of threads supported by the thread pool on the current
   //! machine
-  unsigned getMaxThreads() const { return mi.maxThreads; }
-  unsigned getMaxCores() const { return mi.maxCores; }
-  unsigned getMaxSockets() const { return mi.maxSockets; }
-  unsigned getMaxNumaNodes() const { return mi.maxNumaNodes; }
+  unsigned getMaxThreads() const { return myPartition(*this).mi_.maxThreads; }
+  unsigned getMaxCores() const { return myPartition(*this).mi_.maxCores; }
+  unsigned getMaxSockets() const { return myPartition(*this).mi_.maxSockets; }
+  unsigned getMaxNumaNodes() const {
+    return myPartition(*this).mi_.maxNumaNodes;
+  }
+
+  //! return the number of threads in the pool across all partitions
+  unsigned getMaxPoolThreads() const { return mi.maxThreads; }
+  //! return the number of sockets in the pool across all partitions
+  unsigned getMaxPoolSockets() const { return mi.maxSockets; }
+  //! return the pool thread id of the leader of pool socket pid
+  unsigned getPoolLeaderForSocket(unsigned pid) const {
+    for (unsigned i = 0; i < getMaxPoolThreads(); ++i)
+      if (poolTopo[i].socket == pid && poolTopo[i].socketLeader == i)
+        return i;
+    abort();
+  }
 
   unsigned getLeaderForSocket(unsigned pid) const {
     for (unsigned i = 0; i < getMaxThreads(); ++i)
@@ -186,18 +356,30 @@ public:
     abort();
   }
 
+  //! return the number of threads of socket pid, active or not
+  unsigned getNumSocketThreads(unsigned pid) const {
+    const Partition& p = myPartition(*this);
+    return p.socket_begin_[pid + 1] - p.socket_begin_[pid];
+  }
+  //! return the i-th thread of socket pid; the threads of a socket are
+  //! ordered by NUMA node, so nearby threads are close in this order
+  unsigned getSocketThread(unsigned pid, unsigned i) const {
+    const Partition& p = myPartition(*this);
+    return p.socket_threads_[p.socket_begin_[pid] + i];
+  }
+
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return signalOf(tid)->topo.socketLeader == tid;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getSocket(unsigned tid) const { return signalOf(tid)->topo.socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return signalOf(tid)->topo.socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
+    return signalOf(tid)->topo.cumulativeMaxSocket;
   }
   unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return signalOf(tid)->topo.numaNode;
   }
 
   static unsigned getTID() { return my_box.topo.tid; }
@@ -208,6 +390,16 @@ public:
     return my_box.topo.cumulativeMaxSocket;
   }
   static unsigned getNumaNode() { return my_box.topo.numaNode; }
+
+  //! return the id of the partition of the calling thread
+  static unsigned getPartitionID() {
+    return my_box.partition ? my_box.partition->id_ : 0;
+  }
+  //! return the pool thread id of thread tid of the calling thread's
+  //! partition
+  static unsigned getPoolTID(unsigned tid) {
+    return my_box.partition ? my_box.partition->threads_[tid] : tid;
+  }
 };
 
 /**
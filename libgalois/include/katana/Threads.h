@@ -25,17 +25,74 @@
 namespace katana {
 
 /**
- * Sets the number of threads to use when running any Galois iterator. Returns
- * the actual value of threads used, which could be less than the requested
- * value. System behavior is undefined if this function is called during
- * parallel execution or after the first parallel execution.
+ * Sets the number of threads to use when running any Galois iterator from the
+ * calling thread. Returns the actual value of threads used, which could be
+ * less than the requested value, e.g., the number of threads of the thread
+ * pool partition of the calling thread. System behavior is undefined if this
+ * function is called during parallel execution.
  */
 KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
 
 /**
- * Returns the number of threads in use.
+ * Returns the number of threads in use by the calling thread.
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
+/**
+ * Sets the number of times a thread that runs out of work looks for work to
+ * steal among the threads of its own socket before it also steals from other
+ * sockets. Socket leaders look in other sockets after the first failure, so
+ * work moves between sockets in large pieces that threads of the socket then
+ * share. Larger values keep more steals within a socket at the cost of idle
+ * time when only other sockets have work.
+ */
+KATANA_EXPORT void setSocketStealAttempts(unsigned int num) noexcept;
+
+/**
+ * Returns the number of times a thread looks for work within its socket
+ * before stealing from other sockets.
+ */
+KATANA_EXPORT unsigned int getSocketStealAttempts() noexcept;
+
+/**
+ * Splits the thread pool into num partitions that run Galois iterators
+ * concurrently, each made of whole sockets if there are at least num
+ * sockets. Returns the actual number of partitions. Partition 0 includes the
+ * thread that created the runtime, which is the only thread that can use it;
+ * other threads use one of the other partitions through a
+ * ThreadPartitionScope. Calling this with num = 1 restores the whole pool.
+ * System behavior is undefined if this function is called while a partition
+ * is in use.
+ */
+KATANA_EXPORT unsigned int setThreadPartitions(unsigned int num);
+
+/**
+ * Returns the number of partitions of the thread pool.
+ */
+KATANA_EXPORT unsigned int getThreadPartitions() noexcept;
+
+/**
+ * While a ThreadPartitionScope exists, Galois iterators started by the
+ * thread that made it run on the threads of one partition of the thread
+ * pool, independently of those started by other threads on other partitions.
+ * Thread ids, per-thread storage and statistics are those of the partition.
+ * Only one thread can be in a partition at a time.
+ */
+class KATANA_EXPORT ThreadPartitionScope {
+public:
+  explicit ThreadPartitionScope(unsigned int partition);
+  ~ThreadPartitionScope();
+
+  ThreadPartitionScope(const ThreadPartitionScope&) = delete;
+  ThreadPartitionScope& operator=(const ThreadPartitionScope&) = delete;
+  ThreadPartitionScope(ThreadPartitionScope&&) = delete;
+  ThreadPartitionScope& operator=(ThreadPartitionScope&&) = delete;
+
+private:
+  char* pts_base_;
+  char* pss_base_;
+  unsigned int active_threads_;
+};
+
 }  // namespace katana
 #endif
@@ -29,10 +29,12 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "katana/Arena.h"
 #include "katana/PriorityQueue.h"
 #include "katana/config.h"
 
@@ -166,6 +168,32 @@ template <
 using UnorderedMap = std::unordered_map<
     K, V, Hash, KeyEqual, Pow2BlockAllocator<std::pair<const K, V>>>;
 
+//! [STL containers using katana ArenaAllocator]
+//! specialize STL containers to allocate from the loop arena of the calling
+//! thread (see GetLoopArena): allocation is a pointer bump in thread-local
+//! memory and deallocation is free, since the arena is emptied at the start of
+//! every parallel loop, or when an ArenaScope ends.
+//!
+//! Use these for the temporaries of the operator of a parallel loop. They must
+//! not outlive the loop, or the ArenaScope, they are created in.
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template <typename K, typename V, typename C = std::less<K>>
+using ArenaMap = std::map<K, V, C, ArenaAllocator<std::pair<const K, V>>>;
+
+template <
+    typename K, typename V, typename Hash = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>>
+using ArenaUnorderedMap = std::unordered_map<
+    K, V, Hash, KeyEqual, ArenaAllocator<std::pair<const K, V>>>;
+
+template <
+    typename T, typename Hash = std::hash<T>,
+    typename KeyEqual = std::equal_to<T>>
+using ArenaUnorderedSet =
+    std::unordered_set<T, Hash, KeyEqual, ArenaAllocator<T>>;
+
 //! [STL basic_string using katana Pow2BlockAllocator]
 //! specializes std::basic_string to use katana concurrent, scaleable allocator:
 //! the allocator is composed of thread-local allocators
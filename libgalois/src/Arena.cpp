@@ -0,0 +1,111 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include "katana/Arena.h"
+
+#include <cstdlib>
+
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+
+katana::Arena::~Arena() {
+  Reset();
+  for (char* block : blocks_) {
+    std::free(block);
+  }
+}
+
+void*
+katana::Arena::AllocateSlow(size_t size, size_t alignment) {
+  if (size + alignment > kBlockSize / 2) {
+    void* ptr = alignment <= alignof(std::max_align_t)
+                    ? std::malloc(size)
+                    : std::aligned_alloc(
+                          alignment, (size + alignment - 1) & ~(alignment - 1));
+    if (!ptr) {
+      throw std::bad_alloc();
+    }
+    large_.emplace_back(ptr, size);
+    large_bytes_ += size;
+    return ptr;
+  }
+
+  // move to the next block, allocating it if it is not cached
+  size_t next = base_ ? current_ + 1 : 0;
+  if (next == blocks_.size()) {
+    char* block = static_cast<char*>(std::malloc(kBlockSize));
+    if (!block) {
+      throw std::bad_alloc();
+    }
+    blocks_.emplace_back(block);
+  }
+  current_ = next;
+  base_ = blocks_[current_];
+  offset_ = 0;
+
+  void* ret = allocate(size, alignment);
+  KATANA_LOG_DEBUG_ASSERT(ret >= base_ && ret < base_ + kBlockSize);
+  return ret;
+}
+
+void
+katana::Arena::rewind(const Mark& m) {
+  KATANA_LOG_DEBUG_ASSERT(m.num_large <= large_.size());
+  while (large_.size() > m.num_large) {
+    std::free(large_.back().first);
+    large_bytes_ -= large_.back().second;
+    large_.pop_back();
+  }
+
+  if (blocks_.empty()) {
+    return;
+  }
+  KATANA_LOG_DEBUG_ASSERT(m.block < blocks_.size());
+  current_ = m.block;
+  base_ = blocks_[current_];
+  offset_ = m.offset;
+}
+
+void
+katana::Arena::Reset() {
+  rewind(Mark{0, 0, 0});
+  // a loop that needed many blocks should not keep them all forever
+  while (blocks_.size() > kMaxCachedBlocks) {
+    std::free(blocks_.back());
+    blocks_.pop_back();
+  }
+}
+
+size_t
+katana::Arena::capacity() const {
+  return blocks_.size() * kBlockSize + large_bytes_;
+}
+
+katana::Arena&
+katana::GetLoopArena() {
+  thread_local Arena arena;
+  thread_local uint64_t epoch = 0;
+
+  uint64_t loop_epoch = GetThreadPool().getLoopEpoch();
+  if (epoch != loop_epoch) {
+    arena.Reset();
+    epoch = loop_epoch;
+  }
+  return arena;
+}
@@ -19,39 +19,67 @@
 
 #include "katana/Barrier.h"
 
+#include <vector>
+
 #include "katana/Logging.h"
 #include "katana/ThreadPool.h"
 
 // anchor vtable
 katana::Barrier::~Barrier() = default;
 
-static katana::Barrier* kBarrier = nullptr;
-static unsigned kBarrierThreads = 0;
+namespace {
+
+// Barrier for each thread pool partition, and the number of threads and of
+// partitions it was last initialized for; the threads of the first partition
+// change with the number of partitions.
+struct PartitionBarrier {
+  katana::Barrier* barrier{nullptr};
+  unsigned threads{0};
+  unsigned partitions{0};
+};
+
+std::vector<PartitionBarrier> kBarriers;
+
+}  // namespace
 
 void
-katana::internal::SetBarrier(katana::Barrier* barrier) {
+katana::internal::SetBarrier(katana::Barrier* barrier, unsigned partition) {
+  if (kBarriers.size() <= partition) {
+    kBarriers.resize(partition + 1);
+  }
+  PartitionBarrier& b = kBarriers[partition];
   KATANA_LOG_VASSERT(
-      !(barrier && kBarrier), "Double initialization of Barrier");
+      !(barrier && b.barrier), "Double initialization of Barrier");
 
-  kBarrier = barrier;
+  b.barrier = barrier;
+  // Barriers of other partitions are made outside of their partition, so
+  // initialize them on first use instead
+  b.threads = 0;
 
-  if (barrier) {
-    kBarrierThreads = GetThreadPool().getMaxUsableThreads();
-    kBarrier->Reinit(kBarrierThreads);
+  if (barrier && partition == 0) {
+    auto& tp = GetThreadPool();
+    b.threads = tp.getMaxUsableThreads();
+    b.partitions = tp.getNumPartitions();
+    b.barrier->Reinit(b.threads);
   }
 }
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
-  KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
-  active_threads =
-      std::min(active_threads, GetThreadPool().getMaxUsableThreads());
+  unsigned partition = ThreadPool::getPartitionID();
+  KATANA_LOG_VASSERT(
+      partition < kBarriers.size() && kBarriers[partition].barrier,
+      "Barrier not initialized");
+  PartitionBarrier& b = kBarriers[partition];
+  auto& tp = GetThreadPool();
+  active_threads = std::min(active_threads, tp.getMaxUsableThreads());
   active_threads = std::max(active_threads, 1U);
 
-  if (active_threads != kBarrierThreads) {
-    kBarrierThreads = active_threads;
-    kBarrier->Reinit(kBarrierThreads);
+  if (active_threads != b.threads || tp.getNumPartitions() != b.partitions) {
+    b.threads = active_threads;
+    b.partitions = tp.getNumPartitions();
+    b.barrier->Reinit(b.threads);
   }
 
-  return *kBarrier;
+  return *b.barrier;
 }
@@ -23,167 +23,387 @@
 
 #include "katana/DynamicBitset.h"
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "katana/Galois.h"
 
 KATANA_EXPORT katana::DynamicBitset katana::EmptyBitset;
 
+namespace {
+
+// Bulk operations work on the words of a bitset as plain integers, in blocks
+// of kBlockWords words that are split among threads
+constexpr size_t kBlockWords = 1024;
+
+static_assert(sizeof(katana::DynamicBitset::TItem) == sizeof(uint64_t));
+
+// The bulk operations assume the bitset is not updated in parallel, so its
+// words can be read and written without atomic operations
+const uint64_t*
+Words(const katana::DynamicBitset& bitset) {
+  return reinterpret_cast<const uint64_t*>(bitset.get_vec().data());
+}
+
+uint64_t*
+Words(katana::DynamicBitset& bitset) {
+  return reinterpret_cast<uint64_t*>(bitset.get_vec().data());
+}
+
+size_t
+Popcount(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_popcountll(n);
+#else
+  n = n - ((n >> 1) & 0x5555555555555555UL);
+  n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
+  return (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
+#endif
+}
+
+unsigned
+CountTrailingZeros(uint64_t n) {
+#ifdef __GNUC__
+  return __builtin_ctzll(n);
+#else
+  unsigned ret = 0;
+  while (!(n & 1)) {
+    n >>= 1;
+    ++ret;
+  }
+  return ret;
+#endif
+}
+
+enum class BitwiseOp { kAnd, kOr, kXor, kAndNot };
+
+template <BitwiseOp op>
+uint64_t
+Apply(uint64_t a, uint64_t b) {
+  switch (op) {
+  case BitwiseOp::kAnd:
+    return a & b;
+  case BitwiseOp::kOr:
+    return a | b;
+  case BitwiseOp::kXor:
+    return a ^ b;
+  case BitwiseOp::kAndNot:
+    return a & ~b;
+  }
+}
+
+#if defined(__AVX512F__)
+template <BitwiseOp op>
+__m512i
+Apply(__m512i a, __m512i b) {
+  switch (op) {
+  case BitwiseOp::kAnd:
+    return _mm512_and_si512(a, b);
+  case BitwiseOp::kOr:
+    return _mm512_or_si512(a, b);
+  case BitwiseOp::kXor:
+    return _mm512_xor_si512(a, b);
+  case BitwiseOp::kAndNot:
+    // not _mm512_andnot_si512, which some GCC versions warn about
+    return _mm512_and_si512(a, _mm512_xor_si512(b, _mm512_set1_epi64(-1)));
+  }
+}
+#elif defined(__AVX2__)
+template <BitwiseOp op>
+__m256i
+Apply(__m256i a, __m256i b) {
+  switch (op) {
+  case BitwiseOp::kAnd:
+    return _mm256_and_si256(a, b);
+  case BitwiseOp::kOr:
+    return _mm256_or_si256(a, b);
+  case BitwiseOp::kXor:
+    return _mm256_xor_si256(a, b);
+  case BitwiseOp::kAndNot:
+    return _mm256_andnot_si256(b, a);
+  }
+}
+#endif
+
+//! dst[i] = a[i] op b[i] for i in [0, n)
+template <BitwiseOp op>
 void
-katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
-  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
+ApplyWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 8 <= n; i += 8) {
+    __m512i x = _mm512_loadu_si512(a + i);
+    __m512i y = _mm512_loadu_si512(b + i);
+    _mm512_storeu_si512(dst + i, Apply<op>(x, y));
+  }
+#elif defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), Apply<op>(x, y));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = Apply<op>(a[i], b[i]);
+  }
+}
+
+//! Number of bits set in w[0, n)
+size_t
+CountWords(const uint64_t* w, size_t n) {
+  size_t ret = 0;
+  size_t i = 0;
+#if defined(__AVX512VPOPCNTDQ__)
+  __m512i acc = _mm512_setzero_si512();
+  for (; i + 8 <= n; i += 8) {
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_loadu_si512(w + i)));
+  }
+  alignas(64) uint64_t lanes[8];
+  _mm512_store_si512(lanes, acc);
+  for (uint64_t lane : lanes) {
+    ret += lane;
+  }
+#elif defined(__AVX2__)
+  // Count the bits of each nibble with a table lookup and sum the bytes of
+  // each 64-bit lane
+  const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1,
+      2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i acc = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+    __m256i lo = _mm256_and_si256(v, low_mask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(
+        _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+  alignas(32) uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+  ret += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+  for (; i < n; ++i) {
+    ret += Popcount(w[i]);
+  }
+  return ret;
+}
+
+//! Whether any bit is set in w[0, n)
+bool
+AnyWords(const uint64_t* w, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 8 <= n; i += 8) {
+    __m512i v = _mm512_loadu_si512(w + i);
+    if (_mm512_test_epi64_mask(v, v)) {
+      return true;
+    }
+  }
+#elif defined(__AVX2__)
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+    if (!_mm256_testz_si256(v, v)) {
+      return true;
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    if (w[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//! Run fn(begin, end) on blocks of words [begin, end) of [0, num_words) in
+//! parallel
+template <typename Fn>
+void
+ForEachBlock(size_t num_words, Fn fn) {
+  size_t num_blocks = (num_words + kBlockWords - 1) / kBlockWords;
   katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] |= other_bitvec[i]; }, katana::no_stats());
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t block) {
+        size_t begin = block * kBlockWords;
+        fn(begin, std::min(begin + kBlockWords, num_words));
+      },
+      katana::no_stats());
+}
+
+template <BitwiseOp op>
+void
+ApplyBitsets(
+    katana::DynamicBitset* dst, const katana::DynamicBitset& a,
+    const katana::DynamicBitset& b) {
+  KATANA_LOG_DEBUG_ASSERT(dst->size() == a.size());
+  KATANA_LOG_DEBUG_ASSERT(dst->size() == b.size());
+  uint64_t* d = Words(*dst);
+  const uint64_t* x = Words(a);
+  const uint64_t* y = Words(b);
+  ForEachBlock(dst->get_vec().size(), [&](size_t begin, size_t end) {
+    ApplyWords<op>(d + begin, x + begin, y + begin, end - begin);
+  });
+}
+
+}  // namespace
+
+void
+katana::DynamicBitset::bitwise_or(const DynamicBitset& other) {
+  ApplyBitsets<BitwiseOp::kOr>(this, *this, other);
+}
+
+void
+katana::DynamicBitset::bitwise_or(
+    const DynamicBitset& other1, const DynamicBitset& other2) {
+  ApplyBitsets<BitwiseOp::kOr>(this, other1, other2);
 }
 
 void
 katana::DynamicBitset::bitwise_not() {
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = ~bitvec_[i]; }, katana::no_stats());
+  uint64_t* w = Words(*this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      w[i] = ~w[i];
+    }
+  });
+  // keep the bits past the end unset so that they are not counted
+  if (size_t tail = num_bits_ % kNumBitsInUint64) {
+    w[bitvec_.size() - 1] &= (uint64_t{1} << tail) - 1;
+  }
 }
 
 void
 katana::DynamicBitset::bitwise_and(const DynamicBitset& other) {
-  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] &= other_bitvec[i]; }, katana::no_stats());
+  ApplyBitsets<BitwiseOp::kAnd>(this, *this, other);
 }
 
 void
 katana::DynamicBitset::bitwise_and(
     const DynamicBitset& other1, const DynamicBitset& other2) {
-  KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
-  KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
+  ApplyBitsets<BitwiseOp::kAnd>(this, other1, other2);
+}
 
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] & other_bitvec2[i]; },
-      katana::no_stats());
+void
+katana::DynamicBitset::bitwise_andnot(const DynamicBitset& other) {
+  ApplyBitsets<BitwiseOp::kAndNot>(this, *this, other);
+}
+
+void
+katana::DynamicBitset::bitwise_andnot(
+    const DynamicBitset& other1, const DynamicBitset& other2) {
+  ApplyBitsets<BitwiseOp::kAndNot>(this, other1, other2);
 }
 
 void
 katana::DynamicBitset::bitwise_xor(const DynamicBitset& other) {
-  KATANA_LOG_DEBUG_ASSERT(size() == other.size());
-  const auto& other_bitvec = other.get_vec();
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] ^= other_bitvec[i]; }, katana::no_stats());
+  ApplyBitsets<BitwiseOp::kXor>(this, *this, other);
 }
 
 void
 katana::DynamicBitset::bitwise_xor(
     const DynamicBitset& other1, const DynamicBitset& other2) {
-  KATANA_LOG_DEBUG_ASSERT(size() == other1.size());
-  KATANA_LOG_DEBUG_ASSERT(size() == other2.size());
-  const auto& other_bitvec1 = other1.get_vec();
-  const auto& other_bitvec2 = other2.get_vec();
-
-  katana::do_all(
-      katana::iterate(size_t{0}, bitvec_.size()),
-      [&](size_t i) { bitvec_[i] = other_bitvec1[i] ^ other_bitvec2[i]; },
-      katana::no_stats());
+  ApplyBitsets<BitwiseOp::kXor>(this, other1, other2);
 }
 
 size_t
 katana::DynamicBitset::count() const {
   katana::GAccumulator<size_t> ret;
-  katana::do_all(
-      katana::iterate(bitvec_.begin(), bitvec_.end()),
-      [&](uint64_t n) {
-#ifdef __GNUC__
-        ret += __builtin_popcountll(n);
-#else
-        n = n - ((n >> 1) & 0x5555555555555555UL);
-        n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-        ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >>
-               56;
-#endif
-      },
-      katana::no_stats());
+  const uint64_t* w = Words(*this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    ret += CountWords(w + begin, end - begin);
+  });
   return ret.reduce();
 }
 
 size_t
 katana::DynamicBitset::SerialCount() const {
-  size_t ret = 0;
-  for (uint64_t n : bitvec_) {
-#ifdef __GNUC__
-    ret += __builtin_popcountll(n);
-#else
-    n = n - ((n >> 1) & 0x5555555555555555UL);
-    n = (n & 0x3333333333333333UL) + ((n >> 2) & 0x3333333333333333UL);
-    ret += (((n + (n >> 4)) & 0xF0F0F0F0F0F0F0FUL) * 0x101010101010101UL) >> 56;
-#endif
-  }
-  return ret;
+  return CountWords(Words(*this), bitvec_.size());
+}
+
+bool
+katana::DynamicBitset::any() const {
+  std::atomic<bool> found{false};
+  const uint64_t* w = Words(*this);
+  ForEachBlock(bitvec_.size(), [&](size_t begin, size_t end) {
+    // skip the remaining blocks once a bit is found
+    if (!found.load(std::memory_order_relaxed) &&
+        AnyWords(w + begin, end - begin)) {
+      found.store(true, std::memory_order_relaxed);
+    }
+  });
+  return found.load();
 }
 
 namespace {
-template <typename Integer>
-void
-ComputeOffsets(
-    const katana::DynamicBitset& bitset, std::vector<Integer>* offsets) {
-  // TODO uint32_t is somewhat dangerous; change in the future
-  uint32_t activeThreads = katana::getActiveThreads();
-  std::vector<Integer> tPrefixBitCounts(activeThreads);
+/**
+ * Write the offsets of the set bits of bitset, in order, to the array that
+ * get_output(num_set_bits) returns. Each thread counts the bits set in its
+ * share of the words, and after a prefix sum, writes their offsets word by
+ * word.
+ *
+ * @returns number of set bits
+ */
+template <typename Integer, typename GetOutput>
+size_t
+ComputeOffsets(const katana::DynamicBitset& bitset, GetOutput get_output) {
+  const uint64_t* w = Words(bitset);
+  const size_t num_words = bitset.get_vec().size();
+  std::vector<size_t> prefix_counts(katana::getActiveThreads());
 
   // count how many bits are set on each thread
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-
-    Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
-    }
-
-    tPrefixBitCounts[tid] = count;
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
+    prefix_counts[tid] = CountWords(w + start, end - start);
   });
 
   // calculate prefix sum of bits per thread
-  for (uint32_t i = 1; i < activeThreads; ++i) {
-    tPrefixBitCounts[i] += tPrefixBitCounts[i - 1];
+  for (size_t i = 1; i < prefix_counts.size(); ++i) {
+    prefix_counts[i] += prefix_counts[i - 1];
   }
 
   // total num of set bits
-  Integer bitsetCount = tPrefixBitCounts[activeThreads - 1];
-
-  // calculate the indices of the set bits and save them to the offset
-  // vector
-  if (bitsetCount > 0) {
-    size_t cur_size = offsets->size();
-    offsets->resize(cur_size + bitsetCount);
-    katana::on_each([&](unsigned tid, unsigned nthreads) {
-      auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
-      Integer index = cur_size;
-      if (tid != 0) {
-        index += tPrefixBitCounts[tid - 1];
-      }
+  size_t bitset_count = prefix_counts.back();
+  if (bitset_count == 0) {
+    return 0;
+  }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
-          ++index;
-        }
+  // calculate the indices of the set bits and save them to the output
+  Integer* output = get_output(bitset_count);
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [start, end] =
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
+    Integer* out = output + (tid == 0 ? 0 : prefix_counts[tid - 1]);
+    for (size_t i = start; i < end; ++i) {
+      for (uint64_t word = w[i]; word; word &= word - 1) {
+        *out++ = i * katana::DynamicBitset::kNumBitsInUint64 +
+                 CountTrailingZeros(word);
       }
-    });
-  }
+    }
+  });
+
+  return bitset_count;
 }
-}  //namespace
+
+template <typename Integer>
+void
+AppendOffsetsTo(
+    const katana::DynamicBitset& bitset, std::vector<Integer>* offsets) {
+  size_t cur_size = offsets->size();
+  ComputeOffsets<Integer>(bitset, [&](size_t count) {
+    offsets->resize(cur_size + count);
+    return offsets->data() + cur_size;
+  });
+}
+}  // namespace
 
 template <>
 std::vector<uint32_t>
 katana::DynamicBitset::GetOffsets<uint32_t>() const {
   std::vector<uint32_t> offsets;
-  ComputeOffsets<uint32_t>(*this, &offsets);
+  AppendOffsetsTo<uint32_t>(*this, &offsets);
   return offsets;
 }
 
@@ -191,18 +411,34 @@ template <>
 std::vector<uint64_t>
 katana::DynamicBitset::GetOffsets<uint64_t>() const {
   std::vector<uint64_t> offsets;
-  ComputeOffsets<uint64_t>(*this, &offsets);
+  AppendOffsetsTo<uint64_t>(*this, &offsets);
   return offsets;
 }
 
 template <>
 void
 katana::DynamicBitset::AppendOffsets(std::vector<uint32_t>* offsets) const {
-  ComputeOffsets<uint32_t>(*this, offsets);
+  AppendOffsetsTo<uint32_t>(*this, offsets);
 }
 
 template <>
 void
 katana::DynamicBitset::AppendOffsets(std::vector<uint64_t>* offsets) const {
-  ComputeOffsets<uint64_t>(*this, offsets);
+  AppendOffsetsTo<uint64_t>(*this, offsets);
+}
+
+template <typename Integer>
+size_t
+katana::DynamicBitset::WriteOffsets(NUMAArray<Integer>* offsets) const {
+  return ComputeOffsets<Integer>(*this, [&](size_t count) {
+    KATANA_LOG_VASSERT(
+        count <= offsets->size(), "{} offsets do not fit in {}", count,
+        offsets->size());
+    return offsets->data();
+  });
 }
+
+template KATANA_EXPORT size_t
+katana::DynamicBitset::WriteOffsets(NUMAArray<uint32_t>* offsets) const;
+template KATANA_EXPORT size_t
+katana::DynamicBitset::WriteOffsets(NUMAArray<uint64_t>* offsets) const;
@@ -26,6 +26,7 @@
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 
 namespace {
 // Dijkstra style 2-pass ring termination detection
@@ -203,8 +204,44 @@ public:
   }
 };
 
+// Termination detection and barrier of a thread pool partition after the
+// first, which uses those of the runtime
+struct PartitionDependents {
+  LocalTerminationDetection term;
+  std::unique_ptr<katana::Barrier> barrier;
+};
+
+std::vector<std::unique_ptr<PartitionDependents>> partition_deps;
+
 }  // namespace
 
+unsigned int
+katana::setThreadPartitions(unsigned int num) {
+  for (unsigned i = 0; i < partition_deps.size(); ++i) {
+    internal::SetTerminationDetection(nullptr, i + 1);
+    internal::SetBarrier(nullptr, i + 1);
+  }
+  partition_deps.clear();
+
+  auto& tp = GetThreadPool();
+  num = tp.setPartitions(num);
+  // The partition of the calling thread may be smaller than its number of
+  // active threads
+  setActiveThreads(getActiveThreads());
+
+  for (unsigned i = 1; i < num; ++i) {
+    auto& deps = partition_deps.emplace_back(
+        std::make_unique<PartitionDependents>());
+    // The barrier is initialized for the threads of its partition when it is
+    // first used from there
+    deps->barrier = CreateTopoBarrier(1);
+    internal::SetTerminationDetection(&deps->term, i);
+    internal::SetBarrier(deps->barrier.get(), i);
+  }
+
+  return num;
+}
+
 struct katana::GaloisRuntime::Impl {
   struct Dependents {
     LocalTerminationDetection term;
@@ -233,6 +270,11 @@ katana::GaloisRuntime::GaloisRuntime() : impl_(std::make_unique<Impl>()) {
 }
 
 katana::GaloisRuntime::~GaloisRuntime() {
+  // Repartitioning checks that there are no dedicated threads, which an
+  // unpartitioned pool may still have at this point
+  if (katana::getThreadPartitions() > 1) {
+    katana::setThreadPartitions(1);
+  }
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
   internal::setPagePoolState(nullptr);
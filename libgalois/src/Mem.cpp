@@ -28,7 +28,7 @@
 void
 katana::Prealloc(size_t pagesPerThread, size_t bytes) {
   size_t size =
-      (pagesPerThread * katana::activeThreads) + (bytes / allocSize());
+      (pagesPerThread * katana::getActiveThreads()) + (bytes / allocSize());
   // If the user requested a non-zero allocation, at the very least
   // allocate a page.
   if (size == 0 && bytes > 0) {
@@ -40,9 +40,9 @@ katana::Prealloc(size_t pagesPerThread, size_t bytes) {
 
 void
 katana::Prealloc(size_t pages) {
-  unsigned pagesPerThread =
-      (pages + katana::activeThreads - 1) / katana::activeThreads;
-  katana::GetThreadPool().run(katana::activeThreads, [=]() {
+  unsigned numThreads = katana::getActiveThreads();
+  unsigned pagesPerThread = (pages + numThreads - 1) / numThreads;
+  katana::GetThreadPool().run(numThreads, [=]() {
     katana::pagePoolPreAlloc(pagesPerThread);
   });
 }
@@ -50,7 +50,7 @@ katana::Prealloc(size_t pages) {
 void
 katana::EnsurePreallocated(size_t pagesPerThread, size_t bytes) {
   size_t size =
-      (pagesPerThread * katana::activeThreads) + (bytes / allocSize());
+      (pagesPerThread * katana::getActiveThreads()) + (bytes / allocSize());
   // If the user requested a non-zero allocation, at the very least
   // allocate a page.
   if (size == 0 && bytes > 0) {
@@ -62,9 +62,9 @@ katana::EnsurePreallocated(size_t pagesPerThread, size_t bytes) {
 
 void
 katana::EnsurePreallocated(size_t pages) {
-  unsigned pagesPerThread =
-      (pages + katana::activeThreads - 1) / katana::activeThreads;
-  katana::GetThreadPool().run(katana::activeThreads, [=]() {
+  unsigned numThreads = katana::getActiveThreads();
+  unsigned pagesPerThread = (pages + numThreads - 1) / numThreads;
+  katana::GetThreadPool().run(numThreads, [=]() {
     katana::pagePoolEnsurePreallocated(pagesPerThread);
   });
 }
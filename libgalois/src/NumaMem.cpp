@@ -28,28 +28,32 @@
 using namespace katana;
 
 /* Access pages on each thread so each thread has some pages already loaded
- * (preferably ones it will use) */
+ * (preferably ones it will use). Threads are assigned units of unitSize bytes
+ * and fault in each page of pageSize bytes of their units, since memory that
+ * is not backed by huge pages is placed one small page at a time. */
 static void
 pageIn(
-    void* _ptr, size_t len, size_t pageSize, unsigned numThreads,
+    void* _ptr, size_t len, size_t unitSize, unsigned numThreads,
     bool finegrained) {
   char* ptr = static_cast<char*>(_ptr);
+  const size_t pageSize = pageSizeOf(_ptr);
 
   if (numThreads == 1) {
     for (size_t x = 0; x < len; x += pageSize / 2)
       ptr[x] = 0;
   } else {
     GetThreadPool().run(
-        numThreads, [ptr, len, pageSize, numThreads, finegrained]() {
+        numThreads, [ptr, len, unitSize, pageSize, numThreads, finegrained]() {
           auto myID = ThreadPool::getTID();
 
           if (finegrained) {
-            // round robin page distribution among threads (e.g. thread 0 gets
-            // a page, then thread 1, then thread n, then back to thread 0 and
+            // round robin unit distribution among threads (e.g. thread 0 gets
+            // a unit, then thread 1, then thread n, then back to thread 0 and
             // so on until the end of the region)
-            for (size_t x = pageSize * myID; x < len;
-                 x += pageSize * numThreads)
-              ptr[x] = 0;
+            for (size_t u = unitSize * myID; u < len;
+                 u += unitSize * numThreads)
+              for (size_t x = u; x < len && x < u + unitSize; x += pageSize)
+                ptr[x] = 0;
           } else {
             // sectioned page distribution (e.g. thread 0 gets first chunk, thread
             // 1 gets next chunk, ... last thread gets last chunk)
@@ -69,7 +73,6 @@ pageIn(
  * or uint64_t*
  * @param _ptr Pointer to the memory to page in
  * @param len Length of the memory passed in
- * @param pageSize Size of a page
  * @param numThreads Number of threads to split work amongst
  * @param threadRanges Array that specifies distribution of elements among
  * threads
@@ -79,12 +82,13 @@ pageIn(
 template <typename RangeArrayTy>
 static void
 pageInSpecified(
-    void* _ptr, size_t len, size_t pageSize, unsigned numThreads,
-    RangeArrayTy threadRanges, size_t elementSize) {
+    void* _ptr, size_t len, unsigned numThreads, RangeArrayTy threadRanges,
+    size_t elementSize) {
   KATANA_LOG_DEBUG_ASSERT(numThreads > 0);
   KATANA_LOG_DEBUG_ASSERT(elementSize > 0);
 
   char* ptr = static_cast<char*>(_ptr);
+  const size_t pageSize = pageSizeOf(_ptr);
 
   if (numThreads > 1) {
     GetThreadPool().run(
@@ -113,8 +117,8 @@ pageInSpecified(
             // memset(ptr + beginByte, 0, (endByte - beginByte +
             // 1));
 
-            uint32_t beginPage = beginByte / pageSize;
-            uint32_t endPage = endByte / pageSize;
+            size_t beginPage = beginByte / pageSize;
+            size_t endPage = endByte / pageSize;
 
             KATANA_LOG_DEBUG_ASSERT(beginPage <= endPage);
 
@@ -123,7 +127,7 @@ pageInSpecified(
             //        beginPage, endPage);
 
             // write a byte to every page this thread occupies
-            for (uint32_t i = beginPage; i <= endPage; i++) {
+            for (size_t i = beginPage; i <= endPage; i++) {
               ptr[i * pageSize] = 0;
             }
           }
@@ -156,7 +160,8 @@ roundup(size_t data, size_t mult) {
 }
 
 LAptr
-katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
+katana::largeMallocInterleaved(
+    size_t bytes, unsigned numThreads, HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
 
@@ -167,7 +172,7 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
   // the alloc would go
 #endif
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = allocPages(bytes / allocSize(), false, policy);
 
   // Then page in based on thread number
   if (data)
@@ -178,29 +183,32 @@ katana::largeMallocInterleaved(size_t bytes, unsigned numThreads) {
 }
 
 LAptr
-katana::largeMallocLocal(size_t bytes) {
+katana::largeMallocLocal(size_t bytes, HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a prefaulted allocation
   return LAptr{
-      allocPages(bytes / allocSize(), true), internal::largeFreer{bytes}};
+      allocPages(bytes / allocSize(), true, policy),
+      internal::largeFreer{bytes}};
 }
 
 LAptr
-katana::largeMallocFloating(size_t bytes) {
+katana::largeMallocFloating(size_t bytes, HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
   return LAptr{
-      allocPages(bytes / allocSize(), false), internal::largeFreer{bytes}};
+      allocPages(bytes / allocSize(), false, policy),
+      internal::largeFreer{bytes}};
 }
 
 LAptr
-katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
+katana::largeMallocBlocked(
+    size_t bytes, unsigned numThreads, HugePagePolicy policy) {
   // round up to hugePageSize
   bytes = roundup(bytes, allocSize());
   // Get a non-prefaulted allocation
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = allocPages(bytes / allocSize(), false, policy);
   if (data)
     // false = blocked paging
     pageIn(data, bytes, allocSize(), numThreads, false);
@@ -218,22 +226,22 @@ katana::largeMallocBlocked(size_t bytes, unsigned numThreads) {
  * @param threadRanges Array specifying distribution of elements among threads
  * @param elementSize Size of a data element that will be stored in the
  * allocated memory
+ * @param policy How huge pages back the allocation
  * @returns The allocated memory along with a freer object
  */
 template <typename RangeArrayTy>
 KATANA_EXPORT LAptr
 katana::largeMallocSpecified(
     size_t bytes, uint32_t numThreads, RangeArrayTy& threadRanges,
-    size_t elementSize) {
+    size_t elementSize, HugePagePolicy policy) {
   // ceiling to nearest page
   bytes = roundup(bytes, allocSize());
 
-  void* data = allocPages(bytes / allocSize(), false);
+  void* data = allocPages(bytes / allocSize(), false, policy);
 
   // NUMA aware page in based on element distribution specified in threadRanges
   if (data)
-    pageInSpecified(
-        data, bytes, allocSize(), numThreads, threadRanges, elementSize);
+    pageInSpecified(data, bytes, numThreads, threadRanges, elementSize);
 
   return LAptr{data, internal::largeFreer{bytes}};
 }
@@ -241,7 +249,7 @@ katana::largeMallocSpecified(
 // file
 template LAptr katana::largeMallocSpecified<std::vector<uint32_t>>(
     size_t bytes, uint32_t numThreads, std::vector<uint32_t>& threadRanges,
-    size_t elementSize);
+    size_t elementSize, HugePagePolicy policy);
 template LAptr katana::largeMallocSpecified<std::vector<uint64_t>>(
     size_t bytes, uint32_t numThreads, std::vector<uint64_t>& threadRanges,
-    size_t elementSize);
+    size_t elementSize, HugePagePolicy policy);
@@ -19,18 +19,29 @@
 
 #include "katana/PageAlloc.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
 #include <mutex>
+#include <optional>
+#include <sstream>
 
 #include "katana/Logging.h"
 #include "katana/SimpleLock.h"
 
 #ifdef __linux__
 #include <linux/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 #include <sys/mman.h>
 
 // figure this out dynamically
 const size_t hugePageSize = 2 * 1024 * 1024;
+const size_t basePageSize = 4096;
 // protect mmap, munmap since linux has issues
 static katana::SimpleLock allocLock;
 
@@ -59,6 +70,220 @@ static const int _MAP_HUGE_POP = _MAP_POP;
 static const int _MAP_HUGE = _MAP;
 #endif
 
+namespace {
+
+//! An allocation returned by allocPages
+struct Mapping {
+  size_t bytes;
+  katana::HugePagePolicy policy;
+  //! whether the allocation is backed by hugetlbfs pages
+  bool huge;
+  std::string name;
+};
+
+// Live allocations by start address, protected by allocLock
+std::map<const char*, Mapping> mappings;
+std::atomic<size_t> hugePageFallbacks{0};
+
+void
+addMapping(void* ptr, size_t bytes, katana::HugePagePolicy policy, bool huge) {
+  std::lock_guard<katana::SimpleLock> lg(allocLock);
+  mappings.emplace(
+      static_cast<const char*>(ptr), Mapping{bytes, policy, huge, {}});
+}
+
+void
+removeMapping(void* ptr) {
+  std::lock_guard<katana::SimpleLock> lg(allocLock);
+  mappings.erase(static_cast<const char*>(ptr));
+}
+
+//! Return the allocation that contains ptr; the caller must hold allocLock
+const Mapping*
+findMapping(const void* ptr) {
+  auto p = static_cast<const char*>(ptr);
+  auto it = mappings.upper_bound(p);
+  if (it == mappings.begin()) {
+    return nullptr;
+  }
+  --it;
+  if (p >= it->first + it->second.bytes) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+//! A virtual memory area with transparent huge pages
+struct HugeArea {
+  uintptr_t begin;
+  uintptr_t end;
+  size_t huge_bytes;
+};
+
+//! Snapshot of the allocations and of the areas of the process with
+//! transparent huge pages, so that the pages of allocations can be counted
+//! without holding allocLock
+struct BackingSnapshot {
+  std::vector<std::pair<const char*, Mapping>> mappings;
+  std::vector<HugeArea> huge_areas;
+};
+
+#ifdef __linux__
+//! Return the areas of /proc/self/smaps with transparent huge pages
+std::vector<HugeArea>
+readHugeAreas() {
+  std::vector<HugeArea> areas;
+  std::ifstream smaps("/proc/self/smaps");
+  std::string line;
+  uintptr_t vma_begin = 0;
+  uintptr_t vma_end = 0;
+  while (std::getline(smaps, line)) {
+    uintptr_t b = 0;
+    uintptr_t e = 0;
+    char dash = 0;
+    std::istringstream header(line);
+    if (header >> std::hex >> b >> dash >> e && dash == '-') {
+      vma_begin = b;
+      vma_end = e;
+      continue;
+    }
+    size_t kb = 0;
+    if (std::sscanf(line.c_str(), "AnonHugePages: %zu kB", &kb) != 1) {
+      continue;
+    }
+    if (kb != 0) {
+      areas.emplace_back(HugeArea{vma_begin, vma_end, kb * 1024});
+    }
+  }
+  return areas;
+}
+
+//! Return the bytes of [begin, end) backed by transparent huge pages. The
+//! kernel reports transparent huge pages per virtual memory area, which may
+//! span other allocations; the count is prorated when it does.
+size_t
+transparentHugeBytes(
+    const std::vector<HugeArea>& areas, const char* begin, const char* end) {
+  size_t total = 0;
+  for (const HugeArea& area : areas) {
+    uintptr_t lo = std::max(area.begin, reinterpret_cast<uintptr_t>(begin));
+    uintptr_t hi = std::min(area.end, reinterpret_cast<uintptr_t>(end));
+    if (lo >= hi) {
+      continue;
+    }
+    total += static_cast<double>(area.huge_bytes) * (hi - lo) /
+             (area.end - area.begin);
+  }
+  return total;
+}
+
+//! Add the bytes on each NUMA node of [ptr, ptr + bytes) to node_bytes,
+//! sampling the node of one page every hugePageSize bytes
+void
+addNodeBytes(
+    const char* ptr, size_t bytes, std::vector<size_t>* node_bytes) {
+  constexpr size_t kBatch = 1024;
+  std::vector<void*> pages(kBatch);
+  std::vector<int> status(kBatch);
+  for (size_t off = 0; off < bytes; off += kBatch * hugePageSize) {
+    size_t n =
+        std::min(kBatch, (bytes - off + hugePageSize - 1) / hugePageSize);
+    for (size_t i = 0; i < n; ++i) {
+      pages[i] = const_cast<char*>(ptr + off + i * hugePageSize);
+    }
+    // With no target nodes, move_pages only reports the node of each page
+    if (syscall(
+            SYS_move_pages, 0, n, pages.data(), nullptr, status.data(), 0) !=
+        0) {
+      return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (status[i] < 0) {
+        // not faulted in yet
+        continue;
+      }
+      size_t node = status[i];
+      if (node_bytes->size() <= node) {
+        node_bytes->resize(node + 1);
+      }
+      (*node_bytes)[node] +=
+          std::min(hugePageSize, bytes - off - i * hugePageSize);
+    }
+  }
+}
+#endif
+
+bool
+mayHaveTransparentHugePages(const Mapping& m) {
+  return !m.huge && m.policy == katana::HugePagePolicy::kTransparent;
+}
+
+//! Return the snapshot of the allocations for which keep returns true.
+//! Only the snapshot of the allocations is taken under allocLock;
+//! /proc/self/smaps is read after it is released, and only if one of the
+//! allocations may have transparent huge pages.
+template <typename Keep>
+BackingSnapshot
+takeSnapshot(const Keep& keep) {
+  BackingSnapshot snapshot;
+  {
+    std::lock_guard<katana::SimpleLock> lg(allocLock);
+    for (const auto& [ptr, m] : mappings) {
+      if (keep(ptr, m)) {
+        snapshot.mappings.emplace_back(ptr, m);
+      }
+    }
+  }
+#ifdef __linux__
+  bool transparent = std::any_of(
+      snapshot.mappings.begin(), snapshot.mappings.end(),
+      [](const auto& pm) { return mayHaveTransparentHugePages(pm.second); });
+  if (transparent) {
+    snapshot.huge_areas = readHugeAreas();
+  }
+#endif
+  return snapshot;
+}
+
+//! Return the pages that back [ptr, ptr + bytes) of allocation m, which may
+//! have been freed since the snapshot of huge_areas was taken
+katana::PageBacking
+backingOf(
+    const Mapping& m, const char* ptr, size_t bytes,
+    [[maybe_unused]] const std::vector<HugeArea>& huge_areas) {
+  katana::PageBacking ret;
+  if (m.huge) {
+    ret.huge_bytes = bytes;
+  } else if (m.policy == katana::HugePagePolicy::kTransparent) {
+#ifdef __linux__
+    ret.huge_bytes =
+        std::min(bytes, transparentHugeBytes(huge_areas, ptr, ptr + bytes));
+#endif
+    ret.normal_bytes = bytes - ret.huge_bytes;
+  } else {
+    ret.normal_bytes = bytes;
+  }
+#ifdef __linux__
+  addNodeBytes(ptr, bytes, &ret.node_bytes);
+#endif
+  return ret;
+}
+
+}  // namespace
+
+katana::PageBacking&
+katana::PageBacking::operator+=(const PageBacking& o) {
+  huge_bytes += o.huge_bytes;
+  normal_bytes += o.normal_bytes;
+  if (node_bytes.size() < o.node_bytes.size()) {
+    node_bytes.resize(o.node_bytes.size());
+  }
+  for (size_t i = 0; i < o.node_bytes.size(); ++i) {
+    node_bytes[i] += o.node_bytes[i];
+  }
+  return *this;
+}
+
 size_t
 katana::allocSize() {
   return hugePageSize;
@@ -67,16 +292,20 @@ katana::allocSize() {
 #ifdef KATANA_USE_JEMALLOC
 
 void*
-katana::allocPages(unsigned num, [[maybe_unused]] bool preFault) {
+katana::allocPages(
+    unsigned num, [[maybe_unused]] bool preFault, HugePagePolicy policy) {
   if (num == 0) {
     return nullptr;
   }
   KATANA_DEBUG_WARN_ONCE("not using huge pages due to jemalloc");
-  return malloc(num * hugePageSize);
+  void* ptr = malloc(num * hugePageSize);
+  addMapping(ptr, num * hugePageSize, policy, false);
+  return ptr;
 }
 
 void
 katana::freePages(void* ptr, [[maybe_unused]] unsigned num) {
+  removeMapping(ptr);
   free(ptr);
 }
 
@@ -93,17 +322,62 @@ trymmap(size_t size, int flag) {
   return ptr;
 }
 
+//! Map size bytes aligned to hugePageSize, as transparent huge pages require
+static void*
+trymmapAligned(size_t size) {
+  char* ptr = static_cast<char*>(trymmap(size + hugePageSize, _MAP));
+  if (!ptr) {
+    return nullptr;
+  }
+  std::lock_guard<katana::SimpleLock> lg(allocLock);
+  size_t misalignment = reinterpret_cast<uintptr_t>(ptr) % hugePageSize;
+  size_t head = misalignment ? hugePageSize - misalignment : 0;
+  if (head) {
+    munmap(ptr, head);
+  }
+  munmap(ptr + head + size, hugePageSize - head);
+  return ptr + head;
+}
+
 void*
-katana::allocPages(unsigned num, bool preFault) {
+katana::allocPages(unsigned num, bool preFault, HugePagePolicy policy) {
   if (num == 0) {
     return nullptr;
   }
 
-  void* ptr = trymmap(num * hugePageSize, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
-  if (!ptr) {
-    KATANA_DEBUG_WARN_ONCE(
-        "huge page alloc failed, falling back to regular pages");
-    ptr = trymmap(num * hugePageSize, preFault ? _MAP_POP : _MAP);
+  const size_t bytes = num * hugePageSize;
+  void* ptr = nullptr;
+  bool huge = false;
+
+  switch (policy) {
+  case HugePagePolicy::kExplicit:
+    ptr = trymmap(bytes, preFault ? _MAP_HUGE_POP : _MAP_HUGE);
+    huge = ptr != nullptr;
+    if (!ptr) {
+      KATANA_DEBUG_WARN_ONCE(
+          "huge page alloc failed, falling back to regular pages");
+      ptr = trymmap(bytes, preFault ? _MAP_POP : _MAP);
+      ++hugePageFallbacks;
+    }
+    break;
+  case HugePagePolicy::kTransparent:
+    // Populating before madvise would fault in normal pages, so fault in
+    // by hand instead
+    ptr = trymmapAligned(bytes);
+#ifdef MADV_HUGEPAGE
+    if (ptr && madvise(ptr, bytes, MADV_HUGEPAGE) != 0) {
+      KATANA_DEBUG_WARN_ONCE("madvise(MADV_HUGEPAGE) failed: {}", errno);
+    }
+#endif
+    if (ptr && preFault) {
+      for (size_t x = 0; x < bytes; x += basePageSize) {
+        static_cast<char*>(ptr)[x] = 0;
+      }
+    }
+    break;
+  case HugePagePolicy::kNone:
+    ptr = trymmap(bytes, preFault ? _MAP_POP : _MAP);
+    break;
   }
 
   if (!ptr) {
@@ -111,19 +385,85 @@ katana::allocPages(unsigned num, bool preFault) {
   }
 
   if (preFault && doHandMap) {
-    for (size_t x = 0; x < num * hugePageSize; x += 4096) {
+    for (size_t x = 0; x < bytes; x += 4096) {
       static_cast<char*>(ptr)[x] = 0;
     }
   }
 
+  addMapping(ptr, bytes, policy, huge);
   return ptr;
 }
 
 void
 katana::freePages(void* ptr, unsigned num) {
+  removeMapping(ptr);
   std::lock_guard<SimpleLock> lg(allocLock);
   if (munmap(ptr, num * hugePageSize) != 0) {
     KATANA_LOG_FATAL("munmap failed: {}", errno);
   }
 }
 #endif
+
+size_t
+katana::pageSizeOf(const void* ptr) {
+  std::lock_guard<SimpleLock> lg(allocLock);
+  const Mapping* m = findMapping(ptr);
+  return m && m->huge ? hugePageSize : basePageSize;
+}
+
+katana::PageBacking
+katana::getPageBacking(const void* ptr, size_t bytes) {
+  std::optional<Mapping> m;
+  {
+    std::lock_guard<SimpleLock> lg(allocLock);
+    if (const Mapping* found = findMapping(ptr)) {
+      m = *found;
+    }
+  }
+  if (!m) {
+    return PageBacking{};
+  }
+  std::vector<HugeArea> huge_areas;
+#ifdef __linux__
+  if (mayHaveTransparentHugePages(*m)) {
+    huge_areas = readHugeAreas();
+  }
+#endif
+  return backingOf(*m, static_cast<const char*>(ptr), bytes, huge_areas);
+}
+
+katana::PageBacking
+katana::getPageBacking() {
+  BackingSnapshot snapshot =
+      takeSnapshot([](const char*, const Mapping&) { return true; });
+  PageBacking ret;
+  for (const auto& [ptr, m] : snapshot.mappings) {
+    ret += backingOf(m, ptr, m.bytes, snapshot.huge_areas);
+  }
+  return ret;
+}
+
+void
+katana::setPageAllocName(const void* ptr, std::string name) {
+  std::lock_guard<SimpleLock> lg(allocLock);
+  auto it = mappings.find(static_cast<const char*>(ptr));
+  if (it != mappings.end()) {
+    it->second.name = std::move(name);
+  }
+}
+
+std::vector<std::pair<std::string, katana::PageBacking>>
+katana::getNamedPageBackings() {
+  BackingSnapshot snapshot = takeSnapshot(
+      [](const char*, const Mapping& m) { return !m.name.empty(); });
+  std::vector<std::pair<std::string, PageBacking>> ret;
+  for (const auto& [ptr, m] : snapshot.mappings) {
+    ret.emplace_back(m.name, backingOf(m, ptr, m.bytes, snapshot.huge_areas));
+  }
+  return ret;
+}
+
+size_t
+katana::numHugePageFallbacks() {
+  return hugePageFallbacks;
+}
@@ -152,7 +152,12 @@ katana::PerBackend::deallocOffset(const unsigned offset, const unsigned sz) {
 
 void*
 katana::PerBackend::getRemote(unsigned thread, unsigned offset) {
-  char* rbase = heads[thread].load(std::memory_order_relaxed);
+  return getPoolRemote(ThreadPool::getPoolTID(thread), offset);
+}
+
+void*
+katana::PerBackend::getPoolRemote(unsigned pool_thread, unsigned offset) {
+  char* rbase = heads[pool_thread].load(std::memory_order_relaxed);
   KATANA_LOG_DEBUG_ASSERT(rbase);
   return &rbase[offset];
 }
@@ -0,0 +1,192 @@
+#include "katana/PerfCounters.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/PagePool.h"
+#include "katana/Statistics.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+constexpr const char* kEventNames[katana::kNumPerfEvents] = {
+    "Cycles",
+    "Instructions",
+    "LLCMisses",
+    "DTLBMisses",
+};
+
+#ifdef __linux__
+
+// The counters of one thread, opened as a single group so that they are read
+// with one system call
+class ThreadCounters {
+public:
+  ThreadCounters() { Open(); }
+
+  ~ThreadCounters() {
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+  }
+
+  ThreadCounters(const ThreadCounters&) = delete;
+  ThreadCounters& operator=(const ThreadCounters&) = delete;
+
+  katana::PerfCounts Read() const {
+    katana::PerfCounts counts;
+    if (num_open_ == 0) {
+      return counts;
+    }
+
+    // layout of PERF_FORMAT_GROUP with the total times
+    struct {
+      uint64_t nr;
+      uint64_t time_enabled;
+      uint64_t time_running;
+      uint64_t values[katana::kNumPerfEvents];
+    } data;
+    if (read(leader_, &data, sizeof(data)) < 0) {
+      return counts;
+    }
+    // scale up the counts of events that the kernel multiplexed with others
+    double scale = 1;
+    if (data.time_running != 0 && data.time_running < data.time_enabled) {
+      scale = double(data.time_enabled) / double(data.time_running);
+    }
+    for (size_t i = 0; i < katana::kNumPerfEvents; ++i) {
+      if (slots_[i] >= 0 && uint64_t(slots_[i]) < data.nr) {
+        counts.counts[i] = uint64_t(double(data.values[slots_[i]]) * scale);
+      }
+    }
+    return counts;
+  }
+
+private:
+  static int OpenEvent(uint32_t type, uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // count the calling thread on any cpu
+    return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+  }
+
+  void Open() {
+    constexpr uint64_t kLLCReadMiss =
+        PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    constexpr uint64_t kDTLBReadMiss =
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    const std::pair<uint32_t, uint64_t> events[katana::kNumPerfEvents] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, kLLCReadMiss},
+        {PERF_TYPE_HW_CACHE, kDTLBReadMiss},
+    };
+
+    int error = 0;
+    for (size_t i = 0; i < katana::kNumPerfEvents; ++i) {
+      slots_[i] = -1;
+      fds_[i] = OpenEvent(events[i].first, events[i].second, leader_);
+      if (fds_[i] < 0) {
+        error = errno;
+        continue;
+      }
+      if (leader_ < 0) {
+        leader_ = fds_[i];
+      }
+      slots_[i] = int(num_open_++);
+    }
+
+    if (num_open_ < katana::kNumPerfEvents) {
+      KATANA_WARN_ONCE(
+          "could only count {} of {} hardware events: {}", num_open_,
+          katana::kNumPerfEvents, std::strerror(error));
+    }
+    if (leader_ >= 0) {
+      ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  int fds_[katana::kNumPerfEvents];
+  //! index of each event in the values read from the group; -1 if the event
+  //! could not be opened
+  int slots_[katana::kNumPerfEvents];
+  int leader_{-1};
+  size_t num_open_{0};
+};
+
+#else
+
+class ThreadCounters {
+public:
+  katana::PerfCounts Read() const { return katana::PerfCounts{}; }
+};
+
+#endif
+
+}  // namespace
+
+const char*
+katana::PerfCounts::Name(size_t i) {
+  KATANA_LOG_DEBUG_ASSERT(i < kNumPerfEvents);
+  return kEventNames[i];
+}
+
+bool
+katana::PerfCountersEnabled() {
+  static const bool enabled = GetEnv("KATANA_PERF_COUNTERS");
+  return enabled;
+}
+
+katana::PerfCounts
+katana::ReadThreadPerfCounts() {
+  if (!PerfCountersEnabled()) {
+    return PerfCounts{};
+  }
+  // opened the first time a thread reads them
+  thread_local ThreadCounters counters;
+  return counters.Read();
+}
+
+katana::LoopPerfCounters<true>::LoopPerfCounters(const char* loopname)
+    : loopname_(loopname), enabled_(PerfCountersEnabled()) {
+  if (enabled_) {
+    start_ = GetThreadPool().getPerfCounts();
+    start_pages_ = numPagePoolAllocTotal();
+  }
+}
+
+katana::LoopPerfCounters<true>::~LoopPerfCounters() {
+  if (!enabled_) {
+    return;
+  }
+  PerfCounts counts = GetThreadPool().getPerfCounts();
+  counts -= start_;
+  for (size_t i = 0; i < kNumPerfEvents; ++i) {
+    ReportStatSum(loopname_, PerfCounts::Name(i), counts.counts[i]);
+  }
+  ReportStatSum(
+      loopname_, "PagePoolAllocs", numPagePoolAllocTotal() - start_pages_);
+}
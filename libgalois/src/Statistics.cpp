@@ -24,11 +24,15 @@
 
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <sstream>
+#include <string>
 
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
+#include "katana/JSON.h"
 #include "katana/Logging.h"
+#include "katana/PageAlloc.h"
 #include "katana/PerThreadStorage.h"
 
 namespace {
@@ -38,6 +42,46 @@ CheckPrintingThreadVals() {
   return katana::GetEnv("PRINT_PER_THREAD_STATS");
 }
 
+// Statistics reported from a partition of a partitioned thread pool are kept
+// apart from those of the other partitions by their region
+katana::gstl::Str
+PartitionRegion(const std::string& region) {
+  if (katana::GetThreadPool().getNumPartitions() == 1) {
+    return katana::gstl::makeStr(region);
+  }
+  return katana::gstl::makeStr(
+      region + "@Partition" +
+      std::to_string(katana::ThreadPool::getPartitionID()));
+}
+
+katana::StatManager::Format
+DefaultFormat() {
+  std::string format;
+  if (katana::GetEnv("KATANA_STAT_FORMAT", &format) && format == "json") {
+    return katana::StatManager::Format::kJson;
+  }
+  return katana::StatManager::Format::kText;
+}
+
+// statistics as JSON objects, one for each region
+using JsonRegions = std::map<std::string, nlohmann::json>;
+
+std::string
+ToString(const katana::gstl::Str& str) {
+  return std::string(str.c_str(), str.size());
+}
+
+template <typename T>
+nlohmann::json
+ToJson(const T& val) {
+  return val;
+}
+
+nlohmann::json
+ToJson(const katana::gstl::Str& val) {
+  return ToString(val);
+}
+
 void
 PrintHeader(std::ostream& out, const char* sep) {
   out << "STAT_TYPE" << sep << "REGION" << sep << "CATEGORY" << sep;
@@ -71,8 +115,9 @@ struct StatImpl {
       return;
     }
 
-    for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
-      const auto* manager = perThreadManagers_.getRemote(t);
+    auto num_threads = katana::GetThreadPool().getMaxPoolThreads();
+    for (unsigned t = 0; t < num_threads; ++t) {
+      const auto* manager = perThreadManagers_.getPoolRemote(t);
 
       for (auto i = manager->cbegin(), end_i = manager->cend(); i != end_i;
            ++i) {
@@ -124,6 +169,30 @@ struct StatImpl {
       }
     }
   }
+
+  void AddToJson(JsonRegions* regions) const {
+    for (auto i = result_.cbegin(), end_i = result_.cend(); i != end_i; ++i) {
+      std::string region = ToString(result_.region(i));
+      nlohmann::json& obj = (*regions)[region];
+      if (obj.is_null()) {
+        obj["region"] = region;
+      }
+
+      const auto& s = result_.stat(i);
+      nlohmann::json stat;
+      stat["kind"] = StatKind();
+      stat["total_type"] = katana::StatTotal::str(s.totalTy());
+      stat["total"] = ToJson(s.total());
+      if (CheckPrintingThreadVals()) {
+        nlohmann::json values = nlohmann::json::array();
+        for (const auto& v : s.values()) {
+          values.push_back(ToJson(v));
+        }
+        stat["thread_values"] = std::move(values);
+      }
+      obj["stats"][ToString(result_.category(i))] = std::move(stat);
+    }
+  }
 };
 
 }  // end unnamed namespace
@@ -134,6 +203,7 @@ public:
   StatImpl<double> fp_stats_;
   StatImpl<Str> str_stats_;
   std::string outfile_;
+  Format format_{DefaultFormat()};
 };
 
 katana::StatManager::StatManager() { impl_ = std::make_unique<Impl>(); }
@@ -145,6 +215,11 @@ katana::StatManager::SetStatFile(const std::string& outfile) {
   impl_->outfile_ = outfile;
 }
 
+void
+katana::StatManager::SetStatFormat(Format format) {
+  impl_->format_ = format;
+}
+
 bool
 katana::StatManager::IsPrintingThreadVals() const {
   return CheckPrintingThreadVals();
@@ -165,6 +240,25 @@ katana::StatManager::PrintStats(std::ostream& out) {
   impl_->str_stats_.Print(out, kSep, kThreadSep, kThreadNameSep);
 }
 
+void
+katana::StatManager::PrintStatsJson(std::ostream& out) {
+  MergeStats();
+
+  JsonRegions regions;
+  impl_->int_stats_.AddToJson(&regions);
+  impl_->fp_stats_.AddToJson(&regions);
+  impl_->str_stats_.AddToJson(&regions);
+
+  for (const auto& [region, obj] : regions) {
+    auto res = JsonDump(obj);
+    if (!res) {
+      KATANA_LOG_ERROR("printing stats of {}: {}", region, res.error());
+      continue;
+    }
+    out << res.value() << "\n";
+  }
+}
+
 auto
 katana::StatManager::int_cbegin() const -> int_const_iterator {
   return impl_->int_stats_.result_.cbegin();
@@ -228,7 +322,7 @@ katana::StatManager::AddInt(
     const std::string& region, const std::string& category, int64_t val,
     const StatTotal::Type& type) {
   impl_->int_stats_.Add(
-      gstl::makeStr(region), gstl::makeStr(category), val, type);
+      PartitionRegion(region), gstl::makeStr(category), val, type);
 }
 
 void
@@ -236,24 +330,32 @@ katana::StatManager::AddFP(
     const std::string& region, const std::string& category, double val,
     const StatTotal::Type& type) {
   impl_->fp_stats_.Add(
-      gstl::makeStr(region), gstl::makeStr(category), val, type);
+      PartitionRegion(region), gstl::makeStr(category), val, type);
 }
 
 void
 katana::StatManager::AddParam(
     const std::string& region, const std::string& category, const Str& val) {
   impl_->str_stats_.Add(
-      gstl::makeStr(region), gstl::makeStr(category), val, StatTotal::SINGLE);
+      PartitionRegion(region), gstl::makeStr(category), val, StatTotal::SINGLE);
 }
 
 void
 katana::StatManager::Print() {
+  auto print = [this](std::ostream& out) {
+    if (impl_->format_ == Format::kJson) {
+      PrintStatsJson(out);
+    } else {
+      PrintStats(out);
+    }
+  };
+
   if (impl_->outfile_.empty()) {
-    return PrintStats(std::cout);
+    return print(std::cout);
   }
   // n.b. Assumes that stats fit in memory
   std::ostringstream out;
-  PrintStats(out);
+  print(out);
 
   std::string stats = out.str();
   if (stats.empty()) {
@@ -288,6 +390,11 @@ katana::SetStatFile(const std::string& f) {
   internal::sysStatManager()->SetStatFile(f);
 }
 
+void
+katana::SetStatFormat(StatManager::Format format) {
+  internal::sysStatManager()->SetStatFormat(format);
+}
+
 void
 katana::PrintStats() {
   internal::sysStatManager()->Print();
@@ -300,6 +407,24 @@ katana::reportPageAlloc(const char* category) {
         ReportStatSum("PageAlloc", category, numPagePoolAllocForThread(tid));
       },
       std::make_tuple());
+
+  // Pages that back large allocations, in total and for each named one
+  auto report_backing = [](const std::string& id, const PageBacking& backing) {
+    ReportStatSingle("PageAlloc", "HugeBytes_" + id, backing.huge_bytes);
+    ReportStatSingle("PageAlloc", "NormalBytes_" + id, backing.normal_bytes);
+    for (size_t node = 0; node < backing.node_bytes.size(); ++node) {
+      ReportStatSingle(
+          "PageAlloc", "Node" + std::to_string(node) + "Bytes_" + id,
+          backing.node_bytes[node]);
+    }
+  };
+  report_backing(category, getPageBacking());
+  for (const auto& [name, backing] : getNamedPageBackings()) {
+    report_backing(std::string(category) + "_" + name, backing);
+  }
+  ReportStatSingle(
+      "PageAlloc", std::string("HugePageFallbacks_") + category,
+      numHugePageFallbacks());
 }
 
 void
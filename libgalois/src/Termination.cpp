@@ -17,24 +17,34 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <vector>
+
 #include "katana/Logging.h"
 #include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
 
 // vtable anchoring
 katana::TerminationDetection::~TerminationDetection() = default;
 
-static katana::TerminationDetection* kTerminationDetection = nullptr;
+// Termination detection for each thread pool partition
+static std::vector<katana::TerminationDetection*> kTerminationDetection;
 
 void
-katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
+katana::internal::SetTerminationDetection(
+    katana::TerminationDetection* t, unsigned partition) {
+  if (kTerminationDetection.size() <= partition) {
+    kTerminationDetection.resize(partition + 1);
+  }
   KATANA_LOG_VASSERT(
-      !(kTerminationDetection && t),
+      !(kTerminationDetection[partition] && t),
       "Double initialization of TerminationDetection");
-  kTerminationDetection = t;
+  kTerminationDetection[partition] = t;
 }
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
-  kTerminationDetection->Init(active_threads);
-  return *kTerminationDetection;
+  katana::TerminationDetection* t =
+      kTerminationDetection[katana::ThreadPool::getPartitionID()];
+  t->Init(active_threads);
+  return *t;
 }
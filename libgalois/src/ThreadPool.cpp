@@ -21,10 +21,51 @@
 
 #include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <tuple>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include "katana/Env.h"
 #include "katana/HWTopo.h"
 #include "katana/Logging.h"
+#include "katana/Threads.h"
+
+namespace {
+
+// Adds the hardware events counted for the calling thread during the lifetime
+// of the guard to counts
+class PerfCountsGuard {
+public:
+  explicit PerfCountsGuard(katana::PerfCounts* counts)
+      : counts_(counts), enabled_(katana::PerfCountersEnabled()) {
+    if (enabled_) {
+      start_ = katana::ReadThreadPerfCounts();
+    }
+  }
+
+  ~PerfCountsGuard() {
+    if (enabled_) {
+      katana::PerfCounts end = katana::ReadThreadPerfCounts();
+      end -= start_;
+      *counts_ += end;
+    }
+  }
+
+  PerfCountsGuard(const PerfCountsGuard&) = delete;
+  PerfCountsGuard& operator=(const PerfCountsGuard&) = delete;
+
+private:
+  katana::PerfCounts* counts_;
+  katana::PerfCounts start_;
+  bool enabled_;
+};
+
+}  // namespace
 
 // Forward declare this to avoid including PerThreadStorage.
 // We avoid this to stress that the thread Pool MUST NOT depend on PTS.
@@ -32,6 +73,10 @@ namespace katana {
 
 extern void initPTS(unsigned);
 
+namespace internal {
+extern thread_local unsigned int activeThreadsOverride;
+}  // namespace internal
+
 }
 
 using katana::ThreadPool;
@@ -40,9 +85,13 @@ thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
     : mi(getHWTopo().machineTopoInfo),
-      reserved(0),
-      masterFastmode(0),
-      running(false) {
+      poolTopo(getHWTopo().threadTopoInfo),
+      reserved(0) {
+  std::vector<unsigned> all(mi.maxThreads);
+  std::iota(all.begin(), all.end(), 0);
+  whole = makePartition(0, std::move(all));
+  partitions.emplace_back(whole.get());
+
   signals.resize(mi.maxThreads);
   initThread(0);
 
@@ -60,6 +109,10 @@ ThreadPool::ThreadPool()
 }
 
 ThreadPool::~ThreadPool() {
+  beKind();
+  if (partitions.size() > 1) {
+    setPartitions(1);
+  }
   destroyCommon();
   for (auto& t : threads) {
     t.join();
@@ -68,30 +121,246 @@ ThreadPool::~ThreadPool() {
 
 void
 ThreadPool::destroyCommon() {
-  beKind();  // reset fastmode
+  beKind();  // reset idle policy
   run(mi.maxThreads, []() { throw shutdown_ty(); });
 }
 
 void
 ThreadPool::burnPower(unsigned num) {
   num = std::min(num, getMaxUsableThreads());
+  Partition& p = myPartition(*this);
 
   // changing number of threads?  just do a reset
-  if (masterFastmode && masterFastmode != num) {
+  if (p.policy_ == IdlePolicy::kSpin && p.policy_threads_ != num) {
     beKind();
   }
-  if (!masterFastmode) {
-    run(num, []() { throw fastmode_ty{true}; });
-    masterFastmode = num;
+  if (p.policy_ != IdlePolicy::kSpin) {
+    beKind();
+    run(num, []() { throw policy_ty{IdlePolicy::kSpin, 0}; });
+    p.policy_ = IdlePolicy::kSpin;
+    p.policy_threads_ = num;
   }
 }
 
 void
 ThreadPool::beKind() {
-  if (masterFastmode) {
-    run(masterFastmode, []() { throw fastmode_ty{false}; });
-    masterFastmode = 0;
+  Partition& p = myPartition(*this);
+  if (p.policy_ != IdlePolicy::kSleep) {
+    run(p.policy_threads_, []() { throw policy_ty{IdlePolicy::kSleep, 0}; });
+    p.policy_ = IdlePolicy::kSleep;
+    p.policy_threads_ = 0;
+  }
+}
+
+void
+ThreadPool::setIdlePolicy(IdlePolicy policy, unsigned spin_iterations) {
+  Partition& p = myPartition(*this);
+  unsigned num = getMaxUsableThreads();
+  if (p.policy_ == policy && p.policy_threads_ == num &&
+      p.spin_iterations_ == spin_iterations) {
+    return;
+  }
+  beKind();
+  if (policy == IdlePolicy::kSleep) {
+    return;
+  }
+  // Switch every thread so that later sections may use any number of them
+  run(num, [=]() { throw policy_ty{policy, spin_iterations}; });
+  p.policy_ = policy;
+  p.policy_threads_ = num;
+  p.spin_iterations_ = spin_iterations;
+}
+
+void
+ThreadPool::per_signal::sleepUntilReleased() {
+#ifdef __linux__
+  static_assert(sizeof(fastRelease) == sizeof(int));
+  while (fastRelease.load(std::memory_order_acquire) == kSleeping) {
+    syscall(
+        SYS_futex, reinterpret_cast<int*>(&fastRelease), FUTEX_WAIT_PRIVATE,
+        kSleeping, nullptr, nullptr, 0);
+  }
+#else
+  std::unique_lock<std::mutex> lg(m);
+  cv.wait(lg, [this] { return fastRelease != kSleeping; });
+#endif
+}
+
+void
+ThreadPool::per_signal::wakeSleeper() {
+#ifdef __linux__
+  syscall(
+      SYS_futex, reinterpret_cast<int*>(&fastRelease), FUTEX_WAKE_PRIVATE, 1,
+      nullptr, nullptr, 0);
+#else
+  std::lock_guard<std::mutex> lg(m);
+  cv.notify_one();
+#endif
+}
+
+std::unique_ptr<ThreadPool::Partition>
+ThreadPool::makePartition(
+    unsigned id, std::vector<unsigned> pool_threads) const {
+  std::sort(pool_threads.begin(), pool_threads.end());
+
+  auto p = std::make_unique<Partition>();
+  p->id_ = id;
+  p->threads_ = std::move(pool_threads);
+
+  // Renumber sockets in the order their first thread appears in the
+  // partition, which keeps the leader of each socket its first thread.
+  std::vector<unsigned> pool_sockets;
+  std::vector<unsigned> leaders;
+  unsigned max_socket = 0;
+  for (unsigned tid = 0; tid < p->threads_.size(); ++tid) {
+    ThreadTopoInfo topo = poolTopo[p->threads_[tid]];
+    auto it = std::find(pool_sockets.begin(), pool_sockets.end(), topo.socket);
+    unsigned socket = std::distance(pool_sockets.begin(), it);
+    if (it == pool_sockets.end()) {
+      pool_sockets.emplace_back(topo.socket);
+      leaders.emplace_back(tid);
+    }
+    max_socket = std::max(max_socket, socket);
+
+    topo.tid = tid;
+    topo.socket = socket;
+    topo.socketLeader = leaders[socket];
+    topo.cumulativeMaxSocket = max_socket;
+    p->topo_.emplace_back(topo);
+  }
+
+  unsigned num_threads = p->threads_.size();
+  p->socket_threads_.resize(num_threads);
+  std::iota(p->socket_threads_.begin(), p->socket_threads_.end(), 0);
+  std::stable_sort(
+      p->socket_threads_.begin(), p->socket_threads_.end(),
+      [&](unsigned a, unsigned b) {
+        const ThreadTopoInfo& x = p->topo_[a];
+        const ThreadTopoInfo& y = p->topo_[b];
+        return std::tie(x.socket, x.numaNode) < std::tie(y.socket, y.numaNode);
+      });
+  p->socket_begin_.assign(pool_sockets.size() + 1, 0);
+  for (const ThreadTopoInfo& topo : p->topo_) {
+    ++p->socket_begin_[topo.socket + 1];
+  }
+  std::partial_sum(
+      p->socket_begin_.begin(), p->socket_begin_.end(),
+      p->socket_begin_.begin());
+
+  p->mi_ = MachineTopoInfo{
+      .maxThreads = num_threads,
+      .maxCores = std::max(1U, mi.maxCores * num_threads / mi.maxThreads),
+      .maxSockets = static_cast<unsigned>(pool_sockets.size()),
+      .maxNumaNodes = mi.maxNumaNodes,
+  };
+  return p;
+}
+
+unsigned
+ThreadPool::setPartitions(unsigned num) {
+  if (num <= 1 && partitions.size() == 1) {
+    return 1;
+  }
+  for (Partition* p : partitions) {
+    KATANA_LOG_VASSERT(
+        !p->running_ && !p->occupied_ && p->policy_ == IdlePolicy::kSleep,
+        "Can't partition thread pool while partition {} is in use", p->id_);
+  }
+  KATANA_LOG_VASSERT(
+      !reserved, "Can't partition thread pool with dedicated threads");
+
+  num = std::min(std::max(1U, num), mi.maxThreads);
+
+  partitions.clear();
+  partitionStorage.clear();
+  if (num == 1) {
+    partitions.emplace_back(whole.get());
+  } else {
+    // Order threads by socket so that consecutive threads fill whole sockets.
+    // With fewer sockets than partitions, sockets are split among partitions.
+    std::vector<unsigned> order(mi.maxThreads);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+      return poolTopo[a].socket < poolTopo[b].socket;
+    });
+
+    for (unsigned id = 0; id < num; ++id) {
+      std::vector<unsigned> pool_threads;
+      if (num <= mi.maxSockets) {
+        unsigned socket_begin = id * mi.maxSockets / num;
+        unsigned socket_end = (id + 1) * mi.maxSockets / num;
+        for (unsigned t : order) {
+          if (poolTopo[t].socket >= socket_begin &&
+              poolTopo[t].socket < socket_end) {
+            pool_threads.emplace_back(t);
+          }
+        }
+      } else {
+        pool_threads.assign(
+            order.begin() + id * mi.maxThreads / num,
+            order.begin() + (id + 1) * mi.maxThreads / num);
+      }
+      partitionStorage.emplace_back(makePartition(id, std::move(pool_threads)));
+      partitions.emplace_back(partitionStorage.back().get());
+    }
+  }
+
+  // Pool threads are idle, so their mailboxes can be updated from here; they
+  // observe the update when they are next woken.
+  for (Partition* p : partitions) {
+    for (unsigned tid = 0; tid < p->num_threads(); ++tid) {
+      per_signal* box = signals[p->threads_[tid]];
+      box->topo = p->topo_[tid];
+      box->partition = p;
+    }
   }
+
+  return num;
+}
+
+bool
+ThreadPool::tryEnterPartition(unsigned id) {
+  KATANA_LOG_VASSERT(
+      id < partitions.size(), "partition {} out of range [0, {})", id,
+      partitions.size());
+  KATANA_LOG_VASSERT(
+      !my_box.partition,
+      "Only threads outside the thread pool can enter a partition");
+
+  Partition& p = *partitions[id];
+  // The thread that made the pool is pool thread 0 and runs the loops of its
+  // partition, so no other thread may take its place there
+  if (&p == signals[0]->partition) {
+    return false;
+  }
+  bool expected = false;
+  if (!p.occupied_.compare_exchange_strong(expected, true)) {
+    return false;
+  }
+
+  // The calling thread takes the place of the first thread of the
+  // partition, which stays idle while it is entered.
+  my_box.topo = p.topo_[0];
+  my_box.partition = &p;
+  return true;
+}
+
+void
+ThreadPool::enterPartition(unsigned id) {
+  KATANA_LOG_VASSERT(
+      tryEnterPartition(id), "Partition {} is in use by another thread", id);
+}
+
+void
+ThreadPool::exitPartition() {
+  Partition* p = my_box.partition;
+  KATANA_LOG_VASSERT(
+      p && p->occupied_, "Thread did not enter a thread pool partition");
+  KATANA_LOG_VASSERT(!p->running_, "Can't exit partition while it is running");
+
+  my_box.topo = ThreadTopoInfo{};
+  my_box.partition = nullptr;
+  p->occupied_ = false;
 }
 
 // inefficient append
@@ -129,7 +398,8 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = poolTopo[tid];
+  my_box.partition = whole.get();
   // Initialize
   initPTS(mi.maxThreads);
 
@@ -155,17 +425,22 @@ ThreadPool::initThread(unsigned tid) {
 void
 ThreadPool::threadLoop(unsigned tid) {
   initThread(tid);
-  bool fastmode = false;
+  IdlePolicy policy = IdlePolicy::kSleep;
+  unsigned spin_iterations = 0;
   auto& me = my_box;
   do {
-    me.wait(fastmode);
-    cascade(fastmode);
+    me.wait(policy, spin_iterations);
+    Partition& p = *me.partition;
+    internal::activeThreadsOverride = p.active_threads_;
+    cascade(policy);
     try {
-      work();
+      PerfCountsGuard counts_guard(&me.perf_counts);
+      p.work_();
     } catch (const shutdown_ty&) {
       return;
-    } catch (const fastmode_ty& fm) {
-      fastmode = fm.mode;
+    } catch (const policy_ty& pt) {
+      policy = pt.policy;
+      spin_iterations = pt.spin_iterations;
     } catch (const dedicated_ty dt) {
       me.done = 1;
       dt.fn();
@@ -187,12 +462,12 @@ ThreadPool::decascade() {
   // nothing to wake up
   if (me.wbegin != me.wend) {
     auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
-    auto& c1done = signals[me.wbegin]->done;
+    auto& c1done = signalOf(me.wbegin)->done;
     while (!c1done) {
       asmPause();
     }
     if (midpoint < me.wend) {
-      auto& c2done = signals[midpoint]->done;
+      auto& c2done = signalOf(midpoint)->done;
       while (!c2done) {
         asmPause();
       }
@@ -202,7 +477,7 @@ ThreadPool::decascade() {
 }
 
 void
-ThreadPool::cascade(bool fastmode) {
+ThreadPool::cascade(IdlePolicy policy) {
   auto& me = my_box;
   KATANA_LOG_DEBUG_ASSERT(me.wbegin <= me.wend);
 
@@ -213,16 +488,16 @@ ThreadPool::cascade(bool fastmode) {
 
   auto midpoint = me.wbegin + (1 + me.wend - me.wbegin) / 2;
 
-  auto* child1 = signals[me.wbegin];
+  auto* child1 = signalOf(me.wbegin);
   child1->wbegin = me.wbegin + 1;
   child1->wend = midpoint;
-  child1->wakeup(fastmode);
+  child1->wakeup(policy);
 
   if (midpoint < me.wend) {
-    auto* child2 = signals[midpoint];
+    auto* child2 = signalOf(midpoint);
     child2->wbegin = midpoint + 1;
     child2->wend = me.wend;
-    child2->wakeup(fastmode);
+    child2->wakeup(policy);
   }
 }
 
@@ -230,31 +505,44 @@ void
 ThreadPool::runInternal(unsigned num) {
   // sanitize num
   // seq write to starting should make work safe
-  KATANA_LOG_VASSERT(!running, "Recursive thread pool execution not supported");
-  running = true;
-  num = std::min(std::max(1U, num), getMaxUsableThreads());
   // my_box is tid 0
   auto& me = my_box;
+  Partition& p = myPartition(*this);
+  KATANA_LOG_VASSERT(
+      me.partition || partitions.size() == 1,
+      "Threads outside the thread pool must enter a partition to run");
+  KATANA_LOG_VASSERT(
+      !p.running_, "Recursive thread pool execution not supported");
+  p.running_ = true;
+  // ids are unique across partitions, which may run loops concurrently
+  static std::atomic<uint64_t> next_loop_epoch{0};
+  p.loop_epoch_ = ++next_loop_epoch;
+  num = std::min(std::max(1U, num), getMaxUsableThreads());
+  // children run with the number of active threads of their master
+  p.active_threads_ = getActiveThreads();
   me.wbegin = 1;
   me.wend = num;
 
+  // threads are woken up according to their idle policy, so the threads
+  // that run must all have the policy of the partition
   KATANA_LOG_VASSERT(
-      !masterFastmode || masterFastmode == num,
-      "fastmode threads {} != num threads {}", masterFastmode, num);
+      p.policy_ == IdlePolicy::kSleep || p.policy_threads_ >= num,
+      "idle policy threads {} < num threads {}", p.policy_threads_, num);
   // launch threads
-  cascade(masterFastmode);
+  cascade(p.policy_);
   // Do master thread work
   try {
-    work();
+    PerfCountsGuard counts_guard(&me.perf_counts);
+    p.work_();
   } catch (const shutdown_ty&) {
     return;
-  } catch (const fastmode_ty& fm) {
+  } catch (const policy_ty&) {
   }
   // wait for children
   decascade();
   // Clean up
-  work = nullptr;
-  running = false;
+  p.work_ = nullptr;
+  p.running_ = false;
 }
 
 void
@@ -263,20 +551,34 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   // thread but we don't want to depend on katana symbols and too many
   // clients access katana::activeThreads directly.
   KATANA_LOG_VASSERT(
-      !running, "Can't start dedicated thread during parallel section");
+      !whole->running_, "Can't start dedicated thread during parallel section");
+  KATANA_LOG_VASSERT(
+      partitions.size() == 1,
+      "Can't start dedicated thread in a partitioned thread pool");
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
-  work = [&f]() { throw dedicated_ty{f}; };
+  whole->work_ = [&f]() { throw dedicated_ty{f}; };
   auto* child = signals[mi.maxThreads - reserved];
   child->wbegin = 0;
   child->wend = 0;
   child->done = 0;
-  child->wakeup(masterFastmode);
+  child->wakeup(whole->policy_);
   while (!child->done) {
     asmPause();
   }
-  work = nullptr;
+  whole->work_ = nullptr;
+}
+
+katana::PerfCounts
+ThreadPool::getPerfCounts() const {
+  const Partition& p = myPartition(*this);
+  // the calling thread does the work of the first thread of its partition
+  PerfCounts counts = my_box.perf_counts;
+  for (unsigned tid = 1; tid < p.num_threads(); ++tid) {
+    counts += signals[p.pool_thread(tid)]->perf_counts;
+  }
+  return counts;
 }
 
 static katana::ThreadPool* TPOOL = nullptr;
@@ -33,9 +33,9 @@ katana::ThreadTimers::reportTimes(const char* category, const char* region) {
   on_each_gen(
       [&](auto, auto) {
         auto ns = timers_.getLocal()->get_nsec();
-        auto lag = ns - minTime;
         KATANA_LOG_DEBUG_VASSERT(
-            lag > 0, "negative time lag from min is impossible");
+            ns >= minTime, "negative time lag from min is impossible");
+        auto lag = ns - minTime;
 
         ReportStatMax(region, timeCat.c_str(), ns / 1000000);
         ReportStatMax(region, lagCat.c_str(), lag / 1000000);
@@ -21,20 +21,74 @@
 
 #include <algorithm>
 
+#include "katana/PerThreadStorage.h"
 #include "katana/ThreadPool.h"
 namespace katana {
 KATANA_EXPORT unsigned int activeThreads = 1;
+
+namespace internal {
+// The number of active threads of the calling thread when nonzero, which
+// takes the place of the process-wide activeThreads. Threads in a thread pool
+// partition have one, and the thread pool passes the one of the thread that
+// starts an iterator on to the threads that run it.
+thread_local unsigned int activeThreadsOverride = 0;
+}  // namespace internal
+
+namespace {
+unsigned int socketStealAttempts = 4;
+}  // namespace
 }  // namespace katana
 
 unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
   num = std::max(num, 1U);
-  katana::activeThreads = num;
+  if (katana::internal::activeThreadsOverride) {
+    katana::internal::activeThreadsOverride = num;
+  } else {
+    katana::activeThreads = num;
+  }
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
-  return katana::activeThreads;
+  unsigned int num = katana::internal::activeThreadsOverride;
+  return num ? num : katana::activeThreads;
+}
+
+void
+katana::setSocketStealAttempts(unsigned int num) noexcept {
+  katana::socketStealAttempts = std::max(num, 1U);
+}
+
+unsigned int
+katana::getSocketStealAttempts() noexcept {
+  return katana::socketStealAttempts;
+}
+
+unsigned int
+katana::getThreadPartitions() noexcept {
+  return katana::GetThreadPool().getNumPartitions();
+}
+
+katana::ThreadPartitionScope::ThreadPartitionScope(unsigned int partition)
+    : pts_base_(ptsBase),
+      pss_base_(pssBase),
+      active_threads_(internal::activeThreadsOverride) {
+  auto& tp = GetThreadPool();
+  tp.enterPartition(partition);
+
+  // Use the per-thread storage of the pool thread this thread stands in for
+  unsigned pool_tid = tp.getPartition(partition).pool_thread(0);
+  ptsBase = static_cast<char*>(getPTSBackend().getPoolRemote(pool_tid, 0));
+  pssBase = static_cast<char*>(getPPSBackend().getPoolRemote(pool_tid, 0));
+  internal::activeThreadsOverride = tp.getMaxUsableThreads();
+}
+
+katana::ThreadPartitionScope::~ThreadPartitionScope() {
+  GetThreadPool().exitPartition();
+  ptsBase = pts_base_;
+  pssBase = pss_base_;
+  internal::activeThreadsOverride = active_threads_;
 }
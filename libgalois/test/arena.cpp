@@ -0,0 +1,142 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "katana/Arena.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/Reduction.h"
+#include "katana/gstl.h"
+
+namespace {
+
+void
+TestArena() {
+  katana::Arena arena;
+
+  // alignment is respected
+  for (size_t alignment : {1, 2, 8, 16, 64, 4096}) {
+    void* ptr = arena.allocate(3, alignment);
+    KATANA_LOG_ASSERT(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+  }
+
+  // the last allocation can be freed and reused
+  void* a = arena.allocate(100);
+  arena.deallocate(a, 100);
+  KATANA_LOG_ASSERT(arena.allocate(100) == a);
+
+  // rewinding frees in stack order, including large allocations
+  katana::Arena::Mark mark = arena.mark();
+  void* b = arena.allocate(64);
+  for (int i = 0; i < 100; ++i) {
+    arena.allocate(katana::Arena::kBlockSize / 8);
+  }
+  void* large = arena.allocate(4 * katana::Arena::kBlockSize);
+  KATANA_LOG_ASSERT(large);
+  size_t capacity = arena.capacity();
+  arena.rewind(mark);
+  KATANA_LOG_ASSERT(arena.capacity() < capacity);
+  KATANA_LOG_ASSERT(arena.allocate(64) == b);
+
+  // a partial rewind frees the bytes of the large allocations after the mark
+  void* kept = arena.allocate(2 * katana::Arena::kBlockSize);
+  KATANA_LOG_ASSERT(kept);
+  capacity = arena.capacity();
+  mark = arena.mark();
+  KATANA_LOG_ASSERT(arena.allocate(3 * katana::Arena::kBlockSize));
+  KATANA_LOG_ASSERT(
+      arena.capacity() == capacity + 3 * katana::Arena::kBlockSize);
+  arena.rewind(mark);
+  KATANA_LOG_ASSERT(arena.capacity() == capacity);
+
+  arena.Reset();
+  KATANA_LOG_ASSERT(
+      arena.capacity() <=
+      katana::Arena::kMaxCachedBlocks * katana::Arena::kBlockSize);
+}
+
+void
+TestContainers() {
+  constexpr size_t kNumIterations = 10000;
+
+  katana::GAccumulator<size_t> sum;
+  katana::do_all(katana::iterate(size_t{0}, kNumIterations), [&](size_t i) {
+    katana::ArenaScope scope;
+    katana::gstl::ArenaVector<size_t> vec;
+    katana::gstl::ArenaMap<size_t, size_t> map;
+    katana::gstl::ArenaUnorderedMap<size_t, size_t> unordered_map;
+    for (size_t j = 0; j < i % 100; ++j) {
+      vec.push_back(j);
+      map[j % 7] += j;
+      unordered_map[j % 5] += j;
+    }
+    size_t map_sum = 0;
+    for (const auto& [k, v] : map) {
+      map_sum += v;
+    }
+    for (const auto& [k, v] : unordered_map) {
+      map_sum -= v;
+    }
+    KATANA_LOG_ASSERT(map_sum == 0);
+    sum += vec.size();
+  });
+
+  size_t expected = 0;
+  for (size_t i = 0; i < kNumIterations; ++i) {
+    expected += i % 100;
+  }
+  KATANA_LOG_ASSERT(sum.reduce() == expected);
+}
+
+void
+TestLoopReset() {
+  // what a loop allocates without a scope is freed by the next loop
+  std::vector<size_t> capacities(katana::getActiveThreads());
+  for (int round = 0; round < 2; ++round) {
+    katana::on_each([&](unsigned tid, unsigned) {
+      katana::Arena& arena = katana::GetLoopArena();
+      KATANA_LOG_ASSERT(arena.mark().offset == 0);
+      for (int i = 0; i < 40; ++i) {
+        arena.allocate(katana::Arena::kBlockSize / 4);
+      }
+      if (round == 0) {
+        capacities[tid] = arena.capacity();
+      } else {
+        // blocks are reused rather than allocated again
+        KATANA_LOG_ASSERT(arena.capacity() == capacities[tid]);
+      }
+    });
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestArena();
+  TestContainers();
+  TestLoopReset();
+
+  return 0;
+}
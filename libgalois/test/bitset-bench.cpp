@@ -0,0 +1,246 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  // number of bits and percentage of them that are set
+  for (long size : {1 << 16, 1 << 24}) {
+    for (long density : {1, 50}) {
+      b->Args({size, density});
+    }
+  }
+}
+
+/// Number of bits is not a multiple of 64 so that the last word is partial.
+katana::DynamicBitset
+MakeBitset(long size, long density, unsigned seed) {
+  katana::DynamicBitset ret;
+  ret.resize(size + 7);
+
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<long> dist(0, 99);
+  for (size_t i = 0; i < ret.size(); ++i) {
+    if (dist(gen) < density) {
+      ret.set(i);
+    }
+  }
+  return ret;
+}
+
+// The baselines below are the implementations DynamicBitset used before its
+// bulk operations worked on blocks of words.
+
+void
+BaselineOr(katana::DynamicBitset* dst, const katana::DynamicBitset& other) {
+  auto& vec = dst->get_vec();
+  const auto& other_vec = other.get_vec();
+  katana::do_all(katana::iterate(size_t{0}, vec.size()), [&](size_t i) {
+    vec[i] |= other_vec[i];
+  });
+}
+
+size_t
+BaselineCount(const katana::DynamicBitset& bitset) {
+  katana::GAccumulator<size_t> ret;
+  const auto& vec = bitset.get_vec();
+  katana::do_all(katana::iterate(size_t{0}, vec.size()), [&](size_t i) {
+    ret += __builtin_popcountll(vec[i]);
+  });
+  return ret.reduce();
+}
+
+std::vector<uint32_t>
+BaselineOffsets(const katana::DynamicBitset& bitset) {
+  std::vector<unsigned> counts(katana::getActiveThreads());
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [start, end] =
+        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+    for (size_t i = start; i < end; ++i) {
+      counts[tid] += bitset.test(i);
+    }
+  });
+  for (size_t i = 1; i < counts.size(); ++i) {
+    counts[i] += counts[i - 1];
+  }
+
+  std::vector<uint32_t> ret(counts.back());
+  katana::on_each([&](unsigned tid, unsigned nthreads) {
+    auto [start, end] =
+        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+    size_t index = tid == 0 ? 0 : counts[tid - 1];
+    for (size_t i = start; i < end; ++i) {
+      if (bitset.test(i)) {
+        ret[index++] = i;
+      }
+    }
+  });
+  return ret;
+}
+
+void
+VerifyOr(
+    const katana::DynamicBitset& result, const katana::DynamicBitset& a,
+    const katana::DynamicBitset& b) {
+  for (size_t i = 0; i < result.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        result.test(i) == (a.test(i) || b.test(i)), "at bit {}", i);
+  }
+}
+
+void
+OrBaseline(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1), 0);
+  auto b = MakeBitset(state.range(0), state.range(1), 1);
+  katana::DynamicBitset dst;
+  dst.resize(a.size());
+
+  for (auto _ : state) {
+    dst.reset();
+    BaselineOr(&dst, a);
+    BaselineOr(&dst, b);
+  }
+
+  VerifyOr(dst, a, b);
+  state.SetBytesProcessed(state.iterations() * 2 * a.size() / 8);
+}
+
+void
+Or(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1), 0);
+  auto b = MakeBitset(state.range(0), state.range(1), 1);
+  katana::DynamicBitset dst;
+  dst.resize(a.size());
+
+  for (auto _ : state) {
+    dst.bitwise_or(a, b);
+  }
+
+  VerifyOr(dst, a, b);
+  state.SetBytesProcessed(state.iterations() * 2 * a.size() / 8);
+}
+
+void
+CountBaseline(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1), 0);
+
+  size_t count = 0;
+  for (auto _ : state) {
+    count = BaselineCount(a);
+  }
+
+  KATANA_LOG_ASSERT(count == a.SerialCount());
+  state.SetBytesProcessed(state.iterations() * a.size() / 8);
+}
+
+void
+Count(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1), 0);
+
+  size_t count = 0;
+  for (auto _ : state) {
+    count = a.count();
+  }
+
+  KATANA_LOG_ASSERT(count == BaselineCount(a));
+  state.SetBytesProcessed(state.iterations() * a.size() / 8);
+}
+
+void
+OffsetsBaseline(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1), 0);
+
+  std::vector<uint32_t> offsets;
+  for (auto _ : state) {
+    offsets = BaselineOffsets(a);
+  }
+
+  KATANA_LOG_ASSERT(offsets == a.GetOffsets<uint32_t>());
+  state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+void
+Offsets(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1), 0);
+
+  std::vector<uint32_t> offsets;
+  for (auto _ : state) {
+    offsets = a.GetOffsets<uint32_t>();
+  }
+
+  KATANA_LOG_ASSERT(offsets == BaselineOffsets(a));
+  state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+void
+WriteOffsets(benchmark::State& state) {
+  auto a = MakeBitset(state.range(0), state.range(1), 0);
+  katana::NUMAArray<uint32_t> offsets;
+  offsets.allocateBlocked(a.size());
+
+  size_t num = 0;
+  for (auto _ : state) {
+    num = a.WriteOffsets(&offsets);
+  }
+
+  auto expected = BaselineOffsets(a);
+  KATANA_LOG_ASSERT(num == expected.size());
+  KATANA_LOG_ASSERT(std::equal(expected.begin(), expected.end(), &offsets[0]));
+  state.SetItemsProcessed(state.iterations() * a.size());
+}
+
+/// Checks the operations that have no benchmark of their own, in particular
+/// that the bits past the end of a bitset stay unset.
+void
+VerifyOperations() {
+  auto a = MakeBitset(1000, 50, 0);
+  auto b = MakeBitset(1000, 50, 1);
+  katana::DynamicBitset dst;
+  dst.resize(a.size());
+
+  dst.bitwise_andnot(a, b);
+  for (size_t i = 0; i < a.size(); ++i) {
+    KATANA_LOG_ASSERT(dst.test(i) == (a.test(i) && !b.test(i)));
+  }
+
+  dst.bitwise_xor(a, b);
+  dst.bitwise_not();
+  for (size_t i = 0; i < a.size(); ++i) {
+    KATANA_LOG_ASSERT(dst.test(i) == (a.test(i) == b.test(i)));
+  }
+  KATANA_LOG_ASSERT(dst.count() == BaselineOffsets(dst).size());
+
+  dst.bitwise_andnot(dst);
+  KATANA_LOG_ASSERT(dst.none());
+  dst.set(a.size() - 1);
+  KATANA_LOG_ASSERT(dst.any());
+  KATANA_LOG_ASSERT(dst.GetOffsets<uint64_t>().back() == a.size() - 1);
+}
+
+BENCHMARK(OrBaseline)->Apply(MakeArguments);
+BENCHMARK(Or)->Apply(MakeArguments);
+BENCHMARK(CountBaseline)->Apply(MakeArguments);
+BENCHMARK(Count)->Apply(MakeArguments);
+BENCHMARK(OffsetsBaseline)->Apply(MakeArguments);
+BENCHMARK(Offsets)->Apply(MakeArguments);
+BENCHMARK(WriteOffsets)->Apply(MakeArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::GaloisRuntime G;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+  VerifyOperations();
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,52 @@
+#include <atomic>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr int kNumItems = 100000;
+
+/// Runs a for_each over [kNumItems / 2, kNumItems) with worklist WL in which
+/// each even item i pushes i / 2, and checks that each item of
+/// [1, kNumItems) is visited exactly once.
+template <typename WL>
+void
+TestWorklist(const char* name) {
+  std::vector<std::atomic<int>> visits(kNumItems);
+  katana::for_each(
+      katana::iterate(kNumItems / 2, kNumItems),
+      [&](int i, auto& ctx) {
+        visits[i].fetch_add(1, std::memory_order_relaxed);
+        if (i % 2 == 0) {
+          ctx.push(i / 2);
+        }
+      },
+      katana::wl<WL>(), katana::disable_conflict_detection(),
+      katana::loopname(name));
+
+  for (int i = 1; i < kNumItems; ++i) {
+    KATANA_LOG_VASSERT(
+        visits[i].load() == 1, "{}: item {} visited {} times", name, i,
+        visits[i].load());
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  // The undistributed worklists share one queue and take a different path
+  // through ChunkMaster than the per-socket ones
+  TestWorklist<katana::ChunkFIFO<32>>("ChunkFIFO");
+  TestWorklist<katana::ChunkLIFO<32>>("ChunkLIFO");
+  TestWorklist<katana::PerSocketChunkFIFO<32>>("PerSocketChunkFIFO");
+  TestWorklist<katana::PerSocketChunkLIFO<32>>("PerSocketChunkLIFO");
+  TestWorklist<katana::PerSocketChunkBag<32>>("PerSocketChunkBag");
+
+  return 0;
+}
@@ -1,3 +1,6 @@
+#include <set>
+#include <string>
+
 #include <benchmark/benchmark.h>
 
 #include "katana/Galois.h"
@@ -16,6 +19,13 @@ MakeArguments(benchmark::internal::Benchmark* b) {
   }
 }
 
+void
+MakeSkewedArguments(benchmark::internal::Benchmark* b) {
+  for (long attempts : {1, 4, 16}) {
+    b->Args({1024 * 1024, attempts});
+  }
+}
+
 std::vector<int>
 MakeInput(long size) {
   std::vector<int> ret;
@@ -145,11 +155,79 @@ ForEach(benchmark::State& state) {
   state.SetItemsProcessed(state.iterations() * size);
 }
 
+//! Amount of work for item i: a few items at the start of the range take
+//! most of the time, as in loops over the nodes of power-law graphs.
+int
+SkewedWork(int i) {
+  return 1 + 4096 / (i / 16 + 1);
+}
+
+int
+RunSkewedOperator(int i) {
+  unsigned x = i;
+  for (int k = 0, n = SkewedWork(i); k < n; ++k) {
+    x = x * 1664525 + 1013904223;
+  }
+  return x;
+}
+
+//! Return a loop name for each number of socket steal attempts so that the
+//! statistics printed at exit, which include the number of steals within and
+//! across sockets, show each setting separately
+const char*
+SkewedLoopName(const std::string& loop, long attempts) {
+  static std::set<std::string> names;
+  return names.emplace(loop + std::to_string(attempts)).first->c_str();
+}
+
+void
+SkewedDoAll(benchmark::State& state) {
+  long size = state.range(0);
+  auto output = MakeOutput(size);
+
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+  katana::setSocketStealAttempts(state.range(1));
+  const char* loopname = SkewedLoopName("SkewedDoAll", state.range(1));
+
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(0, static_cast<int>(size)),
+        [&](int i) { output[i] = RunSkewedOperator(i); }, katana::steal(),
+        katana::loopname(loopname), katana::more_stats());
+  }
+
+  benchmark::DoNotOptimize(output.data());
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
+void
+SkewedForEach(benchmark::State& state) {
+  long size = state.range(0);
+  auto output = MakeOutput(size);
+
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+  katana::setSocketStealAttempts(state.range(1));
+  const char* loopname = SkewedLoopName("SkewedForEach", state.range(1));
+
+  for (auto _ : state) {
+    katana::for_each(
+        katana::iterate(0, static_cast<int>(size)),
+        [&](int i, auto&) { output[i] = RunSkewedOperator(i); },
+        katana::disable_conflict_detection(), katana::no_pushes(),
+        katana::loopname(loopname), katana::more_stats());
+  }
+
+  benchmark::DoNotOptimize(output.data());
+  state.SetItemsProcessed(state.iterations() * size);
+}
+
 BENCHMARK(StdForEach)->Apply(MakeArguments);
 BENCHMARK(DoAll)->Apply(MakeArguments);
 BENCHMARK(SerialDoAll)->Apply(MakeArguments);
 BENCHMARK(ForEach)->Apply(MakeArguments);
 BENCHMARK(SerialForEach)->Apply(MakeArguments);
+BENCHMARK(SkewedDoAll)->Apply(MakeSkewedArguments);
+BENCHMARK(SkewedForEach)->Apply(MakeSkewedArguments);
 }  // namespace
 
 int
@@ -0,0 +1,262 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <string>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/PageAlloc.h"
+
+namespace {
+
+constexpr size_t kNumElements = 3 * (1 << 20) + 5;
+
+/// Check that the pages that back array account for all of it and that they
+/// are huge pages, or normal pages, as policy asks for.
+template <typename T>
+void
+CheckBacking(const katana::NUMAArray<T>& array, katana::HugePagePolicy policy) {
+  size_t bytes = array.size() * sizeof(T);
+  katana::PageBacking backing = array.getPageBacking();
+  KATANA_LOG_VASSERT(
+      backing.huge_bytes + backing.normal_bytes == bytes,
+      "huge {} + normal {} != {}", backing.huge_bytes, backing.normal_bytes,
+      bytes);
+
+  size_t node_bytes = std::accumulate(
+      backing.node_bytes.begin(), backing.node_bytes.end(), size_t{0});
+  KATANA_LOG_ASSERT(node_bytes <= bytes);
+
+  switch (policy) {
+  case katana::HugePagePolicy::kExplicit:
+    KATANA_LOG_ASSERT(
+        backing.huge_bytes == bytes || backing.normal_bytes == bytes);
+    break;
+  case katana::HugePagePolicy::kTransparent:
+    KATANA_LOG_ASSERT(
+        reinterpret_cast<uintptr_t>(array.data()) % katana::allocSize() == 0);
+    break;
+  case katana::HugePagePolicy::kNone:
+    KATANA_LOG_ASSERT(backing.huge_bytes == 0);
+    KATANA_LOG_ASSERT(katana::pageSizeOf(array.data()) < katana::allocSize());
+    break;
+  }
+}
+
+/// @returns the number of explicit huge pages that are free and not reserved
+/// according to /proc/meminfo
+size_t
+AvailableHugePages() {
+  std::ifstream meminfo("/proc/meminfo");
+  std::string line;
+  size_t free = 0;
+  size_t reserved = 0;
+  while (std::getline(meminfo, line)) {
+    std::sscanf(line.c_str(), "HugePages_Free: %zu", &free);
+    std::sscanf(line.c_str(), "HugePages_Rsvd: %zu", &reserved);
+  }
+  return free > reserved ? free - reserved : 0;
+}
+
+/// @returns the number of pages of allocSize() that bytes bytes take
+size_t
+NumPages(size_t bytes) {
+  return (bytes + katana::allocSize() - 1) / katana::allocSize();
+}
+
+void
+TestPolicy(katana::HugePagePolicy policy) {
+  size_t fallbacks = katana::numHugePageFallbacks();
+  size_t available_huge_pages = AvailableHugePages();
+
+  katana::NUMAArray<uint32_t> blocked;
+  blocked.allocateBlocked(kNumElements, policy);
+  katana::NUMAArray<uint32_t> interleaved;
+  interleaved.allocateInterleaved(kNumElements, policy);
+  katana::NUMAArray<uint64_t> local;
+  local.allocateLocal(kNumElements, policy);
+
+  for (size_t i = 0; i < kNumElements; ++i) {
+    blocked[i] = i;
+    interleaved[i] = i;
+    local[i] = i;
+  }
+
+  CheckBacking(blocked, policy);
+  CheckBacking(interleaved, policy);
+  CheckBacking(local, policy);
+
+  // Explicit huge pages that are not available are counted as fallbacks.
+  // Whether they are available is known from the kernel, except when there
+  // are some but fewer than the arrays need.
+  size_t new_fallbacks = katana::numHugePageFallbacks() - fallbacks;
+  size_t needed_huge_pages = 2 * NumPages(kNumElements * sizeof(uint32_t)) +
+                             NumPages(kNumElements * sizeof(uint64_t));
+#ifdef KATANA_USE_JEMALLOC
+  KATANA_LOG_ASSERT(new_fallbacks == 0);
+#else
+  if (policy != katana::HugePagePolicy::kExplicit) {
+    KATANA_LOG_ASSERT(new_fallbacks == 0);
+  } else if (available_huge_pages == 0) {
+    KATANA_LOG_VASSERT(
+        new_fallbacks == 3, "{} fallbacks without huge pages", new_fallbacks);
+    KATANA_LOG_ASSERT(blocked.getPageBacking().huge_bytes == 0);
+    KATANA_LOG_ASSERT(interleaved.getPageBacking().huge_bytes == 0);
+    KATANA_LOG_ASSERT(local.getPageBacking().huge_bytes == 0);
+  } else if (available_huge_pages >= needed_huge_pages) {
+    KATANA_LOG_VASSERT(
+        new_fallbacks == 0, "{} fallbacks with {} huge pages available",
+        new_fallbacks, available_huge_pages);
+  } else {
+    KATANA_LOG_ASSERT(new_fallbacks <= 3);
+  }
+#endif
+}
+
+/// @returns the NUMA node that each thread runs on, or -1 if it is not known
+std::vector<int>
+ThreadNodes() {
+  std::vector<int> nodes(katana::getActiveThreads(), -1);
+#ifdef SYS_getcpu
+  katana::on_each([&](unsigned tid, unsigned) {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+      nodes[tid] = node;
+    }
+  });
+#endif
+  return nodes;
+}
+
+/// Check that the edges of the nodes of each thread are on pages on the NUMA
+/// node of that thread. Pages that hold edges of more than one thread are
+/// skipped, as are the pages of thread 0, which may not be bound to a core.
+void
+CheckDegreePlacement(
+    const katana::NUMAArray<uint32_t>& dests,
+    const katana::NUMAArray<uint64_t>& adj_indices) {
+  const std::vector<int> thread_nodes = ThreadNodes();
+  const unsigned num_threads = katana::getActiveThreads();
+  const size_t page = katana::allocSize();
+  const char* base = reinterpret_cast<const char*>(dests.data());
+
+  for (unsigned t = 1; t < num_threads; ++t) {
+    if (thread_nodes[t] < 0) {
+      continue;
+    }
+    auto [node_begin, node_end] = katana::block_range(
+        uint64_t{0}, uint64_t{adj_indices.size()}, t, num_threads);
+    size_t begin =
+        (node_begin ? adj_indices[node_begin - 1] : 0) * sizeof(uint32_t);
+    size_t end = (node_end ? adj_indices[node_end - 1] : 0) * sizeof(uint32_t);
+    for (size_t off = (begin + page - 1) / page * page; off + page <= end;
+         off += page) {
+      katana::PageBacking backing = katana::getPageBacking(base + off, page);
+      for (size_t node = 0; node < backing.node_bytes.size(); ++node) {
+        KATANA_LOG_VASSERT(
+            backing.node_bytes[node] == 0 || int(node) == thread_nodes[t],
+            "page at {} of thread {} is on node {}, not {}", off, t, node,
+            thread_nodes[t]);
+      }
+    }
+  }
+}
+
+void
+TestDegreeBlocked() {
+  constexpr uint64_t kNumNodes = 1000;
+  // A star graph, where node 0 has most of the edges, and a graph where the
+  // degree of a node grows with its id, so that later threads have more
+  // edges than earlier ones
+  for (bool star : {true, false}) {
+    katana::NUMAArray<uint64_t> adj_indices;
+    adj_indices.allocateBlocked(kNumNodes);
+    uint64_t num_edges = 0;
+    for (uint64_t n = 0; n < kNumNodes; ++n) {
+      if (star) {
+        num_edges += n == 0 ? kNumElements : 1;
+      } else {
+        num_edges += 8 * kNumElements / kNumNodes * n / kNumNodes;
+      }
+      adj_indices[n] = num_edges;
+    }
+
+    katana::NUMAArray<uint32_t> dests;
+    dests.allocateDegreeBlocked(
+        num_edges, adj_indices, katana::HugePagePolicy::kTransparent);
+    KATANA_LOG_ASSERT(dests.size() == num_edges);
+    // before any page is touched again by this thread
+    CheckDegreePlacement(dests, adj_indices);
+    for (uint64_t e = 0; e < num_edges; ++e) {
+      dests[e] = e % kNumNodes;
+    }
+    CheckBacking(dests, katana::HugePagePolicy::kTransparent);
+  }
+}
+
+void
+TestNames() {
+  katana::NUMAArray<int> array;
+  array.allocateInterleaved(kNumElements);
+  array.setName("test_array");
+
+  bool found = false;
+  for (const auto& [name, backing] : katana::getNamedPageBackings()) {
+    if (name == "test_array") {
+      found = true;
+      KATANA_LOG_ASSERT(
+          backing.huge_bytes + backing.normal_bytes >=
+          kNumElements * sizeof(int));
+    }
+  }
+  KATANA_LOG_ASSERT(found);
+
+  array.deallocate();
+  for (const auto& [name, backing] : katana::getNamedPageBackings()) {
+    KATANA_LOG_ASSERT(name != "test_array");
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestPolicy(katana::HugePagePolicy::kExplicit);
+  TestPolicy(katana::HugePagePolicy::kTransparent);
+  TestPolicy(katana::HugePagePolicy::kNone);
+  TestDegreeBlocked();
+  TestNames();
+
+  katana::reportPageAlloc("PageAllocTest");
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "katana/Galois.h"
+#include "katana/JSON.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr int kNumIterations = 100000;
+
+// Reads the JSON lines that the statistics were printed as, keyed by region
+std::map<std::string, nlohmann::json>
+ReadStats(const std::string& path) {
+  std::map<std::string, nlohmann::json> regions;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    nlohmann::json obj = nlohmann::json::parse(line);
+    regions[obj["region"].get<std::string>()] = obj;
+  }
+  return regions;
+}
+
+}  // namespace
+
+int
+main() {
+  // must be set before anything asks whether counters are enabled
+  setenv("KATANA_PERF_COUNTERS", "1", 1);
+
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  katana::GAccumulator<int> sum;
+  katana::do_all(
+      katana::iterate(0, kNumIterations), [&](int i) { sum += i & 1; },
+      katana::steal(), katana::loopname("DoAll"));
+  katana::for_each(
+      katana::iterate(0, kNumIterations),
+      [&](int i, auto&) { sum += i & 1; }, katana::loopname("ForEach"));
+  KATANA_LOG_ASSERT(sum.reduce() == kNumIterations);
+
+  char path[] = "/tmp/katana-statistics-XXXXXX";
+  int fd = mkstemp(path);
+  KATANA_LOG_ASSERT(fd >= 0);
+  close(fd);
+
+  katana::SetStatFile(path);
+  katana::SetStatFormat(katana::StatManager::Format::kJson);
+  katana::PrintStats();
+  auto regions = ReadStats(path);
+  unlink(path);
+  // the stats are printed again at exit
+  katana::SetStatFile("");
+
+  for (const char* loop : {"DoAll", "ForEach"}) {
+    KATANA_LOG_VASSERT(regions.count(loop), "no stats for {}", loop);
+    const nlohmann::json& stats = regions[loop]["stats"];
+    KATANA_LOG_ASSERT(stats["Iterations"]["total"] == kNumIterations);
+    KATANA_LOG_ASSERT(stats["Iterations"]["total_type"] == "TSUM");
+    // counts are zero where the kernel does not allow counting, but they are
+    // reported anyway
+    for (size_t i = 0; i < katana::kNumPerfEvents; ++i) {
+      KATANA_LOG_ASSERT(stats.contains(katana::PerfCounts::Name(i)));
+    }
+    KATANA_LOG_ASSERT(stats.contains("PagePoolAllocs"));
+  }
+  KATANA_LOG_ASSERT(regions["DoAll"]["stats"].contains("LocalSteals"));
+  KATANA_LOG_ASSERT(regions["ForEach"]["stats"].contains("Conflicts"));
+
+  return 0;
+}
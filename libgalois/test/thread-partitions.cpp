@@ -0,0 +1,126 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+constexpr int kNumRounds = 20;
+constexpr int kNumItems = 100000;
+
+/// Run loops that use per-thread storage, barriers and termination detection
+/// and check their results and that thread ids stay within the partition.
+void
+RunLoops() {
+  auto& tp = katana::GetThreadPool();
+  unsigned num_threads = katana::getActiveThreads();
+  KATANA_LOG_ASSERT(num_threads <= tp.getMaxThreads());
+
+  for (int round = 0; round < kNumRounds; ++round) {
+    katana::GAccumulator<int> sum;
+    katana::GReduceMax<unsigned> max_tid;
+    katana::do_all(
+        katana::iterate(0, kNumItems),
+        [&](int) {
+          sum += 1;
+          max_tid.update(katana::ThreadPool::getTID());
+        },
+        katana::steal());
+    KATANA_LOG_ASSERT(sum.reduce() == kNumItems);
+    KATANA_LOG_ASSERT(max_tid.reduce() < num_threads);
+
+    // Each even item i pushes i / 2, so each item of [1, kNumItems) is
+    // visited exactly once starting from the top half of the range.
+    std::vector<std::atomic<int>> visits(kNumItems);
+    katana::for_each(
+        katana::iterate(kNumItems / 2, kNumItems),
+        [&](int i, auto& ctx) {
+          visits[i].fetch_add(1, std::memory_order_relaxed);
+          if (i % 2 == 0) {
+            ctx.push(i / 2);
+          }
+        },
+        katana::disable_conflict_detection());
+    for (int i = 1; i < kNumItems; ++i) {
+      KATANA_LOG_VASSERT(
+          visits[i].load() == 1, "item {} visited {} times", i,
+          visits[i].load());
+    }
+
+    katana::GAccumulator<int> on_each_threads;
+    katana::on_each([&](unsigned, unsigned) { on_each_threads += 1; });
+    KATANA_LOG_ASSERT(
+        on_each_threads.reduce() == static_cast<int>(num_threads));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+
+  unsigned num_partitions = katana::setThreadPartitions(2);
+  KATANA_LOG_ASSERT(num_partitions == katana::getThreadPartitions());
+
+  // Partition 0 holds the thread that made the runtime, so other threads
+  // cannot enter it
+  std::thread([]() {
+    KATANA_LOG_ASSERT(!katana::GetThreadPool().tryEnterPartition(0));
+  }).join();
+
+  std::vector<std::thread> clients;
+  for (unsigned i = 1; i < num_partitions; ++i) {
+    clients.emplace_back([i]() {
+      katana::ThreadPartitionScope scope(i);
+      std::thread([i]() {
+        KATANA_LOG_ASSERT(!katana::GetThreadPool().tryEnterPartition(i));
+      }).join();
+      KATANA_LOG_ASSERT(katana::ThreadPool::getPartitionID() == i);
+      RunLoops();
+    });
+  }
+  // The thread that made the runtime runs on the first partition
+  RunLoops();
+  for (auto& t : clients) {
+    t.join();
+  }
+
+  katana::setThreadPartitions(1);
+  katana::setActiveThreads(katana::GetThreadPool().getMaxThreads());
+  RunLoops();
+  std::thread([]() {
+    KATANA_LOG_ASSERT(!katana::GetThreadPool().tryEnterPartition(0));
+  }).join();
+
+  // Threads outside the pool that are not in a partition see the number of
+  // active threads of the process
+  std::thread([]() {
+    KATANA_LOG_ASSERT(
+        katana::getActiveThreads() == katana::GetThreadPool().getMaxThreads());
+  }).join();
+
+  return 0;
+}
@@ -17,15 +17,18 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <iostream>
+#include <thread>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
 #include <llvm/Support/CommandLine.h>
 
 #include "katana/Galois.h"
+#include "katana/Logging.h"
 #include "katana/Reduction.h"
 #include "katana/Timer.h"
 
@@ -41,27 +44,49 @@ static cll::opt<int> trials(
     "trials", cll::desc("number of trials"), cll::init(1));
 static cll::opt<unsigned> threads(
     "threads", cll::desc("number of threads"), cll::init(2));
-
+static cll::opt<int> gap(
+    "gap",
+    cll::desc("microseconds the pool is idle before each parallel section"),
+    cll::init(0));
+static cll::opt<unsigned> spinIterations(
+    "spinIterations",
+    cll::desc("spin iterations before sleeping for the SpinThenSleep policy"),
+    cll::init(katana::ThreadPool::kDefaultSpinIterations));
+
+using IdlePolicy = katana::ThreadPool::IdlePolicy;
+
+/// Time each of rounds do_all sections, i.e., the fork-join latency, with the
+/// threads of the pool waiting between sections according to policy, and
+/// print the percentiles of the latencies.
 void
-runDoAllBurn(int num) {
-  katana::GetThreadPool().burnPower(katana::getActiveThreads());
+runDoAllLatency(IdlePolicy policy, const std::string& name) {
+  katana::GetThreadPool().setIdlePolicy(policy, spinIterations);
 
+  std::vector<double> latencies;
+  latencies.reserve(rounds);
   for (int r = 0; r < rounds; ++r) {
-    katana::do_all(katana::iterate(0, num), [&](int) {
+    if (gap > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(gap));
+    }
+    auto start = std::chrono::steady_clock::now();
+    katana::do_all(katana::iterate(0, size.getValue()), [&](int) {
       asm volatile("" ::: "memory");
     });
+    auto end = std::chrono::steady_clock::now();
+    latencies.emplace_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
   }
 
-  katana::GetThreadPool().beKind();
-}
+  katana::GetThreadPool().setIdlePolicy(IdlePolicy::kSleep);
 
-void
-runDoAll(int num) {
-  for (int r = 0; r < rounds; ++r) {
-    katana::do_all(katana::iterate(0, num), [&](int) {
-      asm volatile("" ::: "memory");
-    });
-  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&](double p) {
+    return latencies[std::min<size_t>(
+        latencies.size() - 1, std::floor(p * latencies.size()))];
+  };
+  std::cout << name << " latency (us) p50: " << percentile(0.5)
+            << " p99: " << percentile(0.99) << " max: " << latencies.back()
+            << "\n";
 }
 
 void
@@ -96,6 +121,9 @@ int
 main(int argc, char* argv[]) {
   katana::GaloisRuntime Katana_runtime;
   llvm::cl::ParseCommandLineOptions(argc, argv);
+  if (rounds <= 0) {
+    KATANA_LOG_FATAL("rounds must be positive, not {}", rounds.getValue());
+  }
 
   katana::setActiveThreads(threads);
 
@@ -109,15 +137,17 @@ main(int argc, char* argv[]) {
   katana::GetThreadPool().runDedicated(f);
 
   for (int t = 0; t < trials; ++t) {
-    run(runDoAll, "DoAll");
-    run(runDoAllBurn, "DoAllBurn");
+    runDoAllLatency(IdlePolicy::kSleep, "DoAllSleep");
+    runDoAllLatency(IdlePolicy::kSpin, "DoAllSpin");
+    runDoAllLatency(IdlePolicy::kSpinThenSleep, "DoAllSpinThenSleep");
     run(runExplicitThread, "ExplicitThread");
   }
   EXIT = 1;
 
   std::cout << "threads: " << katana::getActiveThreads() << " usable threads: "
             << katana::GetThreadPool().getMaxUsableThreads()
-            << " rounds: " << rounds << " size: " << size << "\n";
+            << " rounds: " << rounds << " size: " << size << " gap: " << gap
+            << "\n";
 
   return 0;
 }
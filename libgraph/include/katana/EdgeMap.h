@@ -0,0 +1,269 @@
+#ifndef KATANA_LIBGRAPH_KATANA_EDGEMAP_H_
+#define KATANA_LIBGRAPH_KATANA_EDGEMAP_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/config.h"
+
+/// \file EdgeMap.h
+///
+/// EdgeMap applies an update to the edges out of (push) or into (pull) the
+/// nodes of a frontier for one round of a traversal and collects the nodes
+/// the update activates into the frontier of the next round, like edgeMap of
+/// Ligra (Shun and Blelloch, PPoPP 2013):
+///
+///   - EdgeMapPush visits the out-edges of the nodes of the frontier.
+///   - EdgeMapPull visits the in-edges of all nodes, given the transposed
+///     topology, and stops at a node once it needs no more updates.
+///   - EdgeMapBlocked visits all edges grouped by blocks of destinations
+///     (see EdgeBlocks), so that the destination data that a thread writes
+///     stays in its cache.
+///
+/// The loops read the CSR arrays of the topology directly, so any topology
+/// with num_nodes(), adj_data() and dest_data() works, e.g., GraphTopology,
+/// EdgeShuffleTopology and a materialized ProjectedTopology (a lazy one has no
+/// CSR). Each is a template over the topology and the update, so the update
+/// is inlined into the inner loop.
+///
+/// An update is a class with these members:
+///
+///     struct Update {
+///       // Push and EdgeMapBlocked: called for an edge e from src to dst with
+///       // src in the frontier, possibly concurrently for the same dst;
+///       // returns true if dst becomes active
+///       bool Push(Node src, Node dst, Edge e);
+///       // Pull: same as Push, but one thread at a time calls it for a dst
+///       bool Pull(Node src, Node dst, Edge e);
+///       // returns false if dst needs no more updates in this round
+///       bool Cond(Node dst);
+///       // optional: prefetches the data of n that Push or Pull accesses
+///       void Prefetch(Node n);
+///     };
+///
+/// Only the members that the chosen variant calls are needed.
+
+namespace katana {
+
+namespace internal {
+
+template <typename Update, typename = void>
+struct HasPrefetch : std::false_type {};
+
+template <typename Update>
+struct HasPrefetch<
+    Update, std::void_t<decltype(std::declval<Update&>().Prefetch(
+                Frontier::Node{}))>> : std::true_type {};
+
+/// Number of edges ahead whose destination is prefetched
+constexpr uint64_t kEdgeMapPrefetchDistance = 16;
+
+constexpr unsigned kEdgeMapChunkSize = 64;
+
+template <typename Update>
+void
+EdgeMapPrefetch(
+    Update& update, const Frontier::Node* dests, uint64_t e, uint64_t limit) {
+  if constexpr (HasPrefetch<Update>::value) {
+    if (e + kEdgeMapPrefetchDistance < limit) {
+      update.Prefetch(dests[e + kEdgeMapPrefetchDistance]);
+    }
+  }
+}
+
+template <typename Topology, typename = void>
+struct HasIsLazy : std::false_type {};
+
+template <typename Topology>
+struct HasIsLazy<
+    Topology, std::void_t<decltype(std::declval<const Topology&>().is_lazy())>>
+    : std::true_type {};
+
+/// The loops read the CSR arrays, which a lazy projection does not have
+template <typename Topology>
+void
+AssertHasCSR([[maybe_unused]] const Topology& topo) {
+  if constexpr (HasIsLazy<Topology>::value) {
+    KATANA_LOG_VASSERT(
+        !topo.is_lazy(), "EdgeMap needs a CSR, which a lazy projection lacks");
+  }
+}
+
+}  // namespace internal
+
+/// The edges of a topology grouped by blocks of consecutive destinations for
+/// EdgeMapBlocked. The edges of a block are ordered by source. It takes 16
+/// bytes per edge.
+class KATANA_EXPORT EdgeBlocks {
+public:
+  using Node = Frontier::Node;
+  using Edge = uint64_t;
+
+  /// Default number of destinations of a block, so that 4 bytes of data per
+  /// destination fit in a 256 KiB L2 cache
+  static constexpr uint32_t kDefaultBlockNodes = 64 * 1024;
+
+  EdgeBlocks() = default;
+
+  template <typename Topology>
+  explicit EdgeBlocks(
+      const Topology& topo, uint32_t block_nodes = kDefaultBlockNodes) {
+    internal::AssertHasCSR(topo);
+    Init(
+        topo.num_nodes(), topo.adj_data(), topo.dest_data(), topo.num_edges(),
+        block_nodes);
+  }
+
+  /// Groups the edges of a CSR topology
+  void Init(
+      uint64_t num_nodes, const Edge* adj_indices, const Node* dests,
+      uint64_t num_edges, uint32_t block_nodes = kDefaultBlockNodes);
+
+  uint64_t num_nodes() const { return num_nodes_; }
+  uint64_t num_edges() const { return srcs_.size(); }
+  size_t num_blocks() const {
+    return block_offsets_.empty() ? 0 : block_offsets_.size() - 1;
+  }
+  uint32_t block_nodes() const { return block_nodes_; }
+
+  /// Edges of block b are [block_begin(b), block_end(b)) in srcs(), dests()
+  /// and edges()
+  uint64_t block_begin(size_t b) const { return block_offsets_[b]; }
+  uint64_t block_end(size_t b) const { return block_offsets_[b + 1]; }
+
+  const Node* srcs() const { return srcs_.data(); }
+  const Node* dests() const { return dests_.data(); }
+  /// id of each edge in the topology the blocks were made of
+  const Edge* edges() const { return edges_.data(); }
+
+private:
+  uint64_t num_nodes_{0};
+  uint32_t block_nodes_{kDefaultBlockNodes};
+  NUMAArray<uint64_t> block_offsets_;
+  NUMAArray<Node> srcs_;
+  NUMAArray<Node> dests_;
+  NUMAArray<Edge> edges_;
+};
+
+/// Calls update.Push for the out-edges of the nodes of frontier and pushes
+/// the destinations it activates to next, if not null, with PushUnique.
+/// Extra arguments are passed to do_all, e.g., katana::loopname().
+template <typename Topology, typename Update, typename... Args>
+void
+EdgeMapPush(
+    const Topology& topo, const Frontier& frontier, Update& update,
+    Frontier* next, Args&&... args) {
+  using Node = Frontier::Node;
+  internal::AssertHasCSR(topo);
+  const auto* adj = topo.adj_data();
+  const Node* dests = topo.dest_data();
+
+  frontier.ForEach(
+      [&](Node src) {
+        uint64_t begin = src == 0 ? 0 : adj[src - 1];
+        uint64_t end = adj[src];
+        for (uint64_t e = begin; e < end; ++e) {
+          internal::EdgeMapPrefetch(update, dests, e, end);
+          Node dst = dests[e];
+          if (update.Cond(dst) && update.Push(src, dst, e) && next) {
+            next->PushUnique(dst);
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<internal::kEdgeMapChunkSize>(),
+      std::forward<Args>(args)...);
+}
+
+/// Calls update.Pull for the in-edges from frontier of each node for which
+/// update.Cond is true, until it is false, and pushes the nodes it activates
+/// to next, if not null. in_topo is the transpose of the graph, and frontier
+/// must be dense. Extra arguments are passed to do_all.
+template <typename Topology, typename Update, typename... Args>
+void
+EdgeMapPull(
+    const Topology& in_topo, const Frontier& frontier, Update& update,
+    Frontier* next, Args&&... args) {
+  using Node = Frontier::Node;
+  KATANA_LOG_DEBUG_ASSERT(frontier.IsDense());
+  internal::AssertHasCSR(in_topo);
+  const auto* adj = in_topo.adj_data();
+  const Node* srcs = in_topo.dest_data();
+  const uint64_t num_edges = in_topo.num_edges();
+  const auto& words = frontier.bitset().get_vec();
+
+  katana::do_all(
+      katana::iterate(Node{0}, Node(in_topo.num_nodes())),
+      [&](Node dst) {
+        if (!update.Cond(dst)) {
+          return;
+        }
+        uint64_t begin = dst == 0 ? 0 : adj[dst - 1];
+        uint64_t end = adj[dst];
+        bool activated = false;
+        for (uint64_t e = begin; e < end; ++e) {
+          // the frontier bit of a source is a random access; the edges of
+          // the next nodes are contiguous, so look ahead across nodes
+          if (e + internal::kEdgeMapPrefetchDistance < num_edges) {
+            __builtin_prefetch(
+                &words[srcs[e + internal::kEdgeMapPrefetchDistance] /
+                       DynamicBitset::kNumBitsInUint64]);
+          }
+          internal::EdgeMapPrefetch(update, srcs, e, num_edges);
+          Node src = srcs[e];
+          if (frontier.Contains(src) && update.Pull(src, dst, e)) {
+            activated = true;
+            if (!update.Cond(dst)) {
+              break;
+            }
+          }
+        }
+        if (activated && next) {
+          next->Push(dst);
+        }
+      },
+      katana::steal(), katana::chunk_size<internal::kEdgeMapChunkSize>(),
+      std::forward<Args>(args)...);
+}
+
+/// Same as EdgeMapPush, but visits the edges block by block. Each block is
+/// one task, taken with work stealing, so a thread updates the destinations
+/// of one block at a time and they stay in its cache; balancing the load
+/// needs a few blocks per thread. It visits all edges, so it suits dense
+/// frontiers; frontier must be dense. Extra arguments are passed to do_all.
+template <typename Update, typename... Args>
+void
+EdgeMapBlocked(
+    const EdgeBlocks& blocks, const Frontier& frontier, Update& update,
+    Frontier* next, Args&&... args) {
+  using Node = Frontier::Node;
+  KATANA_LOG_DEBUG_ASSERT(frontier.IsDense());
+  const Node* srcs = blocks.srcs();
+  const Node* dests = blocks.dests();
+  const uint64_t* edges = blocks.edges();
+
+  katana::do_all(
+      katana::iterate(size_t{0}, blocks.num_blocks()),
+      [&](size_t b) {
+        const uint64_t end = blocks.block_end(b);
+        for (uint64_t i = blocks.block_begin(b); i < end; ++i) {
+          internal::EdgeMapPrefetch(update, dests, i, end);
+          Node src = srcs[i];
+          if (!frontier.Contains(src)) {
+            continue;
+          }
+          Node dst = dests[i];
+          if (update.Cond(dst) && update.Push(src, dst, edges[i]) && next) {
+            next->PushUnique(dst);
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<1>(), std::forward<Args>(args)...);
+}
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef KATANA_LIBGRAPH_KATANA_FRONTIER_H_
+#define KATANA_LIBGRAPH_KATANA_FRONTIER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A Frontier is the set of active nodes of one round of a traversal, e.g.,
+/// one level of BFS.
+///
+/// It is kept in a sparse form, an array of nodes, or in a dense form, a bitset
+/// over all nodes, or both. Small frontiers are cheapest to iterate over and
+/// to push to (top-down) in sparse form, while large frontiers are cheaper in
+/// dense form, which also answers Contains() in constant time as pulling
+/// (bottom-up) needs. Finish() picks the form from the number of nodes and the
+/// sum of their out-degrees.
+///
+/// A round fills the frontier of the next round:
+///
+///     next->Clear();
+///     current->ForEach([&](Node n) { ... next->Push(m); ... });
+///     next->Finish();
+///     std::swap(current, next);
+///
+/// Push, PushUnique and Contains may be called from parallel loops; the other
+/// methods use parallel loops themselves and must not be. A round should use
+/// either Push or PushUnique, not both.
+class KATANA_EXPORT Frontier {
+public:
+  /// Same as GraphTopology::Node
+  using Node = uint32_t;
+
+  /// A frontier with more than num_nodes / kDenseDivisor nodes, or more than
+  /// num_edges / kDenseDivisor out-edges, is dense.
+  static constexpr uint64_t kDenseDivisor = 20;
+
+  Frontier() = default;
+
+  /// @param num_nodes number of nodes of the graph
+  /// @param num_edges number of edges of the graph; if 0, only the number of
+  ///   nodes decides the form of the frontier
+  explicit Frontier(size_t num_nodes, uint64_t num_edges = 0) {
+    Init(num_nodes, num_edges);
+  }
+
+  /// Resizes the frontier for a graph and empties it.
+  void Init(size_t num_nodes, uint64_t num_edges = 0);
+
+  /// Empties the frontier. Nodes pushed afterwards are kept in sparse form,
+  /// or, if dense is true, in dense form.
+  void Clear(bool dense = false);
+
+  /// Adds a node. In sparse form, a node pushed more than once appears more
+  /// than once until Deduplicate() is called.
+  void Push(Node node) {
+    if (pushing_dense_) {
+      bitset_.set(node);
+    } else {
+      pushed_.getLocal()->push_back(node);
+    }
+  }
+
+  /// Adds a node unless it is already in the frontier.
+  ///
+  /// @returns true if the node was added
+  bool PushUnique(Node node) {
+    if (bitset_.set(node)) {
+      return false;
+    }
+    if (!pushing_dense_) {
+      if (!has_unique_pushes_.load(std::memory_order_relaxed)) {
+        has_unique_pushes_.store(true, std::memory_order_relaxed);
+      }
+      pushed_.getLocal()->push_back(node);
+    }
+    return true;
+  }
+
+  /// Completes a round of pushes. Afterwards, the frontier may be read but not
+  /// pushed to.
+  void Finish() { Finish(0); }
+
+  /// Same as Finish(), but also takes the sum of the out-degrees of the nodes
+  /// in the frontier into account to pick its form. A traversal that computes
+  /// this sum anyway while pushing can pass it here.
+  void Finish(uint64_t out_degree_sum);
+
+  /// Removes duplicate nodes, and sorts the sparse form.
+  void Deduplicate();
+
+  /// Makes the dense form available.
+  void MakeDense();
+
+  /// Makes the sparse form available.
+  void MakeSparse();
+
+  /// Adds all nodes of the graph to the frontier, in dense form.
+  void Fill();
+
+  /// @returns true if node is in the frontier; requires the dense form
+  bool Contains(Node node) const {
+    KATANA_LOG_DEBUG_ASSERT(has_dense_);
+    return bitset_.test(node);
+  }
+
+  /// Calls fn(node) for each node in the frontier with katana::do_all. Extra
+  /// arguments are passed to do_all, e.g., katana::steal().
+  template <typename Fn, typename... Args>
+  void ForEach(const Fn& fn, Args&&... args) const {
+    if (has_sparse_) {
+      katana::do_all(
+          katana::iterate(size_t{0}, size_),
+          [&](size_t i) { fn(sparse_[i]); }, std::forward<Args>(args)...);
+      return;
+    }
+
+    KATANA_LOG_DEBUG_ASSERT(has_dense_);
+    const auto& words = bitset_.get_vec();
+    katana::do_all(
+        katana::iterate(size_t{0}, words.size()),
+        [&](size_t w) {
+          uint64_t word = words[w].load(std::memory_order_relaxed);
+          for (; word; word &= word - 1) {
+            fn(Node(
+                w * katana::DynamicBitset::kNumBitsInUint64 +
+                __builtin_ctzll(word)));
+          }
+        },
+        std::forward<Args>(args)...);
+  }
+
+  /// @returns the sum of degree_fn(node) over the nodes in the frontier
+  template <typename DegreeFn>
+  uint64_t SumDegrees(const DegreeFn& degree_fn) const {
+    katana::GAccumulator<uint64_t> sum;
+    ForEach([&](Node n) { sum += degree_fn(n); }, katana::no_stats());
+    return sum.reduce();
+  }
+
+  /// @returns the number of nodes in the frontier, counting duplicates
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  /// @returns true if the dense form is available
+  bool IsDense() const { return has_dense_; }
+
+  /// @returns true if the sparse form is available
+  bool IsSparse() const { return has_sparse_; }
+
+  size_t num_nodes() const { return bitset_.size(); }
+
+  /// The dense form; requires IsDense()
+  const DynamicBitset& bitset() const {
+    KATANA_LOG_DEBUG_ASSERT(has_dense_);
+    return bitset_;
+  }
+
+private:
+  bool ShouldBeDense(uint64_t out_degree_sum) const;
+
+  /// Moves the nodes pushed to per-thread vectors to sparse_
+  void GatherPushed();
+
+  void ReserveSparse(size_t size);
+
+  DynamicBitset bitset_;
+  NUMAArray<Node> sparse_;
+  PerThreadStorage<std::vector<Node>> pushed_;
+
+  size_t size_{0};
+  uint64_t num_edges_{0};
+
+  bool has_dense_{false};
+  bool has_sparse_{true};
+  bool pushing_dense_{false};
+  std::atomic<bool> has_unique_pushes_{false};
+};
+
+/// Chooses between pushing from a frontier (top-down) and pulling to unvisited
+/// nodes (bottom-up) in each round of a traversal, as in direction-optimizing
+/// BFS (Beamer et al., SC 2012).
+///
+/// It switches to pulling when the out-edges of the frontier are more than
+/// 1/alpha of the edges not yet explored, and back to pushing when the
+/// frontier stops growing and is smaller than 1/beta of the nodes.
+class KATANA_EXPORT FrontierDirection {
+public:
+  FrontierDirection(
+      size_t num_nodes, uint64_t num_edges, uint32_t alpha = 15,
+      uint32_t beta = 18)
+      : num_nodes_(num_nodes),
+        edges_to_check_(num_edges),
+        alpha_(alpha),
+        beta_(beta) {}
+
+  /// @param frontier_size number of nodes in the frontier of the next round
+  /// @param out_degree_sum sum of the out-degrees of those nodes; only used
+  ///   when pushing
+  /// @returns true if the next round should pull
+  bool NextIsPull(size_t frontier_size, uint64_t out_degree_sum);
+
+  bool IsPull() const { return pull_; }
+
+private:
+  size_t num_nodes_;
+  uint64_t edges_to_check_;
+  uint32_t alpha_;
+  uint32_t beta_;
+  size_t prev_size_{0};
+  bool pull_{false};
+};
+
+}  // namespace katana
+
+#endif
@@ -1,13 +1,20 @@
 #ifndef KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGRAPH_KATANA_GRAPHTOPOLOGY_H_
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
 #include "arrow/util/bitmap.h"
+#include "katana/Cache.h"
 #include "katana/DynamicBitset.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
@@ -501,11 +508,132 @@ private:
   PropIndexVec node_prop_indices_;
 };
 
+/// Iterates over the ids in [begin, end) whose bit is set in a bitmask, in
+/// the LSB-first layout of arrow bitmaps, or over all of them if there is no
+/// bitmask. It skips unset bits a byte at a time. Without a bitmask it is
+/// a counting iterator; with one, advancing and taking distances count the
+/// set bits in between, which is linear but cheap enough for splitting ranges
+/// among threads.
+class KATANA_EXPORT BitmaskFilterIterator
+    : public boost::iterator_facade<
+          BitmaskFilterIterator, const uint64_t,
+          boost::random_access_traversal_tag, const uint64_t&, int64_t> {
+public:
+  BitmaskFilterIterator() = default;
+
+  BitmaskFilterIterator(
+      const uint8_t* bitmask, uint64_t pos, uint64_t end) noexcept
+      : bitmask_(bitmask), pos_(pos), end_(end) {
+    SkipUnset();
+  }
+
+private:
+  friend class boost::iterator_core_access;
+
+  // a reference, like boost::counting_iterator, so that the standard
+  // iterator category is random access as well
+  const uint64_t& dereference() const noexcept { return pos_; }
+
+  bool equal(const BitmaskFilterIterator& other) const noexcept {
+    return pos_ == other.pos_;
+  }
+
+  void increment() noexcept {
+    ++pos_;
+    SkipUnset();
+  }
+
+  /// only valid if there is a set bit before pos_
+  void decrement() noexcept {
+    --pos_;
+    if (bitmask_ == nullptr) {
+      return;
+    }
+    while (!IsSet(pos_)) {
+      --pos_;
+    }
+  }
+
+  void advance(int64_t n) noexcept {
+    if (bitmask_ == nullptr) {
+      pos_ += n;
+      return;
+    }
+    for (; n > 0; --n) {
+      increment();
+    }
+    for (; n < 0; ++n) {
+      decrement();
+    }
+  }
+
+  int64_t distance_to(const BitmaskFilterIterator& other) const noexcept {
+    if (other.pos_ < pos_) {
+      return -other.distance_to(*this);
+    }
+    if (bitmask_ == nullptr) {
+      return static_cast<int64_t>(other.pos_ - pos_);
+    }
+    int64_t count = 0;
+    uint64_t i = pos_;
+    for (; i < other.pos_ && i % 8 != 0; ++i) {
+      count += IsSet(i);
+    }
+    for (; i + 8 <= other.pos_; i += 8) {
+      count += __builtin_popcount(bitmask_[i / 8]);
+    }
+    for (; i < other.pos_; ++i) {
+      count += IsSet(i);
+    }
+    return count;
+  }
+
+  bool IsSet(uint64_t i) const noexcept {
+    return (bitmask_[i / 8] >> (i % 8)) & 1;
+  }
+
+  void SkipUnset() noexcept {
+    if (bitmask_ == nullptr) {
+      return;
+    }
+    while (pos_ < end_) {
+      unsigned byte = bitmask_[pos_ / 8] >> (pos_ % 8);
+      if (byte != 0) {
+        pos_ += __builtin_ctz(byte);
+        break;
+      }
+      pos_ = (pos_ / 8 + 1) * 8;
+    }
+    pos_ = std::min(pos_, end_);
+  }
+
+  const uint8_t* bitmask_{nullptr};
+  uint64_t pos_{0};
+  uint64_t end_{0};
+};
+
 /// filter nodes and edges
 /// and creates a new projected graph based on the filtered nodes and edges
 /// also maintains mappings from original to projected and projected to original nodes and edges
+///
+/// A projection is either materialized, with a CSR of its own, or lazy. A
+/// lazy projection keeps the node mappings and the bitmasks, and it filters
+/// the edges of the original topology with the edge bitmask as they are
+/// iterated. The edge ids of a lazy projection are the edge ids of the
+/// original topology, so they are not contiguous, and it has no CSR:
+/// adj_data() and dest_data() abort.
 class KATANA_EXPORT ProjectedTopology : public GraphTopologyTypes {
 public:
+  enum class Kind {
+    kMaterialized,
+    kLazy,
+    /// choose with ChooseKind
+    kAuto,
+  };
+
+  using edge_iterator = BitmaskFilterIterator;
+  using edges_range = StandardRange<edge_iterator>;
+
   ProjectedTopology() = default;
   ProjectedTopology(ProjectedTopology&&) = default;
   ProjectedTopology& operator=(ProjectedTopology&&) = default;
@@ -513,13 +641,28 @@ public:
   ProjectedTopology(const ProjectedTopology&) = delete;
   ProjectedTopology& operator=(const ProjectedTopology&) = delete;
 
-  uint64_t num_nodes() const noexcept { return adj_indices_.size(); }
+  bool is_lazy() const noexcept { return original_topo_ != nullptr; }
 
-  uint64_t num_edges() const noexcept { return dests_.size(); }
+  uint64_t num_nodes() const noexcept {
+    return is_lazy() ? projected_to_original_nodes_mapping_.size()
+                     : adj_indices_.size();
+  }
 
-  const Edge* adj_data() const noexcept { return adj_indices_.data(); }
+  uint64_t num_edges() const noexcept {
+    return is_lazy() ? num_lazy_edges_ : dests_.size();
+  }
 
-  const Node* dest_data() const noexcept { return dests_.data(); }
+  /// \returns the CSR of a materialized projection; a lazy one has none
+  const Edge* adj_data() const noexcept {
+    KATANA_LOG_VASSERT(!is_lazy(), "a lazy projection has no CSR");
+    return adj_indices_.data();
+  }
+
+  /// \returns the CSR of a materialized projection; a lazy one has none
+  const Node* dest_data() const noexcept {
+    KATANA_LOG_VASSERT(!is_lazy(), "a lazy projection has no CSR");
+    return dests_.data();
+  }
 
   /// Checks equality against another instance of ProjectedTopology.
   /// WARNING: Expensive operation due to element-wise checks on large arrays
@@ -537,8 +680,27 @@ public:
       return false;
     }
 
-    return adj_indices_ == projected_topo_.adj_indices_ &&
-           dests_ == projected_topo_.dests_;
+    if (!is_lazy() && !projected_topo_.is_lazy()) {
+      return adj_indices_ == projected_topo_.adj_indices_ &&
+             dests_ == projected_topo_.dests_;
+    }
+
+    // compare the destinations of each node in order
+    for (Node n = 0; n < num_nodes(); ++n) {
+      auto these = edges(n);
+      auto those = projected_topo_.edges(n);
+      auto it = these.begin();
+      auto jt = those.begin();
+      for (; it != these.end() && jt != those.end(); ++it, ++jt) {
+        if (edge_dest(*it) != projected_topo_.edge_dest(*jt)) {
+          return false;
+        }
+      }
+      if (it != these.end() || jt != those.end()) {
+        return false;
+      }
+    }
+    return true;
   }
 
   /// Gets the edge range of some node.
@@ -546,14 +708,25 @@ public:
   /// \param node node to get the edge range of
   /// \returns iterable edge range for node.
   edges_range edges(Node node) const noexcept {
+    if (is_lazy()) {
+      KATANA_LOG_DEBUG_ASSERT(
+          node < projected_to_original_nodes_mapping_.size());
+      auto range =
+          original_topo_->edges(projected_to_original_nodes_mapping_[node]);
+      return MakeLazyRange(*range.begin(), *range.end());
+    }
     KATANA_LOG_DEBUG_ASSERT(node < adj_indices_.size());
-    edge_iterator e_beg{node != 0 ? adj_indices_[node - 1] : 0};
-    edge_iterator e_end{adj_indices_[node]};
-
-    return MakeStandardRange(e_beg, e_end);
+    return MakeStandardRange(
+        edge_iterator{nullptr, node != 0 ? adj_indices_[node - 1] : 0, 0},
+        edge_iterator{nullptr, adj_indices_[node], 0});
   }
 
   Node edge_source(const Edge& eid) const noexcept {
+    if (is_lazy()) {
+      return original_to_projected_nodes_mapping_[original_topo_->edge_source(
+          eid)];
+    }
+
     KATANA_LOG_DEBUG_ASSERT(eid < num_edges());
 
     if (eid < adj_indices_[0]) {
@@ -574,6 +747,10 @@ public:
   }
 
   Node edge_dest(Edge edge_id) const noexcept {
+    if (is_lazy()) {
+      return original_to_projected_nodes_mapping_[original_topo_->edge_dest(
+          edge_id)];
+    }
     KATANA_LOG_DEBUG_ASSERT(edge_id < dests_.size());
     return dests_[edge_id];
   }
@@ -587,7 +764,12 @@ public:
   }
 
   edges_range all_edges() const noexcept {
-    return MakeStandardRange<edge_iterator>(Edge{0}, Edge{num_edges()});
+    if (is_lazy()) {
+      return MakeLazyRange(Edge{0}, Edge{original_topo_->num_edges()});
+    }
+    return MakeStandardRange(
+        edge_iterator{nullptr, Edge{0}, 0},
+        edge_iterator{nullptr, Edge{num_edges()}, 0});
   }
   // Standard container concepts
 
@@ -601,11 +783,16 @@ public:
 
   ///@param node node to get degree for
   ///@returns Degree of node N
-  size_t degree(Node node) const noexcept { return edges(node).size(); }
+  size_t degree(Node node) const noexcept {
+    if (is_lazy()) {
+      return edges(node).size();
+    }
+    return adj_indices_[node] - (node != 0 ? adj_indices_[node - 1] : 0);
+  }
 
   PropertyIndex edge_property_index(const Edge& eid) const noexcept {
-    KATANA_LOG_DEBUG_ASSERT(eid < num_edges());
-    return projected_to_original_edges_mapping_[eid];
+    KATANA_LOG_DEBUG_ASSERT(is_lazy() || eid < num_edges());
+    return is_lazy() ? eid : projected_to_original_edges_mapping_[eid];
   }
 
   /// @param eid the input eid (must be projected edge id)
@@ -615,6 +802,9 @@ public:
 
   /// @param eid the input eid (must be original edge id)
   Edge original_to_projected_edge_id(const Edge& eid) const noexcept {
+    if (is_lazy()) {
+      return edge_bitmask_.GetBit(eid) ? eid : original_topo_->num_edges();
+    }
     return original_to_projected_edges_mapping_[eid];
   }
 
@@ -644,13 +834,30 @@ public:
   /// this function creates a topology by filtering nodes and edges
   /// @param node_types the types that the selected nodes must have
   /// @param edge_types the types that the selected edges must have
+  /// @param kind whether to materialize the projection, to make it lazy or
+  /// to choose with ChooseKind
   static std::shared_ptr<ProjectedTopology> MakeTypeProjectedTopology(
       const PropertyGraph* pg, const std::vector<std::string>& node_types,
-      const std::vector<std::string>& edge_types);
+      const std::vector<std::string>& edge_types,
+      Kind kind = Kind::kMaterialized);
+
+  /// The cost model of Kind::kAuto. Materializing a projection writes about
+  /// one word per edge of the original graph and three per selected edge
+  /// once, while each traversal of a lazy projection also scans the
+  /// scanned_edges out of the selected nodes that were not selected. A lazy
+  /// projection is chosen if it is cheaper for kExpectedTraversals traversals.
+  /// @param num_edges the number of edges of the original graph
+  /// @param scanned_edges the number of edges out of the selected nodes
+  /// @param selected_edges the number of selected edges
+  static Kind ChooseKind(
+      uint64_t num_edges, uint64_t scanned_edges,
+      uint64_t selected_edges) noexcept;
+
+  static constexpr uint64_t kExpectedTraversals = 4;
 
   /// this function creates an empty graph with num_new_nodes nodes
   static std::shared_ptr<ProjectedTopology> CreateEmptyEdgeProjectedTopology(
-      const katana::PropertyGraph* pg, uint32_t num_new_nodes,
+      const katana::PropertyGraph* pg, uint64_t num_new_nodes,
       const katana::DynamicBitset& bitset);
 
   /// this function creates an empty graph
@@ -691,6 +898,35 @@ private:
             static_cast<int64_t>(original_to_projected_edges_mapping_.size())) {
   }
 
+  /// a lazy projection of original_topo
+  ProjectedTopology(
+      std::shared_ptr<const GraphTopology> original_topo,
+      uint64_t num_lazy_edges,
+      NUMAArray<Node>&& original_to_projected_nodes_mapping,
+      NUMAArray<Node>&& projected_to_original_nodes_mapping,
+      NUMAArray<uint8_t>&& node_bitmask_data,
+      NUMAArray<uint8_t>&& edge_bitmask_data)
+      : original_to_projected_nodes_mapping_(
+            std::move(original_to_projected_nodes_mapping)),
+        projected_to_original_nodes_mapping_(
+            std::move(projected_to_original_nodes_mapping)),
+        node_bitmask_data_(std::move(node_bitmask_data)),
+        edge_bitmask_data_(std::move(edge_bitmask_data)),
+        node_bitmask_(
+            static_cast<void*>(node_bitmask_data_.data()), 0,
+            static_cast<int64_t>(original_to_projected_nodes_mapping_.size())),
+        edge_bitmask_(
+            static_cast<void*>(edge_bitmask_data_.data()), 0,
+            static_cast<int64_t>(original_topo->num_edges())),
+        original_topo_(std::move(original_topo)),
+        num_lazy_edges_(num_lazy_edges) {}
+
+  edges_range MakeLazyRange(Edge begin, Edge end) const noexcept {
+    return MakeStandardRange(
+        edge_iterator{edge_bitmask_data_.data(), begin, end},
+        edge_iterator{edge_bitmask_data_.data(), end, end});
+  }
+
   // TODO(udit) : we can let go of original_to_projected_nodes_mapping_ and original_to_projected_edges_mapping_
   // by doing a binary search on projected_to_original_nodes_mapping_ and projected_to_original_edges_mapping_
   // it's a trade-off
@@ -704,6 +940,9 @@ private:
   NUMAArray<uint8_t> edge_bitmask_data_;
   arrow::internal::Bitmap node_bitmask_;
   arrow::internal::Bitmap edge_bitmask_;
+  /// the topology that a lazy projection filters; null if it is materialized
+  std::shared_ptr<const GraphTopology> original_topo_;
+  uint64_t num_lazy_edges_{0};
 };
 
 template <typename Topo>
@@ -779,6 +1018,9 @@ private:
 
 class KATANA_EXPORT ProjectedPropGraphViewWrapper : public GraphTopologyTypes {
 public:
+  using edge_iterator = ProjectedTopology::edge_iterator;
+  using edges_range = ProjectedTopology::edges_range;
+
   explicit ProjectedPropGraphViewWrapper(
       const PropertyGraph* pg,
       std::shared_ptr<const ProjectedTopology> projected_topo) noexcept
@@ -826,6 +1068,10 @@ public:
 
   auto empty() const noexcept { return topo().empty(); }
 
+  /// \returns true if edges are filtered from the original topology as they
+  /// are iterated, in which case edge ids are original edge ids
+  bool is_lazy() const noexcept { return topo().is_lazy(); }
+
   auto edge_property_index(const Edge& e) const noexcept {
     return topo().edge_property_index(e);
   }
@@ -1199,6 +1445,13 @@ public:
   katana::Result<tsuba::RDGTopology> ToRDGTopology() const;
 
 private:
+  friend class PGViewCache;
+
+  /// \returns the sorted topology whose edges this topology indexes
+  std::shared_ptr<EdgeShuffleTopology> edge_shuffle_topology() const noexcept {
+    return std::const_pointer_cast<EdgeShuffleTopology>(edge_shuff_topo_);
+  }
+
   // Must invoke SortAllEdgesByDataThenDst() before
   // calling this function
   static AdjIndexVec CreatePerEdgeTypeAdjacencyIndex(
@@ -1748,9 +2001,9 @@ struct PGViewBuilder<PGViewProjectedGraph> {
   static PGViewProjectedGraph BuildView(
       const PropertyGraph* pg, const std::vector<std::string>& node_types,
       const std::vector<std::string>& edge_types,
-      ViewCache& viewCache) noexcept {
-    auto topo =
-        viewCache.BuildOrGetProjectedGraphTopo(pg, node_types, edge_types);
+      ProjectedTopology::Kind kind, ViewCache& viewCache) noexcept {
+    auto topo = viewCache.BuildOrGetProjectedGraphTopo(
+        pg, node_types, edge_types, kind);
 
     return PGViewProjectedGraph{pg, topo};
   }
@@ -1770,19 +2023,94 @@ struct PropertyGraphViews {
   using ProjectedGraph = internal::PGViewProjectedGraph;
 };
 
+/// Identifies a topology in the PGViewCache: its kind, the transpose and sort
+/// states it was built with, and for projections the types it keeps and
+/// whether it is materialized or lazy. The type lists are sorted so that the
+/// order the types are given in does not matter.
+struct KATANA_EXPORT PGViewCacheKey {
+  enum class ViewKind {
+    kEdgeShuffleTopology,
+    kShuffleTopology,
+    kEdgeTypeAwareTopology,
+    kProjectedTopology,
+  };
+
+  ViewKind kind{ViewKind::kEdgeShuffleTopology};
+  tsuba::RDGTopology::TransposeKind transpose_kind{
+      tsuba::RDGTopology::TransposeKind::kNo};
+  tsuba::RDGTopology::EdgeSortKind edge_sort_kind{
+      tsuba::RDGTopology::EdgeSortKind::kAny};
+  tsuba::RDGTopology::NodeSortKind node_sort_kind{
+      tsuba::RDGTopology::NodeSortKind::kAny};
+  std::vector<std::string> node_types;
+  std::vector<std::string> edge_types;
+  ProjectedTopology::Kind projection_kind{
+      ProjectedTopology::Kind::kMaterialized};
+
+  static PGViewCacheKey Make(
+      ViewKind kind, tsuba::RDGTopology::TransposeKind transpose_kind,
+      tsuba::RDGTopology::EdgeSortKind edge_sort_kind,
+      tsuba::RDGTopology::NodeSortKind node_sort_kind);
+
+  static PGViewCacheKey MakeProjected(
+      std::vector<std::string> node_types, std::vector<std::string> edge_types,
+      ProjectedTopology::Kind projection_kind =
+          ProjectedTopology::Kind::kMaterialized);
+
+  bool operator==(const PGViewCacheKey& other) const {
+    return kind == other.kind && transpose_kind == other.transpose_kind &&
+           edge_sort_kind == other.edge_sort_kind &&
+           node_sort_kind == other.node_sort_kind &&
+           node_types == other.node_types && edge_types == other.edge_types &&
+           projection_kind == other.projection_kind;
+  }
+
+  struct KATANA_EXPORT Hash {
+    size_t operator()(const PGViewCacheKey& key) const;
+  };
+};
+
+/// Caches the topologies that views of a PropertyGraph are built on. The
+/// cache is keyed by PGViewCacheKey and holds a bounded number of bytes of
+/// topologies, evicting the least recently used ones beyond it. Views that
+/// were built keep their topologies alive after they are evicted.
 class KATANA_EXPORT PGViewCache {
-  std::vector<std::shared_ptr<EdgeShuffleTopology>> edge_shuff_topos_;
-  std::vector<std::shared_ptr<ShuffleTopology>> fully_shuff_topos_;
-  std::vector<std::shared_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
+public:
+  using View = std::variant<
+      std::shared_ptr<EdgeShuffleTopology>, std::shared_ptr<ShuffleTopology>,
+      std::shared_ptr<EdgeTypeAwareTopology>,
+      std::shared_ptr<ProjectedTopology>>;
+
+  struct Entry {
+    View view;
+    /// approximate size of the topology in bytes
+    size_t bytes;
+  };
+
+  /// The environment variable that sets the budget of the PGViewCaches in
+  /// megabytes; the budget is unbounded if it is not set
+  static constexpr const char* kBudgetEnvVar = "KATANA_PG_VIEW_CACHE_MB";
+  /// The environment variable that limits the megabytes of cached
+  /// topologies that are written with a PropertyGraph; all of them are
+  /// written if it is not set
+  static constexpr const char* kPersistEnvVar = "KATANA_PG_VIEW_PERSIST_MB";
+
+  /// \returns the limit in bytes that kPersistEnvVar sets
+  static size_t PersistBytesFromEnv();
+
+private:
+  Cache<Entry, PGViewCacheKey> views_;
   std::shared_ptr<CondensedTypeIDMap> edge_type_id_map_;
   // TODO(amber): define a node_type_id_map_;
-  std::shared_ptr<ProjectedTopology> projected_topos_;
 
   template <typename>
   friend struct internal::PGViewBuilder;
 
 public:
-  PGViewCache() = default;
+  /// Make a cache with the budget in kBudgetEnvVar
+  PGViewCache();
+  /// Make a cache that holds about budget_bytes of topologies
+  explicit PGViewCache(size_t budget_bytes);
   PGViewCache(PGViewCache&&) = default;
   PGViewCache& operator=(PGViewCache&&) = default;
 
@@ -1794,23 +2122,49 @@ public:
     return internal::PGViewBuilder<PGView>::BuildView(pg, *this);
   }
 
-  katana::Result<std::vector<tsuba::RDGTopology>> ToRDGTopology();
+  /// \returns the cached topologies that can be stored with the RDG, from the
+  /// most to the least recently used, up to max_bytes of them
+  katana::Result<std::vector<tsuba::RDGTopology>> ToRDGTopology(
+      size_t max_bytes = std::numeric_limits<size_t>::max());
 
+  /// \returns the hits and misses of the lookups of topologies
+  CacheStats GetStats() const { return views_.GetStats(); }
+
+  /// \returns the approximate number of bytes of the cached topologies
+  size_t size_bytes() const { return views_.size(); }
+
+  /// \returns the budget in bytes
+  size_t budget_bytes() const { return views_.capacity(); }
+
+  /// Builds a projected view. Projections are materialized unless kind asks
+  /// for a lazy one or lets ChooseKind pick it. A lazy view is not safe for
+  /// analytics: its edge ids are the ids of the original topology, which are
+  /// not in [0, num_edges()), so arrays indexed by edge id must be sized for
+  /// the original graph, and it has no CSR, so EdgeMap and other loops over
+  /// adj_data() and dest_data() abort on it.
   template <typename PGView>
   PGView BuildView(
       const PropertyGraph* pg, const std::vector<std::string>& node_types,
-      const std::vector<std::string>& edge_types) noexcept {
+      const std::vector<std::string>& edge_types,
+      ProjectedTopology::Kind kind =
+          ProjectedTopology::Kind::kMaterialized) noexcept {
     return internal::PGViewBuilder<PGView>::BuildView(
-        pg, node_types, edge_types, *this);
+        pg, node_types, edge_types, kind, *this);
   }
 
 private:
+  /// \returns the entry of the first of keys that is in the cache
+  std::optional<Entry> Find(const std::vector<PGViewCacheKey>& keys);
+
   std::shared_ptr<GraphTopology> GetOriginalTopology(
       const PropertyGraph* pg) const noexcept;
 
   std::shared_ptr<CondensedTypeIDMap> BuildOrGetEdgeTypeIndex(
       const PropertyGraph* pg) noexcept;
 
+  /// Inserts topo, or moves it to the front if it is cached
+  void InsertEdgeShuffTopo(const std::shared_ptr<EdgeShuffleTopology>& topo);
+
   std::shared_ptr<EdgeShuffleTopology> BuildOrGetEdgeShuffTopo(
       PropertyGraph* pg, const tsuba::RDGTopology::TransposeKind& tpose_kind,
       const tsuba::RDGTopology::EdgeSortKind& sort_kind) noexcept;
@@ -1826,7 +2180,8 @@ private:
 
   std::shared_ptr<ProjectedTopology> BuildOrGetProjectedGraphTopo(
       const PropertyGraph* pg, const std::vector<std::string>& node_properties,
-      const std::vector<std::string>& edge_properties) noexcept;
+      const std::vector<std::string>& edge_properties,
+      ProjectedTopology::Kind kind) noexcept;
 };
 
 /// Creates a uniform-random CSR GraphTopology instance, where each node as
@@ -119,6 +119,7 @@ private:
   }
 
   friend class PGViewCache;
+  friend class ProjectedTopology;
 
   friend class PropertyGraphRetractor;
 
@@ -254,13 +255,21 @@ public:
     return pg_view_cache_.BuildView<PGView>(this);
   }
 
+  /// Builds a view projected to node_types and edge_types; see
+  /// PGViewCache::BuildView for kind
   template <typename PGView>
   PGView BuildView(
       const std::vector<std::string>& node_types,
-      const std::vector<std::string>& edge_types) noexcept {
-    return pg_view_cache_.BuildView<PGView>(this, node_types, edge_types);
+      const std::vector<std::string>& edge_types,
+      ProjectedTopology::Kind kind =
+          ProjectedTopology::Kind::kMaterialized) noexcept {
+    return pg_view_cache_.BuildView<PGView>(
+        this, node_types, edge_types, kind);
   }
 
+  /// \returns the hits and misses of the topologies that views are built on
+  CacheStats GetViewCacheStats() const { return pg_view_cache_.GetStats(); }
+
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
   /// and its underlying resources.
   static Result<std::unique_ptr<PropertyGraph>> Make(
@@ -826,14 +835,20 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
-  Result<void> MakeNodeIndex(const std::string& column_name);
+  // Creates an index over a node property. Hash indexes only support equality
+  // lookups but answer them with fewer cache misses.
+  Result<void> MakeNodeIndex(
+      const std::string& column_name,
+      PropertyIndexKind kind = PropertyIndexKind::kOrdered);
 
   // Delete an existing index over a node property.
   Result<void> DeleteNodeIndex(const std::string& column_name);
 
-  // Creates an index over an edge property.
-  Result<void> MakeEdgeIndex(const std::string& column_name);
+  // Creates an index over an edge property. Hash indexes only support equality
+  // lookups but answer them with fewer cache misses.
+  Result<void> MakeEdgeIndex(
+      const std::string& column_name,
+      PropertyIndexKind kind = PropertyIndexKind::kOrdered);
 
   // Delete an existing index over an edge property.
   Result<void> DeleteEdgeIndex(const std::string& column_name);
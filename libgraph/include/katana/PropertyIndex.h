@@ -1,48 +1,65 @@
 #ifndef KATANA_LIBGRAPH_KATANA_PROPERTYINDEX_H_
 #define KATANA_LIBGRAPH_KATANA_PROPERTYINDEX_H_
 
-#include <set>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
 #include <arrow/type_traits.h>
-#include <boost/iterator/iterator_categories.hpp>
-#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/iterator_adaptor.hpp>
 
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
 #include "katana/Result.h"
 #include "katana/config.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
 
 namespace katana {
 
+// The lookup structure behind a PropertyIndex.
+enum class PropertyIndexKind : uint32_t {
+  // Binary search over ids sorted by value; supports range queries.
+  kOrdered = 0,
+  // Open addressing hash table; supports equality lookups only.
+  kHash = 1,
+};
+
 // PropertyIndex provides an interface similar to an ordered container
 // over a single property.
+//
+// Indexes are stored in columnar form: a permutation of the ids of all
+// entities with a valid, non-NaN property value in which entities with equal values
+// are contiguous and ordered by id. Ordered indexes additionally order the
+// runs by value and answer lookups by binary search; hash indexes locate a
+// run through a hash table. Either way an index costs a few words per entity
+// rather than one heap node per entity.
 template <typename node_or_edge>
 class KATANA_EXPORT PropertyIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexID {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexID, bool, uint8_t, int64_t, uint64_t, double_t, std::string_view*>;
-
   // PropertyIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
+  class iterator : public boost::iterator_adaptor<
+                       iterator, const node_or_edge*, const node_or_edge,
+                       boost::random_access_traversal_tag> {
   public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    iterator() : base_iterator(0) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexID>(base_iterator::operator*()).id;
-    }
+    iterator() : iterator::iterator_adaptor_(nullptr) {}
+    explicit iterator(const node_or_edge* p)
+        : iterator::iterator_adaptor_(p) {}
   };
 
+  // Value returned by FindBatch for keys that are not in the index.
+  static constexpr node_or_edge kNotFound =
+      std::numeric_limits<node_or_edge>::max();
+
   PropertyIndex(std::string column_name)
       : column_name_(std::move(column_name)) {}
 
@@ -56,11 +73,74 @@ public:
   // The name of the indexed property.
   std::string column_name() { return column_name_; }
 
+  virtual PropertyIndexKind kind() const = 0;
+
   virtual iterator begin() = 0;
   virtual iterator end() = 0;
 
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Load an index previously serialized by ToFileFrame. The index reads
+  // directly from `file`, which it keeps alive, instead of copying it.
+  virtual Result<void> BuildFromFile(std::shared_ptr<tsuba::FileView> file) = 0;
+
+  // Serialize the index so that it can be persisted with its property.
+  virtual Result<std::unique_ptr<tsuba::FileFrame>> ToFileFrame() const = 0;
+
+  // Number of bytes used by the index structure, not including the indexed
+  // property itself.
+  virtual size_t memory_usage() const = 0;
+
+protected:
+  // Returns the ids of all entities in [0, num_entities) with a valid value in
+  // `property`, in ascending order. Runs in parallel.
+  static NUMAArray<node_or_edge> ValidIds(
+      const arrow::Array& property, size_t num_entities);
+
+  // Like ValidIds above, but also skips the entities for which `keep(id)` is
+  // false.
+  template <typename Keep>
+  static NUMAArray<node_or_edge> ValidIds(
+      const arrow::Array& property, size_t num_entities, Keep keep);
+
+  iterator MakeIterator(size_t pos) const {
+    return iterator(ids_.data() + pos);
+  }
+
+  // Resolve keys[0, num_keys) in parallel with `find`, which maps a key to
+  // the id of a matching entity or kNotFound.
+  template <typename KeyIterator, typename FindFn>
+  static NUMAArray<node_or_edge> DoFindBatch(
+      KeyIterator keys, size_t num_keys, const FindFn& find) {
+    NUMAArray<node_or_edge> ids;
+    ids.allocateBlocked(num_keys);
+    katana::do_all(
+        katana::iterate(size_t{0}, num_keys),
+        [&](size_t i) { ids[i] = find(keys[i]); }, katana::steal(),
+        katana::no_stats());
+    return ids;
+  }
+
+  // Write ids_ followed by `keys` (num_keys elements of key_size
+  // bytes each, may be empty) to a new FileFrame tagged with kind().
+  Result<std::unique_ptr<tsuba::FileFrame>> WriteFileFrame(
+      size_t num_entities, const void* keys, size_t key_size,
+      size_t num_keys) const;
+
+  // Point ids_ at the ids in `file` and return a pointer to the keys
+  // that follow them. Fails if `file` was not written by WriteFileFrame with
+  // the same kind(), key_size and num_entities.
+  Result<const void*> MapFileFrame(
+      std::shared_ptr<tsuba::FileView> file, size_t num_entities,
+      size_t key_size, size_t* num_keys);
+
+  // Ids of indexed entities, grouped by value and ordered by id within each
+  // group.
+  NUMAArray<node_or_edge> ids_;
+
+  // When loaded from storage, the file that ids_ (and any keys)
+  // point into.
+  std::shared_ptr<tsuba::FileView> file_;
 
 private:
   std::string column_name_;
@@ -72,74 +152,78 @@ class KATANA_EXPORT PrimitivePropertyIndex
     : public PropertyIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexID = typename PropertyIndex<node_or_edge>::IndexID;
   using iterator = typename PropertyIndex<node_or_edge>::iterator;
-  using set_key_type = typename PropertyIndex<node_or_edge>::set_key_type;
 
   PrimitivePropertyIndex(
       const std::string& column, size_t num_entities,
       std::shared_ptr<arrow::Array> property)
       : PropertyIndex<node_or_edge>(column),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  PropertyIndexKind kind() const override {
+    return PropertyIndexKind::kOrdered;
+  }
 
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
+  iterator begin() override { return this->MakeIterator(0); }
+  iterator end() override { return this->MakeIterator(sorted_keys_.size()); }
 
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexID>(*it).id) != key) {
+    size_t pos = LowerBoundPos(key);
+    if (pos == sorted_keys_.size() || sorted_keys_[pos] != key) {
       return end();
     }
-    return iterator(it);
+    return this->MakeIterator(pos);
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater than
+  // or equal to `key`.
+  iterator LowerBound(c_type key) {
+    return this->MakeIterator(LowerBoundPos(key));
+  }
 
-  // Returns an iterator to the first element in the set that is greater than
+  // Returns an iterator to the first element in the index that is greater than
   // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
-
-private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
-    }
+  iterator UpperBound(c_type key) {
+    auto it = std::upper_bound(sorted_keys_.begin(), sorted_keys_.end(), key);
+    return this->MakeIterator(it - sorted_keys_.begin());
+  }
 
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        node_or_edge id = std::get<IndexID>(a).id;
-        c_type val = property_->Value(id);
-        return val;
+  // Returns, for each key in [begin, end), the smallest id with that value or
+  // kNotFound. Keys are looked up in parallel.
+  template <typename KeyIterator>
+  NUMAArray<node_or_edge> FindBatch(KeyIterator begin, KeyIterator end) {
+    return this->DoFindBatch(begin, end - begin, [this](c_type key) {
+      size_t pos = LowerBoundPos(key);
+      if (pos == sorted_keys_.size() || sorted_keys_[pos] != key) {
+        return PropertyIndex<node_or_edge>::kNotFound;
       }
-      return std::get<c_type>(a);
-    }
+      return this->ids_[pos];
+    });
+  }
 
-    std::shared_ptr<ArrowArrayType> property_;
-  };
+  size_t memory_usage() const override {
+    return this->ids_.size() * sizeof(node_or_edge) +
+           sorted_keys_.size() * sizeof(c_type);
+  }
 
   Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromFile(std::shared_ptr<tsuba::FileView> file) override;
+  Result<std::unique_ptr<tsuba::FileFrame>> ToFileFrame() const override;
+
+private:
+  size_t LowerBoundPos(c_type key) const {
+    auto it = std::lower_bound(sorted_keys_.begin(), sorted_keys_.end(), key);
+    return it - sorted_keys_.begin();
+  }
 
   size_t num_entities_;
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  // Property values of ids_, kept alongside so that binary searches
+  // stay within one contiguous array instead of chasing into the property.
+  NUMAArray<c_type> sorted_keys_;
 };
 
 // StringPropertyIndex provides a PropertyIndex for strings.
@@ -148,89 +232,271 @@ class KATANA_EXPORT StringPropertyIndex : public PropertyIndex<node_or_edge> {
 public:
   using ArrowArrayType =
       typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
-  using IndexID = typename PropertyIndex<node_or_edge>::IndexID;
   using iterator = typename PropertyIndex<node_or_edge>::iterator;
-  using set_key_type = typename PropertyIndex<node_or_edge>::set_key_type;
 
   StringPropertyIndex(
       const std::string& column_name, size_t num_entities,
       const std::shared_ptr<arrow::Array>& property)
       : PropertyIndex<node_or_edge>(column_name),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
+        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)) {
+  }
 
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
+  PropertyIndexKind kind() const override {
+    return PropertyIndexKind::kOrdered;
+  }
 
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
+  iterator begin() override { return this->MakeIterator(0); }
+  iterator end() override {
+    return this->MakeIterator(this->ids_.size());
+  }
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
   iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexID>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
+    iterator it = LowerBound(key);
+    if (it == end() || GetValue(*it) != key) {
+      return end();
     }
-    return iterator(it);
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
+  // Returns an iterator to the first element in the index that is greater than
+  // or equal to `key`.
   iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
+    return iterator(std::lower_bound(
+        this->ids_.begin(), this->ids_.end(), key,
+        [this](node_or_edge id, std::string_view k) {
+          return GetValue(id) < k;
+        }));
   }
 
-  // Returns an iterator to the first element in the set that is greater than
+  // Returns an iterator to the first element in the index that is greater than
   // `key`.
   iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+    return iterator(std::upper_bound(
+        this->ids_.begin(), this->ids_.end(), key,
+        [this](std::string_view k, node_or_edge id) {
+          return k < GetValue(id);
+        }));
+  }
+
+  // Returns, for each key in [begin, end), the smallest id with that value or
+  // kNotFound. Keys are looked up in parallel.
+  template <typename KeyIterator>
+  NUMAArray<node_or_edge> FindBatch(KeyIterator begin, KeyIterator end) {
+    return this->DoFindBatch(begin, end - begin, [this](std::string_view key) {
+      iterator it = Find(key);
+      return it == this->end() ? PropertyIndex<node_or_edge>::kNotFound : *it;
+    });
   }
 
+  size_t memory_usage() const override {
+    return this->ids_.size() * sizeof(node_or_edge);
+  }
+
+  Result<void> BuildFromProperty() override;
+  Result<void> BuildFromFile(std::shared_ptr<tsuba::FileView> file) override;
+  Result<std::unique_ptr<tsuba::FileFrame>> ToFileFrame() const override;
+
 private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexID>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
-      }
-      return *std::get<std::string_view*>(a);
+  size_t num_entities_;
+  std::shared_ptr<arrow::LargeStringArray> property_;
+};
+
+namespace internal {
+
+// Maps the key type of an index to the Arrow array holding its values.
+template <typename key_type>
+struct IndexKeyTraits {
+  using ArrowArrayType = typename arrow::CTypeTraits<key_type>::ArrayType;
+};
+
+template <>
+struct IndexKeyTraits<std::string_view> {
+  using ArrowArrayType = arrow::LargeStringArray;
+};
+
+}  // namespace internal
+
+// HashPropertyIndex provides an equality-only PropertyIndex over primitive
+// types (key_type is the property's C type) or strings (key_type is
+// std::string_view).
+//
+// The table uses open addressing with linear probing over a flat array of
+// slots. Each occupied slot holds the id of one entity with a given value and
+// the offset of that value's run of ids; keys are read from the property
+// rather than copied into the table. The table is kept at most half full, so
+// a successful probe usually touches one slot and one property value.
+template <typename node_or_edge, typename key_type>
+class KATANA_EXPORT HashPropertyIndex : public PropertyIndex<node_or_edge> {
+public:
+  using ArrowArrayType =
+      typename internal::IndexKeyTraits<key_type>::ArrowArrayType;
+  using iterator = typename PropertyIndex<node_or_edge>::iterator;
+
+  HashPropertyIndex(
+      const std::string& column_name, size_t num_entities,
+      const std::shared_ptr<arrow::Array>& property)
+      : PropertyIndex<node_or_edge>(column_name),
+        num_entities_(num_entities),
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  PropertyIndexKind kind() const override { return PropertyIndexKind::kHash; }
+
+  // Iteration visits entities with equal values together, but in no
+  // particular order of values.
+  iterator begin() override { return this->MakeIterator(0); }
+  iterator end() override { return this->MakeIterator(this->ids_.size()); }
+
+  // Returns the range of entities with property value equal to `key`, in
+  // ascending order of id.
+  std::pair<iterator, iterator> EqualRange(key_type key) const {
+    size_t slot = FindSlot(key, Hash(key));
+    if (slot == kNoSlot) {
+      return {this->MakeIterator(0), this->MakeIterator(0)};
     }
+    return {
+        this->MakeIterator(table_[slot].offset),
+        this->MakeIterator(table_[slot + 1].offset)};
+  }
 
-    std::shared_ptr<arrow::LargeStringArray> property_;
-  };
+  // Returns an iterator to an entity with its property value equal to `key`,
+  // or end() if there is none. Unlike ordered indexes, iterating past the
+  // matching entities (see EqualRange) reaches entities with other values.
+  iterator Find(key_type key) {
+    auto [first, last] = EqualRange(key);
+    return first == last ? end() : first;
+  }
+
+  // Returns, for each key in [begin, end), the smallest id with that value or
+  // kNotFound. Keys are looked up in parallel, and the table slots for a
+  // block of keys are prefetched before any of them is probed so that the
+  // cache misses overlap.
+  template <typename KeyIterator>
+  NUMAArray<node_or_edge> FindBatch(KeyIterator begin, KeyIterator end) const;
+
+  size_t memory_usage() const override {
+    return this->ids_.size() * sizeof(node_or_edge) +
+           table_.size() * sizeof(Slot);
+  }
 
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromFile(std::shared_ptr<tsuba::FileView> file) override;
+  Result<std::unique_ptr<tsuba::FileFrame>> ToFileFrame() const override;
+
+private:
+  // A table slot. `offset` is the start of the slot's run in ids_; the run
+  // ends where the next slot's run starts, so empty slots carry the offset
+  // of the next run and the table has one extra slot at the end.
+  struct Slot {
+    node_or_edge id;
+    node_or_edge offset;
+  };
+
+  static constexpr node_or_edge kEmpty =
+      std::numeric_limits<node_or_edge>::max();
+  static constexpr size_t kNoSlot = std::numeric_limits<size_t>::max();
+
+  static uint64_t Hash(key_type key) {
+    uint64_t h;
+    if constexpr (std::is_same_v<key_type, std::string_view>) {
+      h = std::hash<std::string_view>{}(key);
+    } else if constexpr (std::is_floating_point_v<key_type>) {
+      // -0.0 == 0.0, so they must hash alike.
+      double d = key == 0 ? 0.0 : static_cast<double>(key);
+      std::memcpy(&h, &d, sizeof(h));
+    } else {
+      h = static_cast<uint64_t>(key);
+    }
+    // splitmix64 finalizer; spreads sequential ids across the table.
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  }
+
+  key_type GetValue(node_or_edge id) const {
+    if constexpr (std::is_same_v<key_type, std::string_view>) {
+      arrow::util::string_view arrow_view = property_->GetView(id);
+      return std::string_view(arrow_view.data(), arrow_view.length());
+    } else {
+      return property_->Value(id);
+    }
+  }
+
+  size_t num_slots() const { return table_.size() - 1; }
+
+  // Returns the slot holding `key`, or kNoSlot.
+  size_t FindSlot(key_type key, uint64_t hash) const {
+    if (table_.size() == 0) {
+      return kNoSlot;
+    }
+    size_t mask = num_slots() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      node_or_edge id = table_[slot].id;
+      if (id == kEmpty) {
+        return kNoSlot;
+      }
+      if (GetValue(id) == key) {
+        return slot;
+      }
+    }
+  }
 
   size_t num_entities_;
-  std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  std::shared_ptr<ArrowArrayType> property_;
+  NUMAArray<Slot> table_;
+};
+
+template <typename node_or_edge, typename key_type>
+template <typename KeyIterator>
+NUMAArray<node_or_edge>
+HashPropertyIndex<node_or_edge, key_type>::FindBatch(
+    KeyIterator begin, KeyIterator end) const {
+  constexpr size_t kBlockSize = 16;
+  const size_t num_keys = end - begin;
+
+  NUMAArray<node_or_edge> ids;
+  ids.allocateBlocked(num_keys);
+  if (table_.size() == 0) {
+    katana::ParallelSTL::fill(
+        ids.begin(), ids.end(), PropertyIndex<node_or_edge>::kNotFound);
+    return ids;
+  }
 
-// Create a PropertyIndex with the apropriate type for 'property'. Does not
-// build the index.
+  const size_t mask = num_slots() - 1;
+  katana::do_all(
+      katana::iterate(size_t{0}, (num_keys + kBlockSize - 1) / kBlockSize),
+      [&](size_t block) {
+        size_t first = block * kBlockSize;
+        size_t last = std::min(first + kBlockSize, num_keys);
+        uint64_t hashes[kBlockSize];
+        for (size_t i = first; i < last; ++i) {
+          hashes[i - first] = Hash(begin[i]);
+          __builtin_prefetch(&table_[hashes[i - first] & mask]);
+        }
+        for (size_t i = first; i < last; ++i) {
+          size_t slot = FindSlot(begin[i], hashes[i - first]);
+          ids[i] = slot == kNoSlot ? PropertyIndex<node_or_edge>::kNotFound
+                                   : this->ids_[table_[slot].offset];
+        }
+      },
+      katana::steal(), katana::no_stats());
+  return ids;
+}
+
+// Create a PropertyIndex of the given kind with the apropriate type for
+// 'property'. Does not build the index.
 template <typename node_or_edge>
 Result<std::unique_ptr<PropertyIndex<node_or_edge>>> MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property,
+    PropertyIndexKind kind = PropertyIndexKind::kOrdered);
 
 }  // namespace katana
 
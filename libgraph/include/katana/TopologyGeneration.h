@@ -35,6 +35,15 @@ KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeClique(
 KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeTriangle(
     size_t num_rows) noexcept;
 
+/// Generates a directed graph with 2^scale nodes and edge_factor * 2^scale
+/// edges whose degrees follow a power law, with the R-MAT model (Chakrabarti
+/// et al., SDM 2004) and the Graph500 parameters. Node ids are randomly
+/// permuted so that high-degree nodes are not clustered at small ids. The
+/// graph may have self loops and parallel edges, and it only depends on
+/// the arguments, not on the number of threads.
+KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeRmat(
+    size_t scale, size_t edge_factor, uint64_t seed = 0) noexcept;
+
 /***********************************************************/
 /* Functions for adding node and edge properties to graphs */
 /***********************************************************/
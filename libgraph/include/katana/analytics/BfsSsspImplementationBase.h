@@ -24,6 +24,9 @@
 #include <cstdlib>
 #include <iostream>
 
+#include <arrow/api.h>
+
+#include "katana/ParallelSTL.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -309,6 +312,83 @@ struct BfsSsspImplementationBase {
 
     return true;
   }
+
+  /// Multi-source traversals advance up to kMultiSourceWidth sources together.
+  /// Bit i of a node's SourceMask stands for the i-th source of the batch, so
+  /// one pass over a node's edges serves every source that has reached it.
+  using SourceMask = uint64_t;
+  constexpr static const size_t kMultiSourceWidth = 64;
+
+  /// Call fn with the batch index of every source set in mask.
+  template <typename F>
+  static void ForEachSource(SourceMask mask, const F& fn) {
+    while (mask != 0) {
+      fn(static_cast<size_t>(__builtin_ctzll(mask)));
+      mask &= mask - 1;
+    }
+  }
+
+  /// Atomically add bits to *mask. The plain load first keeps hub nodes,
+  /// which most frontier nodes point at, from bouncing their cache line
+  /// around once they already carry every bit.
+  static void MergeSources(SourceMask* mask, SourceMask bits) {
+    if ((__atomic_load_n(mask, __ATOMIC_RELAXED) & bits) != bits) {
+      __atomic_fetch_or(mask, bits, __ATOMIC_RELAXED);
+    }
+  }
+
+  /// The distances computed by a multi-source traversal, one column per
+  /// source. Columns are arrow buffers so that they become node properties
+  /// without a copy. Every entry starts out as kDistanceInfinity.
+  class MultiSourceDistances {
+  public:
+    static katana::Result<MultiSourceDistances> Make(
+        size_t num_sources, size_t num_nodes) {
+      MultiSourceDistances distances;
+      distances.num_nodes_ = num_nodes;
+      for (size_t i = 0; i < num_sources; ++i) {
+        std::shared_ptr<arrow::Buffer> buffer =
+            KATANA_CHECKED(arrow::AllocateBuffer(num_nodes * sizeof(Dist)));
+        Dist* data = reinterpret_cast<Dist*>(buffer->mutable_data());
+        katana::ParallelSTL::fill(data, data + num_nodes, kDistanceInfinity);
+        distances.columns_.emplace_back(data);
+        distances.buffers_.emplace_back(std::move(buffer));
+      }
+      return distances;
+    }
+
+    size_t num_sources() const { return columns_.size(); }
+
+    /// The column for source i; columns(b) + j is the column of source b + j.
+    Dist* const* columns(size_t i = 0) const { return &columns_[i]; }
+
+    /// Add the columns to pg as node properties named by names.
+    katana::Result<void> AddTo(
+        katana::PropertyGraph* pg, const std::vector<std::string>& names,
+        tsuba::TxnContext* txn_ctx) && {
+      KATANA_LOG_DEBUG_ASSERT(names.size() == buffers_.size());
+      using ArrayType = typename arrow::CTypeTraits<Dist>::ArrayType;
+
+      std::vector<std::shared_ptr<arrow::Field>> fields;
+      std::vector<std::shared_ptr<arrow::Array>> arrays;
+      for (size_t i = 0; i < buffers_.size(); ++i) {
+        fields.emplace_back(arrow::field(
+            names[i], arrow::CTypeTraits<Dist>::type_singleton()));
+        arrays.emplace_back(
+            std::make_shared<ArrayType>(num_nodes_, std::move(buffers_[i])));
+      }
+      columns_.clear();
+      buffers_.clear();
+
+      return pg->AddNodeProperties(
+          arrow::Table::Make(arrow::schema(fields), arrays), txn_ctx);
+    }
+
+  private:
+    size_t num_nodes_{0};
+    std::vector<Dist*> columns_;
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers_;
+  };
 };
 
 template <typename T, typename BucketFunc, size_t MAX_BUCKETS = 543210ul>
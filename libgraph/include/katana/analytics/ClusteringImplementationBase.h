@@ -28,6 +28,7 @@
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
 #include "katana/analytics/Utils.h"
+#include "katana/gstl.h"
 
 namespace katana::analytics {
 
@@ -75,6 +76,14 @@ struct ClusteringImplementationBase {
 
   using CommunityArray = katana::NUMAArray<CommunityType>;
 
+  //! Maps the clusters of the neighbors of a node to local indexes. It is a
+  //! temporary of one iteration of a parallel loop, so it is allocated from
+  //! the loop arena.
+  using ClusterLocalMap = katana::gstl::ArenaMap<uint64_t, uint64_t>;
+  //! Edge weight to each cluster of a ClusterLocalMap
+  template <typename T>
+  using ClusterCounter = katana::gstl::ArenaVector<T>;
+
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
@@ -86,8 +95,8 @@ struct ClusteringImplementationBase {
   template <typename EdgeWeightType>
   static void FindNeighboringClusters(
       const Graph& graph, const GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
+      ClusterLocalMap& cluster_local_map, ClusterCounter<EdgeTy>& counter,
+      EdgeTy& self_loop_wt) {
     uint64_t num_unique_clusters = 0;
 
     // Add the node's current cluster to be considered
@@ -218,8 +227,8 @@ struct ClusteringImplementationBase {
    * without swapping the cluster assignment.
    */
   static uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+      ClusterLocalMap& cluster_local_map, ClusterCounter<EdgeTy>& counter,
+      uint64_t self_loop_wt,
       CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
     double cur_gain = 0;
@@ -509,7 +518,8 @@ struct ClusteringImplementationBase {
     katana::do_all(
         katana::iterate(uint64_t{0}, num_unique_clusters),
         [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
+          katana::ArenaScope scope;
+          ClusterLocalMap cluster_local_map;
           uint64_t num_unique_clusters = 0;
           for (auto node : cluster_bags[c]) {
             KATANA_LOG_DEBUG_ASSERT(
@@ -697,18 +707,19 @@ struct ClusteringImplementationBase {
     subcomm_info[n_current_subcomm_id].node_wt = 0;
     subcomm_info[n_current_subcomm_id].internal_edge_wt = 0;
 
-    // TODO(amber): this method is called from a parallel loop. Use iteration
-    // local allocator for the following STL containers
+    // this method is called from a parallel loop, so the following
+    // containers are allocated from the loop arena
+    katana::ArenaScope scope;
     /*
    * Map each neighbor's subcommunity to local number: Subcommunity --> Index
    */
-    std::map<uint64_t, uint64_t> cluster_local_map;
+    ClusterLocalMap cluster_local_map;
 
     /*
    * Edges weight to each unique subcommunity
    */
-    std::vector<EdgeTy> counter;
-    std::vector<uint64_t> neighboring_cluster_ids;
+    ClusterCounter<EdgeTy> counter;
+    katana::gstl::ArenaVector<uint64_t> neighboring_cluster_ids;
 
     /*
    * Identify the neighboring clusters of the currently selected
@@ -758,8 +769,9 @@ struct ClusteringImplementationBase {
     double max_quality_value_increment = 0;
     double total_transformed_quality_value_increment = 0;
     double quality_value_increment = 0;
-    std::vector<double> cum_transformed_quality_value_increment_per_cluster(
-        num_unique_clusters);
+    katana::gstl::ArenaVector<double>
+        cum_transformed_quality_value_increment_per_cluster(
+            num_unique_clusters);
     auto& n_degree_wt = graph.template GetData<DegreeWeight<EdgeWeightType>>(n);
 
     for (auto pair : cluster_local_map) {
@@ -1024,8 +1036,8 @@ struct ClusteringImplementationBase {
 
   template <typename EdgeWeightType>
   uint64_t MaxCPMQualityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeWeightType>& counter, EdgeWeightType self_loop_wt,
+      ClusterLocalMap& cluster_local_map,
+      ClusterCounter<EdgeWeightType>& counter, EdgeWeightType self_loop_wt,
       CommunityArray& c_info, uint64_t node_wt, uint64_t sc,
       double resolution) {
     uint64_t max_index = sc;  // Assign the initial value as self community
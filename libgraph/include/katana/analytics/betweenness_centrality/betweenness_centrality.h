@@ -18,16 +18,31 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
+    kApproximate,
     // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
     // kAsynchronous,
     // kAutomatic,
   };
 
+  constexpr static const double kDefaultEpsilon = 0.01;
+  constexpr static const double kDefaultDelta = 0.1;
+  static const uint32_t kDefaultTopK = 0;
+
 private:
   Algorithm algorithm_;
-
-  BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+  double epsilon_;
+  double delta_;
+  uint32_t top_k_;
+
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm,
+      double epsilon = kDefaultEpsilon, double delta = kDefaultDelta,
+      uint32_t top_k = kDefaultTopK)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        delta_(delta),
+        top_k_(top_k) {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
@@ -51,10 +66,34 @@ public:
 
   Algorithm algorithm() const { return algorithm_; }
 
+  /// The largest acceptable error in normalized centrality,
+  /// bc(v) / (n (n - 1)).
+  double epsilon() const { return epsilon_; }
+
+  /// The probability with which the error may exceed epsilon.
+  double delta() const { return delta_; }
+
+  /// The number of most central nodes whose ranking must be stable, or 0 to
+  /// bound the error of every node.
+  uint32_t top_k() const { return top_k_; }
+
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Estimate centrality from shortest path DAGs of randomly sampled sources,
+  /// computed with the Level kernels, and stop as soon as the estimates are
+  /// within epsilon of the true normalized values with probability
+  /// 1 - delta. If top_k is nonzero, instead stop once the estimates of the
+  /// top_k most central nodes are that accurate and no other node can exceed
+  /// them by more than epsilon. The sources argument is ignored. The number
+  /// of samples taken is reported as the "Samples" statistic.
+  static BetweennessCentralityPlan Approximate(
+      double epsilon = kDefaultEpsilon, double delta = kDefaultDelta,
+      uint32_t top_k = kDefaultTopK) {
+    return {kCPU, kApproximate, epsilon, delta, top_k};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
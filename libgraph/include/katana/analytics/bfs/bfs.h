@@ -80,6 +80,20 @@ KATANA_EXPORT Result<void> Bfs(
     const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
     BfsPlan algo = {});
 
+/// Compute the BFS level (hop count) of every node from each node in sources.
+/// The levels from sources[i] are stored in a uint32 property named by
+/// output_property_names[i]; nodes that sources[i] does not reach get
+/// std::numeric_limits<uint32_t>::max() / 4, as the single-source algorithms
+/// use for unreached nodes. Sources are traversed in batches of 64 that share
+/// one pass over the edges per level, so a batch costs roughly as much memory
+/// bandwidth as a single BFS.
+/// The output properties are created by this function and may not exist
+/// before the call.
+KATANA_EXPORT Result<void> BfsMulti(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names,
+    tsuba::TxnContext* txn_ctx);
+
 /// Do a quick validation of the results of a BFS computation where the results
 /// are stored in property_name. This function does do an exhaustive check.
 /// @return a failure if the BFS results do not pass validation or if there is a
@@ -62,6 +62,37 @@ KATANA_EXPORT Result<void> Jaccard(
     const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
     JaccardPlan plan = {});
 
+/// Find, for each node, the k other nodes with the highest Jaccard similarity
+/// to it among the nodes that share at least one neighbor with it. Pairs whose
+/// similarity is below threshold are dropped. The result is a new graph over
+/// the same nodes with an edge from each node to each of its matches, most
+/// similar first, and the similarity of each match in an edge property named
+/// output_property_name. The plan controls the assumptions made about edge
+/// list ordering; edge lists are sorted internally unless the plan says they
+/// already are. Repeated edges count once, so similarities are those of the
+/// sets of neighbors.
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> JaccardTopK(
+    PropertyGraph* pg, uint32_t k, double threshold,
+    const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
+    JaccardPlan plan = {});
+
+namespace internal {
+
+/// \returns true if this CPU can run IntersectSortedAVX2
+KATANA_EXPORT bool HaveAVX2();
+
+/// Count the values common to the sorted arrays a and b. A value counts once
+/// however often it repeats in either array.
+KATANA_EXPORT uint32_t IntersectSortedScalar(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size);
+
+/// The same as IntersectSortedScalar, but compares blocks of 8 values at a
+/// time. Only call it if HaveAVX2().
+KATANA_EXPORT uint32_t IntersectSortedAVX2(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size);
+
+}  // namespace internal
+
 KATANA_EXPORT Result<void> JaccardAssertValid(
     PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
 
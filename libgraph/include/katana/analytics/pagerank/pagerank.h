@@ -18,6 +18,7 @@ public:
     kPullResidual,
     kPushSynchronous,
     kPushAsynchronous,
+    kPropagationBlocking,
   };
 
   static constexpr double kDefaultTolerance = 1.0e-3;
@@ -103,6 +104,23 @@ public:
       float alpha = kDefaultAlpha) {
     return {kCPU, kPushSynchronous, tolerance, max_iterations, alpha};
   }
+
+  /// Propagation blocking algorithm
+  ///
+  /// Computes the same ranks as the topological pull algorithm, but streams
+  /// the contributions along the out-edges into bins of destinations that fit
+  /// in cache instead of reading the ranks of in-neighbors at random. It does
+  /// not need the transposed graph, but it takes another 28 bytes per edge.
+  ///
+  /// BEAMER, Scott; ASANOVIC, Krste; PATTERSON, David. Reducing pagerank
+  /// communication via propagation blocking. In: IEEE International Parallel
+  /// and Distributed Processing Symposium. IEEE, 2017. p. 820-831.
+  static PagerankPlan PropagationBlocking(
+      float tolerance = kDefaultTolerance,
+      unsigned int max_iterations = kDefaultMaxIterations,
+      float alpha = kDefaultAlpha) {
+    return {kCPU, kPropagationBlocking, tolerance, max_iterations, alpha};
+  }
 };
 
 /// Compute the Page Rank of each node in the graph.
@@ -112,6 +130,34 @@ KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     tsuba::TxnContext* txn_ctx, PagerankPlan plan = {});
 
+/// Compute the Page Rank of each node in the graph like Pagerank, but start
+/// from the ranks in the existing property initial_property_name, e.g., the
+/// result of a previous run before some edges were added, instead of a
+/// uniform vector. The computation uses the kPushAsynchronous algorithm with
+/// the tolerance and alpha of plan, and its cost depends on how far the
+/// initial ranks are from the result rather than on the size of the graph.
+/// The property named output_property_name is created by this function and may
+/// not exist before the call.
+KATANA_EXPORT Result<void> PagerankWarmStart(
+    PropertyGraph* pg, const std::string& initial_property_name,
+    const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
+    PagerankPlan plan = {});
+
+/// Update the Page Rank of previous_pg, stored in its property
+/// previous_property_name, for pg, a later version of the same graph. Nodes
+/// keep their ids between versions; pg may add nodes after those of
+/// previous_pg but not remove any. Only nodes whose out-edges differ between
+/// the versions, and new nodes, seed the kPushAsynchronous computation, so
+/// the work is proportional to the change as long as the previous ranks were
+/// computed with the same alpha and at least the tolerance of plan.
+/// The property named output_property_name is created on pg by this function
+/// and may not exist before the call.
+KATANA_EXPORT Result<void> PagerankDelta(
+    PropertyGraph* pg, PropertyGraph* previous_pg,
+    const std::string& previous_property_name,
+    const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
+    PagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
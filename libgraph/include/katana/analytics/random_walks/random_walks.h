@@ -1,11 +1,15 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
+#include <functional>
 #include <iostream>
 
+#include <arrow/api.h>
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
+#include "katana/NUMAArray.h"
+#include "katana/URI.h"
 #include "katana/analytics/Utils.h"
 
 // API
@@ -133,13 +137,79 @@ public:
   }
 };
 
+/// A set of random walks stored in one contiguous array. Walk i occupies
+/// nodes()[i * stride(), i * stride() + length(i)); a walk that reaches a
+/// node without neighbors ends early and leaves the rest of its stride
+/// unused.
+class KATANA_EXPORT RandomWalksResult {
+public:
+  RandomWalksResult() = default;
+  RandomWalksResult(
+      NUMAArray<uint32_t>&& nodes, NUMAArray<uint32_t>&& lengths,
+      uint32_t stride)
+      : nodes_(std::move(nodes)),
+        lengths_(std::move(lengths)),
+        stride_(stride) {}
+
+  uint64_t num_walks() const { return lengths_.size(); }
+
+  /// Maximum number of nodes in a walk, i.e., walk_length + 1
+  uint32_t stride() const { return stride_; }
+
+  uint32_t length(uint64_t walk) const { return lengths_[walk]; }
+
+  const uint32_t* begin(uint64_t walk) const {
+    return nodes_.data() + walk * stride_;
+  }
+  const uint32_t* end(uint64_t walk) const {
+    return begin(walk) + length(walk);
+  }
+
+  const NUMAArray<uint32_t>& nodes() const { return nodes_; }
+  const NUMAArray<uint32_t>& lengths() const { return lengths_; }
+
+  /// Convert to an Arrow array with one fixed-size list of stride() nodes per
+  /// walk; slots past the end of a walk are null. The node array is handed to
+  /// Arrow without copying, so this result is empty afterwards. The array may
+  /// outlive the Katana runtime and be released on any thread.
+  Result<std::shared_ptr<arrow::FixedSizeListArray>> ToArrowArray();
+
+  /// Copy the walks into one vector per walk
+  std::vector<std::vector<uint32_t>> ToVectors() const;
+
+private:
+  NUMAArray<uint32_t> nodes_;
+  NUMAArray<uint32_t> lengths_;
+  uint32_t stride_{0};
+};
+
 /// Compute the random-walks for pg. The pg is expected to be symmetric. The
 /// parameters can be specified, but have reasonable defaults. Not all
-/// parameters are used by the algorithms. The generated random-walks generated
-/// are returned as a vector of vectors.
-KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
+/// parameters are used by the algorithms. Edge2Vec returns the walks of each
+/// of its iterations, one iteration after another.
+KATANA_EXPORT Result<RandomWalksResult> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Receives one batch of walks; first_walk is the index of the first walk
+/// of the batch among all walks generated
+using RandomWalksConsumer = std::function<Result<void>(
+    RandomWalksResult&& batch, uint64_t first_walk)>;
+
+/// Compute the random-walks for pg like RandomWalks, but hand them to
+/// consumer in batches of at most batch_size walks as they are generated, so
+/// that only one batch is held in memory at a time. Stops at the first error
+/// returned by consumer.
+KATANA_EXPORT Result<void> RandomWalks(
+    PropertyGraph* pg, const RandomWalksConsumer& consumer,
+    uint64_t batch_size, RandomWalksPlan plan = RandomWalksPlan());
+
+/// Compute the random-walks for pg and write each batch of at most
+/// batch_size walks to its own parquet file, prefix.0, prefix.1, ..., with a
+/// single fixed-size list column named "walk".
+KATANA_EXPORT Result<void> RandomWalksToParquet(
+    PropertyGraph* pg, const katana::Uri& prefix, uint64_t batch_size,
+    RandomWalksPlan plan = RandomWalksPlan());
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
@@ -127,6 +127,21 @@ KATANA_EXPORT Result<void> Sssp(
     const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
     SsspPlan plan = {});
 
+/// Compute the shortest path lengths from each node in sources. The edge
+/// weights are taken from the property named edge_weight_property_name, as in
+/// Sssp, and the path lengths from sources[i] are stored in a property of the
+/// weight type named by output_property_names[i]. Sources are relaxed in
+/// batches of 64 that share each scan of a node's edges, which makes a batch
+/// far cheaper than 64 calls to Sssp when sources reach overlapping parts of
+/// the graph.
+/// The output properties are created by this function and may not exist
+/// before the call.
+KATANA_EXPORT Result<void> SsspMulti(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::vector<std::string>& output_property_names,
+    tsuba::TxnContext* txn_ctx);
+
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
@@ -0,0 +1,66 @@
+#include "katana/EdgeMap.h"
+
+#include <numeric>
+#include <vector>
+
+void
+katana::EdgeBlocks::Init(
+    uint64_t num_nodes, const Edge* adj_indices, const Node* dests,
+    uint64_t num_edges, uint32_t block_nodes) {
+  KATANA_LOG_ASSERT(block_nodes > 0);
+  num_nodes_ = num_nodes;
+  block_nodes_ = block_nodes;
+  const size_t num_blocks = (num_nodes + block_nodes - 1) / block_nodes;
+
+  block_offsets_.deallocate();
+  srcs_.deallocate();
+  dests_.deallocate();
+  edges_.deallocate();
+  block_offsets_.allocateInterleaved(num_blocks + 1);
+  srcs_.allocateBlocked(num_edges);
+  dests_.allocateBlocked(num_edges);
+  edges_.allocateBlocked(num_edges);
+
+  // A stable counting sort of the edges by destination block. Thread t sorts
+  // a contiguous range of sources, so the edges of a block end up ordered by
+  // source.
+  const unsigned num_threads = katana::getActiveThreads();
+  auto thread_nodes = [&](unsigned tid) {
+    return std::make_pair(
+        Node(num_nodes * tid / num_threads),
+        Node(num_nodes * (tid + 1) / num_threads));
+  };
+  // counts[b * num_threads + t] is the number of edges of thread t into
+  // block b, and then where thread t writes its first edge into block b
+  std::vector<uint64_t> counts(num_blocks * num_threads + 1);
+
+  katana::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = thread_nodes(tid);
+    uint64_t* mine = counts.data() + tid;
+    for (uint64_t e = begin == 0 ? 0 : adj_indices[begin - 1];
+         e < (end == 0 ? 0 : adj_indices[end - 1]); ++e) {
+      ++mine[size_t(dests[e] / block_nodes) * num_threads];
+    }
+  });
+
+  std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), 0UL);
+  for (size_t b = 0; b <= num_blocks; ++b) {
+    block_offsets_[b] = counts[b * num_threads];
+  }
+  KATANA_LOG_DEBUG_ASSERT(block_offsets_[num_blocks] == num_edges);
+
+  katana::on_each([&](unsigned tid, unsigned) {
+    auto [begin, end] = thread_nodes(tid);
+    uint64_t* mine = counts.data() + tid;
+    for (Node src = begin; src < end; ++src) {
+      for (uint64_t e = src == 0 ? 0 : adj_indices[src - 1];
+           e < adj_indices[src]; ++e) {
+        uint64_t& pos = mine[size_t(dests[e] / block_nodes) * num_threads];
+        srcs_[pos] = src;
+        dests_[pos] = dests[e];
+        edges_[pos] = e;
+        ++pos;
+      }
+    }
+  });
+}
@@ -0,0 +1,152 @@
+#include "katana/Frontier.h"
+
+#include <algorithm>
+
+void
+katana::Frontier::Init(size_t num_nodes, uint64_t num_edges) {
+  bitset_.resize(num_nodes);
+  bitset_.reset();
+  sparse_.deallocate();
+  num_edges_ = num_edges;
+  size_ = 0;
+  has_dense_ = false;
+  has_sparse_ = true;
+  pushing_dense_ = false;
+  has_unique_pushes_ = false;
+}
+
+void
+katana::Frontier::Clear(bool dense) {
+  if (has_dense_ || has_unique_pushes_) {
+    if (has_sparse_ && size_ < bitset_.get_vec().size()) {
+      // cheaper to unset the bits one by one than to zero the bitset
+      katana::do_all(
+          katana::iterate(size_t{0}, size_),
+          [&](size_t i) { bitset_.reset(sparse_[i]); }, katana::no_stats());
+    } else {
+      auto& words = bitset_.get_vec();
+      katana::do_all(
+          katana::iterate(size_t{0}, words.size()),
+          [&](size_t w) { words[w] = 0; }, katana::no_stats());
+    }
+  }
+
+  size_ = 0;
+  has_dense_ = dense;
+  has_sparse_ = !dense;
+  pushing_dense_ = dense;
+  has_unique_pushes_ = false;
+}
+
+void
+katana::Frontier::Finish(uint64_t out_degree_sum) {
+  if (pushing_dense_) {
+    size_ = bitset_.count();
+    has_dense_ = true;
+    has_sparse_ = false;
+  } else {
+    GatherPushed();
+    has_sparse_ = true;
+    // nodes pushed with PushUnique are already in the bitset
+    has_dense_ = has_unique_pushes_;
+  }
+  pushing_dense_ = false;
+
+  if (ShouldBeDense(out_degree_sum)) {
+    MakeDense();
+  } else {
+    MakeSparse();
+  }
+}
+
+void
+katana::Frontier::Deduplicate() {
+  MakeDense();
+  size_ = bitset_.count();
+  has_sparse_ = false;
+  MakeSparse();
+}
+
+void
+katana::Frontier::MakeDense() {
+  if (has_dense_) {
+    return;
+  }
+  katana::do_all(
+      katana::iterate(size_t{0}, size_),
+      [&](size_t i) { bitset_.set(sparse_[i]); }, katana::no_stats());
+  has_dense_ = true;
+}
+
+void
+katana::Frontier::MakeSparse() {
+  if (has_sparse_) {
+    return;
+  }
+  ReserveSparse(size_);
+  size_ = bitset_.WriteOffsets(&sparse_);
+  has_sparse_ = true;
+}
+
+void
+katana::Frontier::Fill() {
+  Clear(true);
+  bitset_.bitwise_not();
+  size_ = bitset_.size();
+  pushing_dense_ = false;
+}
+
+bool
+katana::Frontier::ShouldBeDense(uint64_t out_degree_sum) const {
+  if (size_ > num_nodes() / kDenseDivisor) {
+    return true;
+  }
+  return num_edges_ != 0 && size_ + out_degree_sum > num_edges_ / kDenseDivisor;
+}
+
+void
+katana::Frontier::GatherPushed() {
+  std::vector<size_t> offsets(pushed_.size() + 1);
+  for (unsigned i = 0; i < pushed_.size(); ++i) {
+    offsets[i + 1] = offsets[i] + pushed_.getRemote(i)->size();
+  }
+  size_ = offsets.back();
+  ReserveSparse(size_);
+
+  katana::do_all(
+      katana::iterate(0u, pushed_.size()),
+      [&](unsigned i) {
+        std::vector<Node>& pushed = *pushed_.getRemote(i);
+        std::copy(pushed.begin(), pushed.end(), sparse_.data() + offsets[i]);
+        pushed.clear();
+      },
+      katana::no_stats());
+}
+
+void
+katana::Frontier::ReserveSparse(size_t size) {
+  if (sparse_.size() >= size) {
+    return;
+  }
+  // grow geometrically so that a growing frontier is not copied every round
+  size_t capacity = std::max(size, 2 * sparse_.size());
+  sparse_.deallocate();
+  sparse_.allocateBlocked(capacity);
+}
+
+bool
+katana::FrontierDirection::NextIsPull(
+    size_t frontier_size, uint64_t out_degree_sum) {
+  if (!pull_) {
+    if (out_degree_sum > edges_to_check_ / alpha_) {
+      pull_ = true;
+    } else {
+      edges_to_check_ -= std::min(out_degree_sum, edges_to_check_);
+    }
+  } else if (
+      frontier_size < prev_size_ && frontier_size <= num_nodes_ / beta_) {
+    pull_ = false;
+  }
+  prev_size_ = frontier_size;
+  return pull_;
+}
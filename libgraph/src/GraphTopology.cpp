@@ -2,8 +2,12 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <iostream>
 
+#include <boost/container_hash/hash.hpp>
+
+#include "katana/Env.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Random.h"
@@ -464,7 +468,7 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
 
   // ordered map
   std::set<katana::EntityTypeID> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+  for (uint32_t i = 0; i < katana::getActiveThreads(); ++i) {
     auto& edgeTypesSet = *edgeTypes.getRemote(i);
     for (auto edgeType : edgeTypesSet) {
       mergedSet.insert(edgeType);
@@ -609,16 +613,45 @@ katana::EdgeTypeAwareTopology::Make(
       std::move(per_type_adj_indices)});
 }
 
+namespace {
+
+/// \returns the entity types of mgr that have any of the types type_names,
+/// so that whether an entity has one of them is a single lookup
+katana::DynamicBitset
+MakeTypeFilter(
+    const katana::EntityTypeManager& mgr,
+    const std::vector<std::string>& type_names) {
+  katana::DynamicBitset filter;
+  filter.resize(mgr.GetNumEntityTypes());
+
+  std::vector<katana::EntityTypeID> type_ids;
+  for (const auto& name : type_names) {
+    type_ids.emplace_back(mgr.GetEntityTypeID(name));
+  }
+
+  for (size_t t = 0; t < mgr.GetNumEntityTypes(); ++t) {
+    for (auto type_id : type_ids) {
+      if (mgr.IsSubtypeOf(type_id, t)) {
+        filter.set(t);
+        break;
+      }
+    }
+  }
+  return filter;
+}
+
+}  // namespace
+
 /// This function converts a bitset to a bitmask
 void
 katana::ProjectedTopology::FillBitMask(
     size_t num_elements, const katana::DynamicBitset& bitset,
     katana::NUMAArray<uint8_t>* bitmask) {
-  uint32_t num_bytes = (num_elements + 7) / 8;
+  uint64_t num_bytes = (num_elements + 7) / 8;
 
   // TODO(udit) find another way to do the following
   // as it is prone to errors
-  katana::do_all(katana::iterate(uint32_t{0}, num_bytes), [&](uint32_t i) {
+  katana::do_all(katana::iterate(uint64_t{0}, num_bytes), [&](uint64_t i) {
     auto start = i * 8;
     auto end = (i + 1) * 8;
     end = (end > num_elements) ? num_elements : end;
@@ -637,12 +670,13 @@ katana::ProjectedTopology::FillBitMask(
 
 std::shared_ptr<katana::ProjectedTopology>
 katana::ProjectedTopology::CreateEmptyEdgeProjectedTopology(
-    const katana::PropertyGraph* pg, uint32_t num_new_nodes,
+    const katana::PropertyGraph* pg, uint64_t num_new_nodes,
     const katana::DynamicBitset& bitset) {
   const auto& topology = pg->topology();
 
   katana::NUMAArray<Edge> out_indices;
   out_indices.allocateInterleaved(num_new_nodes);
+  katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
 
   katana::NUMAArray<Node> out_dests;
   katana::NUMAArray<Node> original_to_projected_nodes_mapping;
@@ -670,6 +704,7 @@ katana::ProjectedTopology::CreateEmptyEdgeProjectedTopology(
 
   NUMAArray<uint8_t> edge_bitmask;
   edge_bitmask.allocateInterleaved((topology.num_edges() + 7) / 8);
+  katana::ParallelSTL::fill(edge_bitmask.begin(), edge_bitmask.end(), 0);
 
   return std::make_shared<katana::ProjectedTopology>(katana::ProjectedTopology{
       std::move(out_indices), std::move(out_dests),
@@ -689,7 +724,7 @@ katana::ProjectedTopology::CreateEmptyProjectedTopology(
 std::shared_ptr<katana::ProjectedTopology>
 katana::ProjectedTopology::MakeTypeProjectedTopology(
     const katana::PropertyGraph* pg, const std::vector<std::string>& node_types,
-    const std::vector<std::string>& edge_types) {
+    const std::vector<std::string>& edge_types, Kind kind) {
   KATANA_LOG_DEBUG_ASSERT(pg);
 
   const auto& topology = pg->topology();
@@ -697,9 +732,11 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
     return std::make_shared<ProjectedTopology>(ProjectedTopology());
   }
 
-  // calculate number of new nodes
-  uint32_t num_new_nodes = 0;
-  uint32_t num_new_edges = 0;
+  // an empty list of types selects every node or every edge
+  katana::DynamicBitset node_type_filter =
+      MakeTypeFilter(pg->GetNodeTypeManager(), node_types);
+  katana::DynamicBitset edge_type_filter =
+      MakeTypeFilter(pg->GetEdgeTypeManager(), edge_types);
 
   katana::DynamicBitset bitset_nodes;
   bitset_nodes.resize(topology.num_nodes());
@@ -707,62 +744,33 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
   NUMAArray<Node> original_to_projected_nodes_mapping;
   original_to_projected_nodes_mapping.allocateInterleaved(topology.num_nodes());
 
-  if (node_types.empty()) {
-    num_new_nodes = topology.num_nodes();
-    // set all nodes
-    katana::do_all(katana::iterate(topology.all_nodes()), [&](auto src) {
+  // set the entry of each selected node to 1; their prefix sum numbers them
+  katana::do_all(katana::iterate(topology.all_nodes()), [&](auto src) {
+    bool selected = node_types.empty() ||
+                    node_type_filter.test(pg->GetTypeOfNode(src));
+    if (selected) {
       bitset_nodes.set(src);
-      original_to_projected_nodes_mapping[src] = 1;
-    });
-  } else {
-    katana::ParallelSTL::fill(
-        original_to_projected_nodes_mapping.begin(),
-        original_to_projected_nodes_mapping.end(), Node{0});
-
-    std::set<katana::EntityTypeID> node_entity_type_ids;
-
-    for (auto node_type : node_types) {
-      auto entity_type_id = pg->GetNodeEntityTypeID(node_type);
-      node_entity_type_ids.insert(entity_type_id);
-    }
-
-    katana::GAccumulator<uint32_t> accum_num_new_nodes;
-
-    katana::do_all(katana::iterate(topology.all_nodes()), [&](auto src) {
-      for (auto type : node_entity_type_ids) {
-        if (pg->DoesNodeHaveType(src, type)) {
-          accum_num_new_nodes += 1;
-          bitset_nodes.set(src);
-          // this sets the correspondign entry in the array to 1
-          // will perform a prefix sum on this array later on
-          original_to_projected_nodes_mapping[src] = 1;
-          return;
-        }
-      }
-    });
-    num_new_nodes = accum_num_new_nodes.reduce();
-
-    if (num_new_nodes == 0) {
-      // no nodes selected;
-      // return empty graph
-      return CreateEmptyProjectedTopology(pg, bitset_nodes);
     }
-  }
+    original_to_projected_nodes_mapping[src] = selected;
+  });
 
-  // fill old to new nodes mapping
   katana::ParallelSTL::partial_sum(
       original_to_projected_nodes_mapping.begin(),
       original_to_projected_nodes_mapping.end(),
       original_to_projected_nodes_mapping.begin());
 
+  uint64_t num_new_nodes =
+      original_to_projected_nodes_mapping[topology.num_nodes() - 1];
+  if (num_new_nodes == 0) {
+    // no nodes selected;
+    // return empty graph
+    return CreateEmptyProjectedTopology(pg, bitset_nodes);
+  }
+
   NUMAArray<Node> projected_to_original_nodes_mapping;
   projected_to_original_nodes_mapping.allocateInterleaved(num_new_nodes);
 
-  uint32_t num_nodes_bytes = (topology.num_nodes() + 7) / 8;
-
-  NUMAArray<uint8_t> node_bitmask;
-  node_bitmask.allocateInterleaved(num_nodes_bytes);
-
+  // fill old to new nodes mapping
   katana::do_all(katana::iterate(topology.all_nodes()), [&](auto src) {
     if (bitset_nodes.test(src)) {
       original_to_projected_nodes_mapping[src]--;
@@ -773,131 +781,101 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
     }
   });
 
+  NUMAArray<uint8_t> node_bitmask;
+  node_bitmask.allocateInterleaved((topology.num_nodes() + 7) / 8);
   FillBitMask(topology.num_nodes(), bitset_nodes, &node_bitmask);
 
-  // calculate number of new edges
+  // count the selected edges of each selected node into out_indices
   katana::DynamicBitset bitset_edges;
   bitset_edges.resize(topology.num_edges());
 
   NUMAArray<Edge> out_indices;
   out_indices.allocateInterleaved(num_new_nodes);
 
-  // initializes the edge-index array to all zeros
-  katana::ParallelSTL::fill(out_indices.begin(), out_indices.end(), Edge{0});
-
-  if (edge_types.empty()) {
-    katana::GAccumulator<uint32_t> accum_num_new_edges;
-    // set all edges incident to projected nodes
-    katana::do_all(
-        katana::iterate(Node{0}, Node{num_new_nodes}),
-        [&](auto src) {
-          auto old_src = projected_to_original_nodes_mapping[src];
-          for (Edge e : topology.edges(old_src)) {
-            auto dest = topology.edge_dest(e);
-            if (bitset_nodes.test(dest)) {
-              bitset_edges.set(e);
-              out_indices[src] += 1;
-              accum_num_new_edges += 1;
-            }
-          }
-        },
-        katana::steal());
-
-    num_new_edges = accum_num_new_edges.reduce();
-  } else {
-    std::set<katana::EntityTypeID> edge_entity_type_ids;
+  // edges out of the selected nodes, which a lazy projection scans
+  katana::GAccumulator<uint64_t> accum_scanned_edges;
 
-    for (auto edge_type : edge_types) {
-      auto entity_type_id = pg->GetEdgeEntityTypeID(edge_type);
-      edge_entity_type_ids.insert(entity_type_id);
-    }
-
-    katana::GAccumulator<uint32_t> accum_num_new_edges;
-
-    katana::do_all(
-        katana::iterate(Node{0}, Node{num_new_nodes}),
-        [&](auto src) {
-          auto old_src = projected_to_original_nodes_mapping[src];
-
-          for (Edge e : topology.edges(old_src)) {
-            auto dest = topology.edge_dest(e);
-            if (bitset_nodes.test(dest)) {
-              for (auto type : edge_entity_type_ids) {
-                if (pg->DoesEdgeHaveType(e, type)) {
-                  accum_num_new_edges += 1;
-                  bitset_edges.set(e);
-                  out_indices[src] += 1;
-                  break;
-                }
-              }
-            }
+  katana::do_all(
+      katana::iterate(Node{0}, static_cast<Node>(num_new_nodes)),
+      [&](Node src) {
+        auto old_src = projected_to_original_nodes_mapping[src];
+        Edge num_selected = 0;
+        for (Edge e : topology.edges(old_src)) {
+          if (bitset_nodes.test(topology.edge_dest(e)) &&
+              (edge_types.empty() ||
+               edge_type_filter.test(pg->GetTypeOfEdge(e)))) {
+            bitset_edges.set(e);
+            ++num_selected;
           }
-        },
-        katana::steal());
+        }
+        out_indices[src] = num_selected;
+        accum_scanned_edges += topology.degree(old_src);
+      },
+      katana::steal());
 
-    num_new_edges = accum_num_new_edges.reduce();
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
 
-    if (num_new_edges == 0) {
-      // no edge selected
-      // return empty graph with only selected nodes
-      return CreateEmptyEdgeProjectedTopology(pg, num_new_nodes, bitset_nodes);
-    }
+  uint64_t num_new_edges = out_indices[num_new_nodes - 1];
+  if (num_new_edges == 0) {
+    // no edge selected
+    // return empty graph with only selected nodes
+    return CreateEmptyEdgeProjectedTopology(pg, num_new_nodes, bitset_nodes);
   }
 
-  // Prefix sum calculation of the edge index array
-  katana::ParallelSTL::partial_sum(
-      out_indices.begin(), out_indices.end(), out_indices.begin());
+  NUMAArray<uint8_t> edge_bitmask;
+  edge_bitmask.allocateInterleaved((topology.num_edges() + 7) / 8);
+  FillBitMask(topology.num_edges(), bitset_edges, &edge_bitmask);
 
-  NUMAArray<Edge> out_dests_offset;
-  out_dests_offset.allocateInterleaved(num_new_nodes);
+  if (kind == Kind::kAuto) {
+    kind = ChooseKind(
+        topology.num_edges(), accum_scanned_edges.reduce(), num_new_edges);
+  }
 
-  // temporary buffer for storing the starting point of each node's
-  // adjacency
-  out_dests_offset[0] = 0;
-  katana::do_all(
-      katana::iterate(Node{1}, Node{num_new_nodes}),
-      [&](Node n) { out_dests_offset[n] = out_indices[n - 1]; },
-      katana::no_stats());
+  if (kind == Kind::kLazy) {
+    return std::make_shared<ProjectedTopology>(ProjectedTopology{
+        pg->topology_, num_new_edges,
+        std::move(original_to_projected_nodes_mapping),
+        std::move(projected_to_original_nodes_mapping), std::move(node_bitmask),
+        std::move(edge_bitmask)});
+  }
 
   NUMAArray<Node> out_dests;
   NUMAArray<Edge> original_to_projected_edges_mapping;
   NUMAArray<Edge> projected_to_original_edges_mapping;
-  NUMAArray<uint8_t> edge_bitmask;
 
   out_dests.allocateInterleaved(num_new_edges);
   original_to_projected_edges_mapping.allocateInterleaved(topology.num_edges());
   projected_to_original_edges_mapping.allocateInterleaved(num_new_edges);
-  edge_bitmask.allocateInterleaved((topology.num_edges() + 7) / 8);
 
-  // Update out_dests with the new destination ids
+  // scatter the selected edges of each node to where the prefix sum puts
+  // them; every original edge gets its entry in the edge mapping here
   katana::do_all(
-      katana::iterate(Node{0}, Node{num_new_nodes}),
-      [&](Node n) {
-        auto src = projected_to_original_nodes_mapping[n];
+      katana::iterate(topology.all_nodes()),
+      [&](Node src) {
+        if (!bitset_nodes.test(src)) {
+          for (Edge e : topology.edges(src)) {
+            original_to_projected_edges_mapping[e] = topology.num_edges();
+          }
+          return;
+        }
 
+        auto n = original_to_projected_nodes_mapping[src];
+        Edge e_new = n != 0 ? out_indices[n - 1] : 0;
         for (Edge e : topology.edges(src)) {
-          if (bitset_edges.test(e)) {
-            auto e_new = out_dests_offset[n];
-            out_dests_offset[n]++;
-
-            auto dest = topology.edge_dest(e);
-            dest = original_to_projected_nodes_mapping[dest];
-            out_dests[e_new] = dest;
-
-            original_to_projected_edges_mapping[e] = e_new;
-            projected_to_original_edges_mapping[e_new] = e;
+          if (!bitset_edges.test(e)) {
+            original_to_projected_edges_mapping[e] = topology.num_edges();
+            continue;
           }
+          out_dests[e_new] =
+              original_to_projected_nodes_mapping[topology.edge_dest(e)];
+          original_to_projected_edges_mapping[e] = e_new;
+          projected_to_original_edges_mapping[e_new] = e;
+          ++e_new;
         }
       },
       katana::steal());
 
-  katana::do_all(katana::iterate(topology.all_edges()), [&](auto edge) {
-    if (!bitset_edges.test(edge)) {
-      original_to_projected_edges_mapping[edge] = topology.num_edges();
-    }
-  });
-
-  FillBitMask(topology.num_edges(), bitset_edges, &edge_bitmask);
   return std::make_shared<ProjectedTopology>(ProjectedTopology{
       std::move(out_indices), std::move(out_dests),
       std::move(original_to_projected_nodes_mapping),
@@ -906,6 +884,179 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
       std::move(projected_to_original_edges_mapping), std::move(node_bitmask),
       std::move(edge_bitmask)});
 }
+
+katana::ProjectedTopology::Kind
+katana::ProjectedTopology::ChooseKind(
+    uint64_t num_edges, uint64_t scanned_edges,
+    uint64_t selected_edges) noexcept {
+  // materializing reads every original edge and writes the CSR and both edge
+  // mappings; a lazy traversal reads every edge of the selected nodes
+  uint64_t materialize_cost = num_edges + 3 * selected_edges;
+  uint64_t lazy_cost = kExpectedTraversals * scanned_edges;
+  return lazy_cost < materialize_cost ? Kind::kLazy : Kind::kMaterialized;
+}
+
+katana::PGViewCacheKey
+katana::PGViewCacheKey::Make(
+    ViewKind kind, tsuba::RDGTopology::TransposeKind transpose_kind,
+    tsuba::RDGTopology::EdgeSortKind edge_sort_kind,
+    tsuba::RDGTopology::NodeSortKind node_sort_kind) {
+  PGViewCacheKey key;
+  key.kind = kind;
+  key.transpose_kind = transpose_kind;
+  key.edge_sort_kind = edge_sort_kind;
+  key.node_sort_kind = node_sort_kind;
+  return key;
+}
+
+katana::PGViewCacheKey
+katana::PGViewCacheKey::MakeProjected(
+    std::vector<std::string> node_types, std::vector<std::string> edge_types,
+    ProjectedTopology::Kind projection_kind) {
+  PGViewCacheKey key;
+  key.kind = ViewKind::kProjectedTopology;
+  std::sort(node_types.begin(), node_types.end());
+  node_types.erase(
+      std::unique(node_types.begin(), node_types.end()), node_types.end());
+  std::sort(edge_types.begin(), edge_types.end());
+  edge_types.erase(
+      std::unique(edge_types.begin(), edge_types.end()), edge_types.end());
+  key.node_types = std::move(node_types);
+  key.edge_types = std::move(edge_types);
+  key.projection_kind = projection_kind;
+  return key;
+}
+
+size_t
+katana::PGViewCacheKey::Hash::operator()(
+    const katana::PGViewCacheKey& key) const {
+  size_t seed = 0;
+  boost::hash_combine(seed, static_cast<int>(key.kind));
+  boost::hash_combine(seed, static_cast<int>(key.transpose_kind));
+  boost::hash_combine(seed, static_cast<int>(key.edge_sort_kind));
+  boost::hash_combine(seed, static_cast<int>(key.node_sort_kind));
+  boost::hash_combine(seed, key.node_types);
+  boost::hash_combine(seed, key.edge_types);
+  boost::hash_combine(seed, static_cast<int>(key.projection_kind));
+  return seed;
+}
+
+namespace {
+
+using ViewKind = katana::PGViewCacheKey::ViewKind;
+
+size_t
+PGViewCacheBudgetFromEnv() {
+  int budget_mb = 0;
+  if (katana::GetEnv(katana::PGViewCache::kBudgetEnvVar, &budget_mb) &&
+      budget_mb > 0) {
+    return size_t(budget_mb) << 20U;
+  }
+  return std::numeric_limits<size_t>::max();
+}
+
+/// The keys of the cached topologies that satisfy a request for the given
+/// states, where kAny matches topologies in any state; the exact key is first
+std::vector<katana::PGViewCacheKey>
+MatchingKeys(
+    ViewKind kind, tsuba::RDGTopology::TransposeKind transpose_kind,
+    tsuba::RDGTopology::EdgeSortKind edge_sort_kind,
+    tsuba::RDGTopology::NodeSortKind node_sort_kind) {
+  using EdgeSortKind = tsuba::RDGTopology::EdgeSortKind;
+  using NodeSortKind = tsuba::RDGTopology::NodeSortKind;
+
+  std::vector<EdgeSortKind> edge_sorts{edge_sort_kind};
+  if (edge_sort_kind == EdgeSortKind::kAny) {
+    edge_sorts.insert(
+        edge_sorts.end(),
+        {EdgeSortKind::kSortedByDestID, EdgeSortKind::kSortedByEdgeType,
+         EdgeSortKind::kSortedByNodeType});
+  }
+  std::vector<NodeSortKind> node_sorts{node_sort_kind};
+  if (node_sort_kind == NodeSortKind::kAny) {
+    node_sorts.insert(
+        node_sorts.end(),
+        {NodeSortKind::kSortedByDegree, NodeSortKind::kSortedByNodeType});
+  }
+
+  std::vector<katana::PGViewCacheKey> keys;
+  for (auto node_sort : node_sorts) {
+    for (auto edge_sort : edge_sorts) {
+      keys.emplace_back(katana::PGViewCacheKey::Make(
+          kind, transpose_kind, edge_sort, node_sort));
+    }
+  }
+  return keys;
+}
+
+size_t
+ApproxBytes(const katana::EdgeShuffleTopology& topo) {
+  using T = katana::GraphTopologyTypes;
+  return topo.num_nodes() * sizeof(T::Edge) +
+         topo.num_edges() * (sizeof(T::Node) + sizeof(T::PropertyIndex));
+}
+
+size_t
+ApproxBytes(const katana::ShuffleTopology& topo) {
+  using T = katana::GraphTopologyTypes;
+  return ApproxBytes(static_cast<const katana::EdgeShuffleTopology&>(topo)) +
+         topo.num_nodes() * sizeof(T::PropertyIndex);
+}
+
+size_t
+ApproxBytes(
+    const katana::EdgeTypeAwareTopology& topo,
+    const katana::CondensedTypeIDMap& edge_type_index) {
+  // the edges themselves belong to the EdgeShuffleTopology it is built on,
+  // which the cache keeps more recently used than this topology
+  using T = katana::GraphTopologyTypes;
+  return topo.num_nodes() * edge_type_index.num_unique_types() *
+         sizeof(T::Edge);
+}
+
+size_t
+ApproxBytes(
+    const katana::ProjectedTopology& topo, const katana::PropertyGraph* pg) {
+  using T = katana::GraphTopologyTypes;
+  if (topo.is_lazy()) {
+    // the node mappings and the bitmasks; the edges belong to pg
+    return (topo.num_nodes() + pg->num_nodes()) * sizeof(T::Node) +
+           (pg->num_nodes() + pg->num_edges()) / 8;
+  }
+  // the CSR and the mappings in both directions; the bitmasks are small
+  return topo.num_nodes() * (sizeof(T::Edge) + sizeof(T::Node)) +
+         topo.num_edges() * (sizeof(T::Node) + sizeof(T::Edge)) +
+         pg->num_nodes() * sizeof(T::Node) + pg->num_edges() * sizeof(T::Edge);
+}
+
+}  // namespace
+
+katana::PGViewCache::PGViewCache() : PGViewCache(PGViewCacheBudgetFromEnv()) {}
+
+size_t
+katana::PGViewCache::PersistBytesFromEnv() {
+  int persist_mb = 0;
+  if (katana::GetEnv(kPersistEnvVar, &persist_mb) && persist_mb >= 0) {
+    return size_t(persist_mb) << 20U;
+  }
+  return std::numeric_limits<size_t>::max();
+}
+
+katana::PGViewCache::PGViewCache(size_t budget_bytes)
+    : views_(budget_bytes, [](const Entry& entry) { return entry.bytes; }) {}
+
+std::optional<katana::PGViewCache::Entry>
+katana::PGViewCache::Find(const std::vector<PGViewCacheKey>& keys) {
+  KATANA_LOG_DEBUG_ASSERT(!keys.empty());
+  for (const auto& key : keys) {
+    // Contains does not count as a lookup, so a request is one hit or miss
+    if (views_.Contains(key)) {
+      return views_.Get(key);
+    }
+  }
+  return views_.Get(keys.front());
+}
+
 std::shared_ptr<katana::GraphTopology>
 katana::PGViewCache::GetOriginalTopology(
     const PropertyGraph* pg) const noexcept {
@@ -937,36 +1088,46 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopo(
     const tsuba::RDGTopology::TransposeKind& tpose_kind,
     const tsuba::RDGTopology::EdgeSortKind& sort_kind) noexcept {
   // try to find a matching topology in the cache
-  auto pred = [&](const auto& topo_ptr) {
-    return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
-           topo_ptr->has_edges_sorted_by(sort_kind);
-  };
-  auto it =
-      std::find_if(edge_shuff_topos_.begin(), edge_shuff_topos_.end(), pred);
-
-  if (it != edge_shuff_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return *it;
-  } else {
-    // no matching topology in cache, see if we have it in storage
-    tsuba::RDGTopology shadow = tsuba::RDGTopology::MakeShadow(
-        tsuba::RDGTopology::TopologyKind::kEdgeShuffleTopology, tpose_kind,
-        sort_kind, tsuba::RDGTopology::NodeSortKind::kAny);
-
-    auto res = pg->LoadTopology(std::move(shadow));
-    if (!res) {
-      // no matching topology in cache or storage, generate it
-      edge_shuff_topos_.emplace_back(
-          EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind));
-    } else {
-      // found matching topology in storage
-      tsuba::RDGTopology* topo = res.value();
-      edge_shuff_topos_.emplace_back(katana::EdgeShuffleTopology::Make(topo));
+  auto keys = MatchingKeys(
+      ViewKind::kEdgeShuffleTopology, tpose_kind, sort_kind,
+      tsuba::RDGTopology::NodeSortKind::kAny);
+  auto found = Find(keys);
+  if (found) {
+    auto topo = std::get<std::shared_ptr<EdgeShuffleTopology>>(found->view);
+    if (topo->is_valid()) {
+      KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+      return topo;
     }
+  }
+
+  // no matching topology in cache, see if we have it in storage
+  tsuba::RDGTopology shadow = tsuba::RDGTopology::MakeShadow(
+      tsuba::RDGTopology::TopologyKind::kEdgeShuffleTopology, tpose_kind,
+      sort_kind, tsuba::RDGTopology::NodeSortKind::kAny);
 
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, edge_shuff_topos_.back().get()));
-    return edge_shuff_topos_.back();
+  std::shared_ptr<EdgeShuffleTopology> topo;
+  auto res = pg->LoadTopology(std::move(shadow));
+  if (!res) {
+    // no matching topology in cache or storage, generate it
+    topo = EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind);
+  } else {
+    // found matching topology in storage
+    topo = katana::EdgeShuffleTopology::Make(res.value());
   }
+
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  InsertEdgeShuffTopo(topo);
+  return topo;
+}
+
+void
+katana::PGViewCache::InsertEdgeShuffTopo(
+    const std::shared_ptr<EdgeShuffleTopology>& topo) {
+  views_.Insert(
+      PGViewCacheKey::Make(
+          ViewKind::kEdgeShuffleTopology, topo->transpose_state(),
+          topo->edge_sort_state(), tsuba::RDGTopology::NodeSortKind::kAny),
+      Entry{topo, ApproxBytes(*topo)});
 }
 
 std::shared_ptr<katana::ShuffleTopology>
@@ -976,49 +1137,50 @@ katana::PGViewCache::BuildOrGetShuffTopo(
     const tsuba::RDGTopology::NodeSortKind& node_sort_todo,
     const tsuba::RDGTopology::EdgeSortKind& edge_sort_todo) noexcept {
   // try to find a matching topology in the cache
-  auto pred = [&](const auto& topo_ptr) {
-    return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind) &&
-           topo_ptr->has_edges_sorted_by(edge_sort_todo) &&
-           topo_ptr->has_nodes_sorted_by(node_sort_todo);
-  };
-
-  auto it =
-      std::find_if(fully_shuff_topos_.begin(), fully_shuff_topos_.end(), pred);
-
-  if (it != fully_shuff_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return *it;
-  } else {
-    // no matching topology in cache, see if we have it in storage
-
-    tsuba::RDGTopology shadow = tsuba::RDGTopology::MakeShadow(
-        tsuba::RDGTopology::TopologyKind::kShuffleTopology, tpose_kind,
-        edge_sort_todo, node_sort_todo);
-    auto res = pg->LoadTopology(std::move(shadow));
+  auto keys = MatchingKeys(
+      ViewKind::kShuffleTopology, tpose_kind, edge_sort_todo, node_sort_todo);
+  auto found = Find(keys);
+  if (found) {
+    auto topo = std::get<std::shared_ptr<ShuffleTopology>>(found->view);
+    if (topo->is_valid()) {
+      KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+      return topo;
+    }
+  }
 
-    if (!res) {
-      // no matching topology in cache or storage, generate it
+  // no matching topology in cache, see if we have it in storage
+  tsuba::RDGTopology shadow = tsuba::RDGTopology::MakeShadow(
+      tsuba::RDGTopology::TopologyKind::kShuffleTopology, tpose_kind,
+      edge_sort_todo, node_sort_todo);
+  auto res = pg->LoadTopology(std::move(shadow));
 
-      // EdgeShuffleTopology e_topo below is going to serve as a seed for
-      // ShuffleTopology, so we only care about transpose state, and not the sort
-      // state. Because, when creating ShuffleTopology, once we shuffle the nodes, we
-      // will need to re-sort the edges even if they were already sorted
-      auto e_topo = BuildOrGetEdgeShuffTopo(
-          pg, tpose_kind, tsuba::RDGTopology::EdgeSortKind::kAny);
-      KATANA_LOG_DEBUG_ASSERT(e_topo->has_transpose_state(tpose_kind));
+  std::shared_ptr<ShuffleTopology> topo;
+  if (!res) {
+    // no matching topology in cache or storage, generate it
 
-      fully_shuff_topos_.emplace_back(ShuffleTopology::MakeFromTopo(
-          pg, *e_topo, node_sort_todo, edge_sort_todo));
+    // EdgeShuffleTopology e_topo below is going to serve as a seed for
+    // ShuffleTopology, so we only care about transpose state, and not the sort
+    // state. Because, when creating ShuffleTopology, once we shuffle the nodes, we
+    // will need to re-sort the edges even if they were already sorted
+    auto e_topo = BuildOrGetEdgeShuffTopo(
+        pg, tpose_kind, tsuba::RDGTopology::EdgeSortKind::kAny);
+    KATANA_LOG_DEBUG_ASSERT(e_topo->has_transpose_state(tpose_kind));
 
-    } else {
-      // found matching topology in storage
-      tsuba::RDGTopology* topo = res.value();
-      fully_shuff_topos_.emplace_back(katana::ShuffleTopology::Make(topo));
-    }
+    topo = ShuffleTopology::MakeFromTopo(
+        pg, *e_topo, node_sort_todo, edge_sort_todo);
 
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, fully_shuff_topos_.back().get()));
-    return fully_shuff_topos_.back();
+  } else {
+    // found matching topology in storage
+    topo = katana::ShuffleTopology::Make(res.value());
   }
+
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  views_.Insert(
+      PGViewCacheKey::Make(
+          ViewKind::kShuffleTopology, topo->transpose_state(),
+          topo->edge_sort_state(), topo->node_sort_state()),
+      Entry{topo, ApproxBytes(*topo)});
+  return topo;
 }
 
 std::shared_ptr<katana::EdgeTypeAwareTopology>
@@ -1026,86 +1188,123 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
     katana::PropertyGraph* pg,
     const tsuba::RDGTopology::TransposeKind& tpose_kind) noexcept {
   // try to find a matching topology in the cache
-  auto pred = [&](const auto& topo_ptr) {
-    return topo_ptr->is_valid() && topo_ptr->has_transpose_state(tpose_kind);
-  };
-  auto it = std::find_if(
-      edge_type_aware_topos_.begin(), edge_type_aware_topos_.end(), pred);
-
-  if (it != edge_type_aware_topos_.end()) {
-    KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
-    return *it;
-  } else {
-    // no matching topology in cache, see if we have it in storage
-
-    tsuba::RDGTopology shadow = tsuba::RDGTopology::MakeShadow(
-        tsuba::RDGTopology::TopologyKind::kEdgeTypeAwareTopology, tpose_kind,
-        tsuba::RDGTopology::EdgeSortKind::kSortedByEdgeType,
-        tsuba::RDGTopology::NodeSortKind::kAny);
-    auto res = pg->LoadTopology(std::move(shadow));
-
-    // In either generation, or loading, the EdgeTypeAwareTopology depends on an EdgeShuffleTopology
-    auto sorted_topo = BuildOrGetEdgeShuffTopo(
-        pg, tpose_kind, tsuba::RDGTopology::EdgeSortKind::kSortedByEdgeType);
-
-    // There are two use cases for the EdgeTypeIndex, either we:
-    // Are generating an EdgeTypeAwareTopology, and need the EdgeTypeIndex
-    // Are loading an EdgeTypeAwareTopology from storage, and need to confirm
-    // the EdgeTypeIndex in storage matches the one we have.
-    // If it doesn't match, then the EdgeTypeAwareTopology on storage is out of date and cannot be used
-    auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
-
-    if (res) {
-      // found matching topology in storage
-      tsuba::RDGTopology* rdg_topo = res.value();
-
-      edge_type_aware_topos_.emplace_back(katana::EdgeTypeAwareTopology::Make(
-          rdg_topo, std::move(edge_type_index), std::move(sorted_topo)));
-    } else {
-      // no matching topology in cache or storage, generate it
-      edge_type_aware_topos_.emplace_back(EdgeTypeAwareTopology::MakeFrom(
-          pg, std::move(edge_type_index), std::move(sorted_topo)));
+  auto key = PGViewCacheKey::Make(
+      ViewKind::kEdgeTypeAwareTopology, tpose_kind,
+      tsuba::RDGTopology::EdgeSortKind::kSortedByEdgeType,
+      tsuba::RDGTopology::NodeSortKind::kAny);
+  auto found = Find({key});
+  if (found) {
+    auto topo = std::get<std::shared_ptr<EdgeTypeAwareTopology>>(found->view);
+    if (topo->is_valid()) {
+      KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+      // keep the sorted topology it holds at least as recently used, so that
+      // it is cached, and counted, as long as this topology is
+      InsertEdgeShuffTopo(topo->edge_shuffle_topology());
+      return topo;
     }
+  }
+
+  // no matching topology in cache, see if we have it in storage
+
+  tsuba::RDGTopology shadow = tsuba::RDGTopology::MakeShadow(
+      tsuba::RDGTopology::TopologyKind::kEdgeTypeAwareTopology, tpose_kind,
+      tsuba::RDGTopology::EdgeSortKind::kSortedByEdgeType,
+      tsuba::RDGTopology::NodeSortKind::kAny);
+  auto res = pg->LoadTopology(std::move(shadow));
+
+  // In either generation, or loading, the EdgeTypeAwareTopology depends on an EdgeShuffleTopology
+  auto sorted_topo = BuildOrGetEdgeShuffTopo(
+      pg, tpose_kind, tsuba::RDGTopology::EdgeSortKind::kSortedByEdgeType);
+
+  // There are two use cases for the EdgeTypeIndex, either we:
+  // Are generating an EdgeTypeAwareTopology, and need the EdgeTypeIndex
+  // Are loading an EdgeTypeAwareTopology from storage, and need to confirm
+  // the EdgeTypeIndex in storage matches the one we have.
+  // If it doesn't match, then the EdgeTypeAwareTopology on storage is out of date and cannot be used
+  auto edge_type_index = BuildOrGetEdgeTypeIndex(pg);
+
+  std::shared_ptr<EdgeTypeAwareTopology> topo;
+  if (res) {
+    // found matching topology in storage
+    tsuba::RDGTopology* rdg_topo = res.value();
 
-    KATANA_LOG_DEBUG_ASSERT(
-        CheckTopology(pg, edge_type_aware_topos_.back().get()));
-    return edge_type_aware_topos_.back();
+    topo = katana::EdgeTypeAwareTopology::Make(
+        rdg_topo, edge_type_index, std::move(sorted_topo));
+  } else {
+    // no matching topology in cache or storage, generate it
+    topo = EdgeTypeAwareTopology::MakeFrom(
+        pg, edge_type_index, std::move(sorted_topo));
   }
+
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, topo.get()));
+  views_.Insert(key, Entry{topo, ApproxBytes(*topo, *edge_type_index)});
+  InsertEdgeShuffTopo(topo->edge_shuffle_topology());
+  return topo;
 }
 
 std::shared_ptr<katana::ProjectedTopology>
 katana::PGViewCache::BuildOrGetProjectedGraphTopo(
     const PropertyGraph* pg, const std::vector<std::string>& node_types,
-    const std::vector<std::string>& edge_types) noexcept {
-  if (projected_topos_) {
-    return projected_topos_;
+    const std::vector<std::string>& edge_types,
+    ProjectedTopology::Kind kind) noexcept {
+  using Kind = ProjectedTopology::Kind;
+  auto make_key = [&](Kind k) {
+    return PGViewCacheKey::MakeProjected(node_types, edge_types, k);
+  };
+  // kAuto is keyed by the kind that ChooseKind picked, so it takes either;
+  // an explicit kind keeps its own key because projections without edges are
+  // materialized whatever kind asks for
+  std::vector<PGViewCacheKey> keys;
+  if (kind == Kind::kAuto) {
+    keys = {make_key(Kind::kMaterialized), make_key(Kind::kLazy)};
+  } else {
+    keys = {make_key(kind)};
+  }
+  auto found = Find(keys);
+  if (found) {
+    return std::get<std::shared_ptr<ProjectedTopology>>(found->view);
   }
 
-  projected_topos_ =
-      ProjectedTopology::MakeTypeProjectedTopology(pg, node_types, edge_types);
-  KATANA_LOG_DEBUG_ASSERT(projected_topos_);
-  return projected_topos_;
+  auto topo = ProjectedTopology::MakeTypeProjectedTopology(
+      pg, node_types, edge_types, kind);
+  KATANA_LOG_DEBUG_ASSERT(topo);
+  if (kind == Kind::kAuto) {
+    kind = topo->is_lazy() ? Kind::kLazy : Kind::kMaterialized;
+  }
+  views_.Insert(make_key(kind), Entry{topo, ApproxBytes(*topo, pg)});
+  return topo;
 }
 
 katana::Result<std::vector<tsuba::RDGTopology>>
-katana::PGViewCache::ToRDGTopology() {
-  std::vector<tsuba::RDGTopology> rdg_topos;
-
-  for (size_t i = 0; i < edge_shuff_topos_.size(); i++) {
-    tsuba::RDGTopology topo =
-        KATANA_CHECKED(edge_shuff_topos_[i]->ToRDGTopology());
-    rdg_topos.emplace_back(std::move(topo));
-  }
+katana::PGViewCache::ToRDGTopology(size_t max_bytes) {
+  // collect the topologies first: ToRDGTopology cannot fail inside ForEach
+  std::vector<View> views;
+  size_t bytes = 0;
+  views_.ForEach([&](const PGViewCacheKey& key, const Entry& entry) {
+    // projected topologies cannot be stored
+    if (key.kind == ViewKind::kProjectedTopology ||
+        bytes + entry.bytes > max_bytes) {
+      return;
+    }
+    bytes += entry.bytes;
+    views.emplace_back(entry.view);
+  });
 
-  for (size_t i = 0; i < fully_shuff_topos_.size(); i++) {
-    tsuba::RDGTopology topo =
-        KATANA_CHECKED(fully_shuff_topos_[i]->ToRDGTopology());
-    rdg_topos.emplace_back(std::move(topo));
-  }
+  auto to_rdg_topology =
+      [](const auto& topo_ptr) -> katana::Result<tsuba::RDGTopology> {
+    using Topo = typename std::decay_t<decltype(topo_ptr)>::element_type;
+    if constexpr (std::is_same_v<Topo, ProjectedTopology>) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "projected topologies cannot be stored");
+    } else {
+      return topo_ptr->ToRDGTopology();
+    }
+  };
 
-  for (size_t i = 0; i < edge_type_aware_topos_.size(); i++) {
+  std::vector<tsuba::RDGTopology> rdg_topos;
+  for (const View& view : views) {
     tsuba::RDGTopology topo =
-        KATANA_CHECKED(edge_type_aware_topos_[i]->ToRDGTopology());
+        KATANA_CHECKED(std::visit(to_rdg_topology, view));
     rdg_topos.emplace_back(std::move(topo));
   }
 
@@ -390,8 +390,10 @@ katana::PropertyGraph::DoWriteTopologies() {
 
   rdg_.UpsertTopology(std::move(shadow));
 
-  std::vector<tsuba::RDGTopology> topologies =
-      KATANA_CHECKED(pg_view_cache_.ToRDGTopology());
+  // only the most recently used topologies are worth the space if the write
+  // is limited
+  std::vector<tsuba::RDGTopology> topologies = KATANA_CHECKED(
+      pg_view_cache_.ToRDGTopology(PGViewCache::PersistBytesFromEnv()));
   for (size_t i = 0; i < topologies.size(); i++) {
     rdg_.UpsertTopology(std::move(topologies.at(i)));
   }
@@ -429,6 +431,22 @@ katana::PropertyGraph::DoWrite(
           ? KATANA_CHECKED(WriteEntityTypeIDsArray(edge_entity_type_ids_))
           : nullptr;
 
+  // Persist indexes that storage does not already hold for the current
+  // version of their property.
+  bool same_dir = tsuba::GetRDGDir(handle) == rdg_.rdg_dir();
+  for (const auto& index : node_indexes_) {
+    if (!same_dir || !rdg_.HasNodePropertyIndex(index->column_name())) {
+      rdg_.AddNodePropertyIndex(
+          index->column_name(), KATANA_CHECKED(index->ToFileFrame()));
+    }
+  }
+  for (const auto& index : edge_indexes_) {
+    if (!same_dir || !rdg_.HasEdgePropertyIndex(index->column_name())) {
+      rdg_.AddEdgePropertyIndex(
+          index->column_name(), KATANA_CHECKED(index->ToFileFrame()));
+    }
+  }
+
   return rdg_.Store(
       handle, command_line, versioning_action,
       std::move(node_entity_type_id_array_res),
@@ -777,11 +795,27 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_nodes(), props->num_rows());
   }
-  return rdg_.UpsertNodeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_.UpsertNodeProperties(props, txn_ctx));
+
+  // Indexes over replaced columns still refer to the old values.
+  for (const auto& field : props->fields()) {
+    if (HasNodePropertyIndex(field->name())) {
+      PropertyIndexKind kind =
+          KATANA_CHECKED(GetNodePropertyIndex(field->name()))->kind();
+      KATANA_CHECKED(DeleteNodeIndex(field->name()));
+      KATANA_CHECKED(MakeNodeIndex(field->name(), kind));
+    }
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i) {
+  const auto& props = rdg_.node_properties();
+  if (i >= 0 && i < props->num_columns() &&
+      HasNodePropertyIndex(props->field(i)->name())) {
+    KATANA_CHECKED(DeleteNodeIndex(props->field(i)->name()));
+  }
   return rdg_.RemoveNodeProperty(i);
 }
 
@@ -790,7 +824,7 @@ katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
   auto col_names = rdg_.node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -841,11 +875,27 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().num_edges(), props->num_rows());
   }
-  return rdg_.UpsertEdgeProperties(props, txn_ctx);
+  KATANA_CHECKED(rdg_.UpsertEdgeProperties(props, txn_ctx));
+
+  // Indexes over replaced columns still refer to the old values.
+  for (const auto& field : props->fields()) {
+    if (HasEdgePropertyIndex(field->name())) {
+      PropertyIndexKind kind =
+          KATANA_CHECKED(GetEdgePropertyIndex(field->name()))->kind();
+      KATANA_CHECKED(DeleteEdgeIndex(field->name()));
+      KATANA_CHECKED(MakeEdgeIndex(field->name(), kind));
+    }
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i) {
+  const auto& props = rdg_.edge_properties();
+  if (i >= 0 && i < props->num_columns() &&
+      HasEdgePropertyIndex(props->field(i)->name())) {
+    KATANA_CHECKED(DeleteEdgeIndex(props->field(i)->name()));
+  }
   return rdg_.RemoveEdgeProperty(i);
 }
 
@@ -854,7 +904,7 @@ katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
   auto col_names = rdg_.edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
+    return RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
 }
@@ -881,7 +931,8 @@ katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
 
 // Build an index over nodes.
 katana::Result<void>
-katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
+katana::PropertyGraph::MakeNodeIndex(
+    const std::string& column_name, PropertyIndexKind kind) {
   for (const auto& existing_index : node_indexes_) {
     if (existing_index->column_name() == column_name) {
       return KATANA_ERROR(
@@ -899,7 +950,22 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
   // Create an index based on the type of the field.
   std::unique_ptr<katana::PropertyIndex<GraphTopology::Node>> index =
       KATANA_CHECKED(katana::MakeTypedIndex<katana::GraphTopology::Node>(
-          column_name, num_nodes(), property));
+          column_name, num_nodes(), property, kind));
+
+  // Prefer an index persisted with the graph; it only needs to be mapped.
+  if (rdg_.HasNodePropertyIndex(column_name)) {
+    auto loaded = [&]() -> katana::Result<void> {
+      auto file = KATANA_CHECKED(rdg_.LoadNodePropertyIndex(column_name));
+      return index->BuildFromFile(std::move(file));
+    }();
+    if (loaded) {
+      node_indexes_.push_back(std::move(index));
+      return katana::ResultSuccess();
+    }
+    KATANA_LOG_WARN(
+        "could not load stored index for node property {}, rebuilding: {}",
+        column_name, loaded.error());
+  }
 
   KATANA_CHECKED(index->BuildFromProperty());
 
@@ -921,7 +987,8 @@ katana::PropertyGraph::DeleteNodeIndex(const std::string& column_name) {
 
 // Build an index over edges.
 katana::Result<void>
-katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
+katana::PropertyGraph::MakeEdgeIndex(
+    const std::string& column_name, PropertyIndexKind kind) {
   for (const auto& existing_index : edge_indexes_) {
     if (existing_index->column_name() == column_name) {
       return KATANA_ERROR(
@@ -939,7 +1006,22 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
   // Create an index based on the type of the field.
   std::unique_ptr<katana::PropertyIndex<katana::GraphTopology::Edge>> index =
       KATANA_CHECKED(katana::MakeTypedIndex<katana::GraphTopology::Edge>(
-          column_name, num_edges(), property));
+          column_name, num_edges(), property, kind));
+
+  // Prefer an index persisted with the graph; it only needs to be mapped.
+  if (rdg_.HasEdgePropertyIndex(column_name)) {
+    auto loaded = [&]() -> katana::Result<void> {
+      auto file = KATANA_CHECKED(rdg_.LoadEdgePropertyIndex(column_name));
+      return index->BuildFromFile(std::move(file));
+    }();
+    if (loaded) {
+      edge_indexes_.push_back(std::move(index));
+      return katana::ResultSuccess();
+    }
+    KATANA_LOG_WARN(
+        "could not load stored index for edge property {}, rebuilding: {}",
+        column_name, loaded.error());
+  }
 
   KATANA_CHECKED(index->BuildFromProperty());
 
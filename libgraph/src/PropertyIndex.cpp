@@ -1,6 +1,70 @@
 #include "katana/PropertyIndex.h"
 
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "katana/BitMath.h"
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
+#include "katana/Range.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+constexpr uint64_t kPropertyIndexMagic = 0x4b41544e49445831;  // "KATNIDX1"
+constexpr uint32_t kPropertyIndexFormatVersion = 1;
+
+/// On storage, an index is this header followed by the ids, padded to a
+/// multiple of 8 bytes, followed by the index's lookup structure (sorted keys
+/// or hash table slots, if any). Keeping the arrays aligned lets a mapped file
+/// be used in place.
+struct PropertyIndexFileHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t kind;
+  uint32_t id_size;
+  uint32_t key_size;
+  uint64_t num_entities;
+  uint64_t num_ids;
+  uint64_t num_keys;
+};
+
+katana::Result<void>
+WriteBytes(tsuba::FileFrame* ff, const void* data, size_t size) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  arrow::Status aro_sts = ff->Write(data, size);
+  if (!aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+std::unique_ptr<katana::PropertyIndex<node_or_edge>>
+MakeIndexOfKind(
+    const std::string& column_name, size_t num_entities,
+    const std::shared_ptr<arrow::Array>& property,
+    katana::PropertyIndexKind kind) {
+  if (kind == katana::PropertyIndexKind::kHash) {
+    return std::make_unique<katana::HashPropertyIndex<node_or_edge, c_type>>(
+        column_name, num_entities, property);
+  }
+  if constexpr (std::is_same_v<c_type, std::string_view>) {
+    return std::make_unique<katana::StringPropertyIndex<node_or_edge>>(
+        column_name, num_entities, property);
+  } else {
+    return std::make_unique<
+        katana::PrimitivePropertyIndex<node_or_edge, c_type>>(
+        column_name, num_entities, property);
+  }
+}
+
+}  // namespace
 
 namespace katana {
 
@@ -9,33 +73,33 @@ template <typename node_or_edge>
 Result<std::unique_ptr<PropertyIndex<node_or_edge>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property) {
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind) {
   std::unique_ptr<PropertyIndex<node_or_edge>> index;
 
   switch (property->type_id()) {
   case arrow::Type::BOOL:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, bool>>(
-        column_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, bool>(
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::UINT8:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, uint8_t>>(
-        column_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, uint8_t>(
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::INT64:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, int64_t>>(
-        column_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, int64_t>(
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::UINT64:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, uint64_t>>(
-        column_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, uint64_t>(
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::DOUBLE:
-    index = std::make_unique<PrimitivePropertyIndex<node_or_edge, double_t>>(
-        column_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, double_t>(
+        column_name, num_entities, property, kind);
     break;
   case arrow::Type::LARGE_STRING:
-    index = std::make_unique<StringPropertyIndex<node_or_edge>>(
-        column_name, num_entities, property);
+    index = MakeIndexOfKind<node_or_edge, std::string_view>(
+        column_name, num_entities, property, kind);
     break;
   default:
     return KATANA_ERROR(
@@ -47,6 +111,164 @@ MakeTypedIndex(
   return Result<std::unique_ptr<PropertyIndex<node_or_edge>>>(std::move(index));
 }
 
+template <typename node_or_edge>
+NUMAArray<node_or_edge>
+PropertyIndex<node_or_edge>::ValidIds(
+    const arrow::Array& property, size_t num_entities) {
+  if (property.null_count() == 0) {
+    NUMAArray<node_or_edge> ids;
+    ids.allocateBlocked(num_entities);
+    katana::ParallelSTL::iota(ids.begin(), ids.end(), node_or_edge{0});
+    return ids;
+  }
+
+  return ValidIds(property, num_entities, [](size_t) { return true; });
+}
+
+template <typename node_or_edge>
+template <typename Keep>
+NUMAArray<node_or_edge>
+PropertyIndex<node_or_edge>::ValidIds(
+    const arrow::Array& property, size_t num_entities, Keep keep) {
+  NUMAArray<node_or_edge> ids;
+
+  // Count the valid entities in each block, then scatter each block's ids to
+  // its offset in the output.
+  const size_t num_blocks = katana::getActiveThreads();
+  std::vector<size_t> block_offsets(num_blocks + 1, 0);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t block) {
+        auto [begin, end] =
+            katana::block_range(size_t{0}, num_entities, block, num_blocks);
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+          if (property.IsValid(i) && keep(i)) {
+            ++count;
+          }
+        }
+        block_offsets[block + 1] = count;
+      },
+      katana::no_stats());
+  std::partial_sum(
+      block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+  ids.allocateBlocked(block_offsets[num_blocks]);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_blocks),
+      [&](size_t block) {
+        auto [begin, end] =
+            katana::block_range(size_t{0}, num_entities, block, num_blocks);
+        size_t out = block_offsets[block];
+        for (size_t i = begin; i < end; ++i) {
+          if (property.IsValid(i) && keep(i)) {
+            ids[out++] = i;
+          }
+        }
+      },
+      katana::no_stats());
+
+  return ids;
+}
+
+template <typename node_or_edge>
+Result<std::unique_ptr<tsuba::FileFrame>>
+PropertyIndex<node_or_edge>::WriteFileFrame(
+    size_t num_entities, const void* keys, size_t key_size,
+    size_t num_keys) const {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+
+  PropertyIndexFileHeader header{
+      .magic = kPropertyIndexMagic,
+      .version = kPropertyIndexFormatVersion,
+      .kind = static_cast<uint32_t>(kind()),
+      .id_size = sizeof(node_or_edge),
+      .key_size = static_cast<uint32_t>(key_size),
+      .num_entities = num_entities,
+      .num_ids = ids_.size(),
+      .num_keys = num_keys,
+  };
+  KATANA_CHECKED(WriteBytes(ff.get(), &header, sizeof(header)));
+
+  size_t ids_size = ids_.size() * sizeof(node_or_edge);
+  KATANA_CHECKED(WriteBytes(ff.get(), ids_.data(), ids_size));
+  const uint64_t zeros = 0;
+  KATANA_CHECKED(
+      WriteBytes(ff.get(), &zeros, AlignUp<uint64_t>(ids_size) - ids_size));
+
+  KATANA_CHECKED(WriteBytes(ff.get(), keys, num_keys * key_size));
+
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+template <typename node_or_edge>
+Result<const void*>
+PropertyIndex<node_or_edge>::MapFileFrame(
+    std::shared_ptr<tsuba::FileView> file, size_t num_entities,
+    size_t key_size, size_t* num_keys) {
+  if (file->size() < sizeof(PropertyIndexFileHeader)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "index file for {} is truncated",
+        column_name());
+  }
+  const auto* header = file->ptr<PropertyIndexFileHeader>();
+  if (header->magic != kPropertyIndexMagic ||
+      header->version != kPropertyIndexFormatVersion ||
+      header->kind != static_cast<uint32_t>(kind()) ||
+      header->id_size != sizeof(node_or_edge) ||
+      header->key_size != key_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "index file for {} has unexpected format",
+        column_name());
+  }
+  if (header->num_entities != num_entities) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "index file for {} covers {} entities but the graph has {}",
+        column_name(), header->num_entities, num_entities);
+  }
+
+  size_t ids_offset = sizeof(PropertyIndexFileHeader);
+  size_t ids_size = header->num_ids * sizeof(node_or_edge);
+  size_t keys_offset = ids_offset + AlignUp<uint64_t>(ids_size);
+  size_t keys_size = header->num_keys * key_size;
+  if (file->size() < keys_offset + keys_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "index file for {} is truncated",
+        column_name());
+  }
+
+  // The arrays only view the file; file_ keeps the mapping alive.
+  ids_ = NUMAArray<node_or_edge>(
+      const_cast<node_or_edge*>(file->ptr<node_or_edge>(ids_offset)),
+      header->num_ids);
+  *num_keys = header->num_keys;
+  const void* keys = file->ptr<uint8_t>(keys_offset);
+  file_ = std::move(file);
+
+  return keys;
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitivePropertyIndex<node_or_edge, c_type>::BuildFromFile(
+    std::shared_ptr<tsuba::FileView> file) {
+  size_t num_keys = 0;
+  const void* keys = KATANA_CHECKED(this->MapFileFrame(
+      std::move(file), num_entities_, sizeof(c_type), &num_keys));
+  sorted_keys_ = NUMAArray<c_type>(
+      const_cast<c_type*>(static_cast<const c_type*>(keys)), num_keys);
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<std::unique_ptr<tsuba::FileFrame>>
+PrimitivePropertyIndex<node_or_edge, c_type>::ToFileFrame() const {
+  return this->WriteFileFrame(
+      num_entities_, sorted_keys_.data(), sizeof(c_type), sorted_keys_.size());
+}
+
 template <typename node_or_edge, typename c_type>
 Result<void>
 PrimitivePropertyIndex<node_or_edge, c_type>::BuildFromProperty() {
@@ -55,14 +277,52 @@ PrimitivePropertyIndex<node_or_edge, c_type>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
+  // NaN compares unordered with every value, so NaN rows are left out of the
+  // index like null ones.
+  NUMAArray<node_or_edge> ids = [&] {
+    if constexpr (std::is_floating_point_v<c_type>) {
+      return this->ValidIds(*property_, num_entities_, [&](size_t i) {
+        return !std::isnan(property_->Value(i));
+      });
+    } else {
+      return this->ValidIds(*property_, num_entities_);
     }
-  }
+  }();
+
+  // Sort (value, id) pairs rather than ids with a comparator that reads the
+  // property; this keeps the sort within one contiguous array and breaks ties
+  // by id so the index order is deterministic.
+  struct Entry {
+    c_type key;
+    node_or_edge id;
+
+    bool operator<(const Entry& other) const {
+      return key < other.key || (!(other.key < key) && id < other.id);
+    }
+  };
+
+  NUMAArray<Entry> entries;
+  entries.allocateBlocked(ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, ids.size()),
+      [&](size_t i) {
+        entries[i] = Entry{property_->Value(ids[i]), ids[i]};
+      },
+      katana::no_stats());
+
+  katana::ParallelSTL::sort(entries.begin(), entries.end());
+
+  sorted_keys_.allocateBlocked(entries.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, entries.size()),
+      [&](size_t i) {
+        ids[i] = entries[i].id;
+        sorted_keys_[i] = entries[i].key;
+      },
+      katana::no_stats());
+
+  this->ids_ = std::move(ids);
+  this->file_.reset();
 
   return katana::ResultSuccess();
 }
@@ -75,19 +335,165 @@ StringPropertyIndex<node_or_edge>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
+  NUMAArray<node_or_edge> ids = this->ValidIds(*property_, num_entities_);
+
+  katana::ParallelSTL::sort(
+      ids.begin(), ids.end(), [this](node_or_edge a, node_or_edge b) {
+        std::string_view val_a = GetValue(a);
+        std::string_view val_b = GetValue(b);
+        return val_a < val_b || (val_a == val_b && a < b);
+      });
+
+  this->ids_ = std::move(ids);
+  this->file_.reset();
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringPropertyIndex<node_or_edge>::BuildFromFile(
+    std::shared_ptr<tsuba::FileView> file) {
+  size_t num_keys = 0;
+  KATANA_CHECKED(
+      this->MapFileFrame(std::move(file), num_entities_, 0, &num_keys));
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<std::unique_ptr<tsuba::FileFrame>>
+StringPropertyIndex<node_or_edge>::ToFileFrame() const {
+  // String values are not copied into the index; lookups read them from the
+  // property.
+  return this->WriteFileFrame(num_entities_, nullptr, 0, 0);
+}
+
+template <typename node_or_edge, typename key_type>
+Result<void>
+HashPropertyIndex<node_or_edge, key_type>::BuildFromProperty() {
+  if (static_cast<uint64_t>(property_->length()) < num_entities_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Property does not contain all entities");
+  }
+
+  // NaN is not equal to itself, so no lookup could find NaN rows and each
+  // would claim a slot of its own; leave them out like null ones.
+  NUMAArray<node_or_edge> valid_ids = [&] {
+    if constexpr (std::is_floating_point_v<key_type>) {
+      return this->ValidIds(*property_, num_entities_, [&](size_t i) {
+        return !std::isnan(property_->Value(i));
+      });
+    } else {
+      return this->ValidIds(*property_, num_entities_);
     }
+  }();
+
+  // At most half full, and a power of two so that probes can mask.
+  size_t num_slots = 2;
+  while (num_slots < 2 * valid_ids.size()) {
+    num_slots *= 2;
   }
+  const size_t mask = num_slots - 1;
+
+  table_.allocateBlocked(num_slots + 1);
+  katana::ParallelSTL::fill(table_.begin(), table_.end(), Slot{kEmpty, 0});
+
+  // Number of entities with the value held by each slot; after the prefix
+  // sum below, the start of the slot's run in ids_.
+  NUMAArray<node_or_edge> counts;
+  counts.allocateBlocked(num_slots + 1);
+  katana::ParallelSTL::fill(counts.begin(), counts.end(), node_or_edge{0});
+
+  // Claim one slot per distinct value. A slot is claimed by installing the id
+  // of some entity with that value; once claimed it never changes.
+  katana::do_all(
+      katana::iterate(size_t{0}, valid_ids.size()),
+      [&](size_t i) {
+        node_or_edge id = valid_ids[i];
+        key_type key = GetValue(id);
+        size_t slot = Hash(key) & mask;
+        while (true) {
+          node_or_edge current = table_[slot].id;
+          if (current == kEmpty) {
+            if (__sync_bool_compare_and_swap(&table_[slot].id, kEmpty, id)) {
+              break;
+            }
+            // Lost the race for this slot; look at the winner's value.
+            continue;
+          }
+          if (GetValue(current) == key) {
+            break;
+          }
+          slot = (slot + 1) & mask;
+        }
+        __sync_fetch_and_add(&counts[slot + 1], 1);
+      },
+      katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      counts.begin(), counts.end(), counts.begin());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_slots + 1),
+      [&](size_t slot) { table_[slot].offset = counts[slot]; },
+      katana::no_stats());
+
+  // Scatter ids into their runs, using counts as per-run cursors, then order
+  // each run by id so that the index does not depend on scheduling.
+  NUMAArray<node_or_edge> ids;
+  ids.allocateBlocked(valid_ids.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, valid_ids.size()),
+      [&](size_t i) {
+        node_or_edge id = valid_ids[i];
+        key_type key = GetValue(id);
+        size_t slot = FindSlot(key, Hash(key));
+        KATANA_LOG_DEBUG_ASSERT(slot != kNoSlot);
+        ids[__sync_fetch_and_add(&counts[slot], 1)] = id;
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(size_t{0}, num_slots),
+      [&](size_t slot) {
+        std::sort(
+            ids.begin() + table_[slot].offset,
+            ids.begin() + table_[slot + 1].offset);
+      },
+      katana::steal(), katana::no_stats());
+
+  this->ids_ = std::move(ids);
+  this->file_.reset();
 
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge, typename key_type>
+Result<void>
+HashPropertyIndex<node_or_edge, key_type>::BuildFromFile(
+    std::shared_ptr<tsuba::FileView> file) {
+  size_t num_table_slots = 0;
+  const void* table = KATANA_CHECKED(this->MapFileFrame(
+      std::move(file), num_entities_, sizeof(Slot), &num_table_slots));
+  if (num_table_slots < 3 || !IsPowerOf2(num_table_slots - 1)) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "index file for {} has a malformed table",
+        this->column_name());
+  }
+  table_ = NUMAArray<Slot>(
+      const_cast<Slot*>(static_cast<const Slot*>(table)), num_table_slots);
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename key_type>
+Result<std::unique_ptr<tsuba::FileFrame>>
+HashPropertyIndex<node_or_edge, key_type>::ToFileFrame() const {
+  return this->WriteFileFrame(
+      num_entities_, table_.data(), sizeof(Slot), table_.size());
+}
+
 // Forward declare template types to allow implementation in .cpp.
+template class PropertyIndex<GraphTopology::Node>;
+template class PropertyIndex<GraphTopology::Edge>;
+
 template class PrimitivePropertyIndex<GraphTopology::Node, bool>;
 template class PrimitivePropertyIndex<GraphTopology::Edge, bool>;
 template class PrimitivePropertyIndex<GraphTopology::Node, uint8_t>;
@@ -102,13 +508,26 @@ template class PrimitivePropertyIndex<GraphTopology::Edge, double_t>;
 template class StringPropertyIndex<GraphTopology::Node>;
 template class StringPropertyIndex<GraphTopology::Edge>;
 
+template class HashPropertyIndex<GraphTopology::Node, bool>;
+template class HashPropertyIndex<GraphTopology::Edge, bool>;
+template class HashPropertyIndex<GraphTopology::Node, uint8_t>;
+template class HashPropertyIndex<GraphTopology::Edge, uint8_t>;
+template class HashPropertyIndex<GraphTopology::Node, int64_t>;
+template class HashPropertyIndex<GraphTopology::Edge, int64_t>;
+template class HashPropertyIndex<GraphTopology::Node, uint64_t>;
+template class HashPropertyIndex<GraphTopology::Edge, uint64_t>;
+template class HashPropertyIndex<GraphTopology::Node, double_t>;
+template class HashPropertyIndex<GraphTopology::Edge, double_t>;
+template class HashPropertyIndex<GraphTopology::Node, std::string_view>;
+template class HashPropertyIndex<GraphTopology::Edge, std::string_view>;
+
 template Result<std::unique_ptr<PropertyIndex<GraphTopology::Node>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind);
 template Result<std::unique_ptr<PropertyIndex<GraphTopology::Edge>>>
 MakeTypedIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, PropertyIndexKind kind);
 
 }  // namespace katana
@@ -1,5 +1,13 @@
 #include "katana/TopologyGeneration.h"
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+
 namespace {
 template <typename F>
 std::unique_ptr<katana::PropertyGraph>
@@ -176,4 +184,103 @@ MakeTriangle(size_t num_rows) noexcept {
   });
 }
 
+std::unique_ptr<katana::PropertyGraph>
+MakeRmat(size_t scale, size_t edge_factor, uint64_t seed) noexcept {
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  KATANA_LOG_ASSERT(scale > 0 && scale < 32);
+
+  // Graph500 probabilities of the four quadrants of the adjacency matrix;
+  // the remaining one, d, is 0.05
+  constexpr double kA = 0.57;
+  constexpr double kB = 0.19;
+  constexpr double kC = 0.19;
+  // Edges are generated in chunks with generators of their own, so that the
+  // graph does not depend on the scheduling of the chunks
+  constexpr size_t kEdgesPerChunk = 1 << 14;
+
+  const size_t num_nodes = size_t{1} << scale;
+  const size_t num_edges = num_nodes * edge_factor;
+  const size_t num_chunks = (num_edges + kEdgesPerChunk - 1) / kEdgesPerChunk;
+
+  std::vector<Node> permutation(num_nodes);
+  std::iota(permutation.begin(), permutation.end(), Node{0});
+  std::mt19937_64 permutation_gen(seed);
+  std::shuffle(permutation.begin(), permutation.end(), permutation_gen);
+
+  NUMAArray<Node> srcs;
+  NUMAArray<Node> dsts;
+  srcs.allocateBlocked(num_edges);
+  dsts.allocateBlocked(num_edges);
+
+  katana::do_all(katana::iterate(size_t{0}, num_chunks), [&](size_t chunk) {
+    std::seed_seq seq{seed, uint64_t{chunk}};
+    std::mt19937_64 gen(seq);
+    std::uniform_real_distribution<double> dist;
+    size_t end = std::min(num_edges, (chunk + 1) * kEdgesPerChunk);
+    for (size_t e = chunk * kEdgesPerChunk; e < end; ++e) {
+      Node src = 0;
+      Node dst = 0;
+      for (size_t bit = 0; bit < scale; ++bit) {
+        double r = dist(gen);
+        src <<= 1;
+        dst <<= 1;
+        if (r < kA) {
+          continue;
+        }
+        if (r < kA + kB) {
+          dst |= 1;
+        } else if (r < kA + kB + kC) {
+          src |= 1;
+        } else {
+          src |= 1;
+          dst |= 1;
+        }
+      }
+      srcs[e] = permutation[src];
+      dsts[e] = permutation[dst];
+    }
+  });
+
+  NUMAArray<std::atomic<Edge>> degrees;
+  degrees.allocateBlocked(num_nodes);
+  katana::do_all(katana::iterate(size_t{0}, num_nodes), [&](size_t n) {
+    degrees.constructAt(n, Edge{0});
+  });
+  katana::do_all(katana::iterate(size_t{0}, num_edges), [&](size_t e) {
+    degrees[srcs[e]].fetch_add(1, std::memory_order_relaxed);
+  });
+
+  NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(katana::iterate(size_t{0}, num_nodes), [&](size_t n) {
+    adj_indices[n] = degrees[n].load(std::memory_order_relaxed);
+  });
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  // the edges of a node are placed from its end down, as its degree counts
+  // down to 0
+  NUMAArray<Node> dests;
+  dests.allocateInterleaved(num_edges);
+  katana::do_all(katana::iterate(size_t{0}, num_edges), [&](size_t e) {
+    Node src = srcs[e];
+    Edge remaining = degrees[src].fetch_sub(1, std::memory_order_relaxed);
+    dests[adj_indices[src] - remaining] = dsts[e];
+  });
+  katana::do_all(
+      katana::iterate(size_t{0}, num_nodes),
+      [&](size_t n) {
+        Edge begin = n == 0 ? 0 : adj_indices[n - 1];
+        std::sort(dests.data() + begin, dests.data() + adj_indices[n]);
+      },
+      katana::steal());
+
+  auto res = katana::PropertyGraph::Make(
+      GraphTopology{std::move(adj_indices), std::move(dests)});
+  KATANA_LOG_ASSERT(res);
+  return std::move(res.value());
+}
+
 }  // namespace katana
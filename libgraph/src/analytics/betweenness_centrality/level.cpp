@@ -1,8 +1,12 @@
+#include <cmath>
+#include <random>
+
 #include "betweenness_centrality_impl.h"
 #include "katana/AtomicHelpers.h"
 #include "katana/DynamicBitset.h"
 #include "katana/NUMAArray.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -245,6 +249,76 @@ ExtractBC(
   return katana::ResultSuccess();
 }
 
+/// Running sums of the sampled dependencies of a node, scaled into [0, 1].
+struct DependencySums {
+  double sum;
+  double sum_squares;
+};
+
+/// Grow the number of samples by this factor between accuracy checks.
+constexpr static const double kApproximateCheckGrowth = 1.2;
+
+/// Half-width of the two-sided empirical Bernstein confidence interval
+/// (Maurer and Pontil) around the mean of num_samples values in [0, 1], where
+/// log_term is ln(4 / failure probability).
+double
+BernsteinWidth(
+    const DependencySums& sums, uint64_t num_samples, double log_term) {
+  double mean = sums.sum / num_samples;
+  double variance =
+      std::max(0.0, (sums.sum_squares - sums.sum * mean) / (num_samples - 1));
+  return std::sqrt(2 * variance * log_term / num_samples) +
+         7 * log_term / (3 * (num_samples - 1));
+}
+
+/// Check whether the sampled centralities are accurate enough to stop: either
+/// every node's confidence interval is within epsilon or, with top_k, the top_k
+/// estimates are and no other node can beat them by more than epsilon.
+bool
+IsApproximationAccurate(
+    const LevelGraph& graph, const katana::NUMAArray<DependencySums>& sums,
+    uint64_t num_samples, double log_term, double epsilon, uint32_t top_k) {
+  if (top_k == 0 || top_k >= graph.size()) {
+    katana::GReduceMax<double> max_width;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](LevelGNode n) {
+          max_width.update(BernsteinWidth(sums[n], num_samples, log_term));
+        },
+        katana::no_stats(), katana::loopname("ApproximateCheck"));
+    return max_width.reduce() <= epsilon;
+  }
+
+  std::vector<double> estimates(graph.size());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](LevelGNode n) { estimates[n] = sums[n].sum / num_samples; },
+      katana::no_stats(), katana::loopname("ApproximateEstimates"));
+  std::nth_element(
+      estimates.begin(), estimates.begin() + (top_k - 1), estimates.end(),
+      std::greater<double>());
+  double kth_estimate = estimates[top_k - 1];
+
+  katana::GReduceMax<double> top_width;
+  katana::GReduceMin<double> top_lower;
+  katana::GReduceMax<double> rest_upper;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](LevelGNode n) {
+        double estimate = sums[n].sum / num_samples;
+        double width = BernsteinWidth(sums[n], num_samples, log_term);
+        if (estimate >= kth_estimate) {
+          top_width.update(width);
+          top_lower.update(estimate - width);
+        } else {
+          rest_upper.update(estimate + width);
+        }
+      },
+      katana::no_stats(), katana::loopname("ApproximateCheck"));
+  return top_width.reduce() <= epsilon &&
+         rest_upper.reduce() <= top_lower.reduce() + epsilon;
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -331,3 +405,110 @@ BetweennessCentralityLevel(
   // Get the BC proporty into the property graph by extracting from AoS
   return ExtractBC(pg, graph, graph_data, output_property_name, txn_ctx);
 }
+
+katana::Result<void>
+BetweennessCentralityApproximate(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan,
+    tsuba::TxnContext* txn_ctx) {
+  if (!(plan.epsilon() > 0) || !(plan.delta() > 0 && plan.delta() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "epsilon must be positive and delta in (0, 1); got {} and {}",
+        plan.epsilon(), plan.delta());
+  }
+
+  LevelGraph graph = KATANA_CHECKED(LevelGraph::Make(pg, {}, {}));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::NUMAArray<BCLevelNodeDataTy> graph_data;
+  katana::DynamicBitset active_edges;
+  LevelInitializeGraph(&graph, &graph_data, &active_edges);
+
+  // With fewer than 3 nodes no node lies between two others.
+  if (graph.size() < 3) {
+    return ExtractBC(pg, graph, graph_data, output_property_name, txn_ctx);
+  }
+
+  katana::NUMAArray<DependencySums> sums;
+  sums.allocateBlocked(graph.size());
+  katana::do_all(
+      katana::iterate(graph), [&](LevelGNode n) { sums[n] = {0, 0}; },
+      katana::no_stats(), katana::loopname("ApproximateInit"));
+
+  // A dependency is at most n - 2, so dependency / (n - 1) is in [0, 1] and
+  // its expectation over a uniform source is the normalized centrality.
+  const double num_nodes = graph.size();
+  const double epsilon = plan.epsilon();
+  const double delta = plan.delta();
+
+  // By Hoeffding's inequality and a union bound over the nodes, max_samples
+  // samples bound every error by epsilon with probability 1 - delta / 2. The
+  // other delta / 2 is split among the checks made on the way there, which
+  // cannot succeed before the constant term of their bound drops below
+  // epsilon.
+  const uint64_t max_samples = std::max<uint64_t>(
+      2, std::ceil(std::log(4 * num_nodes / delta) / (2 * epsilon * epsilon)));
+  uint64_t next_check = std::min<uint64_t>(
+      max_samples,
+      std::ceil(7 * std::log(8 * num_nodes / delta) / (3 * epsilon)) + 1);
+  const double num_checks =
+      std::ceil(
+          std::log(static_cast<double>(max_samples) / next_check) /
+          std::log(kApproximateCheckGrowth)) +
+      1;
+  const double log_term = std::log(8 * num_nodes * num_checks / delta);
+
+  std::mt19937_64 gen;
+  std::uniform_int_distribution<LevelGNode> pick_source(0, graph.size() - 1);
+
+  katana::StatTimer exec_time("Approximate", "BetweennessCentrality");
+  exec_time.start();
+
+  uint64_t num_samples = 0;
+  while (num_samples < max_samples) {
+    LevelGNode src_node = pick_source(gen);
+    LevelInitializeIteration(&graph, src_node, &graph_data, &active_edges);
+    katana::gstl::Vector<LevelWorklistType> worklists =
+        LevelSSSP(&graph, src_node, &graph_data, &active_edges);
+    LevelBackwardBrandes(&graph, &worklists, &graph_data, &active_edges);
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](LevelGNode n) {
+          double x = graph_data[n].dependency / (num_nodes - 1);
+          sums[n].sum += x;
+          sums[n].sum_squares += x * x;
+        },
+        katana::no_stats(), katana::loopname("ApproximateAccumulate"));
+    ++num_samples;
+
+    if (num_samples == next_check) {
+      if (IsApproximationAccurate(
+              graph, sums, num_samples, log_term, epsilon, plan.top_k())) {
+        break;
+      }
+      next_check = std::min<uint64_t>(
+          max_samples,
+          std::max<uint64_t>(
+              next_check + 1,
+              std::ceil(next_check * kApproximateCheckGrowth)));
+    }
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("BetweennessCentrality", "Samples", num_samples);
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "MaxSamples", max_samples);
+
+  // Scale the normalized estimates back to the units of the exact algorithms.
+  katana::do_all(
+      katana::iterate(graph),
+      [&](LevelGNode n) {
+        graph_data[n].bc =
+            num_nodes * (num_nodes - 1) * sums[n].sum / num_samples;
+      },
+      katana::no_stats(), katana::loopname("ApproximateEstimate"));
+
+  return ExtractBC(pg, graph, graph_data, output_property_name, txn_ctx);
+}
@@ -22,8 +22,10 @@
 #include <deque>
 #include <type_traits>
 
-#include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
+#include "katana/Frontier.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
 #include "katana/Result.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
@@ -74,18 +76,6 @@ struct EdgeTileMaker {
   }
 };
 
-struct NodePushWrap {
-  template <typename C>
-  void operator()(C& cont, const GNode& n, const char* const /*tag*/) const {
-    (*this)(cont, n);
-  }
-
-  template <typename C>
-  void operator()(C& cont, const GNode& n) const {
-    cont.push(n);
-  }
-};
-
 struct EdgeTilePushWrap {
   Graph* graph;
   BfsImplementation& impl;
@@ -117,28 +107,6 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void
-WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
-  katana::do_all(
-      katana::iterate(wl), [&](const GNode& src) { bitset->set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
-}
-
-template <typename G, typename WL>
-void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
-  wl->clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
-        }
-      },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
-}
-
 template <typename T, typename P, typename R>
 void
 AsynchronousAlgo(
@@ -217,91 +185,67 @@ AsynchronousAlgo(
   }
 }
 
-template <typename P>
 void
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
-    const GNode source, const P& pushWrap, const uint32_t alpha,
-    const uint32_t beta) {
-  using Cont = katana::InsertBag<GNode>;
-  using Loop = katana::DoAll;
-
-  katana::GAccumulator<uint32_t> work_items;
+    const GNode source, const uint32_t alpha, const uint32_t beta) {
   katana::StatTimer bitset_to_wl_timer("Bitset_To_WL_Timer");
   katana::StatTimer wl_to_bitset_timer("WL_To_Bitset_Timer");
 
-  Loop loop;
-
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
-
   uint32_t num_nodes = bidir_view.num_nodes();
   uint64_t num_edges = bidir_view.num_edges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
-
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  auto frontier = std::make_unique<katana::Frontier>(num_nodes, num_edges);
+  auto next_frontier = std::make_unique<katana::Frontier>(num_nodes, num_edges);
+  katana::FrontierDirection direction(num_nodes, num_edges, alpha, beta);
 
   (*node_data)[source] = source;
 
-  pushWrap(*next_frontier, source, "parallel");
-
-  work_items += 1;
-
-  int64_t edges_to_check = num_edges;
-  int64_t scout_count = bidir_view.degree(source);
-  uint64_t old_num_work_items{0};
+  next_frontier->Push(source);
+  next_frontier->Finish();
 
-  katana::GAccumulator<uint64_t> writes_pull;
-  katana::GAccumulator<uint64_t> writes_push;
+  // sum of the out-degrees of the nodes in next_frontier, only tracked when
+  // pushing
+  katana::GAccumulator<uint64_t> scout_count;
+  scout_count += bidir_view.degree(source);
 
   while (!next_frontier->empty()) {
     std::swap(frontier, next_frontier);
-    next_frontier->clear();
-    if (scout_count > edges_to_check / alpha) {
+    bool pull = direction.NextIsPull(frontier->size(), scout_count.reduce());
+    scout_count.reset();
+
+    if (pull) {
       wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
+      frontier->MakeDense();
       wl_to_bitset_timer.stop();
-      do {
-        old_num_work_items = work_items.reduce();
-        work_items.reset();
 
-        loop(
-            katana::iterate(bidir_view),
-            [&](const GNode& dst) {
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                for (auto e : bidir_view.in_edges(dst)) {
-                  auto src = bidir_view.in_edge_dest(e);
-
-                  if (front_bitset.test(src)) {
-                    // assign parents on the bfs path.
-                    ddata = src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
+      next_frontier->Clear(true);
+      katana::do_all(
+          katana::iterate(bidir_view),
+          [&](const GNode& dst) {
+            GNode& ddata = (*node_data)[dst];
+            if (ddata == BfsImplementation::kDistanceInfinity) {
+              for (auto e : bidir_view.in_edges(dst)) {
+                auto src = bidir_view.in_edge_dest(e);
+
+                if (frontier->Contains(src)) {
+                  // assign parents on the bfs path.
+                  ddata = src;
+                  next_frontier->Push(dst);
+                  break;
                 }
               }
-            },
-            katana::steal(), katana::chunk_size<kChunkSize>(),
-            katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
-      } while (work_items.reduce() >= old_num_work_items ||
-               (work_items.reduce() > num_nodes / beta));
+            }
+          },
+          katana::steal(), katana::chunk_size<kChunkSize>(),
+          katana::loopname(std::string("SyncDO-pull").c_str()));
+    } else {
       bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
+      frontier->MakeSparse();
       bitset_to_wl_timer.stop();
-      scout_count = 1;
-    } else {
-      edges_to_check -= scout_count;
-      work_items.reset();
 
-      loop(
-          katana::iterate(*frontier),
+      next_frontier->Clear();
+      frontier->ForEach(
           [&](const GNode& src) {
             for (auto e : bidir_view.edges(src)) {
               auto dst = bidir_view.edge_dest(e);
@@ -309,16 +253,16 @@ SynchronousDirectOpt(
               if (ddata == BfsImplementation::kDistanceInfinity) {
                 GNode old_parent = ddata;
                 if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
-                  next_frontier->push(dst);
-                  work_items += bidir_view.degree(dst);
+                  next_frontier->Push(dst);
+                  scout_count += bidir_view.degree(dst);
                 }
               }
             }
           },
           katana::steal(), katana::chunk_size<kChunkSize>(),
           katana::loopname(std::string("SyncDO-push").c_str()));
-      scout_count = work_items.reduce();
     }
+    next_frontier->Finish(scout_count.reduce());
   }
 }
 
@@ -384,8 +328,7 @@ RunAlgo(
 
     exec_time.start();
     SynchronousDirectOpt(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        bidir_view, &node_data, source, algo.alpha(), algo.beta());
     exec_time.stop();
 
     UpdateGraphNodeData(graph, node_data);
@@ -448,6 +391,85 @@ BfsImpl(
   return katana::ResultSuccess();
 }
 
+using MultiGraph = katana::TypedPropertyGraph<std::tuple<>, std::tuple<>>;
+using SourceMask = BfsImplementation::SourceMask;
+using MultiSourceDistances = BfsImplementation::MultiSourceDistances;
+
+/// Level-synchronous BFS from up to kMultiSourceWidth sources at once. Each
+/// level expands every node that some source reached in the previous level
+/// and pushes the mask of those sources to its neighbors, so a node's edges
+/// are read once per level for the whole batch instead of once per source.
+void
+BfsMultiBatch(
+    const MultiGraph& graph, const uint32_t* sources, size_t num_sources,
+    Dist* const* levels) {
+  KATANA_LOG_DEBUG_ASSERT(num_sources <= BfsImplementation::kMultiSourceWidth);
+
+  katana::NUMAArray<SourceMask> seen;
+  katana::NUMAArray<SourceMask> visit;
+  katana::NUMAArray<SourceMask> next;
+  seen.allocateBlocked(graph.num_nodes());
+  visit.allocateBlocked(graph.num_nodes());
+  next.allocateBlocked(graph.num_nodes());
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        seen[n] = 0;
+        visit[n] = 0;
+        next[n] = 0;
+      },
+      katana::no_stats(), katana::loopname("BfsMulti-Init"));
+
+  for (size_t i = 0; i < num_sources; ++i) {
+    seen[sources[i]] |= SourceMask{1} << i;
+    visit[sources[i]] |= SourceMask{1} << i;
+    levels[i][sources[i]] = 0;
+  }
+
+  katana::GReduceLogicalOr active;
+  for (Dist level = 1;; ++level) {
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          SourceMask frontier = visit[n];
+          if (frontier == 0) {
+            return;
+          }
+          for (auto e : graph.edges(n)) {
+            auto dest = *graph.GetEdgeDest(e);
+            SourceMask bits = frontier & ~seen[dest];
+            if (bits != 0) {
+              BfsImplementation::MergeSources(&next[dest], bits);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<kChunkSize>(),
+        katana::loopname("BfsMulti-Expand"));
+
+    active.reset();
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          SourceMask bits = next[n] & ~seen[n];
+          next[n] = 0;
+          visit[n] = bits;
+          if (bits == 0) {
+            return;
+          }
+          seen[n] |= bits;
+          active.update(true);
+          BfsImplementation::ForEachSource(
+              bits, [&](size_t i) { levels[i][n] = level; });
+        },
+        katana::loopname("BfsMulti-Advance"));
+
+    if (!active.reduce()) {
+      break;
+    }
+  }
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -475,6 +497,42 @@ katana::analytics::Bfs(
   return BfsImpl(&graph, bidir_view, start_node, algo);
 }
 
+katana::Result<void>
+katana::analytics::BfsMulti(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::vector<std::string>& output_property_names,
+    tsuba::TxnContext* txn_ctx) {
+  if (sources.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} output properties", sources.size(),
+        output_property_names.size());
+  }
+  for (auto source : sources) {
+    if (source >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+
+  auto graph = KATANA_CHECKED(MultiGraph::Make(pg, {}, {}));
+  auto levels = KATANA_CHECKED(
+      MultiSourceDistances::Make(sources.size(), pg->num_nodes()));
+
+  katana::StatTimer exec_time("BfsMulti");
+  exec_time.start();
+  constexpr size_t kWidth = BfsImplementation::kMultiSourceWidth;
+  for (size_t begin = 0; begin < sources.size(); begin += kWidth) {
+    BfsMultiBatch(
+        graph, &sources[begin], std::min(kWidth, sources.size() - begin),
+        levels.columns(begin));
+  }
+  exec_time.stop();
+
+  return std::move(levels).AddTo(pg, output_property_names, txn_ctx);
+}
+
 template <typename LevelVec>
 void
 ComputeLevels(
@@ -22,6 +22,7 @@
 #include <boost/unordered_map.hpp>
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Frontier.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -64,13 +65,15 @@ struct CdlpSynchronousAlgo : CdlpAlgo {
     size_t iterations = 0;
     katana::InsertBag<NodeDataPair> apply_bag;
 
-    /// TODO (Yasin): in this implementation, in each iteration, all the nodes are active
-    /// for gather phase. If InsertBag does not accept duplicate items then this
-    /// can be improved to have only the affected nodes to be active in next iteration
+    /// The new community of a node only depends on the communities of its
+    /// neighbors, so only the neighbors of nodes whose community changed are
+    /// active in the next iteration. All nodes are active in the first one.
+    katana::Frontier active(graph->num_nodes(), graph->num_edges());
+    active.Fill();
+
     while (iterations < max_iterations) {
       // Gather Phase
-      katana::do_all(
-          katana::iterate(*graph),
+      active.ForEach(
           [&](const GNode& node) {
             const auto ndata_current_comm = graph->GetData<NodeCommunity>(node);
             using Histogram_type = boost::unordered_map<CommunityType, size_t>;
@@ -105,13 +108,18 @@ struct CdlpSynchronousAlgo : CdlpAlgo {
         break;
 
       // Apply Phase
+      active.Clear();
       katana::do_all(
           katana::iterate(apply_bag),
           [&](const NodeDataPair node_data) {
             GNode node = node_data.node;
             graph->GetData<NodeCommunity>(node) = node_data.data;
+            for (auto e : graph->edges(node)) {
+              active.PushUnique(graph->edge_dest(e));
+            }
           },
           katana::loopname("CDLP_Apply"));
+      active.Finish();
 
       apply_bag.clear();
       iterations += 1;
@@ -20,6 +20,7 @@
 #include "katana/analytics/connected_components/connected_components.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Frontier.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -123,30 +124,38 @@ struct ConnectedComponentsLabelPropAlgo {
   void Deallocate(Graph*) {}
 
   void operator()(Graph* graph) {
-    katana::GReduceLogicalOr changed;
-    do {
-      changed.reset();
-      katana::do_all(
-          katana::iterate(*graph),
+    // Only nodes whose component changed in the previous round are active
+    auto active = std::make_unique<katana::Frontier>(
+        graph->num_nodes(), graph->num_edges());
+    auto next_active = std::make_unique<katana::Frontier>(
+        graph->num_nodes(), graph->num_edges());
+    active->Fill();
+
+    while (!active->empty()) {
+      next_active->Clear();
+      active->ForEach(
           [&](const GNode& src) {
             auto& sdata_current_comp = graph->GetData<NodeComponent>(src);
             auto& sdata_old_comp = old_component_[src];
             if (sdata_old_comp > sdata_current_comp) {
               sdata_old_comp = sdata_current_comp;
 
-              changed.update(true);
-
               for (auto e : graph->edges(src)) {
                 auto dest = graph->edge_dest(e);
                 auto& ddata_current_comp = graph->GetData<NodeComponent>(dest);
                 ComponentType label_new = sdata_current_comp;
-                katana::atomicMin(ddata_current_comp, label_new);
+                if (katana::atomicMin(ddata_current_comp, label_new) >
+                    label_new) {
+                  next_active->PushUnique(dest);
+                }
               }
             }
           },
           katana::disable_conflict_detection(), katana::steal(),
           katana::loopname("ConnectedComponentsLabelPropAlgo"));
-    } while (changed.reduce());
+      next_active->Finish();
+      std::swap(active, next_active);
+    }
   }
 };
 
@@ -19,6 +19,16 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -33,37 +43,74 @@ typedef typename Graph::Node GNode;
 
 namespace {
 
+/// Finish intersecting a and b from a[i] and b[j] with a merge. A pair of
+/// equal values counts only if both are the first occurrence of their value,
+/// so each common value counts once however often it repeats.
+uint32_t
+IntersectSortedTail(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    size_t i, size_t j, uint32_t count) {
+  while (i < a_size && j < b_size) {
+    if (a[i] == b[j]) {
+      if ((i == 0 || a[i - 1] != a[i]) && (j == 0 || b[j - 1] != b[j])) {
+        ++count;
+      }
+      ++i;
+      ++j;
+    } else if (a[i] < b[j]) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return count;
+}
+
+#if defined(__x86_64__)
+/// A mask of the lanes of block, which holds x[i, i + 8), that are the first
+/// occurrence of their value in x.
+__attribute__((target("avx2"))) __m256i
+FirstOccurrences(const uint32_t* x, size_t i, __m256i block) {
+  // Lane 0 of the first block has no predecessor, so give it one that differs
+  __m256i prev =
+      i > 0 ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i - 1))
+            : _mm256_setr_epi32(
+                  ~x[0], x[0], x[1], x[2], x[3], x[4], x[5], x[6]);
+  return _mm256_xor_si256(
+      _mm256_cmpeq_epi32(block, prev), _mm256_set1_epi32(-1));
+}
+#endif
+
+/// Count the values common to the sorted arrays a and b, each value once.
+/// Dispatches to the AVX2 version when the CPU has it.
+uint32_t
+IntersectSorted(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  static const bool kUseAVX2 = internal::HaveAVX2();
+  return kUseAVX2 ? internal::IntersectSortedAVX2(a, a_size, b, b_size)
+                  : internal::IntersectSortedScalar(a, a_size, b, b_size);
+}
+
 struct IntersectWithSortedEdgeList {
 private:
-  const GNode base_;
+  const GNode* dests_;
+  const GNode* base_begin_;
+  const size_t base_size_;
   const Graph& graph_;
 
 public:
   IntersectWithSortedEdgeList(const Graph& graph, GNode base)
-      : base_(base), graph_(graph) {}
+      : dests_(graph.GetPropertyGraph().topology().dest_data()),
+        base_begin_(dests_ + *graph.edge_begin(base)),
+        base_size_(graph.edges(base).size()),
+        graph_(graph) {}
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
+    // Intersect the destinations of n2 and base directly, based on the
     // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.edge_begin(n2);
-    auto edges_n2_end = graph_.edge_end(n2);
-    auto edges_base_iter = graph_.edge_begin(base_);
-    auto edges_base_end = graph_.edge_end(base_);
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.GetEdgeDest(*edges_n2_iter);
-      auto edge_base_dst = graph_.GetEdgeDest(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
-    }
-    return intersection_size;
+    return IntersectSorted(
+        dests_ + *graph_.edge_begin(n2), graph_.edges(n2).size(), base_begin_,
+        base_size_);
   }
 };
 
@@ -136,8 +183,308 @@ JaccardImpl(
   return katana::ResultSuccess();
 }
 
+/// A candidate for one of a node's most similar nodes.
+struct JaccardMatch {
+  uint32_t node;
+  double similarity;
+};
+
+/// Higher similarity first; ties go to the lower node id so that results do
+/// not depend on thread scheduling.
+bool
+IsBetterMatch(const JaccardMatch& a, const JaccardMatch& b) {
+  return a.similarity != b.similarity ? a.similarity > b.similarity
+                                      : a.node < b.node;
+}
+
+/// Compressed adjacency with each node's distinct neighbors sorted by id, plus
+/// the reverse adjacency used to enumerate the nodes that share a neighbor.
+class SortedAdjacency {
+public:
+  SortedAdjacency(const katana::GraphTopology& topo, JaccardPlan plan)
+      : indices_(topo.adj_data()), dests_(topo.dest_data()) {
+    uint64_t num_nodes = topo.num_nodes();
+    uint64_t num_edges = topo.num_edges();
+
+    degrees_.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { degrees_[n] = indices_[n] - Begin(n); },
+        katana::no_stats(), katana::loopname("Jaccard-Degrees"));
+
+    // Sorted edge lists may still repeat a neighbor, and each neighbor must
+    // count once in both the intersection and the union.
+    bool sorted_and_distinct = false;
+    if (plan.edge_sorting() == JaccardPlan::kSorted) {
+      katana::GReduceLogicalOr has_repeats;
+      katana::do_all(
+          katana::iterate(uint64_t{1}, num_edges),
+          [&](uint64_t e) {
+            if (dests_[e] == dests_[e - 1]) {
+              has_repeats.update(true);
+            }
+          },
+          katana::no_stats(), katana::loopname("Jaccard-FindRepeats"));
+      // A repeat may be the first edge of one node and the last of the
+      // previous one, which only costs an unneeded copy.
+      sorted_and_distinct = !has_repeats.reduce();
+    }
+
+    if (!sorted_and_distinct) {
+      sorted_dests_.allocateBlocked(num_edges);
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_nodes),
+          [&](uint64_t n) {
+            auto begin = sorted_dests_.begin() + Begin(n);
+            auto end = sorted_dests_.begin() + indices_[n];
+            std::copy(dests_ + Begin(n), dests_ + indices_[n], begin);
+            std::sort(begin, end);
+            degrees_[n] = std::unique(begin, end) - begin;
+          },
+          katana::steal(), katana::no_stats(),
+          katana::loopname("Jaccard-SortEdges"));
+      dests_ = sorted_dests_.data();
+    }
+
+    in_indices_.allocateBlocked(num_nodes);
+    in_sources_.allocateBlocked(num_edges);
+    katana::ParallelSTL::fill(in_indices_.begin(), in_indices_.end(), 0);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          for (uint64_t e = Begin(n); e < End(n); ++e) {
+            __atomic_fetch_add(&in_indices_[dests_[e]], 1, 0);
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("Jaccard-CountInEdges"));
+    katana::ParallelSTL::partial_sum(
+        in_indices_.begin(), in_indices_.end(), in_indices_.begin());
+
+    katana::NUMAArray<uint64_t> in_offsets;
+    in_offsets.allocateBlocked(num_nodes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) { in_offsets[n] = n == 0 ? 0 : in_indices_[n - 1]; },
+        katana::no_stats(), katana::loopname("Jaccard-InOffsets"));
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t n) {
+          for (uint64_t e = Begin(n); e < End(n); ++e) {
+            in_sources_[__atomic_fetch_add(&in_offsets[dests_[e]], 1, 0)] = n;
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("Jaccard-InEdges"));
+  }
+
+  const uint32_t* neighbors(uint32_t n) const { return dests_ + Begin(n); }
+  uint64_t degree(uint32_t n) const { return degrees_[n]; }
+
+  const uint32_t* in_neighbors_begin(uint32_t n) const {
+    return in_sources_.data() + (n == 0 ? 0 : in_indices_[n - 1]);
+  }
+  const uint32_t* in_neighbors_end(uint32_t n) const {
+    return in_sources_.data() + in_indices_[n];
+  }
+
+private:
+  uint64_t Begin(uint64_t n) const { return n == 0 ? 0 : indices_[n - 1]; }
+  uint64_t End(uint64_t n) const { return Begin(n) + degrees_[n]; }
+
+  const uint64_t* indices_;
+  const uint32_t* dests_;
+  katana::NUMAArray<uint64_t> degrees_;
+  katana::NUMAArray<uint32_t> sorted_dests_;
+  katana::NUMAArray<uint64_t> in_indices_;
+  katana::NUMAArray<uint32_t> in_sources_;
+};
+
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+JaccardTopKImpl(
+    const katana::PropertyGraph& pg, uint32_t k, double threshold,
+    const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
+    JaccardPlan plan) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::StatTimer exec_time("JaccardTopK");
+  exec_time.start();
+
+  uint64_t num_nodes = pg.topology().num_nodes();
+  SortedAdjacency adj(pg.topology(), plan);
+
+  // The matches of each node are appended to the buffer of the thread that
+  // computed them; owner and offset record where to find them.
+  katana::PerThreadStorage<std::vector<JaccardMatch>> matches;
+  katana::PerThreadStorage<std::vector<uint32_t>> candidates;
+  katana::PerThreadStorage<std::vector<JaccardMatch>> heaps;
+  katana::NUMAArray<uint64_t> out_indices;
+  katana::NUMAArray<uint32_t> owner;
+  katana::NUMAArray<uint64_t> offset;
+  out_indices.allocateBlocked(num_nodes);
+  owner.allocateBlocked(num_nodes);
+  offset.allocateBlocked(num_nodes);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        auto& local_candidates = *candidates.getLocal();
+        auto& heap = *heaps.getLocal();
+        auto& local_matches = *matches.getLocal();
+        local_candidates.clear();
+        heap.clear();
+
+        const uint32_t* n_neighbors = adj.neighbors(n);
+        uint64_t n_degree = adj.degree(n);
+        for (uint64_t i = 0; i < n_degree; ++i) {
+          for (const uint32_t* v = adj.in_neighbors_begin(n_neighbors[i]);
+               v != adj.in_neighbors_end(n_neighbors[i]); ++v) {
+            if (*v != n) {
+              local_candidates.emplace_back(*v);
+            }
+          }
+        }
+        std::sort(local_candidates.begin(), local_candidates.end());
+        local_candidates.erase(
+            std::unique(local_candidates.begin(), local_candidates.end()),
+            local_candidates.end());
+
+        for (uint32_t v : local_candidates) {
+          uint64_t v_degree = adj.degree(v);
+          // The intersection can be no larger than the smaller neighbor set
+          // and the union no smaller than the larger one, so skip candidates
+          // that cannot make the cut before intersecting.
+          double bound = static_cast<double>(std::min(n_degree, v_degree)) /
+                         std::max(n_degree, v_degree);
+          if (bound < threshold ||
+              (heap.size() == k && bound < heap.front().similarity)) {
+            continue;
+          }
+
+          uint32_t intersection_size = IntersectSorted(
+              n_neighbors, n_degree, adj.neighbors(v), v_degree);
+          JaccardMatch match{
+              v, static_cast<double>(intersection_size) /
+                     (n_degree + v_degree - intersection_size)};
+          if (match.similarity < threshold) {
+            continue;
+          }
+          if (heap.size() < k) {
+            heap.emplace_back(match);
+            std::push_heap(heap.begin(), heap.end(), IsBetterMatch);
+          } else if (IsBetterMatch(match, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), IsBetterMatch);
+            heap.back() = match;
+            std::push_heap(heap.begin(), heap.end(), IsBetterMatch);
+          }
+        }
+        std::sort_heap(heap.begin(), heap.end(), IsBetterMatch);
+
+        out_indices[n] = heap.size();
+        owner[n] = katana::ThreadPool::getTID();
+        offset[n] = local_matches.size();
+        local_matches.insert(local_matches.end(), heap.begin(), heap.end());
+      },
+      katana::steal(), katana::loopname("JaccardTopK"));
+
+  katana::ParallelSTL::partial_sum(
+      out_indices.begin(), out_indices.end(), out_indices.begin());
+  uint64_t num_edges = num_nodes == 0 ? 0 : out_indices[num_nodes - 1];
+
+  katana::NUMAArray<uint32_t> out_dests;
+  out_dests.allocateBlocked(num_edges);
+  std::shared_ptr<arrow::Buffer> similarities =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_edges * sizeof(double)));
+  auto* similarity_data =
+      reinterpret_cast<double*>(similarities->mutable_data());
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        const JaccardMatch* match =
+            matches.getRemote(owner[n])->data() + offset[n];
+        for (uint64_t e = n == 0 ? 0 : out_indices[n - 1]; e < out_indices[n];
+             ++e, ++match) {
+          out_dests[e] = match->node;
+          similarity_data[e] = match->similarity;
+        }
+      },
+      katana::no_stats(), katana::loopname("JaccardTopK-Gather"));
+
+  exec_time.stop();
+
+  auto result = KATANA_CHECKED(katana::PropertyGraph::Make(
+      katana::GraphTopology{std::move(out_indices), std::move(out_dests)}));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::float64())}),
+      {std::make_shared<arrow::DoubleArray>(num_edges, similarities)});
+  KATANA_CHECKED(result->AddEdgeProperties(table, txn_ctx));
+
+  return result;
+}
+
 }  // namespace
 
+bool
+katana::analytics::internal::HaveAVX2() {
+#if defined(__x86_64__)
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+uint32_t
+katana::analytics::internal::IntersectSortedScalar(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  return IntersectSortedTail(a, a_size, b, b_size, 0, 0, 0);
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2")))
+#endif
+uint32_t
+katana::analytics::internal::IntersectSortedAVX2(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  size_t i = 0;
+  size_t j = 0;
+  uint32_t count = 0;
+#if defined(__x86_64__)
+  // Compare a block of 8 values from a with all 8 rotations of a block from b
+  // and advance whichever block ends with the smaller value (both if they end
+  // with the same one). Only lanes that hold the first occurrence of their
+  // value take part, and the first occurrences of a common value meet in
+  // exactly one pair of blocks, or else both lie at or past where the merge
+  // in IntersectSortedTail picks up.
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  while (i + 8 <= a_size && j + 8 <= b_size) {
+    __m256i a_block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i b_block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+    __m256i b_first = FirstOccurrences(b, j, b_block);
+    __m256i match =
+        _mm256_and_si256(_mm256_cmpeq_epi32(a_block, b_block), b_first);
+    for (int r = 1; r < 8; ++r) {
+      b_block = _mm256_permutevar8x32_epi32(b_block, rotate);
+      b_first = _mm256_permutevar8x32_epi32(b_first, rotate);
+      match = _mm256_or_si256(
+          match,
+          _mm256_and_si256(_mm256_cmpeq_epi32(a_block, b_block), b_first));
+    }
+    match = _mm256_and_si256(match, FirstOccurrences(a, i, a_block));
+    count +=
+        __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(match)));
+
+    uint32_t a_last = a[i + 7];
+    uint32_t b_last = b[j + 7];
+    i += a_last <= b_last ? 8 : 0;
+    j += b_last <= a_last ? 8 : 0;
+  }
+#endif
+  return IntersectSortedTail(a, a_size, b, b_size, i, j, count);
+}
+
 katana::Result<void>
 katana::analytics::Jaccard(
     PropertyGraph* pg, uint32_t compare_node,
@@ -172,6 +519,20 @@ katana::analytics::Jaccard(
   return r;
 }
 
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::analytics::JaccardTopK(
+    PropertyGraph* pg, uint32_t k, double threshold,
+    const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
+    JaccardPlan plan) {
+  if (k == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "k must be positive");
+  }
+
+  return JaccardTopKImpl(
+      *pg, k, threshold, output_property_name, txn_ctx, plan);
+}
+
 constexpr static const double EPSILON = 1e-6;
 
 katana::Result<void>
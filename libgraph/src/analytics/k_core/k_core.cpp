@@ -20,6 +20,7 @@
 #include "katana/analytics/k_core/k_core.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Frontier.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -64,21 +65,21 @@ DegreeCounting(Graph* graph) {
  * Setup initial worklist of dead nodes.
  *
  * @param graph Graph to operate on
- * @param initial_worklist Empty worklist to be filled with dead nodes.
+ * @param push Called with each dead node to add it to the initial worklist.
  * @param k_core_number Each node in the core is expected to have degree <= k_core_number.
  */
+template <typename PushFn>
 void
 SetupInitialWorklist(
-    const Graph& graph, katana::InsertBag<GNode>& initial_worklist,
-    uint32_t k_core_number) {
+    const Graph& graph, const PushFn& push, uint32_t k_core_number) {
   katana::do_all(
       katana::iterate(graph),
       [&](const GNode& node) {
         const auto& node_current_degree =
             graph.GetData<KCoreNodeCurrentDegree>(node);
         if (node_current_degree < k_core_number) {
-          //! Dead node, add to initial_worklist for processing later.
-          initial_worklist.emplace(node);
+          //! Dead node, add to initial worklist for processing later.
+          push(node);
         }
       },
       katana::loopname("InitialWorklistSetup"), katana::no_stats());
@@ -94,19 +95,22 @@ SetupInitialWorklist(
  */
 void
 SyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
-  auto current = std::make_unique<katana::InsertBag<GNode>>();
-  auto next = std::make_unique<katana::InsertBag<GNode>>();
+  auto current = std::make_unique<katana::Frontier>(
+      graph->num_nodes(), graph->num_edges());
+  auto next = std::make_unique<katana::Frontier>(
+      graph->num_nodes(), graph->num_edges());
 
   //! Setup worklist.
-  SetupInitialWorklist(*graph, *next, k_core_number);
+  SetupInitialWorklist(
+      *graph, [&](const GNode& node) { next->Push(node); }, k_core_number);
+  next->Finish();
 
   while (!next->empty()) {
     //! Make "next" into current.
     std::swap(current, next);
-    next->clear();
+    next->Clear();
 
-    katana::do_all(
-        katana::iterate(*current),
+    current->ForEach(
         [&](const GNode& dead_node) {
           //! Decrement degree of all neighbors.
           for (auto e : graph->edges(dead_node)) {
@@ -118,12 +122,13 @@ SyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
             if (old_degree == k_core_number) {
               //! This thread was responsible for putting degree of destination
               //! below threshold; add to worklist.
-              next->emplace(*dest);
+              next->Push(*dest);
             }
           }
         },
         katana::steal(), katana::chunk_size<KCorePlan::kChunkSize>(),
         katana::loopname("KCore Synchronous"));
+    next->Finish();
   }
 }
 
@@ -139,7 +144,9 @@ void
 AsyncCascadeKCore(Graph* graph, uint32_t k_core_number) {
   katana::InsertBag<GNode> initial_worklist;
   //! Setup worklist.
-  SetupInitialWorklist(*graph, initial_worklist, k_core_number);
+  SetupInitialWorklist(
+      *graph, [&](const GNode& node) { initial_worklist.emplace(node); },
+      k_core_number);
 
   katana::for_each(
       katana::iterate(initial_worklist),
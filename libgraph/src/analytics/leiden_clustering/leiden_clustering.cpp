@@ -120,11 +120,11 @@ struct LeidenClusteringImplementation
             uint64_t degree =
                 std::distance(graph.edge_begin(n), graph.edge_end(n));
             uint64_t local_target = Base::UNASSIGNED;
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
+            katana::ArenaScope scope;
+            // Map each neighbor's cluster to a local index
+            typename Base::ClusterLocalMap cluster_local_map;
+            // Number of edges to each unique cluster
+            typename Base::template ClusterCounter<EdgeWeightType> counter;
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
@@ -291,11 +291,11 @@ struct LeidenClusteringImplementation
               uint64_t degree =
                   std::distance(graph.edge_begin(n), graph.edge_end(n));
 
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
+              katana::ArenaScope scope;
+              // Map each neighbor's cluster to a local index
+              typename Base::ClusterLocalMap cluster_local_map;
+              // Number of edges to each unique cluster
+              typename Base::template ClusterCounter<EdgeWeightType> counter;
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
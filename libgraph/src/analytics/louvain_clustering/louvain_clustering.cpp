@@ -117,12 +117,11 @@ struct LouvainClusteringImplementation
 
             uint64_t degree = graph.degree(n);
             uint64_t local_target = Base::UNASSIGNED;
-            // TODO(amber): use scalable allocator with these containers
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
+            katana::ArenaScope scope;
+            // Map each neighbor's cluster to a local index
+            typename Base::ClusterLocalMap cluster_local_map;
+            // Number of edges to each unique cluster
+            typename Base::template ClusterCounter<EdgeWeightType> counter;
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
@@ -273,12 +272,11 @@ struct LouvainClusteringImplementation
 
               uint64_t degree = graph.degree(n);
 
-              // TODO(amber): use scalable allocators
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
+              katana::ArenaScope scope;
+              // Map each neighbor's cluster to a local index
+              typename Base::ClusterLocalMap cluster_local_map;
+              // Number of edges to each unique cluster
+              typename Base::template ClusterCounter<EdgeWeightType> counter;
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
@@ -0,0 +1,237 @@
+/*
+ * This file belongs to the Galois project, a C++ library for exploiting
+ * parallelism. The code is being released under the terms of the 3-Clause BSD
+ * License (a copy is located in LICENSE.txt at the top-level directory).
+ *
+ * Copyright (C) 2018, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "katana/EdgeMap.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "pagerank-impl.h"
+
+namespace {
+
+using NodeData = std::tuple<NodeValue>;
+using EdgeData = std::tuple<>;
+
+using Graph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Default, NodeData, EdgeData>;
+
+using Edge = katana::GraphTopology::Edge;
+using Node = katana::GraphTopology::Node;
+
+/// Smallest number of destinations of a bin; there are at least 4 bins per
+/// thread down to this size so that accumulating the bins balances
+constexpr uint32_t kMinBinNodes = 1024;
+
+uint32_t
+BinNodes(uint64_t num_nodes) {
+  uint64_t bins = 4 * uint64_t{katana::getActiveThreads()};
+  uint64_t bin_nodes = (num_nodes + bins - 1) / bins;
+  return std::clamp<uint64_t>(
+      bin_nodes, kMinBinNodes, katana::EdgeBlocks::kDefaultBlockNodes);
+}
+
+/// The edges of a topology grouped into bins of consecutive destinations,
+/// like EdgeBlocks, but with only what binning and accumulating read: the
+/// destination of each bin entry and the bin entry of each out-edge. It takes
+/// 12 bytes per edge.
+struct Bins {
+  uint32_t bin_nodes{0};
+  /// entries of bin b are [offsets[b], offsets[b + 1])
+  std::vector<uint64_t> offsets;
+  katana::NUMAArray<Node> dests;
+  /// the bin entry of each out-edge
+  katana::NUMAArray<Edge> slots;
+
+  size_t num_bins() const { return offsets.size() - 1; }
+
+  Bins(const katana::GraphTopology& topo, uint32_t num_bin_nodes)
+      : bin_nodes(num_bin_nodes) {
+    const uint64_t num_nodes = topo.num_nodes();
+    const Edge* adj = topo.adj_data();
+    const Node* topo_dests = topo.dest_data();
+    const size_t num_bins = (num_nodes + bin_nodes - 1) / bin_nodes;
+    dests.allocateBlocked(topo.num_edges());
+    slots.allocateBlocked(topo.num_edges());
+
+    // A stable counting sort of the edges by destination bin, as in
+    // EdgeBlocks::Init. Thread t sorts a contiguous range of sources.
+    const unsigned num_threads = katana::getActiveThreads();
+    auto thread_nodes = [&](unsigned tid) {
+      return std::make_pair(
+          Node(num_nodes * tid / num_threads),
+          Node(num_nodes * (tid + 1) / num_threads));
+    };
+    // counts[b * num_threads + t] is the number of edges of thread t into
+    // bin b, and then where thread t writes its next edge into bin b
+    std::vector<uint64_t> counts(num_bins * num_threads + 1);
+
+    katana::on_each([&](unsigned tid, unsigned) {
+      auto [begin, end] = thread_nodes(tid);
+      uint64_t* mine = counts.data() + tid;
+      for (Edge e = begin == 0 ? 0 : adj[begin - 1];
+           e < (end == 0 ? 0 : adj[end - 1]); ++e) {
+        ++mine[size_t(topo_dests[e] / bin_nodes) * num_threads];
+      }
+    });
+
+    std::exclusive_scan(counts.begin(), counts.end(), counts.begin(), 0UL);
+    offsets.resize(num_bins + 1);
+    for (size_t b = 0; b <= num_bins; ++b) {
+      offsets[b] = counts[b * num_threads];
+    }
+
+    katana::on_each([&](unsigned tid, unsigned) {
+      auto [begin, end] = thread_nodes(tid);
+      uint64_t* mine = counts.data() + tid;
+      for (Edge e = begin == 0 ? 0 : adj[begin - 1];
+           e < (end == 0 ? 0 : adj[end - 1]); ++e) {
+        uint64_t& pos = mine[size_t(topo_dests[e] / bin_nodes) * num_threads];
+        dests[pos] = topo_dests[e];
+        slots[e] = pos;
+        ++pos;
+      }
+    });
+  }
+};
+
+/**
+ * PageRank with propagation blocking.
+ *
+ * Computes the same ranks as the topological pull algorithm, but in two
+ * phases per iteration that both access memory in order. Binning walks the
+ * out-edges of each source and writes its contribution to the bin of each
+ * destination, where a bin holds the edges into a block of destinations
+ * small enough for their sums to stay in L2 cache. Accumulating then adds
+ * up each bin into its destinations. The destination of each bin entry does
+ * not change between iterations, so only the contributions are written,
+ * as floats.
+ *
+ * BEAMER, Scott; ASANOVIC, Krste; PATTERSON, David. Reducing pagerank
+ * communication via propagation blocking. In: IEEE International Parallel and
+ * Distributed Processing Symposium. IEEE, 2017. p. 820-831.
+ */
+katana::Result<void>
+ComputePRBlocking(
+    const katana::GraphTopology& topo, Graph* graph,
+    katana::analytics::PagerankPlan plan) {
+  katana::StatTimer exec_time("PagerankPropagationBlocking");
+  exec_time.start();
+
+  const uint64_t num_nodes = topo.num_nodes();
+  const uint64_t num_edges = topo.num_edges();
+  const Edge* adj = topo.adj_data();
+
+  Bins bins(topo, BinNodes(num_nodes));
+  const uint32_t bin_nodes = bins.bin_nodes;
+
+  katana::NUMAArray<PRTy> contributions;
+  contributions.allocateBlocked(num_edges);
+  katana::NUMAArray<PRTy> rank;
+  rank.allocateBlocked(num_nodes);
+  katana::NUMAArray<PRTy> sums;
+  sums.allocateBlocked(num_nodes);
+
+  PRTy init_value = 1.0f / num_nodes;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        rank[n] = init_value;
+        sums[n] = 0;
+      },
+      katana::loopname("initNodeData"));
+
+  float base_score = (1.0f - plan.alpha());
+  unsigned int iteration = 0;
+  katana::GAccumulator<float> accum;
+
+  while (true) {
+    // no stealing: each thread writes its sources, which are contiguous, in
+    // order into each bin
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_nodes),
+        [&](uint64_t src) {
+          Edge begin = src == 0 ? 0 : adj[src - 1];
+          Edge end = adj[src];
+          if (begin == end) {
+            return;
+          }
+          PRTy contribution = rank[src] / (end - begin);
+          for (Edge e = begin; e < end; ++e) {
+            contributions[bins.slots[e]] = contribution;
+          }
+        },
+        katana::loopname("PagerankBinning"));
+
+    katana::do_all(
+        katana::iterate(size_t{0}, bins.num_bins()),
+        [&](size_t b) {
+          for (uint64_t i = bins.offsets[b]; i < bins.offsets[b + 1]; ++i) {
+            sums[bins.dests[i]] += contributions[i];
+          }
+
+          uint64_t first = b * uint64_t{bin_nodes};
+          uint64_t last = std::min(num_nodes, first + bin_nodes);
+          for (uint64_t n = first; n < last; ++n) {
+            float value = sums[n] * plan.alpha() + base_score;
+            accum += std::fabs(value - rank[n]);
+            rank[n] = value;
+            sums[n] = 0;
+          }
+        },
+        katana::steal(), katana::loopname("PagerankAccumulate"));
+
+    iteration += 1;
+    if (accum.reduce() <= plan.tolerance() ||
+        iteration >= plan.max_iterations()) {
+      break;
+    }
+    accum.reset();
+  }
+
+  katana::ReportStatSingle("PageRank", "Iterations", iteration);
+
+  katana::do_all(
+      katana::iterate(*graph),
+      [&](uint32_t i) { graph->template GetData<NodeValue>(i) = rank[i]; },
+      katana::loopname("Extract pagerank"), katana::no_stats());
+
+  exec_time.stop();
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+PagerankPropagationBlocking(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx) {
+  KATANA_CHECKED(katana::analytics::ConstructNodeProperties<NodeData>(
+      pg, txn_ctx, {output_property_name}));
+
+  Graph graph = KATANA_CHECKED(Graph::Make(pg, {output_property_name}, {}));
+
+  katana::EnsurePreallocated(2, 3 * graph.size() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  return ComputePRBlocking(pg->topology(), &graph, plan);
+}
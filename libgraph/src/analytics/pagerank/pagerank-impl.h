@@ -49,4 +49,19 @@ katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx);
 
+katana::Result<void> PagerankPropagationBlocking(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx);
+
+katana::Result<void> PagerankWarmStartImpl(
+    katana::PropertyGraph* pg, const std::string& initial_property_name,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx);
+
+katana::Result<void> PagerankDeltaImpl(
+    katana::PropertyGraph* pg, katana::PropertyGraph* previous_pg,
+    const std::string& previous_property_name,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx);
+
 #endif
@@ -17,8 +17,11 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <cmath>
+
 #include "katana/AtomicHelpers.h"
 #include "katana/Properties.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "pagerank-impl.h"
@@ -50,51 +53,36 @@ InitializeNodeResidual(
       katana::no_stats(), katana::loopname("Initialize"));
 }
 
-}  // namespace
-
-katana::Result<void>
-PagerankPushAsynchronous(
-    katana::PropertyGraph* pg, const std::string& output_property_name,
-    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx) {
-  katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
-  katana::ReportPageAllocGuard page_alloc;
-
-  katana::analytics::TemporaryPropertyGuard temporary_property{
-      pg->NodeMutablePropertyView()};
-
-  if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
-          pg, txn_ctx, {output_property_name, temporary_property.name()});
-      !result) {
-    return result.error();
-  }
-
-  Graph graph = KATANA_CHECKED(
-      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
-
-  InitializeNodeResidual(&graph, plan);
-
+/// Push residuals from the nodes in range until no node holds a residual
+/// larger than the tolerance. Residuals are negative where a node's starting
+/// rank overestimates its true rank, so both signs are pushed.
+template <typename Range>
+void
+PushResidualAsynchronous(
+    Graph* graph, const katana::analytics::PagerankPlan& plan,
+    const Range& range) {
   typedef katana::PerSocketChunkFIFO<
       katana::analytics::PagerankPlan::kChunkSize>
       WL;
   katana::for_each(
-      katana::iterate(graph),
+      range,
       [&](const GNode& src, auto& ctx) {
-        auto& src_residual = graph.GetData<NodeResidual>(src);
-        if (src_residual > plan.tolerance()) {
+        auto& src_residual = graph->GetData<NodeResidual>(src);
+        if (std::fabs(src_residual) > plan.tolerance()) {
           PRTy old_residual = src_residual.exchange(0.0);
-          auto& src_value = graph.GetData<NodeValue>(src);
+          auto& src_value = graph->GetData<NodeValue>(src);
           src_value += old_residual;
-          int src_nout = graph.edges(src).size();
+          int src_nout = graph->edges(src).size();
           if (src_nout > 0) {
             PRTy delta = old_residual * plan.alpha() / src_nout;
             //! For each out-going neighbors.
-            for (const auto& jj : graph.edges(src)) {
-              auto dest = graph.edge_dest(jj);
-              auto& dest_residual = graph.GetData<NodeResidual>(dest);
-              if (delta > 0) {
+            for (const auto& jj : graph->edges(src)) {
+              auto dest = graph->edge_dest(jj);
+              auto& dest_residual = graph->GetData<NodeResidual>(dest);
+              if (delta != 0) {
                 auto old = atomicAdd(dest_residual, delta);
-                if ((old < plan.tolerance()) &&
-                    (old + delta >= plan.tolerance())) {
+                if ((std::fabs(old) < plan.tolerance()) &&
+                    (std::fabs(old + delta) >= plan.tolerance())) {
                   ctx.push(dest);
                 }
               }
@@ -104,6 +92,171 @@ PagerankPushAsynchronous(
       },
       katana::loopname("PushResidualAsynchronous"),
       katana::disable_conflict_detection(), katana::wl<WL>());
+}
+
+/// Make the output and residual properties of a push computation.
+katana::Result<Graph>
+MakePushGraph(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const std::string& residual_property_name, tsuba::TxnContext* txn_ctx) {
+  KATANA_CHECKED(katana::analytics::ConstructNodeProperties<NodeData>(
+      pg, txn_ctx, {output_property_name, residual_property_name}));
+  return Graph::Make(pg, {output_property_name, residual_property_name}, {});
+}
+
+}  // namespace
+
+katana::Result<void>
+PagerankWarmStartImpl(
+    katana::PropertyGraph* pg, const std::string& initial_property_name,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx) {
+  auto initial =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<PRTy>(initial_property_name));
+
+  katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+  Graph graph = KATANA_CHECKED(MakePushGraph(
+      pg, output_property_name, temporary_property.name(), txn_ctx));
+
+  // The ranks x solve x = (1 - alpha) + alpha * P^T x. Starting from value
+  // x0, the residual is whatever x0 misses of that equation; pushing it to
+  // zero converges to x as from a uniform start, but only the change in the
+  // graph since x0 was computed has to be pushed.
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeValue>(n) = initial->Value(n);
+        graph.GetData<NodeResidual>(n) =
+            plan.initial_residual() - initial->Value(n);
+      },
+      katana::no_stats(), katana::loopname("InitializeWarmStart"));
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& src) {
+        int src_nout = graph.edges(src).size();
+        if (src_nout == 0) {
+          return;
+        }
+        PRTy share = initial->Value(src) * plan.alpha() / src_nout;
+        for (const auto& jj : graph.edges(src)) {
+          atomicAdd(graph.GetData<NodeResidual>(graph.edge_dest(jj)), share);
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ComputeWarmStartResidual"));
+
+  PushResidualAsynchronous(&graph, plan, katana::iterate(graph));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+PagerankDeltaImpl(
+    katana::PropertyGraph* pg, katana::PropertyGraph* previous_pg,
+    const std::string& previous_property_name,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx) {
+  const auto& topo = pg->topology();
+  const auto& previous_topo = previous_pg->topology();
+  uint64_t num_previous_nodes = previous_topo.num_nodes();
+  if (topo.num_nodes() < num_previous_nodes) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph has {} nodes but its previous version has {}", topo.num_nodes(),
+        num_previous_nodes);
+  }
+  auto previous = KATANA_CHECKED(
+      previous_pg->GetNodePropertyTyped<PRTy>(previous_property_name));
+
+  katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+  Graph graph = KATANA_CHECKED(MakePushGraph(
+      pg, output_property_name, temporary_property.name(), txn_ctx));
+
+  // If the previous ranks left residuals below the tolerance, the residual
+  // against the new graph is alpha * (P_new - P_old)^T x_old, which is only
+  // nonzero at the old and new destinations of nodes whose out-edges changed,
+  // plus the teleport term of nodes that did not exist before.
+  katana::InsertBag<GNode> seeds;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        bool is_new = n >= num_previous_nodes;
+        graph.GetData<NodeValue>(n) = is_new ? 0 : previous->Value(n);
+        graph.GetData<NodeResidual>(n) = is_new ? plan.initial_residual() : 0;
+        if (is_new) {
+          seeds.push(n);
+        }
+      },
+      katana::no_stats(), katana::loopname("InitializeDelta"));
+
+  katana::GAccumulator<uint64_t> changed_nodes;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_previous_nodes),
+      [&](uint64_t n) {
+        auto edges = topo.edges(n);
+        auto previous_edges = previous_topo.edges(n);
+        if (edges.size() == previous_edges.size() &&
+            std::equal(
+                edges.begin(), edges.end(), previous_edges.begin(),
+                [&](auto e, auto previous_e) {
+                  return topo.edge_dest(e) ==
+                         previous_topo.edge_dest(previous_e);
+                })) {
+          return;
+        }
+        changed_nodes += 1;
+
+        if (previous_edges.size() > 0) {
+          PRTy share =
+              previous->Value(n) * plan.alpha() / previous_edges.size();
+          for (auto e : previous_edges) {
+            auto dest = previous_topo.edge_dest(e);
+            atomicAdd(graph.GetData<NodeResidual>(dest), -share);
+            seeds.push(dest);
+          }
+        }
+        if (edges.size() > 0) {
+          PRTy share = previous->Value(n) * plan.alpha() / edges.size();
+          for (auto e : edges) {
+            auto dest = topo.edge_dest(e);
+            atomicAdd(graph.GetData<NodeResidual>(dest), share);
+            seeds.push(dest);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats(),
+      katana::loopname("ComputeDeltaResidual"));
+  katana::ReportStatSingle("Pagerank", "ChangedNodes", changed_nodes.reduce());
+
+  PushResidualAsynchronous(&graph, plan, katana::iterate(seeds));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+PagerankPushAsynchronous(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, tsuba::TxnContext* txn_ctx) {
+  katana::EnsurePreallocated(5, 5 * pg->num_nodes() * sizeof(NodeData));
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+
+  Graph graph = KATANA_CHECKED(MakePushGraph(
+      pg, output_property_name, temporary_property.name(), txn_ctx));
+
+  InitializeNodeResidual(&graph, plan);
+
+  PushResidualAsynchronous(&graph, plan, katana::iterate(graph));
 
   return katana::ResultSuccess();
 }
@@ -33,11 +33,34 @@ katana::analytics::Pagerank(
     return PagerankPushAsynchronous(pg, output_property_name, plan, txn_ctx);
   case PagerankPlan::kPushSynchronous:
     return PagerankPushSynchronous(pg, output_property_name, plan, txn_ctx);
+  case PagerankPlan::kPropagationBlocking:
+    return PagerankPropagationBlocking(
+        pg, output_property_name, plan, txn_ctx);
   default:
     return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<void>
+katana::analytics::PagerankWarmStart(
+    katana::PropertyGraph* pg, const std::string& initial_property_name,
+    const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
+    katana::analytics::PagerankPlan plan) {
+  return PagerankWarmStartImpl(
+      pg, initial_property_name, output_property_name, plan, txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::PagerankDelta(
+    katana::PropertyGraph* pg, katana::PropertyGraph* previous_pg,
+    const std::string& previous_property_name,
+    const std::string& output_property_name, tsuba::TxnContext* txn_ctx,
+    katana::analytics::PagerankPlan plan) {
+  return PagerankDeltaImpl(
+      pg, previous_pg, previous_property_name, output_property_name, plan,
+      txn_ctx);
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::PagerankAssertValid(
@@ -19,7 +19,16 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
+#include "tsuba/ParquetWriter.h"
 
 using namespace katana::analytics;
 
@@ -29,6 +38,78 @@ namespace {
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
+/// Maximum number of nodes in a walk. Walks always take at least one step.
+uint32_t
+WalkStride(const RandomWalksPlan& plan) {
+  return std::max<uint32_t>(plan.walk_length(), 1) + 1;
+}
+
+/// Owns a NUMAArray so that Arrow can use its memory without a copy.
+///
+/// Arrow may release the buffer on any thread, including after the Katana
+/// runtime has shut down. That is safe for arrays of scalars, whose release
+/// is a munmap that needs neither the thread pool nor per-thread storage;
+/// other element types would run their destructors in a parallel loop.
+template <typename T>
+class NUMAArrayBuffer : public arrow::Buffer {
+  static_assert(
+      std::is_scalar_v<T>,
+      "releasing the array must not need the Katana runtime");
+
+public:
+  explicit NUMAArrayBuffer(katana::NUMAArray<T>&& array)
+      : arrow::Buffer(
+            reinterpret_cast<const uint8_t*>(array.data()),
+            array.size() * sizeof(T)),
+        array_(std::move(array)) {}
+
+private:
+  katana::NUMAArray<T> array_;
+};
+
+/// Generate walks [0, num_walks) in batches of at most batch_size walks and
+/// pass each batch to consumer. Walk i starts at starts[i % starts.size()].
+template <typename Algorithm>
+katana::Result<void>
+WalkBatches(
+    Algorithm* algo, const typename Algorithm::SortedGraphView& graph,
+    const katana::NUMAArray<uint64_t>& degree,
+    const katana::NUMAArray<uint32_t>& starts, uint64_t batch_size,
+    const RandomWalksConsumer& consumer) {
+  uint64_t num_walks = starts.size() * algo->plan_.number_of_walks();
+  uint32_t stride = WalkStride(algo->plan_);
+
+  katana::PerThreadStorage<std::mt19937> generator;
+  katana::PerThreadStorage<std::uniform_real_distribution<double>>
+      distribution;
+
+  for (uint64_t first = 0; first < num_walks; first += batch_size) {
+    uint64_t size = std::min(batch_size, num_walks - first);
+
+    katana::NUMAArray<uint32_t> nodes;
+    nodes.allocateBlocked(size * stride);
+    katana::NUMAArray<uint32_t> lengths;
+    lengths.allocateBlocked(size);
+
+    katana::do_all(
+        katana::iterate(uint64_t(0), size),
+        [&](uint64_t i) {
+          uint64_t walk = first + i;
+          lengths[i] = algo->Walk(
+              graph, starts[walk % starts.size()], degree,
+              generator.getLocal(), distribution.getLocal(),
+              &nodes[i * stride], walk);
+        },
+        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
+        katana::loopname(Algorithm::kLoopName), katana::no_stats());
+
+    KATANA_CHECKED(consumer(
+        RandomWalksResult(std::move(nodes), std::move(lengths), stride),
+        first));
+  }
+  return katana::ResultSuccess();
+}
+
 struct Node2VecAlgo {
   using NodeData = std::tuple<>;
   using EdgeData = std::tuple<>;
@@ -37,8 +118,20 @@ struct Node2VecAlgo {
       SortedPropertyGraphView, NodeData, EdgeData>;
   using GNode = typename SortedGraphView::Node;
 
+  static constexpr const char* kLoopName = "Node2vec walks";
+
   const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  double prob_forward_;
+  double prob_backward_;
+  double upper_bound_;
+  double lower_bound_;
+
+  Node2VecAlgo(const RandomWalksPlan& plan)
+      : plan_(plan),
+        prob_forward_(1.0 / plan.forward_probability()),
+        prob_backward_(1.0 / plan.backward_probability()),
+        upper_bound_(std::max({1.0, prob_forward_, prob_backward_})),
+        lower_bound_(std::min({1.0, prob_forward_, prob_backward_})) {}
 
   GNode FindSampleNeighbor(
       const SortedGraphView& graph, const GNode& n,
@@ -53,122 +146,80 @@ struct Node2VecAlgo {
     return graph.edge_dest(*ei);
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
+  /// Write the walk starting at n to walk and return its length
+  uint32_t Walk(
+      const SortedGraphView& graph, GNode n,
+      const katana::NUMAArray<uint64_t>& degree, std::mt19937* generator,
+      std::uniform_real_distribution<double>* dist, uint32_t* walk,
+      uint64_t) {
+    uint32_t length = 0;
+    walk[length++] = n;
 
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
+    //random value between 0 and 1
+    double prob = (*dist)(*generator);
 
-    double lower_bound = 1.0;
+    //Assumption: All edges have weight 1
+    auto nbr = FindSampleNeighbor(graph, n, degree, prob);
+    KATANA_LOG_ASSERT(nbr < graph.num_nodes());
 
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
+    walk[length++] = nbr;
 
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+    for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
+         current_walk++) {
+      uint32_t curr = walk[current_walk - 1];
+      uint32_t prev = walk[current_walk - 2];
 
-    katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
+      //check if n has no neighbor
+      if (degree[curr] == 0) {
+        break;
+      }
+      //acceptance-rejection sampling
+      while (true) {
+        //sample x
+        double prob = (*dist)(*generator);
+
+        auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
+        KATANA_LOG_ASSERT(nbr < graph.num_nodes());
+
+        //sample y
+        double y = (*dist)(*generator);
+        y = y * upper_bound_;
+
+        if (y <= lower_bound_) {
+          //accept this sample
+          walk[length++] = nbr;
+          break;
+        } else {
+          //compute transition probability
+          double alpha;
+
+          //check if nbr is same as the previous node on this walk
+          if (nbr == prev) {
+            alpha = prob_backward_;
+          }  //check if nbr is also a neighbor of the previous node on this walk
+          else if (graph.has_edge(prev, nbr)) {
+            alpha = 1.0;
+          } else {
+            alpha = prob_forward_;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
-
-          //Assumption: All edges have weight 1
-          auto nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.num_nodes());
-
-          walk.push_back(std::move(nbr));
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
-
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              break;
-            }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.num_nodes());
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
-              } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (graph.has_edge(prev, nbr)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
-              }
-            }
+          if (y <= alpha) {
+            //accept y
+            walk[length++] = nbr;
+            break;
           }
-
-          walks->push(std::move(walk));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Node2vec walks"), katana::no_stats());
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
+        }
+      }
     }
+
+    return length;
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      const katana::NUMAArray<uint32_t>& starts, uint64_t batch_size,
+      const RandomWalksConsumer& consumer) {
+    return WalkBatches(this, graph, degree, starts, batch_size, consumer);
   }
 };
 
@@ -182,12 +233,27 @@ struct Edge2VecAlgo {
       SortedPropertyGraphView, NodeData, EdgeData>;
   using GNode = typename SortedGraphView::Node;
 
+  static constexpr const char* kLoopName = "Edge2vec walks";
+
   const RandomWalksPlan& plan_;
-  Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  double prob_forward_;
+  double prob_backward_;
+  double upper_bound_;
+
+  Edge2VecAlgo(const RandomWalksPlan& plan)
+      : plan_(plan),
+        prob_forward_(1.0 / plan.forward_probability()),
+        prob_backward_(1.0 / plan.backward_probability()),
+        upper_bound_(std::max({1.0, prob_forward_, prob_backward_})) {}
 
   //transition matrix
   std::vector<std::vector<double>> transition_matrix_;
 
+  /// Number of edges of each type on each walk of the current iteration,
+  /// stored as type_counts_[type * num_walks_ + walk]
+  katana::NUMAArray<uint32_t> type_counts_;
+  uint64_t num_walks_{0};
+
   void Initialize() {
     transition_matrix_.resize(plan_.number_of_edge_types() + 1);
     //initialize transition matrix
@@ -212,176 +278,94 @@ struct Edge2VecAlgo {
         graph.edge_dest(*ei), graph.GetEdgeData<EdgeType>(*ei));
   }
 
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
-    }
-
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
-
-    katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
-            return;
-          }
-
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
-
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
-
-          walk.push_back(n);
-
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
-
-          //Assumption: All edges have weight 1
-          auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-          walk.push_back(std::move(nbr_pair.first));
-          types_vec.push_back(nbr_pair.second);
-
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              return;
-            }
-            uint32_t prev = walk[walk.size() - 2];
-
-            uint32_t p1 = types_vec.back();  //last element of types_vec
-
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
-
-              auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
-
-              GNode nbr = nbr_type_pair.first;
-              EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
-
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
-
-              //compute transition probability
-              double alpha;
-
-              //check if nbr is same as the previous node on this walk
-              if (nbr == prev) {
-                alpha = prob_backward;
-              }  //check if nbr is also a neighbor of the previous node on this walk
-              else if (graph.has_edge(prev, nbr)) {
-                alpha = 1.0;
-              } else {
-                alpha = prob_forward;
-              }
-
-              alpha = alpha * transition_matrix_[p1][p2];
-              if (alpha >= y) {
-                //accept y
-                walk.push_back(std::move(nbr));
-                types_vec.push_back(p2);
-                break;
-              }
-            }  //end while
-
-          }  //end for
-
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
-        },
-        katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
-        katana::loopname("Edge2vec walks"), katana::no_stats());
-  }
-
-  //compute the histogram of edge types for each walk
-  std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
-    std::vector<std::vector<uint32_t>> num_edge_types_walks;
-
-    katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
-        per_thread_num_edge_types_walks;
-    katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
-          std::vector<uint32_t> num_edge_types(
-              plan_.number_of_edge_types() + 1, 0);
-
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
-          }
-
-          per_thread_num_edge_types_walks.getLocal()->emplace_back(
-              std::move(num_edge_types));
-        });
-
-    for (unsigned j = 0; j < katana::getActiveThreads(); ++j) {
-      for (auto num_edge_types :
-           *per_thread_num_edge_types_walks.getRemote(j)) {
-        num_edge_types_walks.push_back(std::move(num_edge_types));
+  /// Write the walk starting at n to walk and return its length. Also
+  /// counts the types of the edges taken in type_counts_.
+  uint32_t Walk(
+      const SortedGraphView& graph, GNode n,
+      const katana::NUMAArray<uint64_t>& degree, std::mt19937* generator,
+      std::uniform_real_distribution<double>* dist, uint32_t* walk,
+      uint64_t walk_index) {
+    uint32_t length = 0;
+    walk[length++] = n;
+
+    //random value between 0 and 1
+    double prob = (*dist)(*generator);
+
+    //Assumption: All edges have weight 1
+    auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
+    KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
+
+    walk[length++] = nbr_pair.first;
+    uint32_t p1 = nbr_pair.second;
+    type_counts_[p1 * num_walks_ + walk_index]++;
+
+    for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
+         current_walk++) {
+      uint32_t curr = walk[length - 1];
+      //check if n has no neighbor
+      if (degree[curr] == 0) {
+        break;
       }
-    }
-
-    return num_edge_types_walks;
+      uint32_t prev = walk[length - 2];
+
+      //acceptance-rejection sampling
+      while (true) {
+        //sample x
+        double prob = (*dist)(*generator);
+
+        auto nbr_type_pair = FindSampleNeighbor(graph, curr, degree, prob);
+        KATANA_LOG_ASSERT(nbr_type_pair.first < graph.num_nodes());
+
+        GNode nbr = nbr_type_pair.first;
+        EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
+
+        //sample y
+        double y = (*dist)(*generator);
+        y = y * upper_bound_;
+
+        //compute transition probability
+        double alpha;
+
+        //check if nbr is same as the previous node on this walk
+        if (nbr == prev) {
+          alpha = prob_backward_;
+        }  //check if nbr is also a neighbor of the previous node on this walk
+        else if (graph.has_edge(prev, nbr)) {
+          alpha = 1.0;
+        } else {
+          alpha = prob_forward_;
+        }
+
+        alpha = alpha * transition_matrix_[p1][p2];
+        if (alpha >= y) {
+          //accept y
+          walk[length++] = nbr;
+          type_counts_[p2 * num_walks_ + walk_index]++;
+          p1 = p2;
+          break;
+        }
+      }  //end while
+
+    }  //end for
+
+    return length;
   }
 
-  std::vector<std::vector<uint32_t>> TransformVectors(
-      const std::vector<std::vector<uint32_t>>& num_edge_types_walks) {
-    uint32_t rows = num_edge_types_walks.size();
-    std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks;
-    transformed_num_edge_types_walks.resize(plan_.number_of_edge_types() + 1);
-
-    katana::do_all(
-        katana::iterate(uint32_t(0), plan_.number_of_edge_types() + 1),
-        [&](uint32_t j) {
-          for (uint32_t i = 0; i < rows; i++) {
-            transformed_num_edge_types_walks[j].push_back(
-                num_edge_types_walks[i][j]);
-          }
-        });
-
-    return transformed_num_edge_types_walks;
+  const uint32_t* TypeCounts(uint32_t type) const {
+    return &type_counts_[type * num_walks_];
   }
 
-  std::vector<double> ComputeMeans(const std::vector<std::vector<uint32_t>>&
-                                       transformed_num_edge_types_walks) {
+  std::vector<double> ComputeMeans() {
     std::vector<double> means(plan_.number_of_edge_types() + 1);
 
     for (uint32_t i = 1; i <= plan_.number_of_edge_types(); i++) {
-      uint32_t sum = 0;
-      for (auto n : transformed_num_edge_types_walks[i]) {
-        sum += n;
+      const uint32_t* counts = TypeCounts(i);
+      uint64_t sum = 0;
+      for (uint64_t m = 0; m < num_walks_; m++) {
+        sum += counts[m];
       }
 
-      means[i] = ((double)sum) / (transformed_num_edge_types_walks[i].size());
+      means[i] = ((double)sum) / num_walks_;
     }
 
     return means;
@@ -392,45 +376,38 @@ struct Edge2VecAlgo {
   }
 
   double pearsonCorr(
-      const uint32_t i, const uint32_t j,
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
-    const std::vector<uint32_t>& x = transformed_num_edge_types_walks[i];
-    const std::vector<uint32_t>& y = transformed_num_edge_types_walks[j];
+      const uint32_t i, const uint32_t j, const std::vector<double>& means) {
+    const uint32_t* x = TypeCounts(i);
+    const uint32_t* y = TypeCounts(j);
 
     double sum = 0.0;
     double sig1 = 0.0;
     double sig2 = 0.0;
 
-    for (uint32_t m = 0; m < x.size(); m++) {
+    for (uint64_t m = 0; m < num_walks_; m++) {
       sum += ((double)x[m] - means[i]) * ((double)y[m] - means[j]);
       sig1 += ((double)x[m] - means[i]) * ((double)x[m] - means[i]);
       sig2 += ((double)y[m] - means[j]) * ((double)y[m] - means[j]);
     }
 
-    sum = sum / x.size();
+    sum = sum / num_walks_;
 
-    sig1 = sig1 / x.size();
+    sig1 = sig1 / num_walks_;
     sig1 = sqrt(sig1);
 
-    sig2 = sig2 / x.size();
+    sig2 = sig2 / num_walks_;
     sig2 = sqrt(sig2);
 
     double corr = sum / (sig1 * sig2);
     return corr;
   }
 
-  void ComputeTransitionMatrix(
-      const std::vector<std::vector<uint32_t>>&
-          transformed_num_edge_types_walks,
-      const std::vector<double>& means) {
+  void ComputeTransitionMatrix(const std::vector<double>& means) {
     katana::do_all(
         katana::iterate(uint32_t(1), plan_.number_of_edge_types() + 1),
         [&](uint32_t i) {
           for (uint32_t j = 1; j <= plan_.number_of_edge_types(); j++) {
-            double pearson_corr =
-                pearsonCorr(i, j, transformed_num_edge_types_walks, means);
+            double pearson_corr = pearsonCorr(i, j, means);
             double sigmoid = sigmoidCal(pearson_corr);
 
             transition_matrix_[i][j] = sigmoid;
@@ -438,32 +415,38 @@ struct Edge2VecAlgo {
         });
   }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
+  katana::Result<void> operator()(
+      const SortedGraphView& graph, const katana::NUMAArray<uint64_t>& degree,
+      const katana::NUMAArray<uint32_t>& starts, uint64_t batch_size,
+      const RandomWalksConsumer& consumer) {
     uint32_t iterations = plan_.max_iterations();
 
     Initialize();
 
+    num_walks_ = starts.size() * plan_.number_of_walks();
+    if (num_walks_ == 0) {
+      return katana::ResultSuccess();
+    }
+    type_counts_.allocateBlocked(
+        (plan_.number_of_edge_types() + 1) * num_walks_);
+
     for (uint32_t iter = 0; iter < iterations; iter++) {
       //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
-
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      katana::ParallelSTL::fill(
+          type_counts_.begin(), type_counts_.end(), uint32_t{0});
+      // The walks of every iteration are part of the result, after those of
+      // the iterations before it
+      KATANA_CHECKED(WalkBatches(
+          this, graph, degree, starts, batch_size,
+          [&](RandomWalksResult&& batch, uint64_t first) {
+            return consumer(std::move(batch), iter * num_walks_ + first);
+          }));
 
       //Update transition matrix
-      std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
-
-      std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
-          TransformVectors(num_edge_types_walks);
-
-      std::vector<double> means =
-          ComputeMeans(transformed_num_edge_types_walks);
-
-      ComputeTransitionMatrix(transformed_num_edge_types_walks, means);
+      std::vector<double> means = ComputeMeans();
+      ComputeTransitionMatrix(means);
     }
+    return katana::ResultSuccess();
   }
 };
 
@@ -477,51 +460,211 @@ InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
   });
 }
 
+/// Nodes with at least one neighbor, in order; walks only start from these
+katana::NUMAArray<uint32_t>
+FindStarts(const katana::NUMAArray<uint64_t>& degree) {
+  // Count the starts in each block, then copy each block's starts to its
+  // offset in the output.
+  const size_t num_blocks = katana::getActiveThreads();
+  std::vector<size_t> block_offsets(num_blocks + 1, 0);
+  katana::do_all(
+      katana::iterate(size_t(0), num_blocks),
+      [&](size_t block) {
+        auto [begin, end] =
+            katana::block_range(size_t(0), degree.size(), block, num_blocks);
+        block_offsets[block + 1] = std::count_if(
+            degree.begin() + begin, degree.begin() + end,
+            [](uint64_t d) { return d != 0; });
+      },
+      katana::no_stats());
+  std::partial_sum(
+      block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+  katana::NUMAArray<uint32_t> starts;
+  starts.allocateBlocked(block_offsets[num_blocks]);
+  katana::do_all(
+      katana::iterate(size_t(0), num_blocks),
+      [&](size_t block) {
+        auto [begin, end] =
+            katana::block_range(size_t(0), degree.size(), block, num_blocks);
+        size_t out = block_offsets[block];
+        for (size_t n = begin; n < end; ++n) {
+          if (degree[n] != 0) {
+            starts[out++] = n;
+          }
+        }
+      },
+      katana::no_stats());
+  return starts;
+}
+
+/// Walks of all batches, in order. The batches must have the same stride.
+RandomWalksResult
+Concatenate(const std::vector<RandomWalksResult>& batches) {
+  uint32_t stride = batches[0].stride();
+  std::vector<uint64_t> offsets(batches.size() + 1, 0);
+  for (size_t i = 0; i < batches.size(); ++i) {
+    KATANA_LOG_DEBUG_ASSERT(batches[i].stride() == stride);
+    offsets[i + 1] = offsets[i] + batches[i].num_walks();
+  }
+
+  katana::NUMAArray<uint32_t> nodes;
+  nodes.allocateBlocked(offsets.back() * stride);
+  katana::NUMAArray<uint32_t> lengths;
+  lengths.allocateBlocked(offsets.back());
+  for (size_t i = 0; i < batches.size(); ++i) {
+    katana::ParallelSTL::copy(
+        batches[i].nodes().begin(), batches[i].nodes().end(),
+        nodes.begin() + offsets[i] * stride);
+    katana::ParallelSTL::copy(
+        batches[i].lengths().begin(), batches[i].lengths().end(),
+        lengths.begin() + offsets[i]);
+  }
+  return RandomWalksResult(std::move(nodes), std::move(lengths), stride);
+}
+
 }  //namespace
 
 template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
+static katana::Result<void>
 RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
+    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan,
+    uint64_t batch_size, const RandomWalksConsumer& consumer) {
   katana::ReportPageAllocGuard page_alloc;
 
+  if (batch_size == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "batch size must be positive");
+  }
+
   Algorithm algo(plan);
 
   katana::NUMAArray<uint64_t> degree;
   degree.allocateBlocked(graph.size());
   InitializeDegrees(graph, &degree);
 
+  katana::NUMAArray<uint32_t> starts = FindStarts(degree);
+
   katana::StatTimer execTime("RandomWalks");
   execTime.start();
-  katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
+  KATANA_CHECKED(algo(graph, degree, starts, batch_size, consumer));
   execTime.stop();
 
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
-  return walks_in_vector;
+  return katana::ResultSuccess();
 }
 
-katana::Result<std::vector<std::vector<uint32_t>>>
-katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+katana::Result<void>
+katana::analytics::RandomWalks(
+    PropertyGraph* pg, const RandomWalksConsumer& consumer,
+    uint64_t batch_size, RandomWalksPlan plan) {
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
     auto graph =
         KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Node2VecAlgo>(
+        graph, plan, batch_size, consumer);
   }
   case RandomWalksPlan::kEdge2Vec: {
     TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
     auto graph = KATANA_CHECKED(
         Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Edge2VecAlgo>(
+        graph, plan, batch_size, consumer);
   }
   default:
     return ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<RandomWalksResult>
+katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+  // Generate the walks in as few batches as possible: one, or one per
+  // iteration for Edge2Vec
+  std::vector<RandomWalksResult> batches;
+  KATANA_CHECKED(RandomWalks(
+      pg,
+      [&batches](RandomWalksResult&& batch, uint64_t) {
+        batches.emplace_back(std::move(batch));
+        return katana::ResultSuccess();
+      },
+      std::numeric_limits<uint64_t>::max(), plan));
+
+  if (batches.empty()) {
+    return RandomWalksResult();
+  }
+  if (batches.size() == 1) {
+    return RandomWalksResult(std::move(batches[0]));
+  }
+  return Concatenate(batches);
+}
+
+katana::Result<void>
+katana::analytics::RandomWalksToParquet(
+    PropertyGraph* pg, const katana::Uri& prefix, uint64_t batch_size,
+    RandomWalksPlan plan) {
+  uint64_t file_index = 0;
+  return RandomWalks(
+      pg,
+      [&](RandomWalksResult&& batch, uint64_t) -> katana::Result<void> {
+        auto array = KATANA_CHECKED(batch.ToArrowArray());
+        auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(
+            std::make_shared<arrow::ChunkedArray>(array), "walk"));
+        KATANA_CHECKED(
+            writer->WriteToUri(prefix + ("." + std::to_string(file_index))));
+        file_index++;
+        return katana::ResultSuccess();
+      },
+      batch_size, plan);
+}
+
+katana::Result<std::shared_ptr<arrow::FixedSizeListArray>>
+RandomWalksResult::ToArrowArray() {
+  uint64_t num_walks = lengths_.size();
+  uint64_t num_slots = num_walks * stride_;
+
+  // Walks that ended early leave null slots behind them
+  katana::GAccumulator<uint64_t> null_count;
+  katana::do_all(katana::iterate(uint64_t(0), num_walks), [&](uint64_t walk) {
+    null_count += stride_ - lengths_[walk];
+  });
+
+  std::shared_ptr<arrow::Buffer> null_bitmap;
+  if (null_count.reduce() != 0) {
+    null_bitmap = KATANA_CHECKED(arrow::AllocateEmptyBitmap(num_slots));
+    uint8_t* bits = null_bitmap->mutable_data();
+    // Each byte is set by one iteration so that walks sharing a byte do not
+    // race
+    katana::do_all(
+        katana::iterate(uint64_t(0), (num_slots + 7) / 8), [&](uint64_t byte) {
+          uint8_t value = 0;
+          for (uint64_t slot = byte * 8;
+               slot < std::min(byte * 8 + 8, num_slots); ++slot) {
+            if (slot % stride_ < lengths_[slot / stride_]) {
+              value |= uint8_t(1) << (slot % 8);
+            }
+          }
+          bits[byte] = value;
+        });
+  }
+
+  auto values = std::make_shared<arrow::UInt32Array>(
+      num_slots, std::make_shared<NUMAArrayBuffer<uint32_t>>(std::move(nodes_)),
+      null_bitmap, null_count.reduce());
+  lengths_ = NUMAArray<uint32_t>();
+
+  return std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(arrow::uint32(), stride_), num_walks, values);
+}
+
+std::vector<std::vector<uint32_t>>
+RandomWalksResult::ToVectors() const {
+  std::vector<std::vector<uint32_t>> walks(num_walks());
+  katana::do_all(katana::iterate(uint64_t(0), num_walks()), [&](uint64_t i) {
+    walks[i].assign(begin(i), end(i));
+  });
+  return walks;
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::RandomWalksAssertValid(
@@ -19,6 +19,7 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include "katana/NUMAArray.h"
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
@@ -541,6 +542,121 @@ SSSPWithWrap(
   return Sssp(graph.value(), start_node, plan);
 }
 
+template <typename Weight>
+using SsspMultiGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<SsspEdgeWeight<Weight>>>;
+
+/// Frontier-based Bellman-Ford from up to kMultiSourceWidth sources at once.
+/// A node is active for the sources whose distance to it dropped in the last
+/// round; relaxing its edges updates all of those sources in one scan.
+template <typename Weight>
+void
+SsspMultiBatch(
+    const SsspMultiGraph<Weight>& graph, const uint32_t* sources,
+    size_t num_sources, Weight* const* distances) {
+  using Impl = SsspImplementation<Weight>;
+  using SourceMask = typename Impl::SourceMask;
+  using GNode = typename SsspMultiGraph<Weight>::Node;
+
+  // Distance columns are updated concurrently, the same way
+  // AtomicPODProperty views plain arrow buffers.
+  std::vector<std::atomic<Weight>*> dist(num_sources);
+  for (size_t i = 0; i < num_sources; ++i) {
+    dist[i] = reinterpret_cast<std::atomic<Weight>*>(distances[i]);
+  }
+
+  katana::NUMAArray<SourceMask> visit;
+  katana::NUMAArray<SourceMask> next;
+  visit.allocateBlocked(graph.num_nodes());
+  next.allocateBlocked(graph.num_nodes());
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        visit[n] = 0;
+        next[n] = 0;
+      },
+      katana::no_stats(), katana::loopname("SsspMulti-Init"));
+
+  for (size_t i = 0; i < num_sources; ++i) {
+    visit[sources[i]] |= SourceMask{1} << i;
+    dist[i][sources[i]] = 0;
+  }
+
+  katana::GReduceLogicalOr active;
+  size_t rounds = 0;
+  do {
+    ++rounds;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          SourceMask frontier = visit[n];
+          if (frontier == 0) {
+            return;
+          }
+          for (auto e : graph.edges(n)) {
+            auto dest = *graph.GetEdgeDest(e);
+            Weight weight =
+                graph.template GetEdgeData<SsspEdgeWeight<Weight>>(e);
+            SourceMask improved = 0;
+            Impl::ForEachSource(frontier, [&](size_t i) {
+              Weight new_dist = dist[i][n].load(std::memory_order_relaxed) +
+                                weight;
+              if (new_dist < katana::atomicMin(dist[i][dest], new_dist)) {
+                improved |= SourceMask{1} << i;
+              }
+            });
+            if (improved != 0) {
+              Impl::MergeSources(&next[dest], improved);
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<Impl::kChunkSize>(),
+        katana::loopname("SsspMulti-Relax"));
+
+    active.reset();
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          visit[n] = next[n];
+          next[n] = 0;
+          if (visit[n] != 0) {
+            active.update(true);
+          }
+        },
+        katana::loopname("SsspMulti-Advance"));
+  } while (active.reduce());
+
+  katana::ReportStatSingle("SsspMulti", "rounds", rounds);
+}
+
+template <typename Weight>
+katana::Result<void>
+SsspMultiWithWrap(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::vector<std::string>& output_property_names,
+    tsuba::TxnContext* txn_ctx) {
+  using Impl = SsspImplementation<Weight>;
+
+  auto graph = KATANA_CHECKED(
+      SsspMultiGraph<Weight>::Make(pg, {}, {edge_weight_property_name}));
+  auto distances = KATANA_CHECKED(
+      Impl::MultiSourceDistances::Make(sources.size(), pg->num_nodes()));
+
+  katana::StatTimer exec_time("SsspMulti");
+  exec_time.start();
+  constexpr size_t kWidth = Impl::kMultiSourceWidth;
+  for (size_t begin = 0; begin < sources.size(); begin += kWidth) {
+    SsspMultiBatch<Weight>(
+        graph, &sources[begin], std::min(kWidth, sources.size() - begin),
+        distances.columns(begin));
+  }
+  exec_time.stop();
+
+  return std::move(distances).AddTo(pg, output_property_names, txn_ctx);
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -585,6 +701,62 @@ katana::analytics::Sssp(
   }
 }
 
+katana::Result<void>
+katana::analytics::SsspMulti(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::vector<std::string>& output_property_names,
+    tsuba::TxnContext* txn_ctx) {
+  if (sources.size() != output_property_names.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} output properties", sources.size(),
+        output_property_names.size());
+  }
+  for (auto source : sources) {
+    if (source >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "source {} is not a node",
+          source);
+    }
+  }
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return SsspMultiWithWrap<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_names,
+        txn_ctx);
+  case arrow::Int32Type::type_id:
+    return SsspMultiWithWrap<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_names,
+        txn_ctx);
+  case arrow::UInt64Type::type_id:
+    return SsspMultiWithWrap<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_names,
+        txn_ctx);
+  case arrow::Int64Type::type_id:
+    return SsspMultiWithWrap<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_names,
+        txn_ctx);
+  case arrow::FloatType::type_id:
+    return SsspMultiWithWrap<float>(
+        pg, sources, edge_weight_property_name, output_property_names,
+        txn_ctx);
+  case arrow::DoubleType::type_id:
+    return SsspMultiWithWrap<double>(
+        pg, sources, edge_weight_property_name, output_property_names,
+        txn_ctx);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
 namespace {
 
 template <typename Weight>
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/betweenness_centrality/betweenness_centrality.h"
+
+using katana::analytics::BetweennessCentralityPlan;
+
+namespace {
+
+constexpr double kEpsilon = 0.05;
+constexpr double kDelta = 0.01;
+constexpr uint32_t kTopK = 5;
+/// Room for the float output of both algorithms
+constexpr double kSlack = 1e-5;
+
+std::shared_ptr<arrow::FloatArray>
+RunBetweennessCentrality(
+    katana::PropertyGraph* pg, const std::string& name,
+    BetweennessCentralityPlan plan) {
+  tsuba::TxnContext txn_ctx;
+  auto res = katana::analytics::BetweennessCentrality(
+      pg, name, &txn_ctx, katana::analytics::kBetweennessCentralityAllNodes,
+      plan);
+  KATANA_LOG_VASSERT(res, "BetweennessCentrality: {}", res.error());
+  return pg->GetNodePropertyTyped<float>(name).value();
+}
+
+/// Check the approximations of both modes against the exact Level
+/// centralities, in the normalized units bc(v) / (n (n - 1)) that epsilon
+/// bounds
+void
+TestApproximate(std::unique_ptr<katana::PropertyGraph>&& pg) {
+  double scale = static_cast<double>(pg->size()) * (pg->size() - 1);
+  auto exact =
+      RunBetweennessCentrality(pg.get(), "exact", BetweennessCentralityPlan());
+  auto all = RunBetweennessCentrality(
+      pg.get(), "approximate",
+      BetweennessCentralityPlan::Approximate(kEpsilon, kDelta));
+  auto top = RunBetweennessCentrality(
+      pg.get(), "approximate-top",
+      BetweennessCentralityPlan::Approximate(kEpsilon, kDelta, kTopK));
+
+  for (auto n : pg->all_nodes()) {
+    double error = std::abs(all->Value(n) - exact->Value(n)) / scale;
+    KATANA_LOG_VASSERT(
+        error <= kEpsilon + kSlack,
+        "node {} has centrality {} but approximately {}", n, exact->Value(n),
+        all->Value(n));
+  }
+
+  // The nodes with the top_k largest estimates must be within epsilon, and no
+  // other node may be more than epsilon more central than any of them
+  std::vector<float> estimates(
+      top->raw_values(), top->raw_values() + pg->size());
+  std::nth_element(
+      estimates.begin(), estimates.begin() + (kTopK - 1), estimates.end(),
+      std::greater<float>());
+  float kth_estimate = estimates[kTopK - 1];
+  double min_top = std::numeric_limits<double>::infinity();
+  double max_rest = 0;
+  for (auto n : pg->all_nodes()) {
+    double normalized = exact->Value(n) / scale;
+    if (top->Value(n) >= kth_estimate) {
+      double error = std::abs(top->Value(n) - exact->Value(n)) / scale;
+      KATANA_LOG_VASSERT(
+          error <= kEpsilon + kSlack,
+          "top node {} has centrality {} but approximately {}", n,
+          exact->Value(n), top->Value(n));
+      min_top = std::min(min_top, normalized);
+    } else {
+      max_rest = std::max(max_rest, normalized);
+    }
+  }
+  KATANA_LOG_VASSERT(
+      max_rest <= min_top + kEpsilon + kSlack,
+      "a node outside the top {} has normalized centrality {} but one inside "
+      "has {}",
+      kTopK, max_rest, min_top);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestApproximate(katana::MakeGrid(8, 8, false));
+  TestApproximate(katana::MakeFerrisWheel(40));
+  TestApproximate(katana::MakeRmat(7, 8));
+
+  return 0;
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <llvm/Support/CommandLine.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/bfs/bfs.h"
+#include "katana/analytics/sssp/sssp.h"
+#include "tsuba/RDG.h"
+
+namespace cll = llvm::cl;
+
+static cll::opt<std::string> rmat10InputFile(
+    cll::Positional, cll::desc("<rmat10 input file>"), cll::Required);
+
+namespace {
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max() / 4;
+constexpr const char* kWeightName = "multi-test-weight";
+
+/// More than one batch of 64 sources, with duplicates, a node that reaches
+/// nothing but itself and nodes that it cannot reach
+std::vector<uint32_t>
+ChooseSources(const katana::PropertyGraph& pg) {
+  std::vector<uint32_t> sources;
+  for (uint32_t n = 0; n < 70; ++n) {
+    sources.emplace_back(n * 7 % pg.num_nodes());
+  }
+  sources.emplace_back(sources[0]);
+  sources.emplace_back(sources[65]);
+
+  for (auto n : pg.all_nodes()) {
+    if (pg.topology().degree(n) == 0) {
+      sources.emplace_back(n);
+      break;
+    }
+  }
+  KATANA_LOG_VASSERT(
+      sources.size() == 73, "{} has no node without out-edges",
+      rmat10InputFile);
+  return sources;
+}
+
+std::vector<std::string>
+PropertyNames(const std::string& prefix, size_t num) {
+  std::vector<std::string> names;
+  for (size_t i = 0; i < num; ++i) {
+    names.emplace_back(prefix + std::to_string(i));
+  }
+  return names;
+}
+
+/// BfsMulti writes levels while Bfs writes a BFS tree, so check that each
+/// level is one more than the level of the node's parent in the tree and
+/// that both reach the same nodes
+void
+TestBfsMulti(katana::PropertyGraph* pg, const std::vector<uint32_t>& sources) {
+  tsuba::TxnContext txn_ctx;
+  std::vector<std::string> names = PropertyNames("bfs-multi-", sources.size());
+  auto res = katana::analytics::BfsMulti(pg, sources, names, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "BfsMulti: {}", res.error());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    uint32_t source = sources[i];
+    std::string parent_name = "bfs-parent-" + std::to_string(i);
+    res = katana::analytics::Bfs(pg, source, parent_name, &txn_ctx);
+    KATANA_LOG_VASSERT(res, "Bfs: {}", res.error());
+
+    auto levels = pg->GetNodePropertyTyped<uint32_t>(names[i]).value();
+    auto parents = pg->GetNodePropertyTyped<uint32_t>(parent_name).value();
+    KATANA_LOG_ASSERT(levels->length() == static_cast<int64_t>(pg->size()));
+    KATANA_LOG_ASSERT(levels->Value(source) == 0);
+
+    size_t num_reached = 0;
+    for (auto n : pg->all_nodes()) {
+      uint32_t level = levels->Value(n);
+      uint32_t parent = parents->Value(n);
+      KATANA_LOG_VASSERT(
+          (level == kUnreached) == (parent == kUnreached),
+          "source {}: node {} has level {} but parent {}", source, n, level,
+          parent);
+      if (level == kUnreached) {
+        continue;
+      }
+      ++num_reached;
+      if (n != source) {
+        KATANA_LOG_VASSERT(
+            level == levels->Value(parent) + 1,
+            "source {}: node {} has level {} but its parent {} has level {}",
+            source, n, level, parent, levels->Value(parent));
+        auto edges = pg->topology().edges(parent);
+        KATANA_LOG_ASSERT(std::any_of(edges.begin(), edges.end(), [&](auto e) {
+          return pg->topology().edge_dest(e) == n;
+        }));
+      }
+    }
+    if (pg->topology().degree(source) == 0) {
+      KATANA_LOG_ASSERT(num_reached == 1);
+    }
+
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(parent_name));
+  }
+
+  // Duplicate sources get the same levels
+  auto first = pg->GetNodeProperty(names[0]).value();
+  auto duplicate = pg->GetNodeProperty(names[70]).value();
+  KATANA_LOG_ASSERT(first->Equals(*duplicate));
+
+  for (const auto& name : names) {
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(name));
+  }
+}
+
+void
+TestSsspMulti(katana::PropertyGraph* pg, const std::vector<uint32_t>& sources) {
+  tsuba::TxnContext txn_ctx;
+  std::vector<std::string> names =
+      PropertyNames("sssp-multi-", sources.size());
+  auto res = katana::analytics::SsspMulti(
+      pg, sources, kWeightName, names, &txn_ctx);
+  KATANA_LOG_VASSERT(res, "SsspMulti: {}", res.error());
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    std::string single_name = "sssp-single-" + std::to_string(i);
+    res = katana::analytics::Sssp(
+        pg, sources[i], kWeightName, single_name, &txn_ctx);
+    KATANA_LOG_VASSERT(res, "Sssp: {}", res.error());
+
+    auto multi = pg->GetNodeProperty(names[i]).value();
+    auto single = pg->GetNodeProperty(single_name).value();
+    KATANA_LOG_VASSERT(
+        multi->Equals(*single), "source {}: SsspMulti and Sssp differ",
+        sources[i]);
+
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(single_name));
+  }
+
+  for (const auto& name : names) {
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(name));
+  }
+}
+
+/// Small weights from 1 to 8, so that shortest paths differ from paths with
+/// the fewest edges
+void
+AddWeights(katana::PropertyGraph* pg) {
+  arrow::UInt32Builder builder;
+  for (uint64_t e = 0; e < pg->num_edges(); ++e) {
+    KATANA_LOG_ASSERT(builder.Append(e * 2654435761U % 8 + 1).ok());
+  }
+  std::shared_ptr<arrow::Array> weights;
+  KATANA_LOG_ASSERT(builder.Finish(&weights).ok());
+
+  tsuba::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(pg->AddEdgeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field(kWeightName, arrow::uint32())}),
+          {weights}),
+      &txn_ctx));
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  katana::SharedMemSys sys;
+  cll::ParseCommandLineOptions(argc, argv);
+
+  auto pg_res =
+      katana::PropertyGraph::Make(rmat10InputFile, tsuba::RDGLoadOptions());
+  KATANA_LOG_VASSERT(pg_res, "loading {}: {}", rmat10InputFile, pg_res.error());
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  AddWeights(pg.get());
+
+  std::vector<uint32_t> sources = ChooseSources(*pg);
+  TestBfsMulti(pg.get(), sources);
+  TestSsspMulti(pg.get(), sources);
+
+  return 0;
+}
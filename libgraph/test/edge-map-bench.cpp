@@ -0,0 +1,167 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/EdgeMap.h"
+#include "katana/Frontier.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::Frontier::Node;
+
+constexpr size_t kDegree = 8;
+
+enum class Topo {
+  kGraphTopology,
+  kEdgeShuffleTopology,
+  kProjectedTopology,
+};
+
+enum class Kernel {
+  kBaseline,
+  kPush,
+  kPull,
+  kBlocked,
+};
+
+/// Counts the edges into each node from the frontier, which touches the data
+/// of a random destination for each edge like most traversal kernels
+struct CountInEdges {
+  katana::NUMAArray<std::atomic<uint32_t>>* counts;
+
+  bool Cond(Node) const { return true; }
+  bool Push(Node, Node dst, uint64_t) {
+    (*counts)[dst].fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  bool Pull(Node, Node dst, uint64_t) {
+    (*counts)[dst].store(
+        (*counts)[dst].load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    return false;
+  }
+  void Prefetch(Node n) { __builtin_prefetch(&(*counts)[n]); }
+};
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long topo : {0, 1, 2}) {
+    for (long kernel : {0, 1, 2, 3}) {
+      for (long num_nodes : {1 << 12, 1 << 16, 1 << 20}) {
+        b->Args({topo, kernel, num_nodes});
+      }
+    }
+  }
+  b->ArgNames({"topo", "kernel", "num_nodes"});
+}
+
+template <typename Topology>
+void
+Baseline(const Topology& topo, CountInEdges* update) {
+  katana::do_all(
+      katana::iterate(Node{0}, Node(topo.num_nodes())),
+      [&](Node src) {
+        for (auto e : topo.edges(src)) {
+          update->Push(src, topo.edge_dest(e), e);
+        }
+      },
+      katana::steal());
+}
+
+template <typename Topology>
+void
+RunKernel(
+    benchmark::State& state, Kernel kernel, const Topology& topo,
+    const katana::EdgeShuffleTopology& transpose) {
+  katana::NUMAArray<std::atomic<uint32_t>> counts;
+  counts.allocateBlocked(topo.num_nodes());
+  CountInEdges update{&counts};
+
+  katana::Frontier frontier(topo.num_nodes());
+  katana::do_all(
+      katana::iterate(Node{0}, Node(topo.num_nodes())),
+      [&](Node n) { frontier.Push(n); });
+  frontier.Finish();
+  frontier.MakeDense();
+
+  katana::EdgeBlocks blocks;
+  if (kernel == Kernel::kBlocked) {
+    blocks = katana::EdgeBlocks(topo);
+  }
+
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(Node{0}, Node(topo.num_nodes())),
+        [&](Node n) { counts[n].store(0, std::memory_order_relaxed); });
+
+    switch (kernel) {
+    case Kernel::kBaseline:
+      Baseline(topo, &update);
+      break;
+    case Kernel::kPush:
+      katana::EdgeMapPush(topo, frontier, update, nullptr);
+      break;
+    case Kernel::kPull:
+      katana::EdgeMapPull(transpose, frontier, update, nullptr);
+      break;
+    case Kernel::kBlocked:
+      katana::EdgeMapBlocked(blocks, frontier, update, nullptr);
+      break;
+    }
+
+    katana::GAccumulator<uint64_t> total;
+    katana::do_all(
+        katana::iterate(Node{0}, Node(topo.num_nodes())),
+        [&](Node n) { total += counts[n].load(std::memory_order_relaxed); });
+    KATANA_LOG_VASSERT(
+        total.reduce() == topo.num_edges(), "expected {} found {}",
+        topo.num_edges(), total.reduce());
+  }
+
+  state.SetItemsProcessed(state.iterations() * topo.num_edges());
+}
+
+void
+EdgeMap(benchmark::State& state) {
+  auto topo_kind = static_cast<Topo>(state.range(0));
+  auto kernel = static_cast<Kernel>(state.range(1));
+  size_t num_nodes = state.range(2);
+
+  RandomPolicy policy{kDegree};
+  tsuba::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  auto transpose = katana::EdgeShuffleTopology::MakeTransposeCopy(g.get());
+
+  switch (topo_kind) {
+  case Topo::kGraphTopology:
+    return RunKernel(state, kernel, g->topology(), *transpose);
+  case Topo::kEdgeShuffleTopology:
+    return RunKernel(
+        state, kernel, *katana::EdgeShuffleTopology::MakeOriginalCopy(g.get()),
+        *transpose);
+  case Topo::kProjectedTopology:
+    return RunKernel(
+        state, kernel,
+        *katana::ProjectedTopology::MakeTypeProjectedTopology(
+            g.get(), {}, {}),
+        *transpose);
+  }
+}
+
+BENCHMARK(EdgeMap)->Apply(MakeArguments)->UseRealTime();
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "katana/EdgeMap.h"
+#include "katana/Frontier.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+
+namespace {
+
+using Node = katana::Frontier::Node;
+
+constexpr uint32_t kUnvisited = ~uint32_t{0};
+/// Small enough that the graph has many blocks
+constexpr uint32_t kBlockNodes = 100;
+
+enum class Kernel {
+  kPush,
+  kPull,
+  kBlocked,
+};
+
+/// Counts the edges into each node from the frontier and activates every node
+/// that has one
+struct CountInEdges {
+  const katana::GraphTopology* topo;
+  std::vector<std::atomic<uint32_t>>* counts;
+
+  bool Cond(Node) const { return true; }
+  bool Push(Node src, Node dst, uint64_t e) {
+    KATANA_LOG_ASSERT(topo->edge_dest(e) == dst);
+    KATANA_LOG_ASSERT(topo->edge_source(e) == src);
+    return (*counts)[dst].fetch_add(1) == 0;
+  }
+  bool Pull(Node, Node dst, uint64_t) {
+    (*counts)[dst].fetch_add(1);
+    return true;
+  }
+};
+
+/// One round of BFS: each unvisited node takes one frontier node with an edge
+/// to it as its parent
+struct Visit {
+  std::vector<std::atomic<uint32_t>>* parents;
+
+  bool Cond(Node dst) const { return (*parents)[dst].load() == kUnvisited; }
+  bool Push(Node src, Node dst, uint64_t) {
+    uint32_t expected = kUnvisited;
+    return (*parents)[dst].compare_exchange_strong(expected, src);
+  }
+  bool Pull(Node src, Node dst, uint64_t) {
+    (*parents)[dst].store(src);
+    return true;
+  }
+};
+
+template <typename Update>
+void
+Run(Kernel kernel, const katana::GraphTopology& topo,
+    const katana::EdgeShuffleTopology& transpose,
+    const katana::EdgeBlocks& blocks, const katana::Frontier& frontier,
+    Update& update, katana::Frontier* next) {
+  switch (kernel) {
+  case Kernel::kPush:
+    katana::EdgeMapPush(topo, frontier, update, next);
+    break;
+  case Kernel::kPull:
+    katana::EdgeMapPull(transpose, frontier, update, next);
+    break;
+  case Kernel::kBlocked:
+    katana::EdgeMapBlocked(blocks, frontier, update, next);
+    break;
+  }
+  next->Finish();
+  next->MakeDense();
+}
+
+bool
+HasEdge(const katana::GraphTopology& topo, Node src, Node dst) {
+  auto edges = topo.edges(src);
+  return std::any_of(edges.begin(), edges.end(), [&](auto e) {
+    return topo.edge_dest(e) == dst;
+  });
+}
+
+std::vector<bool>
+Members(const katana::Frontier& frontier, size_t num_nodes) {
+  std::vector<bool> members(num_nodes);
+  for (Node n = 0; n < num_nodes; ++n) {
+    members[n] = frontier.Contains(n);
+  }
+  return members;
+}
+
+/// Every kernel must count the same in-edges from the frontier for each node
+/// and activate the same nodes, and every parent it picks must be a frontier
+/// node with an edge to the child
+void
+TestKernels(const katana::PropertyGraph& pg) {
+  const katana::GraphTopology& topo = pg.topology();
+  size_t num_nodes = topo.num_nodes();
+  auto transpose = katana::EdgeShuffleTopology::MakeTransposeCopy(&pg);
+  katana::EdgeBlocks blocks(topo, kBlockNodes);
+  KATANA_LOG_ASSERT(blocks.num_blocks() > 1);
+  KATANA_LOG_ASSERT(blocks.num_edges() == topo.num_edges());
+
+  katana::Frontier frontier(num_nodes);
+  katana::do_all(katana::iterate(Node{0}, Node(num_nodes)), [&](Node n) {
+    if (n % 3 == 0) {
+      frontier.Push(n);
+    }
+  });
+  frontier.Finish();
+  frontier.MakeDense();
+
+  std::vector<uint32_t> expected_counts(num_nodes);
+  for (Node src = 0; src < num_nodes; src += 3) {
+    for (auto e : topo.edges(src)) {
+      ++expected_counts[topo.edge_dest(e)];
+    }
+  }
+
+  for (Kernel kernel : {Kernel::kPush, Kernel::kPull, Kernel::kBlocked}) {
+    std::vector<std::atomic<uint32_t>> counts(num_nodes);
+    CountInEdges count_update{&topo, &counts};
+    katana::Frontier next(num_nodes);
+    Run(kernel, topo, *transpose, blocks, frontier, count_update, &next);
+    std::vector<bool> members = Members(next, num_nodes);
+    for (Node n = 0; n < num_nodes; ++n) {
+      KATANA_LOG_VASSERT(
+          counts[n].load() == expected_counts[n],
+          "kernel {}: node {} has {} in-edges from the frontier, expected {}",
+          static_cast<int>(kernel), n, counts[n].load(), expected_counts[n]);
+      KATANA_LOG_ASSERT(members[n] == (expected_counts[n] > 0));
+    }
+
+    std::vector<std::atomic<uint32_t>> parents(num_nodes);
+    for (Node n = 0; n < num_nodes; ++n) {
+      parents[n] = frontier.Contains(n) ? n : kUnvisited;
+    }
+    Visit visit_update{&parents};
+    katana::Frontier visited(num_nodes);
+    Run(kernel, topo, *transpose, blocks, frontier, visit_update, &visited);
+    members = Members(visited, num_nodes);
+    for (Node n = 0; n < num_nodes; ++n) {
+      bool is_new = !frontier.Contains(n) && expected_counts[n] > 0;
+      KATANA_LOG_ASSERT(members[n] == is_new);
+      if (!is_new) {
+        KATANA_LOG_ASSERT(frontier.Contains(n) || parents[n] == kUnvisited);
+        continue;
+      }
+      Node parent = parents[n].load();
+      KATANA_LOG_ASSERT(frontier.Contains(parent));
+      KATANA_LOG_ASSERT(HasEdge(topo, parent, n));
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestKernels(*katana::MakeRmat(10, 8));
+  TestKernels(*katana::MakeGrid(30, 30, true));
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <vector>
+
+#include "katana/Frontier.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::Frontier::Node;
+
+constexpr size_t kNumNodes = 100000;
+
+std::vector<Node>
+Collect(const katana::Frontier& frontier) {
+  katana::InsertBag<Node> bag;
+  frontier.ForEach([&](Node n) { bag.push(n); });
+  std::vector<Node> ret(bag.begin(), bag.end());
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+void
+TestSparse() {
+  katana::Frontier frontier(kNumNodes);
+
+  // every third node, twice
+  frontier.Clear();
+  katana::do_all(katana::iterate(size_t{0}, 2 * kNumNodes / 3), [&](size_t i) {
+    frontier.Push(3 * (i / 2));
+  });
+  frontier.Finish();
+  KATANA_LOG_ASSERT(frontier.size() == 2 * kNumNodes / 3);
+  KATANA_LOG_ASSERT(frontier.IsDense());
+
+  frontier.Deduplicate();
+  std::vector<Node> nodes = Collect(frontier);
+  KATANA_LOG_ASSERT(nodes.size() == kNumNodes / 3);
+  KATANA_LOG_ASSERT(frontier.size() == nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    KATANA_LOG_ASSERT(nodes[i] == 3 * i);
+    KATANA_LOG_ASSERT(frontier.Contains(3 * i));
+    KATANA_LOG_ASSERT(!frontier.Contains(3 * i + 1));
+  }
+
+  // a small frontier stays sparse and is not in the bitset
+  frontier.Clear();
+  frontier.Push(7);
+  frontier.Push(11);
+  frontier.Finish();
+  KATANA_LOG_ASSERT(frontier.IsSparse());
+  KATANA_LOG_ASSERT(!frontier.IsDense());
+  KATANA_LOG_ASSERT(Collect(frontier) == std::vector<Node>({7, 11}));
+
+  frontier.MakeDense();
+  KATANA_LOG_ASSERT(frontier.Contains(7) && frontier.Contains(11));
+  KATANA_LOG_ASSERT(frontier.bitset().count() == 2);
+
+  // many out-edges make even a small frontier dense
+  katana::Frontier edges_frontier(kNumNodes, 100 * kNumNodes);
+  edges_frontier.Clear();
+  edges_frontier.Push(1);
+  edges_frontier.Finish(100 * kNumNodes);
+  KATANA_LOG_ASSERT(edges_frontier.IsDense());
+}
+
+void
+TestUnique() {
+  katana::Frontier frontier(kNumNodes);
+
+  for (bool dense : {false, true}) {
+    frontier.Clear(dense);
+    katana::GAccumulator<size_t> added;
+    katana::do_all(katana::iterate(size_t{0}, kNumNodes), [&](size_t i) {
+      added += frontier.PushUnique(i % 100);
+    });
+    frontier.Finish();
+    KATANA_LOG_ASSERT(added.reduce() == 100);
+    KATANA_LOG_ASSERT(frontier.size() == 100);
+    KATANA_LOG_ASSERT(frontier.IsDense());
+    // small, so sparse however it was pushed
+    KATANA_LOG_ASSERT(frontier.IsSparse());
+    KATANA_LOG_ASSERT(Collect(frontier).back() == 99);
+  }
+
+  // Clear must leave no stale bits behind
+  frontier.Clear();
+  frontier.Finish();
+  KATANA_LOG_ASSERT(frontier.empty());
+  frontier.MakeDense();
+  KATANA_LOG_ASSERT(frontier.bitset().count() == 0);
+}
+
+void
+TestFill() {
+  katana::Frontier frontier(kNumNodes);
+  frontier.Fill();
+  KATANA_LOG_ASSERT(frontier.size() == kNumNodes);
+  KATANA_LOG_ASSERT(
+      frontier.SumDegrees([](Node) { return 2; }) == 2 * kNumNodes);
+  KATANA_LOG_ASSERT(Collect(frontier).size() == kNumNodes);
+  frontier.MakeSparse();
+  KATANA_LOG_ASSERT(frontier.size() == kNumNodes);
+}
+
+void
+TestDirection() {
+  katana::FrontierDirection direction(kNumNodes, 10 * kNumNodes);
+  KATANA_LOG_ASSERT(!direction.NextIsPull(1, 10));
+  KATANA_LOG_ASSERT(!direction.NextIsPull(100, 1000));
+  // the frontier has most of the remaining edges
+  KATANA_LOG_ASSERT(direction.NextIsPull(kNumNodes / 2, 5 * kNumNodes));
+  // still growing
+  KATANA_LOG_ASSERT(direction.NextIsPull(kNumNodes / 2 + 1, 0));
+  // shrinking but still large
+  KATANA_LOG_ASSERT(direction.NextIsPull(kNumNodes / 4, 0));
+  KATANA_LOG_ASSERT(!direction.NextIsPull(10, 0));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys Katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  TestSparse();
+  TestUnique();
+  TestFill();
+  TestDirection();
+
+  return 0;
+}
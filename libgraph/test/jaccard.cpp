@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/SharedMemSys.h"
+#include "katana/analytics/jaccard/jaccard.h"
+
+using katana::analytics::JaccardPlan;
+
+namespace {
+
+constexpr uint32_t kNumNodes = 300;
+constexpr uint32_t kK = 5;
+constexpr double kThreshold = 0.05;
+
+using AdjacencyList = std::vector<std::vector<uint32_t>>;
+
+uint32_t
+BruteForceIntersect(
+    const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::set<uint32_t> a_set(a.begin(), a.end());
+  std::set<uint32_t> b_set(b.begin(), b.end());
+  uint32_t count = 0;
+  for (uint32_t v : a_set) {
+    count += b_set.count(v);
+  }
+  return count;
+}
+
+/// Sorted arrays of up to 40 values, with more repeats the smaller the range
+/// of values, so that the AVX2 blocks both do and do not line up with repeats
+void
+TestIntersect() {
+  std::mt19937 gen(17);
+  bool have_avx2 = katana::analytics::internal::HaveAVX2();
+  for (int i = 0; i < 100000; ++i) {
+    std::vector<uint32_t> a(gen() % 40);
+    std::vector<uint32_t> b(gen() % 40);
+    uint32_t range = 1 + gen() % 60;
+    for (auto& v : a) {
+      v = gen() % range;
+    }
+    for (auto& v : b) {
+      v = gen() % range;
+    }
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+
+    uint32_t expected = BruteForceIntersect(a, b);
+    uint32_t scalar = katana::analytics::internal::IntersectSortedScalar(
+        a.data(), a.size(), b.data(), b.size());
+    KATANA_LOG_VASSERT(
+        scalar == expected, "scalar intersection is {}, expected {}", scalar,
+        expected);
+    if (have_avx2) {
+      uint32_t avx2 = katana::analytics::internal::IntersectSortedAVX2(
+          a.data(), a.size(), b.data(), b.size());
+      KATANA_LOG_VASSERT(
+          avx2 == expected, "AVX2 intersection is {}, expected {}", avx2,
+          expected);
+    }
+  }
+}
+
+/// A random graph with repeated edges, whose edge lists are sorted if sorted
+/// is true
+AdjacencyList
+MakeAdjacency(bool sorted) {
+  std::mt19937 gen(5);
+  AdjacencyList adjacency(kNumNodes);
+  for (auto& neighbors : adjacency) {
+    neighbors.resize(gen() % 30);
+    for (auto& v : neighbors) {
+      // Most edges go to a small set of nodes so that many pairs share
+      // neighbors
+      v = gen() % 4 == 0 ? gen() % kNumNodes : gen() % 40;
+    }
+    if (sorted) {
+      std::sort(neighbors.begin(), neighbors.end());
+    }
+  }
+  return adjacency;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const AdjacencyList& adjacency) {
+  katana::NUMAArray<katana::GraphTopology::Edge> indices;
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+  indices.allocateBlocked(adjacency.size());
+  uint64_t num_edges = 0;
+  for (size_t n = 0; n < adjacency.size(); ++n) {
+    num_edges += adjacency[n].size();
+    indices[n] = num_edges;
+  }
+  dests.allocateBlocked(num_edges);
+  uint64_t e = 0;
+  for (const auto& neighbors : adjacency) {
+    for (uint32_t v : neighbors) {
+      dests[e++] = v;
+    }
+  }
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::GraphTopology{std::move(indices), std::move(dests)});
+  KATANA_LOG_ASSERT(pg_res);
+  return std::move(pg_res.value());
+}
+
+/// Check each node's matches against the k best of all other nodes that share
+/// a neighbor with it, ranked by similarity of neighbor sets and then by id
+void
+TestTopK(const AdjacencyList& adjacency, JaccardPlan plan) {
+  std::unique_ptr<katana::PropertyGraph> pg = MakeGraph(adjacency);
+  tsuba::TxnContext txn_ctx;
+  auto res = katana::analytics::JaccardTopK(
+      pg.get(), kK, kThreshold, "similarity", &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "JaccardTopK: {}", res.error());
+  std::unique_ptr<katana::PropertyGraph> matches = std::move(res.value());
+  auto similarities =
+      matches->GetEdgePropertyTyped<double>("similarity").value();
+  const auto& topo = matches->topology();
+  KATANA_LOG_ASSERT(topo.num_nodes() == kNumNodes);
+
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    std::set<uint32_t> n_set(adjacency[n].begin(), adjacency[n].end());
+    std::vector<std::pair<double, uint32_t>> expected;
+    for (uint32_t v = 0; v < kNumNodes; ++v) {
+      uint32_t intersection_size =
+          BruteForceIntersect(adjacency[n], adjacency[v]);
+      if (v == n || intersection_size == 0) {
+        continue;
+      }
+      std::set<uint32_t> v_set(adjacency[v].begin(), adjacency[v].end());
+      double similarity = static_cast<double>(intersection_size) /
+                          (n_set.size() + v_set.size() - intersection_size);
+      if (similarity >= kThreshold) {
+        expected.emplace_back(-similarity, v);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    expected.resize(std::min<size_t>(expected.size(), kK));
+
+    auto edges = topo.edges(n);
+    KATANA_LOG_VASSERT(
+        edges.size() == expected.size(), "node {} has {} matches, expected {}",
+        n, edges.size(), expected.size());
+    size_t i = 0;
+    for (auto e : edges) {
+      KATANA_LOG_VASSERT(
+          topo.edge_dest(e) == expected[i].second &&
+              similarities->Value(e) == -expected[i].first,
+          "match {} of node {} is {} ({}), expected {} ({})", i, n,
+          topo.edge_dest(e), similarities->Value(e), expected[i].second,
+          -expected[i].first);
+      ++i;
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  TestIntersect();
+
+  TestTopK(MakeAdjacency(false), JaccardPlan());
+  TestTopK(MakeAdjacency(false), JaccardPlan::Unsorted());
+  TestTopK(MakeAdjacency(true), JaccardPlan::Sorted());
+
+  return 0;
+}
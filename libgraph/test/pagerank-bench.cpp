@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+namespace {
+
+using katana::analytics::PagerankPlan;
+
+constexpr size_t kEdgeFactor = 16;
+// Every algorithm runs the same number of rounds so that the times compare
+// the cost of a round
+constexpr unsigned int kIterations = 10;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long algo :
+       {PagerankPlan::kPullTopological, PagerankPlan::kPullResidual,
+        PagerankPlan::kPushSynchronous, PagerankPlan::kPropagationBlocking}) {
+    for (long scale : {16, 20, 23}) {
+      b->Args({algo, scale});
+    }
+  }
+  b->ArgNames({"algo", "scale"});
+}
+
+PagerankPlan
+MakePlan(PagerankPlan::Algorithm algo) {
+  switch (algo) {
+  case PagerankPlan::kPullTopological:
+    return PagerankPlan::PullTopological(0, kIterations);
+  case PagerankPlan::kPullResidual:
+    return PagerankPlan::PullResidual(0, kIterations);
+  case PagerankPlan::kPushSynchronous:
+    return PagerankPlan::PushSynchronous(0, kIterations);
+  case PagerankPlan::kPropagationBlocking:
+    return PagerankPlan::PropagationBlocking(0, kIterations);
+  default:
+    KATANA_LOG_FATAL("unexpected algorithm");
+  }
+}
+
+void
+Pagerank(benchmark::State& state) {
+  auto algo = static_cast<PagerankPlan::Algorithm>(state.range(0));
+  size_t scale = state.range(1);
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      katana::MakeRmat(scale, kEdgeFactor);
+  PagerankPlan plan = MakePlan(algo);
+  tsuba::TxnContext txn_ctx;
+
+  // the first run also builds the transposed topology of the pull algorithms
+  KATANA_LOG_ASSERT(
+      katana::analytics::Pagerank(g.get(), "rank", &txn_ctx, plan));
+  KATANA_LOG_ASSERT(g->RemoveNodeProperty("rank"));
+
+  for (auto _ : state) {
+    KATANA_LOG_ASSERT(
+        katana::analytics::Pagerank(g.get(), "rank", &txn_ctx, plan));
+
+    state.PauseTiming();
+    KATANA_LOG_ASSERT(g->RemoveNodeProperty("rank"));
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kIterations * g->num_edges());
+}
+
+BENCHMARK(Pagerank)
+    ->Apply(MakeArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,196 @@
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using katana::analytics::PagerankPlan;
+
+namespace {
+
+using AdjacencyList = std::vector<std::vector<uint32_t>>;
+
+constexpr size_t kScale = 8;
+/// Large enough for propagation blocking to split the nodes into several bins
+constexpr size_t kBlockingScale = 12;
+constexpr size_t kEdgeFactor = 8;
+constexpr uint32_t kNumNewNodes = 4;
+/// Push computations stop once every residual is below kPushTolerance, which
+/// bounds the total error over all nodes by n * kPushTolerance / (1 - alpha)
+constexpr float kPushTolerance = 1e-6;
+constexpr float kPullTolerance = 1e-4;
+constexpr float kMaxError = 5e-3;
+
+AdjacencyList
+ToAdjacency(const katana::PropertyGraph& pg) {
+  const auto& topo = pg.topology();
+  AdjacencyList adjacency(topo.num_nodes());
+  for (auto n : topo.all_nodes()) {
+    for (auto e : topo.edges(n)) {
+      adjacency[n].emplace_back(topo.edge_dest(e));
+    }
+  }
+  return adjacency;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const AdjacencyList& adjacency) {
+  katana::NUMAArray<katana::GraphTopology::Edge> indices;
+  katana::NUMAArray<katana::GraphTopology::Node> dests;
+  indices.allocateBlocked(adjacency.size());
+  uint64_t num_edges = 0;
+  for (size_t n = 0; n < adjacency.size(); ++n) {
+    num_edges += adjacency[n].size();
+    indices[n] = num_edges;
+  }
+  dests.allocateBlocked(num_edges);
+  uint64_t e = 0;
+  for (const auto& neighbors : adjacency) {
+    for (uint32_t v : neighbors) {
+      dests[e++] = v;
+    }
+  }
+
+  auto pg_res = katana::PropertyGraph::Make(
+      katana::GraphTopology{std::move(indices), std::move(dests)});
+  KATANA_LOG_ASSERT(pg_res);
+  return std::move(pg_res.value());
+}
+
+/// A later version of a graph: some nodes lose their edges, some gain edges
+/// to other nodes and new nodes are appended with edges in both directions
+AdjacencyList
+Change(AdjacencyList adjacency) {
+  uint32_t num_nodes = adjacency.size();
+  for (uint32_t n = 0; n < num_nodes; n += 17) {
+    adjacency[n].clear();
+  }
+  for (uint32_t n = 5; n < num_nodes; n += 23) {
+    adjacency[n].emplace_back((n * 31 + 7) % num_nodes);
+    adjacency[n].emplace_back(num_nodes + n % kNumNewNodes);
+  }
+  for (uint32_t i = 0; i < kNumNewNodes; ++i) {
+    adjacency.emplace_back(std::vector<uint32_t>{i, (i * 13 + 1) % num_nodes});
+  }
+  return adjacency;
+}
+
+std::shared_ptr<arrow::FloatArray>
+Ranks(katana::PropertyGraph* pg, const std::string& name) {
+  auto ranks_res = pg->GetNodePropertyTyped<float>(name);
+  KATANA_LOG_VASSERT(ranks_res, "{}: {}", name, ranks_res.error());
+  return ranks_res.value();
+}
+
+std::shared_ptr<arrow::FloatArray>
+RunPagerank(
+    katana::PropertyGraph* pg, const std::string& name, PagerankPlan plan) {
+  tsuba::TxnContext txn_ctx;
+  auto res = katana::analytics::Pagerank(pg, name, &txn_ctx, plan);
+  KATANA_LOG_VASSERT(res, "Pagerank: {}", res.error());
+  return Ranks(pg, name);
+}
+
+void
+AddRanks(
+    katana::PropertyGraph* pg, const std::string& name,
+    const std::vector<float>& ranks) {
+  arrow::FloatBuilder builder;
+  KATANA_LOG_ASSERT(builder.AppendValues(ranks).ok());
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+
+  tsuba::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(pg->AddNodeProperties(
+      arrow::Table::Make(
+          arrow::schema({arrow::field(name, arrow::float32())}), {array}),
+      &txn_ctx));
+}
+
+void
+CheckRanks(
+    const std::string& what, const arrow::FloatArray& expected,
+    const arrow::FloatArray& actual) {
+  KATANA_LOG_ASSERT(expected.length() == actual.length());
+  for (int64_t n = 0; n < expected.length(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::fabs(expected.Value(n) - actual.Value(n)) <= kMaxError,
+        "{}: node {} has rank {}, expected {}", what, n, actual.Value(n),
+        expected.Value(n));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys sys;
+
+  AdjacencyList previous_adjacency =
+      ToAdjacency(*katana::MakeRmat(kScale, kEdgeFactor));
+  AdjacencyList adjacency = Change(previous_adjacency);
+  std::unique_ptr<katana::PropertyGraph> previous_pg =
+      MakeGraph(previous_adjacency);
+  std::unique_ptr<katana::PropertyGraph> pg = MakeGraph(adjacency);
+
+  auto cold = RunPagerank(
+      pg.get(), "cold", PagerankPlan::PullTopological(kPullTolerance));
+
+  // Push residuals are signed, so check the plain asynchronous push too
+  auto push = RunPagerank(
+      pg.get(), "push", PagerankPlan::PushAsynchronous(kPushTolerance));
+  CheckRanks("PushAsynchronous", *cold, *push);
+
+  auto previous = RunPagerank(
+      previous_pg.get(), "rank",
+      PagerankPlan::PushAsynchronous(kPushTolerance));
+
+  tsuba::TxnContext txn_ctx;
+  auto res = katana::analytics::PagerankDelta(
+      pg.get(), previous_pg.get(), "rank", "delta", &txn_ctx,
+      PagerankPlan::PushAsynchronous(kPushTolerance));
+  KATANA_LOG_VASSERT(res, "PagerankDelta: {}", res.error());
+  CheckRanks("PagerankDelta", *cold, *Ranks(pg.get(), "delta"));
+
+  // Warm start from the previous ranks, which underestimate some ranks and
+  // overestimate others, and from ranks that overestimate every rank
+  std::vector<float> initial(pg->size(), 0);
+  for (int64_t n = 0; n < previous->length(); ++n) {
+    initial[n] = previous->Value(n);
+  }
+  AddRanks(pg.get(), "previous", initial);
+  for (size_t n = 0; n < pg->size(); ++n) {
+    initial[n] = 2 * cold->Value(n) + 1;
+  }
+  AddRanks(pg.get(), "high", initial);
+
+  for (const std::string& name : {"previous", "high"}) {
+    std::string output_name = "warm-" + name;
+    res = katana::analytics::PagerankWarmStart(
+        pg.get(), name, output_name, &txn_ctx,
+        PagerankPlan::PushAsynchronous(kPushTolerance));
+    KATANA_LOG_VASSERT(res, "PagerankWarmStart: {}", res.error());
+    CheckRanks(
+        "PagerankWarmStart from " + name, *cold,
+        *Ranks(pg.get(), output_name));
+  }
+
+  // Propagation blocking computes the same iterations as the topological pull
+  std::unique_ptr<katana::PropertyGraph> large_pg =
+      katana::MakeRmat(kBlockingScale, kEdgeFactor);
+  auto pull = RunPagerank(
+      large_pg.get(), "pull", PagerankPlan::PullTopological(kPullTolerance));
+  auto blocking = RunPagerank(
+      large_pg.get(), "blocking",
+      PagerankPlan::PropagationBlocking(kPullTolerance));
+  CheckRanks("PropagationBlocking", *pull, *blocking);
+
+  return 0;
+}
@@ -1,11 +1,16 @@
 #include <string.h>
 
+#include <algorithm>
+#include <limits>
+
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
+#include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
+#include "katana/Timer.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
 #include "llvm/Support/CommandLine.h"
@@ -23,6 +28,15 @@ static cll::opt<std::string> nodeTypes(
 static cll::opt<std::string> edgeTypes(
     cll::Positional, cll::desc("<edge types to project>"), cll::init(""));
 
+static cll::opt<bool> scaling(
+    "scaling",
+    cll::desc("Time building the projection with 1 up to all threads"),
+    cll::init(false));
+
+static cll::opt<unsigned> scalingRounds(
+    "scalingRounds", cll::desc("Builds timed per number of threads"),
+    cll::init(3));
+
 using ProjectedPropertyGraphView = katana::PropertyGraphViews::ProjectedGraph;
 
 struct TempNodeProp : public katana::PODProperty<uint64_t> {};
@@ -56,6 +70,94 @@ SplitString(std::string& str, std::vector<std::string>* vec) {
   }
 }
 
+/// A lazy projection must have the same nodes and edges as a materialized one
+void
+CheckLazyProjection(
+    const katana::PropertyGraph& graph,
+    const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) {
+  using katana::ProjectedTopology;
+  auto materialized = ProjectedTopology::MakeTypeProjectedTopology(
+      &graph, node_types, edge_types, ProjectedTopology::Kind::kMaterialized);
+  auto lazy = ProjectedTopology::MakeTypeProjectedTopology(
+      &graph, node_types, edge_types, ProjectedTopology::Kind::kLazy);
+
+  KATANA_LOG_ASSERT(!materialized->is_lazy());
+  KATANA_LOG_ASSERT(materialized->num_edges() == 0 || lazy->is_lazy());
+  KATANA_LOG_ASSERT(lazy->Equals(*materialized));
+
+  size_t num_edges = 0;
+  for (auto n : lazy->all_nodes()) {
+    KATANA_LOG_ASSERT(
+        lazy->node_property_index(n) == materialized->node_property_index(n));
+    KATANA_LOG_ASSERT(lazy->degree(n) == materialized->degree(n));
+
+    auto lazy_edges = lazy->edges(n);
+    auto it = lazy_edges.begin();
+    for (auto e : materialized->edges(n)) {
+      KATANA_LOG_ASSERT(it != lazy_edges.end());
+      KATANA_LOG_ASSERT(
+          lazy->edge_property_index(*it) ==
+          materialized->edge_property_index(e));
+      KATANA_LOG_ASSERT(lazy->edge_source(*it) == n);
+      ++it;
+      ++num_edges;
+    }
+  }
+  KATANA_LOG_ASSERT(num_edges == lazy->num_edges());
+  KATANA_LOG_ASSERT(lazy->all_edges().size() == lazy->num_edges());
+}
+
+/// Times building the projection with 1, 2, 4, ... threads up to all of them,
+/// taking the best of scalingRounds builds, and checks that every number of
+/// threads builds the same projection
+void
+RunScaling(
+    const katana::PropertyGraph& graph,
+    const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) {
+  using katana::ProjectedTopology;
+  unsigned max_threads = katana::GetThreadPool().getMaxUsableThreads();
+  unsigned prev_threads = katana::getActiveThreads();
+
+  std::shared_ptr<ProjectedTopology> expected;
+  uint64_t serial_usec = 0;
+  for (unsigned threads = 1;; threads = std::min(threads * 2, max_threads)) {
+    katana::setActiveThreads(threads);
+
+    uint64_t best_usec = std::numeric_limits<uint64_t>::max();
+    for (unsigned round = 0; round < std::max(scalingRounds.getValue(), 1U);
+         ++round) {
+      katana::Timer timer;
+      timer.start();
+      auto topo = ProjectedTopology::MakeTypeProjectedTopology(
+          &graph, node_types, edge_types,
+          ProjectedTopology::Kind::kMaterialized);
+      timer.stop();
+      best_usec = std::min(best_usec, timer.get_usec());
+
+      if (!expected) {
+        expected = std::move(topo);
+      } else {
+        KATANA_LOG_ASSERT(topo->Equals(*expected));
+      }
+    }
+    if (threads == 1) {
+      serial_usec = best_usec;
+    }
+
+    fmt::print(
+        "projection threads: {} time (us): {} speedup: {:.2f}\n", threads,
+        best_usec,
+        static_cast<double>(serial_usec) / std::max(best_usec, uint64_t{1}));
+    if (threads == max_threads) {
+      break;
+    }
+  }
+
+  katana::setActiveThreads(prev_threads);
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys sys;
@@ -110,5 +212,45 @@ main(int argc, char** argv) {
       "\n Num Valid Nodes: {} Num Nodes: {}", num_valid_nodes,
       projected_graph.num_nodes());
 
+  // projections are cached by their types
+  auto full_view = full_graph.BuildView<ProjectedPropertyGraphView>({}, {});
+  KATANA_LOG_VASSERT(
+      full_view.num_nodes() == full_graph.num_nodes() &&
+          full_view.num_edges() == full_graph.num_edges(),
+      "\n Num Nodes: {} Num Edges: {}", full_view.num_nodes(),
+      full_view.num_edges());
+
+  auto hits = full_graph.GetViewCacheStats().get_hit_count;
+  auto pg_view_again =
+      full_graph.BuildView<ProjectedPropertyGraphView>(node_types, edge_types);
+  KATANA_LOG_ASSERT(full_graph.GetViewCacheStats().get_hit_count == hits + 1);
+  KATANA_LOG_ASSERT(pg_view_again.num_nodes() == pg_view.num_nodes());
+
+  // cached projections are materialized unless a lazy one is asked for, which
+  // is cached apart from them
+  KATANA_LOG_ASSERT(!pg_view.is_lazy());
+  auto lazy_view = full_graph.BuildView<ProjectedPropertyGraphView>(
+      node_types, edge_types, katana::ProjectedTopology::Kind::kLazy);
+  KATANA_LOG_ASSERT(lazy_view.is_lazy());
+  KATANA_LOG_ASSERT(lazy_view.num_edges() == pg_view.num_edges());
+  auto materialized_view =
+      full_graph.BuildView<ProjectedPropertyGraphView>(node_types, edge_types);
+  KATANA_LOG_ASSERT(!materialized_view.is_lazy());
+
+  // a projection is cached by the kind that was built, so kAuto finds the
+  // materialized full view instead of building another
+  hits = full_graph.GetViewCacheStats().get_hit_count;
+  auto auto_view = full_graph.BuildView<ProjectedPropertyGraphView>(
+      {}, {}, katana::ProjectedTopology::Kind::kAuto);
+  KATANA_LOG_ASSERT(full_graph.GetViewCacheStats().get_hit_count == hits + 1);
+  KATANA_LOG_ASSERT(!auto_view.is_lazy());
+
+  CheckLazyProjection(full_graph, node_types, edge_types);
+  CheckLazyProjection(full_graph, {}, {});
+
+  if (scaling) {
+    RunScaling(full_graph, node_types, edge_types);
+  }
+
   return 0;
 }
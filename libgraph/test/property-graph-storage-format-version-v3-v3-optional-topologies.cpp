@@ -33,5 +33,6 @@ main(int argc, char** argv) {
   TestOptionalTopologyStorageEdgeShuffleTopology(ldbc_003InputFile);
   TestOptionalTopologyStorageShuffleTopology(ldbc_003InputFile);
   TestOptionalTopologyStorageEdgeTypeAwareTopology(ldbc_003InputFile);
+  TestOptionalTopologyStorageLimit(ldbc_003InputFile);
   return 0;
 }
@@ -0,0 +1,263 @@
+#include <random>
+#include <set>
+#include <variant>
+
+#include <arrow/api.h>
+#include <benchmark/benchmark.h>
+
+#include "TestTypedPropertyGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/PropertyIndex.h"
+#include "katana/SharedMemSys.h"
+
+using DataType = int64_t;
+using ArrayType = arrow::CTypeTraits<DataType>::ArrayType;
+using Node = katana::GraphTopology::Node;
+
+namespace {
+
+constexpr DataType kKeyRange = 1 << 20;
+constexpr size_t kNumLookups = 1 << 14;
+
+/// MultisetIndex is the std::multiset representation that PropertyIndex used
+/// before it was made columnar; it is kept here as a baseline.
+class MultisetIndex {
+  struct IndexID {
+    Node id;
+  };
+  using set_key_type = std::variant<IndexID, DataType>;
+
+  class PropertyCompare {
+  public:
+    PropertyCompare(const ArrayType* property) : property_(property) {}
+
+    bool operator()(const set_key_type& a, const set_key_type& b) const {
+      return GetValue(a) < GetValue(b);
+    }
+
+  private:
+    DataType GetValue(const set_key_type& a) const {
+      if (std::holds_alternative<IndexID>(a)) {
+        return property_->Value(std::get<IndexID>(a).id);
+      }
+      return std::get<DataType>(a);
+    }
+
+    const ArrayType* property_;
+  };
+
+public:
+  MultisetIndex(const ArrayType* property, size_t num_entities)
+      : property_(property), set_(PropertyCompare(property)) {
+    for (Node i = 0; i < num_entities; ++i) {
+      if (property_->IsValid(i)) {
+        set_.insert(IndexID{i});
+      }
+    }
+  }
+
+  bool Contains(DataType key) const {
+    auto it = set_.lower_bound(key);
+    return it != set_.end() &&
+           property_->Value(std::get<IndexID>(*it).id) == key;
+  }
+
+  // Estimate of the heap footprint: each element is a red-black tree node
+  // (three pointers and a color) holding one set_key_type.
+  size_t memory_usage() const {
+    return set_.size() * (4 * sizeof(void*) + sizeof(set_key_type));
+  }
+
+private:
+  const ArrayType* property_;
+  std::multiset<set_key_type, PropertyCompare> set_;
+};
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long num_nodes : {1 << 12, 1 << 16, 1 << 20}) {
+    b->Args({num_nodes});
+  }
+}
+
+std::shared_ptr<arrow::Table>
+CreateRandomProperty(const std::string& name, size_t num_rows) {
+  std::mt19937_64 gen(num_rows);
+  std::uniform_int_distribution<DataType> dist(0, kKeyRange - 1);
+
+  arrow::Int64Builder builder;
+  KATANA_LOG_ASSERT(builder.Reserve(num_rows).ok());
+  for (size_t i = 0; i < num_rows; ++i) {
+    builder.UnsafeAppend(dist(gen));
+  }
+  std::vector<std::shared_ptr<arrow::Array>> chunks(1);
+  KATANA_LOG_ASSERT(builder.Finish(&chunks[0]).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}),
+      {std::make_shared<arrow::ChunkedArray>(chunks)});
+}
+
+std::vector<DataType>
+MakeLookupKeys() {
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<DataType> dist(0, kKeyRange - 1);
+  std::vector<DataType> keys(kNumLookups);
+  for (auto& key : keys) {
+    key = dist(gen);
+  }
+  return keys;
+}
+
+struct Fixture {
+  tsuba::TxnContext txn_ctx;
+  std::unique_ptr<katana::PropertyGraph> g;
+  std::shared_ptr<arrow::Table> property;
+
+  explicit Fixture(size_t num_nodes) {
+    LinePolicy policy{1};
+    g = MakeFileGraph<DataType>(num_nodes, 0, &policy, &txn_ctx);
+    property = CreateRandomProperty("key", g->num_nodes());
+    KATANA_LOG_ASSERT(g->AddNodeProperties(property, &txn_ctx));
+  }
+
+  const ArrayType* array() const {
+    return static_cast<const ArrayType*>(property->column(0)->chunk(0).get());
+  }
+};
+
+void
+BuildBaseline(benchmark::State& state) {
+  Fixture f(state.range(0));
+
+  size_t bytes = 0;
+  for (auto _ : state) {
+    MultisetIndex index(f.array(), f.g->num_nodes());
+    bytes = index.memory_usage();
+  }
+  state.counters["bytes_per_entity"] =
+      static_cast<double>(bytes) / f.g->num_nodes();
+  state.SetItemsProcessed(state.iterations() * f.g->num_nodes());
+}
+
+void
+BuildIndex(benchmark::State& state) {
+  Fixture f(state.range(0));
+
+  size_t bytes = 0;
+  for (auto _ : state) {
+    KATANA_LOG_ASSERT(f.g->MakeNodeIndex("key"));
+    auto index_result = f.g->GetNodePropertyIndex("key");
+    KATANA_LOG_ASSERT(index_result);
+    bytes = index_result.value()->memory_usage();
+    state.PauseTiming();
+    KATANA_LOG_ASSERT(f.g->DeleteNodeIndex("key"));
+    state.ResumeTiming();
+  }
+  state.counters["bytes_per_entity"] =
+      static_cast<double>(bytes) / f.g->num_nodes();
+  state.SetItemsProcessed(state.iterations() * f.g->num_nodes());
+}
+
+void
+LookupBaseline(benchmark::State& state) {
+  Fixture f(state.range(0));
+  MultisetIndex index(f.array(), f.g->num_nodes());
+  std::vector<DataType> keys = MakeLookupKeys();
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (DataType key : keys) {
+      found += index.Contains(key);
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void
+LookupIndex(benchmark::State& state) {
+  Fixture f(state.range(0));
+  KATANA_LOG_ASSERT(f.g->MakeNodeIndex("key"));
+  auto index_result = f.g->GetNodePropertyIndex("key");
+  KATANA_LOG_ASSERT(index_result);
+  auto* index = static_cast<katana::PrimitivePropertyIndex<Node, DataType>*>(
+      index_result.value());
+  std::vector<DataType> keys = MakeLookupKeys();
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (DataType key : keys) {
+      found += index->Find(key) != index->end();
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void
+LookupHashIndex(benchmark::State& state) {
+  Fixture f(state.range(0));
+  KATANA_LOG_ASSERT(
+      f.g->MakeNodeIndex("key", katana::PropertyIndexKind::kHash));
+  auto index_result = f.g->GetNodePropertyIndex("key");
+  KATANA_LOG_ASSERT(index_result);
+  auto* index = static_cast<katana::HashPropertyIndex<Node, DataType>*>(
+      index_result.value());
+  std::vector<DataType> keys = MakeLookupKeys();
+
+  for (auto _ : state) {
+    size_t found = 0;
+    for (DataType key : keys) {
+      found += index->Find(key) != index->end();
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename IndexType>
+void
+BatchLookup(benchmark::State& state, katana::PropertyIndexKind kind) {
+  Fixture f(state.range(0));
+  KATANA_LOG_ASSERT(f.g->MakeNodeIndex("key", kind));
+  auto index_result = f.g->GetNodePropertyIndex("key");
+  KATANA_LOG_ASSERT(index_result);
+  auto* index = static_cast<IndexType*>(index_result.value());
+  std::vector<DataType> keys = MakeLookupKeys();
+
+  for (auto _ : state) {
+    auto ids = index->FindBatch(keys.begin(), keys.end());
+    benchmark::DoNotOptimize(ids.data());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void
+BatchLookupIndex(benchmark::State& state) {
+  BatchLookup<katana::PrimitivePropertyIndex<Node, DataType>>(
+      state, katana::PropertyIndexKind::kOrdered);
+}
+
+void
+BatchLookupHashIndex(benchmark::State& state) {
+  BatchLookup<katana::HashPropertyIndex<Node, DataType>>(
+      state, katana::PropertyIndexKind::kHash);
+}
+
+BENCHMARK(BuildBaseline)->Apply(MakeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(BuildIndex)->Apply(MakeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(LookupBaseline)->Apply(MakeArguments);
+BENCHMARK(LookupIndex)->Apply(MakeArguments);
+BENCHMARK(LookupHashIndex)->Apply(MakeArguments);
+BENCHMARK(BatchLookupIndex)->Apply(MakeArguments);
+BENCHMARK(BatchLookupHashIndex)->Apply(MakeArguments);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
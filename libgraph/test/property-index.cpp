@@ -1,17 +1,23 @@
+#include <cmath>
+#include <vector>
+
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
+#include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
 #include "katana/PropertyIndex.h"
 #include "katana/SharedMemSys.h"
+#include "katana/URI.h"
 
 template <typename node_or_edge>
 struct NodeOrEdge {
   static katana::Result<katana::PropertyIndex<node_or_edge>*> MakeIndex(
-      katana::PropertyGraph* pg, const std::string& column_name);
+      katana::PropertyGraph* pg, const std::string& column_name,
+      katana::PropertyIndexKind kind = katana::PropertyIndexKind::kOrdered);
   static katana::Result<void> AddProperties(
       katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
       tsuba::TxnContext* txn_ctx);
@@ -23,8 +29,10 @@ using Edge = NodeOrEdge<katana::GraphTopology::Edge>;
 
 template <>
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Node>*>
-Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeNodeIndex(column_name);
+Node::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::PropertyIndexKind kind) {
+  auto result = pg->MakeNodeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
@@ -40,8 +48,10 @@ Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
 
 template <>
 katana::Result<katana::PropertyIndex<katana::GraphTopology::Edge>*>
-Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeEdgeIndex(column_name);
+Edge::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::PropertyIndexKind kind) {
+  auto result = pg->MakeEdgeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
@@ -205,6 +215,156 @@ TestPrimitiveIndex(size_t num_nodes, size_t line_width) {
   KATANA_LOG_ASSERT(typed_prop->Value(*it) == 46);
 }
 
+template <typename node_or_edge, typename DataType>
+void
+TestHashIndex(size_t num_nodes, size_t line_width) {
+  using IndexType = katana::HashPropertyIndex<node_or_edge, DataType>;
+  using ArrayType = typename arrow::CTypeTraits<DataType>::ArrayType;
+
+  LinePolicy policy{line_width};
+
+  tsuba::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 0, &policy, &txn_ctx);
+
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+  std::shared_ptr<arrow::Table> uniform_prop =
+      CreatePrimitiveProperty<DataType>("uniform", true, num_entities);
+  std::shared_ptr<arrow::Table> nonuniform_prop =
+      CreatePrimitiveProperty<DataType>("nonuniform", false, num_entities);
+  KATANA_LOG_ASSERT(
+      NodeOrEdge<node_or_edge>::AddProperties(g.get(), uniform_prop, &txn_ctx));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), nonuniform_prop, &txn_ctx));
+
+  auto uniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "uniform", katana::PropertyIndexKind::kHash);
+  KATANA_LOG_VASSERT(
+      uniform_index_result, "Could not create index: {}",
+      uniform_index_result.error());
+  auto nonuniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "nonuniform", katana::PropertyIndexKind::kHash);
+  KATANA_LOG_VASSERT(
+      nonuniform_index_result, "Could not create index: {}",
+      nonuniform_index_result.error());
+  KATANA_LOG_ASSERT(
+      uniform_index_result.value()->kind() ==
+      katana::PropertyIndexKind::kHash);
+
+  auto* uniform_index = static_cast<IndexType*>(uniform_index_result.value());
+  auto* nonuniform_index =
+      static_cast<IndexType*>(nonuniform_index_result.value());
+
+  // Every entity has the uniform value, in id order.
+  auto [begin, end] = uniform_index->EqualRange(42);
+  KATANA_LOG_ASSERT(static_cast<size_t>(end - begin) == num_entities);
+  node_or_edge expected = 0;
+  for (auto it = begin; it != end; ++it) {
+    KATANA_LOG_VASSERT(*it == expected, "Unexpected id: {}", *it);
+    ++expected;
+  }
+  KATANA_LOG_ASSERT(uniform_index->Find(0) == uniform_index->end());
+
+  // The non-uniform values are distinct: 42 + 2 * id.
+  auto typed_prop =
+      std::static_pointer_cast<ArrayType>(nonuniform_prop->column(0)->chunk(0));
+  std::vector<DataType> keys;
+  for (size_t i = 0; i < num_entities; ++i) {
+    keys.emplace_back(typed_prop->Value(i));
+    keys.emplace_back(typed_prop->Value(i) + 1);
+  }
+  auto ids = nonuniform_index->FindBatch(keys.begin(), keys.end());
+  KATANA_LOG_ASSERT(ids.size() == keys.size());
+  for (size_t i = 0; i < num_entities; ++i) {
+    KATANA_LOG_VASSERT(ids[2 * i] == i, "Wrong id for key {}", keys[2 * i]);
+    KATANA_LOG_VASSERT(
+        ids[2 * i + 1] == IndexType::kNotFound, "Found missing key {}",
+        keys[2 * i + 1]);
+  }
+}
+
+// NaN is not equal to anything, itself included, so both kinds of index leave
+// NaN rows out the way they leave out nulls.
+template <typename node_or_edge>
+void
+TestNaNIndex(size_t num_nodes, size_t line_width) {
+  LinePolicy policy{line_width};
+
+  tsuba::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<double_t>(num_nodes, 0, &policy, &txn_ctx);
+
+  // Every third entity is NaN and the rest take one of four values.
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+  arrow::DoubleBuilder some_builder;
+  arrow::DoubleBuilder all_builder;
+  for (size_t i = 0; i < num_entities; ++i) {
+    double_t value = i % 3 == 0 ? std::nan("") : 42 + i % 4;
+    KATANA_LOG_ASSERT(some_builder.Append(value).ok());
+    KATANA_LOG_ASSERT(all_builder.Append(std::nan("")).ok());
+  }
+  std::shared_ptr<arrow::Array> some_nan;
+  std::shared_ptr<arrow::Array> all_nan;
+  KATANA_LOG_ASSERT(some_builder.Finish(&some_nan).ok());
+  KATANA_LOG_ASSERT(all_builder.Finish(&all_nan).ok());
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(),
+      arrow::Table::Make(
+          arrow::schema(
+              {arrow::field("some_nan", arrow::float64()),
+               arrow::field("all_nan", arrow::float64())}),
+          {some_nan, all_nan}),
+      &txn_ctx));
+
+  for (auto kind :
+       {katana::PropertyIndexKind::kOrdered,
+        katana::PropertyIndexKind::kHash}) {
+    auto some_index_result =
+        NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "some_nan", kind);
+    KATANA_LOG_VASSERT(
+        some_index_result, "Could not create index: {}",
+        some_index_result.error());
+    auto all_index_result =
+        NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "all_nan", kind);
+    KATANA_LOG_VASSERT(
+        all_index_result, "Could not create index: {}",
+        all_index_result.error());
+
+    auto* all_index = all_index_result.value();
+    KATANA_LOG_ASSERT(all_index->begin() == all_index->end());
+
+    auto* some_index = some_index_result.value();
+    std::vector<bool> found(num_entities, false);
+    for (auto it = some_index->begin(); it != some_index->end(); ++it) {
+      node_or_edge id = *it;
+      KATANA_LOG_VASSERT(id < num_entities, "Invalid id: {}", id);
+      KATANA_LOG_VASSERT(!found[id], "Duplicate id: {}", id);
+      found[id] = true;
+    }
+    for (node_or_edge id = 0; id < num_entities; ++id) {
+      KATANA_LOG_VASSERT(
+          found[id] == (id % 3 != 0), "Id {} wrongly in index: {}", id,
+          bool(found[id]));
+    }
+
+    if (kind == katana::PropertyIndexKind::kHash) {
+      auto* hash_index =
+          static_cast<katana::HashPropertyIndex<node_or_edge, double_t>*>(
+              some_index);
+      auto [begin, end] = hash_index->EqualRange(std::nan(""));
+      KATANA_LOG_ASSERT(begin == end);
+      for (size_t value = 42; value < 46; ++value) {
+        for (auto [it, last] = hash_index->EqualRange(value); it != last;
+             ++it) {
+          KATANA_LOG_ASSERT(*it % 3 != 0 && 42 + *it % 4 == value);
+        }
+      }
+    }
+  }
+}
+
 template <typename node_or_edge>
 void
 TestStringIndex(size_t num_nodes, size_t line_width) {
@@ -273,6 +433,68 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
 }
 
+// Indexes written with a graph are loaded instead of rebuilt, and are rebuilt
+// when their property is replaced.
+void
+TestPersistedIndex(size_t num_nodes, size_t line_width) {
+  using IndexType =
+      katana::PrimitivePropertyIndex<katana::GraphTopology::Node, int64_t>;
+
+  LinePolicy policy{line_width};
+
+  tsuba::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      CreatePrimitiveProperty<int64_t>("nonuniform", false, g->num_nodes()),
+      &txn_ctx));
+  KATANA_LOG_ASSERT(g->MakeNodeIndex("nonuniform"));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyindex");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, "property-index");
+  if (!write_result) {
+    boost::filesystem::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  boost::filesystem::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(make_result, "making result: {}", make_result.error());
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  auto index_result = Node::MakeIndex(g2.get(), "nonuniform");
+  KATANA_LOG_VASSERT(
+      index_result, "Could not load index: {}", index_result.error());
+  auto* index = static_cast<IndexType*>(index_result.value());
+
+  // The non-uniform property starts at 42 and increases by 2.
+  size_t count = 0;
+  for (auto it = index->begin(); it != index->end(); ++it) {
+    KATANA_LOG_ASSERT(*it == count);
+    ++count;
+  }
+  KATANA_LOG_ASSERT(count == g2->num_nodes());
+  KATANA_LOG_ASSERT(index->Find(43) == index->end());
+  KATANA_LOG_ASSERT(*index->LowerBound(43) == 1);
+
+  // Replacing the property must not leave a stale index behind.
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(
+      CreatePrimitiveProperty<int64_t>("nonuniform", true, g2->num_nodes()),
+      &txn_ctx));
+  auto rebuilt_result = g2->GetNodePropertyIndex("nonuniform");
+  KATANA_LOG_ASSERT(rebuilt_result);
+  auto* rebuilt = static_cast<IndexType*>(rebuilt_result.value());
+  KATANA_LOG_ASSERT(rebuilt->Find(44) == rebuilt->end());
+  KATANA_LOG_ASSERT(
+      static_cast<size_t>(rebuilt->end() - rebuilt->Find(42)) ==
+      g2->num_nodes());
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -282,8 +504,17 @@ main() {
   TestPrimitiveIndex<katana::GraphTopology::Node, double_t>(10, 3);
   TestPrimitiveIndex<katana::GraphTopology::Edge, double_t>(10, 3);
 
+  TestHashIndex<katana::GraphTopology::Node, int64_t>(10, 3);
+  TestHashIndex<katana::GraphTopology::Edge, int64_t>(10, 3);
+  TestHashIndex<katana::GraphTopology::Node, double_t>(10, 3);
+
+  TestNaNIndex<katana::GraphTopology::Node>(10, 3);
+  TestNaNIndex<katana::GraphTopology::Edge>(10, 3);
+
   TestStringIndex<katana::GraphTopology::Node>(10, 3);
   TestStringIndex<katana::GraphTopology::Edge>(10, 3);
 
+  TestPersistedIndex(10, 3);
+
   return 0;
 }
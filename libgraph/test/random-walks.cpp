@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <arrow/api.h>
+#include <boost/filesystem.hpp>
+
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/URI.h"
+#include "katana/analytics/random_walks/random_walks.h"
+#include "tsuba/ParquetReader.h"
+
+namespace fs = boost::filesystem;
+
+using katana::analytics::RandomWalksPlan;
+using katana::analytics::RandomWalksResult;
+
+namespace {
+
+constexpr uint32_t kWalkLength = 5;
+constexpr uint32_t kNumberOfWalks = 3;
+
+/// Nodes with neighbors, which are where walks start
+std::vector<uint32_t>
+Starts(const katana::PropertyGraph& pg) {
+  std::vector<uint32_t> starts;
+  for (auto n : pg.all_nodes()) {
+    if (pg.topology().degree(n) != 0) {
+      starts.emplace_back(n);
+    }
+  }
+  return starts;
+}
+
+/// Check that walks [0, walks.num_walks()), the walks first_walk, ... of all
+/// walks, are walks of at least one step along edges of pg from the start
+/// nodes in order, and end early only at nodes without neighbors
+void
+CheckWalks(
+    const katana::PropertyGraph& pg, const std::vector<uint32_t>& starts,
+    const RandomWalksResult& walks, uint64_t first_walk = 0) {
+  const auto& topo = pg.topology();
+  KATANA_LOG_ASSERT(walks.stride() == kWalkLength + 1);
+  for (uint64_t i = 0; i < walks.num_walks(); ++i) {
+    uint32_t length = walks.length(i);
+    const uint32_t* walk = walks.begin(i);
+    KATANA_LOG_VASSERT(
+        length >= 2 && length <= walks.stride(), "walk {} has length {}", i,
+        length);
+    KATANA_LOG_ASSERT(walks.end(i) == walk + length);
+    KATANA_LOG_ASSERT(walk[0] == starts[(first_walk + i) % starts.size()]);
+    for (uint32_t step = 1; step < length; ++step) {
+      auto edges = topo.edges(walk[step - 1]);
+      KATANA_LOG_VASSERT(
+          std::any_of(
+              edges.begin(), edges.end(),
+              [&](auto e) { return topo.edge_dest(e) == walk[step]; }),
+          "walk {} takes missing edge {} -> {}", i, walk[step - 1],
+          walk[step]);
+    }
+    KATANA_LOG_ASSERT(
+        length == walks.stride() || topo.degree(walk[length - 1]) == 0);
+  }
+}
+
+void
+TestResult(const katana::PropertyGraph& pg, const RandomWalksResult& walks) {
+  std::vector<uint32_t> starts = Starts(pg);
+  KATANA_LOG_ASSERT(walks.num_walks() == starts.size() * kNumberOfWalks);
+  CheckWalks(pg, starts, walks);
+
+  std::vector<std::vector<uint32_t>> vectors = walks.ToVectors();
+  KATANA_LOG_ASSERT(vectors.size() == walks.num_walks());
+  for (uint64_t i = 0; i < walks.num_walks(); ++i) {
+    KATANA_LOG_ASSERT(
+        vectors[i] == std::vector<uint32_t>(walks.begin(i), walks.end(i)));
+  }
+}
+
+/// The Arrow array has a list of stride() slots per walk, and the slots past
+/// the end of a walk are null
+void
+CheckArrowArray(
+    const std::vector<std::vector<uint32_t>>& vectors,
+    const arrow::FixedSizeListArray& array) {
+  KATANA_LOG_ASSERT(array.length() == static_cast<int64_t>(vectors.size()));
+  KATANA_LOG_ASSERT(array.value_length() == kWalkLength + 1);
+  auto values = std::static_pointer_cast<arrow::UInt32Array>(array.values());
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    for (uint32_t slot = 0; slot < kWalkLength + 1; ++slot) {
+      int64_t index = array.value_offset(i) + slot;
+      if (slot < vectors[i].size()) {
+        KATANA_LOG_ASSERT(values->IsValid(index));
+        KATANA_LOG_ASSERT(values->Value(index) == vectors[i][slot]);
+      } else {
+        KATANA_LOG_ASSERT(values->IsNull(index));
+      }
+    }
+  }
+}
+
+/// Returns the walks as an Arrow array, to be released after the runtime is
+/// gone
+std::shared_ptr<arrow::FixedSizeListArray>
+TestToArrowArray(RandomWalksResult walks) {
+  std::vector<std::vector<uint32_t>> vectors = walks.ToVectors();
+  auto array_res = walks.ToArrowArray();
+  KATANA_LOG_VASSERT(array_res, "ToArrowArray: {}", array_res.error());
+  KATANA_LOG_ASSERT(walks.num_walks() == 0);
+  KATANA_LOG_ASSERT(array_res.value()->ValidateFull().ok());
+  CheckArrowArray(vectors, *array_res.value());
+  return array_res.value();
+}
+
+void
+TestStreaming(katana::PropertyGraph* pg, uint64_t batch_size) {
+  std::vector<uint32_t> starts = Starts(*pg);
+  uint64_t next_walk = 0;
+  auto res = katana::analytics::RandomWalks(
+      pg,
+      [&](RandomWalksResult&& batch, uint64_t first_walk) {
+        KATANA_LOG_ASSERT(first_walk == next_walk);
+        KATANA_LOG_ASSERT(
+            batch.num_walks() > 0 && batch.num_walks() <= batch_size);
+        CheckWalks(*pg, starts, batch, first_walk);
+        next_walk += batch.num_walks();
+        return katana::ResultSuccess();
+      },
+      batch_size, RandomWalksPlan::Node2Vec(kWalkLength, kNumberOfWalks));
+  KATANA_LOG_VASSERT(res, "RandomWalks: {}", res.error());
+  KATANA_LOG_ASSERT(next_walk == starts.size() * kNumberOfWalks);
+
+  // The first error of the consumer stops the walks
+  uint64_t num_batches = 0;
+  res = katana::analytics::RandomWalks(
+      pg,
+      [&](RandomWalksResult&&, uint64_t) -> katana::Result<void> {
+        ++num_batches;
+        return katana::ErrorCode::InvalidArgument;
+      },
+      batch_size, RandomWalksPlan::Node2Vec(kWalkLength, kNumberOfWalks));
+  KATANA_LOG_ASSERT(!res && num_batches == 1);
+
+  res = katana::analytics::RandomWalks(
+      pg,
+      [](RandomWalksResult&&, uint64_t) { return katana::ResultSuccess(); }, 0,
+      RandomWalksPlan::Node2Vec(kWalkLength, kNumberOfWalks));
+  KATANA_LOG_ASSERT(!res);
+}
+
+void
+TestToParquet(katana::PropertyGraph* pg, uint64_t batch_size) {
+  fs::path dir =
+      fs::temp_directory_path() / fs::unique_path("random-walks-%%%%");
+  fs::create_directories(dir);
+  auto prefix_res = katana::Uri::MakeFromFile((dir / "walks").string());
+  KATANA_LOG_ASSERT(prefix_res);
+
+  auto res = katana::analytics::RandomWalksToParquet(
+      pg, prefix_res.value(), batch_size,
+      RandomWalksPlan::Node2Vec(kWalkLength, kNumberOfWalks));
+  KATANA_LOG_VASSERT(res, "RandomWalksToParquet: {}", res.error());
+
+  std::vector<uint32_t> starts = Starts(*pg);
+  uint64_t num_walks = starts.size() * kNumberOfWalks;
+  uint64_t num_files = (num_walks + batch_size - 1) / batch_size;
+  KATANA_LOG_ASSERT(
+      static_cast<uint64_t>(std::distance(
+          fs::directory_iterator(dir), fs::directory_iterator())) ==
+      num_files);
+
+  auto reader_res = tsuba::ParquetReader::Make();
+  KATANA_LOG_ASSERT(reader_res);
+  uint64_t num_read = 0;
+  for (uint64_t i = 0; i < num_files; ++i) {
+    auto table_res = reader_res.value()->ReadTable(
+        prefix_res.value() + ("." + std::to_string(i)));
+    KATANA_LOG_VASSERT(table_res, "ReadTable: {}", table_res.error());
+    std::shared_ptr<arrow::Table> table = table_res.value();
+    KATANA_LOG_ASSERT(table->num_columns() == 1);
+    KATANA_LOG_ASSERT(table->schema()->field(0)->name() == "walk");
+
+    for (const auto& chunk : table->column(0)->chunks()) {
+      KATANA_LOG_ASSERT(chunk->type_id() == arrow::Type::FIXED_SIZE_LIST);
+      auto walks = std::static_pointer_cast<arrow::FixedSizeListArray>(chunk);
+      auto values =
+          std::static_pointer_cast<arrow::UInt32Array>(walks->values());
+      for (int64_t w = 0; w < walks->length(); ++w) {
+        uint64_t walk = num_read + w;
+        KATANA_LOG_ASSERT(
+            values->Value(walks->value_offset(w)) ==
+            starts[walk % starts.size()]);
+      }
+      num_read += walks->length();
+    }
+  }
+  KATANA_LOG_ASSERT(num_read == num_walks);
+
+  fs::remove_all(dir);
+}
+
+}  // namespace
+
+int
+main() {
+  std::vector<std::shared_ptr<arrow::FixedSizeListArray>> arrays;
+  {
+    katana::SharedMemSys S;
+
+    // The sawtooth graph is directed and its last node has no neighbors, so
+    // walks that reach it end early and leave null slots behind them
+    std::vector<std::unique_ptr<katana::PropertyGraph>> graphs;
+    graphs.emplace_back(katana::MakeGrid(5, 7, true));
+    graphs.emplace_back(katana::MakeSawtooth(9));
+
+    for (auto& pg : graphs) {
+      auto walks_res = katana::analytics::RandomWalks(
+          pg.get(), RandomWalksPlan::Node2Vec(kWalkLength, kNumberOfWalks));
+      KATANA_LOG_VASSERT(walks_res, "RandomWalks: {}", walks_res.error());
+
+      TestResult(*pg, walks_res.value());
+      arrays.emplace_back(TestToArrowArray(std::move(walks_res.value())));
+      TestStreaming(pg.get(), 7);
+      TestToParquet(pg.get(), 7);
+    }
+  }
+
+  // Arrow may drop the last reference to a walk array on a thread that is
+  // not part of the Katana runtime, after the runtime is gone
+  std::thread([&arrays]() { arrays.clear(); }).join();
+
+  return 0;
+}
@@ -1,6 +1,10 @@
 #ifndef KATANA_LIBGRAPH_STORAGEFORMATVERSIONOPTIONALTOPOLOGIES_H_
 #define KATANA_LIBGRAPH_STORAGEFORMATVERSIONOPTIONALTOPOLOGIES_H_
 
+#include <cstdlib>
+
+#include <boost/filesystem.hpp>
+
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "storage-format-version.h"
@@ -99,4 +103,44 @@ TestOptionalTopologyStorageEdgeTypeAwareTopology(std::string inputFile) {
   verify_view(generated_sorted_view, loaded_sorted_view);
 }
 
+size_t
+CountFiles(const std::string& dir) {
+  size_t num_files = 0;
+  for (const auto& entry :
+       boost::filesystem::recursive_directory_iterator(dir)) {
+    if (boost::filesystem::is_regular_file(entry)) {
+      ++num_files;
+    }
+  }
+  return num_files;
+}
+
+void
+TestOptionalTopologyStorageLimit(std::string inputFile) {
+  KATANA_LOG_WARN("***** Testing the limit of stored topologies *****");
+
+  katana::PropertyGraph pg = LoadGraph(inputFile);
+
+  using SortedGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
+  SortedGraphView generated_sorted_view = pg.BuildView<SortedGraphView>();
+
+  // a write with no room for cached topologies comes first, because a
+  // written topology stays with the RDG
+  KATANA_LOG_ASSERT(setenv(katana::PGViewCache::kPersistEnvVar, "0", 1) == 0);
+  std::string limited_rdg_file = StoreGraph(&pg);
+  KATANA_LOG_ASSERT(unsetenv(katana::PGViewCache::kPersistEnvVar) == 0);
+  std::string rdg_file = StoreGraph(&pg);
+
+  KATANA_LOG_VASSERT(
+      CountFiles(limited_rdg_file) < CountFiles(rdg_file),
+      "a write limited to 0 bytes of cached topologies stored {} files, one "
+      "without a limit stored {}",
+      CountFiles(limited_rdg_file), CountFiles(rdg_file));
+
+  // the view is generated again for the graph without it
+  katana::PropertyGraph pg2 = LoadGraph(limited_rdg_file);
+  SortedGraphView loaded_sorted_view = pg2.BuildView<SortedGraphView>();
+  verify_view(generated_sorted_view, loaded_sorted_view);
+}
+
 #endif
@@ -54,18 +54,22 @@ struct CacheStats {
   uint64_t get_hit_count{0ULL};
   uint64_t insert_count{0ULL};
   uint64_t insert_hit_count{0ULL};
+  uint64_t evict_count{0ULL};
 };
 
-template <typename Value>
+/// An LRU cache from Key to Value. Keys are URIs by default; other key types
+/// provide a hash function object, by default a nested Key::Hash like Uri's.
+template <
+    typename Value, typename Key = katana::Uri,
+    typename KeyHash = typename Key::Hash>
 class KATANA_EXPORT Cache {
-  using Key = katana::Uri;
   using ListType = std::list<Key>;
   struct MapValue {
     Value value;
     // This allows us to delete the old position in the LRU list without a scan
     typename ListType::iterator lru_it;
   };
-  using MapType = std::unordered_map<Key, MapValue, Key::Hash>;
+  using MapType = std::unordered_map<Key, MapValue, KeyHash>;
   enum class ReplacementPolicy { kLRUSize, kLRUBytes };
 
 public:
@@ -123,10 +127,14 @@ public:
           KATANA_LOG_WARN(
               "caching zero sized object with LRUBytes policy is illogical");
         }
-        total_bytes_ += value_to_bytes_(value);
+        total_bytes_ += approx_bytes;
       }
     } else {
       cache_stats_.insert_hit_count++;
+      if (value_to_bytes_ != nullptr) {
+        total_bytes_ -= value_to_bytes_(mapit->second.value);
+        total_bytes_ += value_to_bytes_(value);
+      }
       mapit->second.value = value;
       UpdateLRU(mapit);
     }
@@ -147,6 +155,30 @@ public:
     return ret;
   }
 
+  /// Remove the entry for key if there is one
+  /// \returns true if there was an entry
+  bool Erase(const Key& key) {
+    auto it = key_to_value_.find(key);
+    if (it == key_to_value_.end()) {
+      return false;
+    }
+    if (value_to_bytes_ != nullptr) {
+      total_bytes_ -= value_to_bytes_(it->second.value);
+    }
+    lru_list_.erase(it->second.lru_it);
+    key_to_value_.erase(it);
+    return true;
+  }
+
+  /// Call f(key, value) on each entry from the most recently used to the
+  /// least recently used, without changing their order
+  template <typename F>
+  void ForEach(F f) const {
+    for (const Key& key : lru_list_) {
+      f(key, key_to_value_.at(key).value);
+    }
+  }
+
   CacheStats GetStats() const { return cache_stats_; }
 
   // This is mostly a debugging function.  It also explains the cache data structures
@@ -180,6 +212,7 @@ private:
     auto evicted_value = std::move(key_to_value_.at(evicted_key).value);
     uint64_t approx_evicted_bytes = 0;
     key_to_value_.erase(evicted_key);
+    cache_stats_.evict_count++;
     if (value_to_bytes_ != nullptr) {
       approx_evicted_bytes = value_to_bytes_(evicted_value);
       total_bytes_ -= approx_evicted_bytes;
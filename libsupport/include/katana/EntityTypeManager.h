@@ -114,6 +114,8 @@ public:
     for (size_t i = 0; i < num_entity_types; i++) {
       entity_type_id_to_atomic_entity_type_ids_.at(i).resize(set_size);
     }
+
+    BuildSubtypeMatrix();
   }
 
   EntityTypeManager(
@@ -142,6 +144,8 @@ public:
     //Must ensure all sets are at least big enough to fit all EntityTypeIDs
     size_t num_entity_types = entity_type_id_to_atomic_entity_type_ids_.size();
     ResizeSetOfEntityTypeIDsMaps(num_entity_types - 1);
+
+    BuildSubtypeMatrix();
   }
 
   /// This function can be used to convert "old style" graphs (storage format 1,
@@ -447,14 +451,18 @@ public:
   /// \returns true iff the type \p sub_type is a
   /// sub-type of the type \p super_type
   /// (assumes that the sub_type and super_type EntityTypeIDs exists)
+  ///
+  /// This is a single bit test in the subtype matrix unless there are more
+  /// than kMaxSubtypeMatrixTypes entity types; it does not allocate either way
   bool IsSubtypeOf(EntityTypeID sub_type, EntityTypeID super_type) const {
-    const auto& super_atomic_types = GetAtomicSubtypes(super_type);
-    const auto& sub_atomic_types = GetAtomicSubtypes(sub_type);
-    // return true if sub_atomic_types is a subset of super_atomic_types
-    SetOfEntityTypeIDs res;
-    res.resize(SetOfEntityTypeIDsSize_);
-    res.bitwise_and(sub_atomic_types, super_atomic_types);
-    return (res == sub_atomic_types);
+    if (subtype_matrix_stride_ != 0) {
+      uint64_t word = subtype_matrix_
+          [sub_type * subtype_matrix_stride_ + super_type / kBitsPerWord];
+      return (word >> (super_type % kBitsPerWord)) & 1;
+    }
+    // return true if the atomic types of sub_type are a subset of the atomic
+    // types of super_type
+    return IsSubsetOf(GetAtomicSubtypes(sub_type), GetAtomicSubtypes(super_type));
   }
 
   const EntityTypeIDToSetOfEntityTypeIDsMap&
@@ -522,6 +530,40 @@ private:
     KATANA_LOG_ASSERT(id.value() == kUnknownEntityType);
   }
 
+  static constexpr size_t kBitsPerWord = 64;
+
+  /// The largest number of entity types that have a subtype matrix; with
+  /// more, IsSubtypeOf compares the sets of atomic types instead. The matrix
+  /// takes kMaxSubtypeMatrixTypes^2 / 8 bytes (2 MiB) at most.
+  static constexpr size_t kMaxSubtypeMatrixTypes = 4096;
+
+  static bool IsSubsetOf(
+      const SetOfEntityTypeIDs& sub, const SetOfEntityTypeIDs& super) {
+    const auto& sub_words = sub.get_vec();
+    const auto& super_words = super.get_vec();
+    for (size_t i = 0, n = sub_words.size(); i < n; ++i) {
+      uint64_t super_word = i < super_words.size()
+                                ? super_words[i].load(std::memory_order_relaxed)
+                                : 0;
+      if (sub_words[i].load(std::memory_order_relaxed) & ~super_word) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Rebuild the subtype matrix from the sets of atomic types
+  void BuildSubtypeMatrix();
+
+  /// Add the row and the column of the new type \p entity_type_id to the
+  /// subtype matrix
+  void AddToSubtypeMatrix(EntityTypeID entity_type_id);
+
+  /// Set the row of \p sub_type in the subtype matrix to its supertypes: the
+  /// intersection of the supertypes of its atomic types, or all types if it
+  /// has none
+  void FillSubtypeMatrixRow(EntityTypeID sub_type);
+
   /// The current size of the SetEntityTypeIDs bitsets
   size_t SetOfEntityTypeIDsSize_ = kDefaultSetOfEntityTypeIDsSize;
 
@@ -550,6 +592,16 @@ private:
   /// ex: atomic_entity_type_id_to_entity_type_ids_[atomic_id][atomic_id] == 1
   /// but atomic_entity_type_id_to_entity_type_ids_[non_atomic_id][non_atomic_id] == 0
   EntityTypeIDToSetOfEntityTypeIDsMap atomic_entity_type_id_to_entity_type_ids_;
+
+  /// A bit matrix with a row of subtype_matrix_stride_ words per EntityTypeID
+  /// where bit super_type of row sub_type is IsSubtypeOf(sub_type, super_type):
+  /// derived from entity_type_id_to_atomic_entity_type_ids_ and
+  /// atomic_entity_type_id_to_entity_type_ids_
+  /// The stride grows like the SetOfEntityTypeIDs bitsets, so the matrix is
+  /// only rebuilt when the number of types doubles, and it is 0 when there is
+  /// no matrix because there are too many types
+  std::vector<uint64_t> subtype_matrix_;
+  size_t subtype_matrix_stride_{0};
 };
 
 }  // namespace katana
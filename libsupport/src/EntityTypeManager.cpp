@@ -180,6 +180,8 @@ katana::EntityTypeManager::AddNonAtomicEntityType(
       "AddNonAtomicEntityType called with type_id_set that is already "
       "present.");
 
+  AddToSubtypeMatrix(new_entity_type_id);
+
   return Result<EntityTypeID>(new_entity_type_id);
 }
 
@@ -261,6 +263,8 @@ katana::EntityTypeManager::AddAtomicEntityType(const std::string& name) {
   entity_type_id_to_atomic_entity_type_ids_.emplace_back(entity_type_ids);
   atomic_entity_type_id_to_entity_type_ids_.emplace_back(entity_type_ids);
 
+  AddToSubtypeMatrix(new_entity_type_id);
+
   return Result<EntityTypeID>(new_entity_type_id);
 }
 
@@ -312,6 +316,91 @@ katana::EntityTypeManager::ResizeSetOfEntityTypeIDsMaps(
   }
 }
 
+void
+katana::EntityTypeManager::BuildSubtypeMatrix() {
+  size_t num_entity_types = GetNumEntityTypes();
+  subtype_matrix_.clear();
+  if (num_entity_types > kMaxSubtypeMatrixTypes) {
+    subtype_matrix_stride_ = 0;
+    subtype_matrix_.shrink_to_fit();
+    return;
+  }
+
+  // Max EntityTypeID is 1 less than the number of entity type ids
+  subtype_matrix_stride_ =
+      CalculateSetOfEntityTypeIDsSize(num_entity_types - 1) / kBitsPerWord;
+  subtype_matrix_.resize(num_entity_types * subtype_matrix_stride_);
+  for (size_t i = 0; i < num_entity_types; ++i) {
+    FillSubtypeMatrixRow(i);
+  }
+}
+
+void
+katana::EntityTypeManager::AddToSubtypeMatrix(
+    katana::EntityTypeID entity_type_id) {
+  // the rows are full or there are too many types for a matrix
+  if (entity_type_id >= subtype_matrix_stride_ * kBitsPerWord) {
+    BuildSubtypeMatrix();
+    return;
+  }
+
+  KATANA_LOG_DEBUG_ASSERT(
+      subtype_matrix_.size() == entity_type_id * subtype_matrix_stride_);
+  subtype_matrix_.resize((entity_type_id + 1) * subtype_matrix_stride_);
+  FillSubtypeMatrixRow(entity_type_id);
+
+  // the column: existing types whose atomic types are a subset of the new one
+  const SetOfEntityTypeIDs& atomic_types = GetAtomicSubtypes(entity_type_id);
+  uint64_t bit = uint64_t{1} << (entity_type_id % kBitsPerWord);
+  for (size_t i = 0; i < entity_type_id; ++i) {
+    if (IsSubsetOf(GetAtomicSubtypes(i), atomic_types)) {
+      subtype_matrix_
+          [i * subtype_matrix_stride_ + entity_type_id / kBitsPerWord] |= bit;
+    }
+  }
+}
+
+void
+katana::EntityTypeManager::FillSubtypeMatrixRow(katana::EntityTypeID sub_type) {
+  uint64_t* row = &subtype_matrix_[sub_type * subtype_matrix_stride_];
+  bool has_atomic_types = false;
+
+  const auto& atomic_words = GetAtomicSubtypes(sub_type).get_vec();
+  for (size_t w = 0; w < atomic_words.size(); ++w) {
+    uint64_t word = atomic_words[w].load(std::memory_order_relaxed);
+    while (word != 0) {
+      size_t atomic_type = w * kBitsPerWord + __builtin_ctzll(word);
+      word &= word - 1;
+
+      const auto& super_words =
+          atomic_entity_type_id_to_entity_type_ids_.at(atomic_type).get_vec();
+      for (size_t i = 0; i < subtype_matrix_stride_; ++i) {
+        uint64_t super_word =
+            i < super_words.size()
+                ? super_words[i].load(std::memory_order_relaxed)
+                : 0;
+        row[i] = has_atomic_types ? row[i] & super_word : super_word;
+      }
+      has_atomic_types = true;
+    }
+  }
+
+  if (!has_atomic_types) {
+    // no atomic types, like kUnknownEntityType: a subtype of every type
+    size_t num_entity_types = GetNumEntityTypes();
+    for (size_t i = 0; i < subtype_matrix_stride_; ++i) {
+      size_t begin = i * kBitsPerWord;
+      if (begin + kBitsPerWord <= num_entity_types) {
+        row[i] = ~uint64_t{0};
+      } else if (begin < num_entity_types) {
+        row[i] = (uint64_t{1} << (num_entity_types - begin)) - 1;
+      } else {
+        row[i] = 0;
+      }
+    }
+  }
+}
+
 // helper function for ToString
 // Converts a SetOfEntityTypeIDs to its integer represenation
 size_t
@@ -2,6 +2,8 @@
 
 #include <map>
 #include <random>
+#include <string>
+#include <vector>
 
 #include "katana/Cache.h"
 #include "katana/Logging.h"
@@ -150,6 +152,41 @@ TestLRUSize(size_t lru_size, const std::vector<katana::Uri>& keys) {
   KATANA_LOG_ASSERT(cache.size() == 0);
 }
 
+void
+TestKeyTypeAndErase() {
+  katana::Cache<CacheValue, std::string, std::hash<std::string>> cache(
+      10, [](const CacheValue& value) { return BytesInValue(value); });
+
+  cache.Insert("a", SizeFiveValue());
+  cache.Insert("b", SizeOneValue());
+  cache.Insert("c", SizeOneValue());
+  KATANA_LOG_ASSERT(cache.size() == 7);
+
+  std::vector<std::string> order;
+  cache.ForEach(
+      [&](const std::string& key, const CacheValue&) { order.push_back(key); });
+  KATANA_LOG_ASSERT((order == std::vector<std::string>{"c", "b", "a"}));
+
+  KATANA_LOG_ASSERT(cache.Erase("a"));
+  KATANA_LOG_ASSERT(!cache.Erase("a"));
+  KATANA_LOG_ASSERT(!cache.Contains("a"));
+  KATANA_LOG_ASSERT(cache.size() == 2);
+
+  // evicts b and c, the least recently used, to fit e
+  cache.Insert("d", SizeFiveValue());
+  cache.Insert("e", SizeFiveValue());
+  KATANA_LOG_ASSERT(!cache.Contains("b"));
+  KATANA_LOG_ASSERT(!cache.Contains("c"));
+  KATANA_LOG_ASSERT(cache.GetStats().evict_count == 2);
+
+  // replacing the value of a key replaces its bytes too
+  cache.Insert("e", SizeOneValue());
+  KATANA_LOG_ASSERT(cache.size() == 6);
+  cache.Insert("e", SizeFiveValue());
+  KATANA_LOG_ASSERT(cache.size() == 10);
+  KATANA_LOG_ASSERT(cache.Contains("d") && cache.Contains("e"));
+}
+
 int
 main(int argc, char** argv) {
   constexpr size_t lru_size = 10;
@@ -172,5 +209,7 @@ main(int argc, char** argv) {
 
   TestLRUBytes(keys);
 
+  TestKeyTypeAndErase();
+
   return 0;
 }
@@ -0,0 +1,107 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/EntityTypeManager.h"
+#include "katana/Logging.h"
+
+namespace {
+
+constexpr size_t kNumQueries = 64 * 1024;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long num_atomic_types : {16, 256, 1024}) {
+    b->Args({num_atomic_types});
+  }
+}
+
+/// A manager with num_atomic_types atomic types and as many intersections of
+/// 2 or 3 of them, like the labels of a property graph
+katana::EntityTypeManager
+MakeManager(size_t num_atomic_types) {
+  katana::EntityTypeManager mgr;
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<size_t> dist(0, num_atomic_types - 1);
+
+  for (size_t i = 0; i < num_atomic_types; ++i) {
+    KATANA_LOG_ASSERT(mgr.AddAtomicEntityType(fmt::format("type{}", i)));
+  }
+  for (size_t i = 0; i < num_atomic_types; ++i) {
+    katana::TypeNameSet names;
+    for (size_t j = 0; j < 2 + i % 2; ++j) {
+      names.emplace(fmt::format("type{}", dist(gen)));
+    }
+    KATANA_LOG_ASSERT(mgr.GetOrAddNonAtomicEntityTypeFromStrings(names));
+  }
+  return mgr;
+}
+
+std::vector<std::pair<katana::EntityTypeID, katana::EntityTypeID>>
+MakeQueries(const katana::EntityTypeManager& mgr) {
+  std::mt19937_64 gen(1);
+  std::uniform_int_distribution<katana::EntityTypeID> dist(
+      0, mgr.GetNumEntityTypes() - 1);
+  std::vector<std::pair<katana::EntityTypeID, katana::EntityTypeID>> queries;
+  for (size_t i = 0; i < kNumQueries; ++i) {
+    queries.emplace_back(dist(gen), dist(gen));
+  }
+  return queries;
+}
+
+/// The subtype check before the subtype matrix, which builds a bitset per call
+bool
+IsSubtypeOfBaseline(
+    const katana::EntityTypeManager& mgr, katana::EntityTypeID sub_type,
+    katana::EntityTypeID super_type) {
+  const auto& super_atomic_types = mgr.GetAtomicSubtypes(super_type);
+  const auto& sub_atomic_types = mgr.GetAtomicSubtypes(sub_type);
+  katana::SetOfEntityTypeIDs res;
+  res.resize(mgr.SetOfEntityTypeIDsSize());
+  res.bitwise_and(sub_atomic_types, super_atomic_types);
+  return (res == sub_atomic_types);
+}
+
+void
+IsSubtypeOfBaseline(benchmark::State& state) {
+  katana::EntityTypeManager mgr = MakeManager(state.range(0));
+  auto queries = MakeQueries(mgr);
+
+  for (auto _ : state) {
+    size_t count = 0;
+    for (const auto& [sub_type, super_type] : queries) {
+      count += IsSubtypeOfBaseline(mgr, sub_type, super_type);
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void
+IsSubtypeOf(benchmark::State& state) {
+  katana::EntityTypeManager mgr = MakeManager(state.range(0));
+  auto queries = MakeQueries(mgr);
+
+  for (const auto& [sub_type, super_type] : queries) {
+    KATANA_LOG_ASSERT(
+        mgr.IsSubtypeOf(sub_type, super_type) ==
+        IsSubtypeOfBaseline(mgr, sub_type, super_type));
+  }
+
+  for (auto _ : state) {
+    size_t count = 0;
+    for (const auto& [sub_type, super_type] : queries) {
+      count += mgr.IsSubtypeOf(sub_type, super_type);
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(IsSubtypeOfBaseline)->Apply(MakeArguments);
+BENCHMARK(IsSubtypeOf)->Apply(MakeArguments);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -1,6 +1,31 @@
+#include <algorithm>
+
 #include "katana/EntityTypeManager.h"
 #include "katana/Logging.h"
 
+namespace {
+
+void
+CheckSubtypes(const katana::EntityTypeManager& mgr) {
+  for (size_t i = 0; i < mgr.GetNumEntityTypes(); ++i) {
+    auto sub_res = mgr.EntityTypeToTypeNameSet(i);
+    KATANA_LOG_ASSERT(sub_res);
+    for (size_t j = 0; j < mgr.GetNumEntityTypes(); ++j) {
+      auto super_res = mgr.EntityTypeToTypeNameSet(j);
+      KATANA_LOG_ASSERT(super_res);
+      // a type is a subtype of another if all of its names are in the other
+      bool expected = std::includes(
+          super_res.value().begin(), super_res.value().end(),
+          sub_res.value().begin(), sub_res.value().end());
+      KATANA_LOG_VASSERT(
+          mgr.IsSubtypeOf(i, j) == expected, "i={} ({}) j={} ({})", i,
+          sub_res.value(), j, super_res.value());
+    }
+  }
+}
+
+}  // namespace
+
 void
 CreateEntityTypeIDs() {
   std::vector<katana::TypeNameSet> tnss = {
@@ -65,10 +90,35 @@ ValidateConstructor() {
     KATANA_LOG_WARN("{}", mgr.ReportDiff(mgr_copy));
     KATANA_LOG_ASSERT(false);
   }
+  CheckSubtypes(mgr_copy);
+}
+
+void
+ValidateSubtypes() {
+  katana::EntityTypeManager mgr;
+  std::vector<katana::TypeNameSet> tnss = {
+      {"alice"}, {"baker"}, {"alice", "baker"}, {"alice", "baker", "charlie"}};
+  for (const auto& tns : tnss) {
+    auto res = mgr.GetOrAddNonAtomicEntityTypeFromStrings(tns);
+    KATANA_LOG_ASSERT(res);
+  }
+  CheckSubtypes(mgr);
+
+  // grow past the initial size of the subtype matrix
+  for (size_t i = 0; i < katana::kDefaultSetOfEntityTypeIDsSize; ++i) {
+    katana::TypeNameSet tns({fmt::format("type{}", i)});
+    if (i % 2 == 1) {
+      tns.emplace(fmt::format("type{}", i - 1));
+    }
+    auto res = mgr.GetOrAddNonAtomicEntityTypeFromStrings(tns);
+    KATANA_LOG_ASSERT(res);
+  }
+  CheckSubtypes(mgr);
 }
 
 int
 main() {
   CreateEntityTypeIDs();
   ValidateConstructor();
+  ValidateSubtypes();
 }
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <string>
 #include <string_view>
 #include <unordered_set>
 #include <vector>
@@ -43,6 +44,11 @@ public:
       const std::string& source_uri, const std::string& dest_uri,
       uint64_t begin, uint64_t size) = 0;
 
+  /// Backends whose files live on a local file system return the path of
+  /// \param uri so that callers can map it directly; others return
+  /// ErrorCode::NotImplemented
+  virtual katana::Result<std::string> LocalPath(const std::string& uri);
+
   /// Storage classes with higher priority will be tried by GlobalState earlier
   /// currently only used to enforce local fs default; GlobalState defaults
   /// to the LocalStorage when no protocol on the URI is provided
@@ -16,7 +16,40 @@ namespace tsuba {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
 public:
+  /// How Bind makes the contents of a file available
+  ///
+  /// Pages of a mapped file that have not been written to are read from the
+  /// file, so truncating it while it is mapped makes accesses past its new
+  /// end raise SIGBUS. tsuba writes local files under a temporary name and
+  /// renames them into place, which leaves existing mappings intact; other
+  /// writers must do the same, or views of their files must use kCopy.
+  enum class MapMode {
+    /// Read the file through its storage backend into anonymous memory
+    kCopy,
+    /// Map local files copy-on-write; remote files are copied
+    kPrivate,
+    /// Map local files read-only and share their pages with every other
+    /// mapping of the file; remote files are copied
+    kShared,
+  };
+
+  /// Expected access pattern of a mapped file, passed on to madvise
+  enum class Advice {
+    kNormal,
+    kSequential,
+    kRandom,
+    kWillNeed,
+  };
+
+  struct MapOptions {
+    MapMode mode{MapMode::kPrivate};
+    /// Fault in all pages of a mapped file during Bind (MAP_POPULATE)
+    bool populate{false};
+    Advice advice{Advice::kNormal};
+  };
+
   FileView() = default;
+  explicit FileView(const MapOptions& options) : options_(options) {}
   FileView(const FileView&) = delete;
   FileView& operator=(const FileView&) = delete;
 
@@ -27,6 +60,8 @@ public:
         cursor_(other.cursor_),
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
+        options_(other.options_),
+        mapped_(other.mapped_),
         bound_(other.bound_),
         filling_(std::move(other.filling_)),
         fetches_(std::move(other.fetches_)) {
@@ -44,6 +79,8 @@ public:
       cursor_ = other.cursor_;
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
+      options_ = other.options_;
+      mapped_ = other.mapped_;
       bound_ = other.bound_;
       filling_ = std::move(other.filling_);
       fetches_ =
@@ -65,6 +102,10 @@ public:
   /// Calls to Read will handle asynchronous
   /// reads internally, but if you intend to use ptr(), you should pass
   /// resolve=true.
+  ///
+  /// Unless the MapMode is kCopy, a file on local storage is mapped
+  /// directly: the whole file is then addressable regardless of begin and
+  /// end, and pages are read in by the kernel on first access.
   katana::Result<void> Bind(
       std::string_view filename, uint64_t begin, uint64_t end, bool resolve);
   katana::Result<void> Bind(
@@ -79,6 +120,11 @@ public:
 
   bool Valid() const { return bound_; }
 
+  /// True if the bound file is mapped directly rather than copied
+  bool mapped() const { return mapped_; }
+
+  const MapOptions& options() const { return options_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -129,6 +175,9 @@ public:
   ///// End arrow::io::RandomAccessFile methods ///////
 
 private:
+  // Map the local file at path over the whole file; returns the mapping
+  katana::Result<void*> MapLocalFile(const std::string& path, uint64_t size);
+
   // Given the size of some region, how many pages does it take up?
   uint64_t page_number(uint64_t size);
 
@@ -168,6 +217,8 @@ private:
   int64_t cursor_{0};
   int64_t mem_start_{0};
   std::string filename_;
+  MapOptions options_;
+  bool mapped_{false};
   bool bound_{false};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
@@ -223,6 +223,34 @@ public:
   katana::Result<void> SetEdgeEntityTypeIDArrayFile(
       const katana::Uri& new_type_id_array);
 
+  /// Persist a serialized index over node property `name` with the next
+  /// Store. The index is recorded against the version of the property that
+  /// Store writes, and is dropped once that property changes.
+  void AddNodePropertyIndex(
+      const std::string& name, std::unique_ptr<FileFrame> index_ff);
+
+  /// Persist a serialized index over edge property `name` with the next
+  /// Store. The index is recorded against the version of the property that
+  /// Store writes, and is dropped once that property changes.
+  void AddEdgePropertyIndex(
+      const std::string& name, std::unique_ptr<FileFrame> index_ff);
+
+  /// Returns true if storage holds an index over node property `name` that
+  /// was built from the property as it is currently stored
+  bool HasNodePropertyIndex(const std::string& name) const;
+
+  /// Returns true if storage holds an index over edge property `name` that
+  /// was built from the property as it is currently stored
+  bool HasEdgePropertyIndex(const std::string& name) const;
+
+  /// Map the persisted index over node property `name` into memory
+  katana::Result<std::shared_ptr<FileView>> LoadNodePropertyIndex(
+      const std::string& name) const;
+
+  /// Map the persisted index over edge property `name` into memory
+  katana::Result<std::shared_ptr<FileView>> LoadEdgePropertyIndex(
+      const std::string& name) const;
+
   //
   // accessors and mutators
   //
@@ -316,6 +344,9 @@ private:
       RDGVersioningPolicy versioning_action,
       std::unique_ptr<WriteGroup> write_group);
 
+  katana::Result<void> DoStorePropertyIndexes(
+      RDGHandle handle, WriteGroup* write_group);
+
   katana::Result<void> DoStoreNodeEntityTypeIDArray(
       RDGHandle handle, std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
       std::unique_ptr<WriteGroup>& write_group);
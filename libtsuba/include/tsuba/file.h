@@ -89,6 +89,10 @@ FileGet(const StrType& uri, T* obj) {
   return FileGet(uri, obj, 0, sizeof(T));
 }
 
+/// Path of \param uri on the local file system, if its storage backend keeps
+/// it there. Returns ErrorCode::NotImplemented for remote backends.
+KATANA_EXPORT katana::Result<std::string> FileLocalPath(const std::string& uri);
+
 // start reading a part of the file into a caller defined buffer
 KATANA_EXPORT std::future<katana::CopyableResult<void>> FileGetAsync(
     const std::string& uri, void* result_buffer, uint64_t begin, uint64_t size);
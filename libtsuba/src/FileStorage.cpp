@@ -1,9 +1,15 @@
 #include "tsuba/FileStorage.h"
 
 #include "FileStorage_internal.h"
+#include "tsuba/Errors.h"
 
 tsuba::FileStorage::~FileStorage() = default;
 
+katana::Result<std::string>
+tsuba::FileStorage::LocalPath(const std::string&) {
+  return ErrorCode::NotImplemented;
+}
+
 std::vector<tsuba::FileStorage*>&
 tsuba::GetRegisteredFileStorages() {
   static std::vector<FileStorage*> fs;
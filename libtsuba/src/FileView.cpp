@@ -1,10 +1,12 @@
 #include "tsuba/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
 #include <cassert>
 #include <cstdio>
+#include <iomanip>
 #include <string>
 
 #include "katana/Logging.h"
@@ -30,6 +32,25 @@
  * somehow and also tell users to not modify our files?
  */
 
+namespace {
+
+int
+ToMadvise(tsuba::FileView::Advice advice) {
+  switch (advice) {
+  case tsuba::FileView::Advice::kSequential:
+    return MADV_SEQUENTIAL;
+  case tsuba::FileView::Advice::kRandom:
+    return MADV_RANDOM;
+  case tsuba::FileView::Advice::kWillNeed:
+    return MADV_WILLNEED;
+  case tsuba::FileView::Advice::kNormal:
+  default:
+    return MADV_NORMAL;
+  }
+}
+
+}  // namespace
+
 namespace tsuba {
 
 FileView::~FileView() {
@@ -56,6 +77,7 @@ FileView::Unbind() {
     cursor_ = 0;
     mem_start_ = 0;
     filename_ = "";
+    mapped_ = false;
     filling_ = std::vector<uint64_t>();
     KATANA_LOG_DEBUG_ASSERT(fetches_->empty());
 
@@ -87,9 +109,19 @@ FileView::Bind(
   // here.
   page_shift_ = 20; /* 1M */
   void* tmp = nullptr;
+  bool mapped = false;
+
+  // Local files can be mapped directly, which avoids holding a second copy
+  // of the file in memory and lets processes share the page cache.
+  if (buf.size > 0 && options_.mode != MapMode::kCopy) {
+    if (auto path_res = FileLocalPath(filename_); path_res) {
+      tmp = KATANA_CHECKED(MapLocalFile(path_res.value(), buf.size));
+      mapped = true;
+    }
+  }
 
   // Map enough virtual memory to hold entire file, but do not populate it
-  if (buf.size > 0) {
+  if (buf.size > 0 && !mapped) {
     tmp =
         mmap(nullptr, buf.size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     if (tmp == MAP_FAILED) {
@@ -101,9 +133,12 @@ FileView::Bind(
   KATANA_CHECKED(Unbind());
 
   map_start_ = static_cast<uint8_t*>(tmp);
-  mem_start_ = -1;
+  mapped_ = mapped;
+  mem_start_ = mapped ? 0 : -1;
   filling_.clear();
-  filling_.resize(page_number(buf.size) / 64 + 1, 0);
+  if (!mapped) {
+    filling_.resize(page_number(buf.size) / 64 + 1, 0);
+  }
   file_size_ = buf.size;
   fetches_ = std::make_unique<std::vector<FillingRange>>();
   KATANA_CHECKED_CONTEXT(
@@ -129,6 +164,19 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
+  // The kernel reads mapped files in on demand; an asynchronous fill only
+  // asks it to start reading the range now.
+  if (mapped_) {
+    if (!resolve && in_end != in_begin) {
+      uint64_t start = RoundDownToBlock(in_begin);
+      if (int err = madvise(
+              map_start_ + start, in_end - start, MADV_WILLNEED);
+          err) {
+        return KATANA_ERROR(katana::ResultErrno(), "advising mapped file");
+      }
+    }
+    return katana::ResultSuccess();
+  }
   // Gracefully handle the fill zero case here to simplify Bind
   if (in_end != in_begin) {
     if (auto opt =
@@ -168,6 +216,47 @@ FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void*>
+FileView::MapLocalFile(const std::string& path, uint64_t size) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "opening {}", std::quoted(path));
+  }
+
+  // Shared mappings are read-only so that nothing can write through to the
+  // file. Private mappings stay writable, as the copied buffer was.
+  int prot = PROT_READ;
+  int flags = MAP_SHARED;
+  if (options_.mode == MapMode::kPrivate) {
+    prot |= PROT_WRITE;
+    flags = MAP_PRIVATE;
+  }
+#ifdef MAP_POPULATE
+  if (options_.populate) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+
+  void* tmp = mmap(nullptr, size, prot, flags, fd, 0);
+  if (tmp == MAP_FAILED) {
+    std::error_code map_err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(map_err, "mapping {}", std::quoted(path));
+  }
+  // The mapping keeps its own reference to the file
+  close(fd);
+
+  if (options_.advice != Advice::kNormal) {
+    if (int err = madvise(tmp, size, ToMadvise(options_.advice)); err) {
+      std::error_code advise_err = katana::ResultErrno();
+      munmap(tmp, size);
+      return KATANA_ERROR(advise_err, "advising {}", std::quoted(path));
+    }
+  }
+  return tmp;
+}
+
 bool
 FileView::Equals(const FileView& other) const {
   if (!bound_ || !other.bound_) {
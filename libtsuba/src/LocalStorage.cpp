@@ -7,15 +7,26 @@
 #include <unistd.h>
 
 #include <algorithm>
-#include <fstream>
-#include <iterator>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
 #include <system_error>
+#include <thread>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 #include <boost/system/error_code.hpp>
 
 #include "GlobalState.h"
+#include "katana/Env.h"
 #include "katana/Logging.h"
+#include "katana/Random.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "tsuba/Errors.h"
@@ -41,8 +52,370 @@ EnsureDirectories(const std::string& uri) {
   return katana::ResultSuccess();
 }
 
+/// Transfers are split into chunks of this size, which is a multiple of the
+/// alignment O_DIRECT requires
+constexpr uint64_t kChunkSize = UINT64_C(8) << 20; /* 8M */
+constexpr uint32_t kMaxIoThreads = 16;
+
+/// File descriptors for one transfer. direct_fd is opened with O_DIRECT when
+/// requested and supported by the file system, and is -1 otherwise.
+class IoFile {
+public:
+  IoFile() = default;
+  IoFile(const IoFile&) = delete;
+  IoFile& operator=(const IoFile&) = delete;
+  ~IoFile() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    if (direct_fd_ >= 0) {
+      close(direct_fd_);
+    }
+  }
+
+  katana::Result<void> Open(const std::string& path, int flags, bool direct) {
+    fd_ = open(path.c_str(), flags, 0644);
+    if (fd_ < 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "opening {}", std::quoted(path));
+    }
+#ifdef O_DIRECT
+    if (direct) {
+      // Not every file system supports O_DIRECT (e.g., tmpfs); fall back
+      // to buffered I/O for those
+      direct_fd_ =
+          open(path.c_str(), (flags & ~(O_CREAT | O_EXCL | O_TRUNC)) | O_DIRECT);
+    }
+#else
+    (void)direct;
+#endif
+    return katana::ResultSuccess();
+  }
+
+  int fd() const { return fd_; }
+
+  /// Descriptor to use for a transfer of size bytes between buf and offset
+  int fd(const void* buf, uint64_t offset, uint64_t size) const {
+    uint64_t bits = reinterpret_cast<uintptr_t>(buf) | offset | size;
+    if (direct_fd_ >= 0 && (bits & tsuba::kBlockOffsetMask) == 0) {
+      return direct_fd_;
+    }
+    return fd_;
+  }
+
+private:
+  int fd_{-1};
+  int direct_fd_{-1};
+};
+
+/// Files are written under a temporary name next to their destination and
+/// then renamed over it, rather than truncated and rewritten in place: a
+/// FileView may have the destination mapped, and truncating a mapped file
+/// makes accesses to its pages past the new end raise SIGBUS. Mappings of
+/// the old file keep seeing the old contents.
+std::string
+TempPath(const std::string& path) {
+  return path + ".tmp-" + katana::RandomAlphanumericString(12);
+}
+
+/// Replace path with tmp_path if res is a success, otherwise remove tmp_path
+katana::Result<void>
+ReplaceFile(
+    const std::string& tmp_path, const std::string& path,
+    katana::Result<void> res) {
+  if (res && rename(tmp_path.c_str(), path.c_str()) != 0) {
+    res = KATANA_ERROR(
+        katana::ResultErrno(), "renaming {} to {}", std::quoted(tmp_path),
+        std::quoted(path));
+  }
+  if (!res) {
+    unlink(tmp_path.c_str());
+  }
+  return res;
+}
+
+/// pread until size bytes are read or the end of file is reached. Returns
+/// the number of bytes read.
+katana::Result<uint64_t>
+ReadFully(const IoFile& file, uint8_t* data, uint64_t offset, uint64_t size) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pread(
+        file.fd(data + done, offset + done, size - done), data + done,
+        size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "reading at {}", offset);
+    }
+    if (ret == 0) {
+      break;
+    }
+    done += ret;
+  }
+  return done;
+}
+
+katana::Result<void>
+WriteFully(
+    const IoFile& file, const uint8_t* data, uint64_t offset, uint64_t size) {
+  uint64_t done = 0;
+  while (done < size) {
+    ssize_t ret = pwrite(
+        file.fd(data + done, offset + done, size - done), data + done,
+        size - done, offset + done);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "writing at {}", offset);
+    }
+    done += ret;
+  }
+  return katana::ResultSuccess();
+}
+
+/// Copy size bytes from in at in_offset to out at out_offset, stopping early
+/// at the end of in
+katana::Result<void>
+CopyFully(
+    const IoFile& in, const IoFile& out, uint64_t in_offset,
+    uint64_t out_offset, uint64_t size) {
+#ifdef __linux__
+  // Let the kernel copy the range without a round trip through user space
+  uint64_t done = 0;
+  while (done < size) {
+    loff_t in_off = in_offset + done;
+    loff_t out_off = out_offset + done;
+    ssize_t ret =
+        copy_file_range(in.fd(), &in_off, out.fd(), &out_off, size - done, 0);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // Unsupported by the kernel or across these file systems
+      if (done == 0 && (errno == ENOSYS || errno == EXDEV ||
+                        errno == EINVAL || errno == EOPNOTSUPP)) {
+        break;
+      }
+      return KATANA_ERROR(katana::ResultErrno(), "copying at {}", in_offset);
+    }
+    if (ret == 0) {
+      return katana::ResultSuccess();
+    }
+    done += ret;
+  }
+  if (done == size) {
+    return katana::ResultSuccess();
+  }
+#endif
+
+  std::unique_ptr<uint8_t, decltype(&free)> buf(
+      static_cast<uint8_t*>(aligned_alloc(tsuba::kBlockSize, kChunkSize)),
+      &free);
+  if (!buf) {
+    return tsuba::ErrorCode::OutOfMemory;
+  }
+  uint64_t read = KATANA_CHECKED(ReadFully(in, buf.get(), in_offset, size));
+  return WriteFully(out, buf.get(), out_offset, read);
+}
+
 }  // namespace
 
+/// A fixed set of threads that runs the asynchronous requests of a
+/// LocalStorage and helps with the chunks of its transfers
+class tsuba::LocalStorage::IoPool {
+public:
+  explicit IoPool(uint32_t num_threads) {
+    threads_.reserve(num_threads);
+    for (uint32_t t = 0; t < num_threads; ++t) {
+      threads_.emplace_back([this]() { Run(); });
+    }
+  }
+  IoPool(const IoPool&) = delete;
+  IoPool& operator=(const IoPool&) = delete;
+
+  /// Runs the tasks already submitted, then stops the threads
+  ~IoPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  uint32_t num_threads() const { return threads_.size(); }
+
+  template <typename Fn>
+  std::future<katana::CopyableResult<void>> Async(Fn fn) {
+    auto task =
+        std::make_shared<std::packaged_task<katana::CopyableResult<void>()>>(
+            [fn = std::move(fn)]() -> katana::CopyableResult<void> {
+              if (auto res = fn(); !res) {
+                return katana::CopyableErrorInfo{res.error()};
+              }
+              return katana::CopyableResultSuccess();
+            });
+    auto future = task->get_future();
+    Submit([task]() { (*task)(); });
+    return future;
+  }
+
+  /// Call fn(offset, size) for each kChunkSize chunk of [0, size). The
+  /// calling thread works through the chunks with the help of up to
+  /// max_threads - 1 pool threads. It does not wait for helpers that have
+  /// not started, so transfers that are themselves running on the pool
+  /// cannot deadlock. Returns the first error encountered.
+  katana::Result<void> ForEachChunk(
+      uint64_t size, uint32_t max_threads,
+      const std::function<katana::Result<void>(uint64_t, uint64_t)>& fn) {
+    uint64_t num_chunks = (size + kChunkSize - 1) / kChunkSize;
+    auto do_chunk = [&fn, size](uint64_t chunk) {
+      uint64_t offset = chunk * kChunkSize;
+      return fn(offset, std::min(kChunkSize, size - offset));
+    };
+
+    uint64_t num_helpers = std::min<uint64_t>(
+        {max_threads, num_threads() + 1, num_chunks});
+    if (num_helpers <= 1) {
+      for (uint64_t chunk = 0; chunk < num_chunks; ++chunk) {
+        KATANA_CHECKED(do_chunk(chunk));
+      }
+      return katana::ResultSuccess();
+    }
+    --num_helpers;
+
+    // Helpers that start after the caller has returned only touch the
+    // shared state and find no chunks left
+    auto loop = std::make_shared<ChunkLoop>(num_chunks);
+    for (uint64_t h = 0; h < num_helpers; ++h) {
+      Submit([loop, do_chunk]() { loop->Work(do_chunk); });
+    }
+    loop->Work(do_chunk);
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->done.wait(lock, [&]() { return loop->num_working == 0; });
+    if (!loop->result) {
+      return katana::ErrorInfo{loop->result.error()};
+    }
+    return katana::ResultSuccess();
+  }
+
+private:
+  /// The chunks of one transfer, shared by its caller and helpers
+  struct ChunkLoop {
+    explicit ChunkLoop(uint64_t num_chunks_) : num_chunks(num_chunks_) {}
+
+    template <typename DoChunk>
+    void Work(const DoChunk& do_chunk) {
+      // Counted before claiming a chunk so that the caller waits for it
+      ++num_working;
+      for (uint64_t chunk = next_chunk++; chunk < num_chunks;
+           chunk = next_chunk++) {
+        if (auto res = do_chunk(chunk); !res) {
+          std::lock_guard<std::mutex> lock(mutex);
+          // Errors are saved as CopyableResults because ErrorInfo lives on
+          // the thread that created it
+          if (result) {
+            result = katana::CopyableErrorInfo{res.error()};
+          }
+          // Stop everyone from starting more chunks
+          next_chunk = num_chunks;
+          break;
+        }
+      }
+      if (--num_working == 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.notify_all();
+      }
+    }
+
+    const uint64_t num_chunks;
+    std::atomic<uint64_t> next_chunk{0};
+    std::atomic<uint32_t> num_working{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    katana::CopyableResult<void> result{katana::CopyableResultSuccess()};
+  };
+
+  void Submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace_back(std::move(task));
+    }
+    ready_.notify_one();
+  }
+
+  void Run() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this]() { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_{false};
+};
+
+tsuba::LocalStorage::LocalStorage() : FileStorage("file://") {}
+
+tsuba::LocalStorage::~LocalStorage() = default;
+
+katana::Result<void>
+tsuba::LocalStorage::Fini() {
+  pool_.reset();
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  return pool_->Async([=]() { return WriteFile(uri, data, size); });
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  return pool_->Async(
+      [=]() { return ReadFile(uri, start, size, result_buf); });
+}
+
+katana::Result<void>
+tsuba::LocalStorage::Init() {
+  bool direct_io = false;
+  if (katana::GetEnv("KATANA_LOCAL_STORAGE_DIRECT_IO", &direct_io)) {
+    direct_io_ = direct_io;
+  }
+
+  int num_io_threads = 0;
+  if (katana::GetEnv("KATANA_LOCAL_STORAGE_IO_THREADS", &num_io_threads) &&
+      num_io_threads > 0) {
+    num_io_threads_ = num_io_threads;
+  } else {
+    num_io_threads_ = std::clamp<uint32_t>(
+        std::thread::hardware_concurrency(), 1, kMaxIoThreads);
+  }
+  pool_ = std::make_unique<IoPool>(num_io_threads_);
+  return katana::ResultSuccess();
+}
+
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
@@ -57,16 +430,20 @@ tsuba::LocalStorage::WriteFile(
   CleanUri(&uri);
   KATANA_CHECKED(EnsureDirectories(uri));
 
-  std::ofstream ofile(uri);
-  if (!ofile.good()) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "opening file: {}", strerror(errno));
-  }
-  ofile.write(reinterpret_cast<const char*>(data), size); /* NOLINT */
-  if (!ofile.good()) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "writing file");
+  std::string tmp_path = TempPath(uri);
+  katana::Result<void> res = katana::ResultSuccess();
+  {
+    IoFile file;
+    KATANA_CHECKED_ERROR_CODE(
+        file.Open(tmp_path, O_WRONLY | O_CREAT | O_EXCL, direct_io_),
+        ErrorCode::LocalStorageError, "opening file");
+
+    res = pool_->ForEachChunk(
+        size, num_io_threads_, [&](uint64_t offset, uint64_t chunk_size) {
+          return WriteFully(file, data + offset, offset, chunk_size);
+        });
   }
-  return katana::ResultSuccess();
+  return ReplaceFile(tmp_path, uri, std::move(res));
 }
 
 katana::Result<void>
@@ -78,51 +455,50 @@ tsuba::LocalStorage::RemoteCopyFile(
 
   KATANA_CHECKED(EnsureDirectories(dest_uri));
 
-  std::ifstream ifile(source_uri, std::ios_base::binary);
-  if (!ifile) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open source file");
-  }
-  ifile.seekg(begin, std::ios_base::beg);
-
-  std::ofstream ofile(dest_uri, std::ios_base::binary | std::ios_base::trunc);
-  if (!ofile) {
-    return KATANA_ERROR(
+  IoFile ifile;
+  KATANA_CHECKED_ERROR_CODE(
+      ifile.Open(source_uri, O_RDONLY, direct_io_),
+      ErrorCode::LocalStorageError, "failed to open source file");
+  std::string tmp_path = TempPath(dest_uri);
+  katana::Result<void> res = katana::ResultSuccess();
+  {
+    IoFile ofile;
+    KATANA_CHECKED_ERROR_CODE(
+        ofile.Open(tmp_path, O_WRONLY | O_CREAT | O_EXCL, direct_io_),
         ErrorCode::LocalStorageError, "failed to open dest file");
-  }
 
-  std::copy_n(
-      std::istreambuf_iterator<char>(ifile), size,
-      std::ostreambuf_iterator<char>(ofile));
-  return katana::ResultSuccess();
+    res = pool_->ForEachChunk(
+        size, num_io_threads_, [&](uint64_t offset, uint64_t chunk_size) {
+          return CopyFully(ifile, ofile, begin + offset, offset, chunk_size);
+        });
+  }
+  return ReplaceFile(tmp_path, dest_uri, std::move(res));
 }
 
 katana::Result<void>
 tsuba::LocalStorage::ReadFile(
     std::string uri, uint64_t start, uint64_t size, uint8_t* data) {
   CleanUri(&uri);
-  std::ifstream ifile(uri, std::ios_base::binary);
-  if (!ifile) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to open source file {}",
-        std::quoted(uri));
-  }
-
-  ifile.seekg(start);
-  if (!ifile) {
-    return KATANA_ERROR(
-        ErrorCode::LocalStorageError, "failed to seek, {}", start);
-  }
-
-  ifile.read(reinterpret_cast<char*>(data), size); /* NOLINT */
-  if (!ifile) {
-    return KATANA_ERROR(ErrorCode::LocalStorageError, "failed to read");
-  }
+  IoFile file;
+  KATANA_CHECKED_ERROR_CODE(
+      file.Open(uri, O_RDONLY, direct_io_), ErrorCode::LocalStorageError,
+      "failed to open source file");
+
+  std::atomic<uint64_t> total_read{0};
+  KATANA_CHECKED(pool_->ForEachChunk(
+      size, num_io_threads_,
+      [&](uint64_t offset, uint64_t chunk_size) -> katana::Result<void> {
+        total_read += KATANA_CHECKED(
+            ReadFully(file, data + offset, start + offset, chunk_size));
+        return katana::ResultSuccess();
+      }));
 
   // if the difference in what was read from what we wanted is less  than a
   // block it's because the file size isn't well aligned so don't complain.
-  if (size - ifile.gcount() > kBlockSize) {
-    return ErrorCode::LocalStorageError;
+  if (size - total_read > kBlockSize) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "short read of {}: {} of {} bytes",
+        std::quoted(uri), total_read, size);
   }
   return katana::ResultSuccess();
 }
@@ -5,17 +5,28 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <string>
-#include <thread>
 
 #include "katana/Result.h"
 #include "tsuba/FileStorage.h"
 
 namespace tsuba {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system.
+///
+/// Large transfers are split into chunks that are read or written
+/// concurrently with pread/pwrite. Asynchronous requests and the chunks of
+/// every request run on a pool of KATANA_LOCAL_STORAGE_IO_THREADS threads.
+/// Setting KATANA_LOCAL_STORAGE_DIRECT_IO bypasses the page cache (O_DIRECT)
+/// for chunks that are suitably aligned.
 class LocalStorage : public FileStorage {
+  class IoPool;
+
+  bool direct_io_{false};
+  uint32_t num_io_threads_{1};
+  std::unique_ptr<IoPool> pool_;
+
   void CleanUri(std::string* uri);
   katana::Result<void> WriteFile(
       std::string, const uint8_t* data, uint64_t size);
@@ -26,10 +37,11 @@ class LocalStorage : public FileStorage {
       uint64_t size);
 
 public:
-  LocalStorage() : FileStorage("file://") {}
+  LocalStorage();
+  ~LocalStorage() override;
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
   katana::Result<void> Stat(const std::string& uri, StatBuf* size) override;
 
   uint32_t Priority() const override { return 1; }
@@ -53,34 +65,16 @@ public:
 
   // get on future can potentially block (bulk synchronous parallel)
   std::future<katana::CopyableResult<void>> PutAsync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      katana::CopyableErrorInfo cei{write_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
   std::future<katana::CopyableResult<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      katana::CopyableErrorInfo cei{read_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
+      uint8_t* result_buf) override;
+  katana::Result<std::string> LocalPath(const std::string& uri) override {
+    std::string path = uri;
+    CleanUri(&path);
+    return path;
   }
+
   std::future<katana::CopyableResult<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
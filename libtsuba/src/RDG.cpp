@@ -1,5 +1,6 @@
 #include "tsuba/RDG.h"
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
 #include <fstream>
@@ -81,6 +82,48 @@ WriteProperties(
   return katana::ResultSuccess();
 }
 
+katana::Result<std::vector<tsuba::PropIndexStorageInfo>>
+WritePropertyIndexes(
+    tsuba::RDGCore::PropIndexFrames&& indexes,
+    const std::vector<tsuba::PropStorageInfo>& prop_info,
+    const katana::Uri& dir, tsuba::WriteGroup* desc) {
+  std::vector<tsuba::PropIndexStorageInfo> written;
+  for (auto& [name, index_ff] : indexes) {
+    auto prop = std::find_if(
+        prop_info.begin(), prop_info.end(),
+        [&name = name](const tsuba::PropStorageInfo& psi) {
+          return psi.name() == name;
+        });
+    if (prop == prop_info.end() || prop->path().empty()) {
+      KATANA_LOG_DEBUG("not storing index over unknown property {}", name);
+      continue;
+    }
+
+    katana::Uri path_uri = dir.RandFile(name + "_index");
+    index_ff->Bind(path_uri.string());
+    TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
+    desc->StartStore(std::move(index_ff));
+    written.emplace_back(name, path_uri.BaseName(), prop->path());
+  }
+  return written;
+}
+
+katana::Result<std::shared_ptr<tsuba::FileView>>
+BindPropertyIndex(
+    const tsuba::PropIndexStorageInfo* index, const katana::Uri& dir,
+    const std::string& name) {
+  if (index == nullptr) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::PropertyNotFound,
+        "no index stored for property {}", std::quoted(name));
+  }
+  auto file_view = std::make_shared<tsuba::FileView>();
+  KATANA_CHECKED_CONTEXT(
+      file_view->Bind(dir.Join(index->path()).string(), true),
+      "binding index for property {}", std::quoted(name));
+  return file_view;
+}
+
 katana::Result<void>
 CommitRDG(
     tsuba::RDGHandle handle, uint32_t policy_id, bool transposed,
@@ -335,6 +378,8 @@ tsuba::RDG::DoStore(
       *core_->edge_properties(), edge_props_to_store,
       handle.impl_->rdg_manifest().dir(), write_group.get()));
 
+  KATANA_CHECKED(DoStorePropertyIndexes(handle, write_group.get()));
+
   // writing partition metadata
   core_->part_header().set_part_prop_info_list(KATANA_CHECKED(
       WritePartArrays(handle.impl_->rdg_manifest().dir(), write_group.get())));
@@ -359,6 +404,34 @@ tsuba::RDG::DoStore(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+tsuba::RDG::DoStorePropertyIndexes(RDGHandle handle, WriteGroup* write_group) {
+  RDGPartHeader& part_header = core_->part_header();
+  const katana::Uri& dir = handle.impl_->rdg_manifest().dir();
+
+  // properties have been written, so an index whose property changed since
+  // it was stored no longer matches anything on storage
+  part_header.RemoveStalePropIndexes();
+
+  std::vector<PropIndexStorageInfo> node_indexes =
+      KATANA_CHECKED(WritePropertyIndexes(
+          core_->TakeNodePropIndexesToStore(),
+          part_header.node_prop_info_list(), dir, write_group));
+  for (auto& index : node_indexes) {
+    part_header.UpsertNodePropIndex(std::move(index));
+  }
+
+  std::vector<PropIndexStorageInfo> edge_indexes =
+      KATANA_CHECKED(WritePropertyIndexes(
+          core_->TakeEdgePropIndexesToStore(),
+          part_header.edge_prop_info_list(), dir, write_group));
+  for (auto& index : edge_indexes) {
+    part_header.UpsertEdgePropIndex(std::move(index));
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 tsuba::RDG::DoMake(
     const std::vector<PropStorageInfo*>& node_props_to_be_loaded,
@@ -1013,6 +1086,40 @@ tsuba::RDG::SetEdgeEntityTypeIDArrayFile(const katana::Uri& new_type_id_array) {
   return core_->RegisterEdgeEntityTypeIDArrayFile(new_type_id_array.BaseName());
 }
 
+void
+tsuba::RDG::AddNodePropertyIndex(
+    const std::string& name, std::unique_ptr<FileFrame> index_ff) {
+  core_->AddNodePropIndexToStore(name, std::move(index_ff));
+}
+
+void
+tsuba::RDG::AddEdgePropertyIndex(
+    const std::string& name, std::unique_ptr<FileFrame> index_ff) {
+  core_->AddEdgePropIndexToStore(name, std::move(index_ff));
+}
+
+bool
+tsuba::RDG::HasNodePropertyIndex(const std::string& name) const {
+  return core_->part_header().FindNodePropIndex(name) != nullptr;
+}
+
+bool
+tsuba::RDG::HasEdgePropertyIndex(const std::string& name) const {
+  return core_->part_header().FindEdgePropIndex(name) != nullptr;
+}
+
+katana::Result<std::shared_ptr<tsuba::FileView>>
+tsuba::RDG::LoadNodePropertyIndex(const std::string& name) const {
+  return BindPropertyIndex(
+      core_->part_header().FindNodePropIndex(name), rdg_dir(), name);
+}
+
+katana::Result<std::shared_ptr<tsuba::FileView>>
+tsuba::RDG::LoadEdgePropertyIndex(const std::string& name) const {
+  return BindPropertyIndex(
+      core_->part_header().FindEdgePropIndex(name), rdg_dir(), name);
+}
+
 tsuba::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {}
 
 tsuba::RDG::RDG() : core_(std::make_unique<RDGCore>()) {}
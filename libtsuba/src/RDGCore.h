@@ -1,7 +1,11 @@
 #ifndef KATANA_LIBTSUBA_RDGCORE_H_
 #define KATANA_LIBTSUBA_RDGCORE_H_
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 
@@ -11,6 +15,7 @@
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/config.h"
+#include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
 #include "tsuba/RDGTopology.h"
 #include "tsuba/TxnContext.h"
@@ -272,6 +277,29 @@ public:
     return edge_entity_type_id_array_file_storage_.Unbind();
   }
 
+  using PropIndexFrames =
+      std::vector<std::pair<std::string, std::unique_ptr<FileFrame>>>;
+
+  /// Queue a serialized property index to be written by the next store,
+  /// replacing any index already queued for the same property
+  void AddNodePropIndexToStore(
+      const std::string& name, std::unique_ptr<FileFrame> index_ff) {
+    AddPropIndexToStore(
+        name, std::move(index_ff), &node_prop_indexes_to_store_);
+  }
+  void AddEdgePropIndexToStore(
+      const std::string& name, std::unique_ptr<FileFrame> index_ff) {
+    AddPropIndexToStore(
+        name, std::move(index_ff), &edge_prop_indexes_to_store_);
+  }
+
+  PropIndexFrames TakeNodePropIndexesToStore() {
+    return std::exchange(node_prop_indexes_to_store_, {});
+  }
+  PropIndexFrames TakeEdgePropIndexesToStore() {
+    return std::exchange(edge_prop_indexes_to_store_, {});
+  }
+
   void AddCommandLine(const std::string& command_line) {
     lineage_.AddCommandLine(command_line);
   }
@@ -279,6 +307,19 @@ public:
 private:
   void InitEmptyProperties();
 
+  static void AddPropIndexToStore(
+      const std::string& name, std::unique_ptr<FileFrame> index_ff,
+      PropIndexFrames* to_store) {
+    auto it = std::find_if(
+        to_store->begin(), to_store->end(),
+        [&](const auto& entry) { return entry.first == name; });
+    if (it == to_store->end()) {
+      to_store->emplace_back(name, std::move(index_ff));
+    } else {
+      it->second = std::move(index_ff);
+    }
+  }
+
   //
   // Data
   //
@@ -291,6 +332,9 @@ private:
   FileView node_entity_type_id_array_file_storage_;
   FileView edge_entity_type_id_array_file_storage_;
 
+  PropIndexFrames node_prop_indexes_to_store_;
+  PropIndexFrames edge_prop_indexes_to_store_;
+
   RDGPartHeader part_header_;
 
   std::vector<std::shared_ptr<arrow::ChunkedArray>> mirror_nodes_;
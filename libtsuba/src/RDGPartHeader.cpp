@@ -37,6 +37,10 @@ const char* kEdgeEntityTypeIDDictionaryKey =
 const char* kNodeEntityTypeIDNameKey = "kg.v1.node_entity_type_id_name";
 // Name maps from Atomic Edge Entity Type ID to set of string names for the Edge Entity Type ID
 const char* kEdgeEntityTypeIDNameKey = "kg.v1.edge_entity_type_id_name";
+// Optional list of persisted indexes over node properties
+const char* kNodePropertyIndexKey = "kg.v1.node_property_index";
+// Optional list of persisted indexes over edge properties
+const char* kEdgePropertyIndexKey = "kg.v1.edge_property_index";
 // Metadata object for partition topology entries
 const char* kPartitionTopologyMetadataKey = "kg.v1.partition_topology_metadata";
 // Set of topology entries
@@ -269,11 +273,34 @@ RDGPartHeader::ChangeStorageLocation(
   // clear out specific file paths so that we know to store them later
   node_entity_type_id_array_path_ = "";
   edge_entity_type_id_array_path_ = "";
+  // indexes are not copied; in-memory indexes are stored again by their owner
+  node_prop_index_info_list_.clear();
+  edge_prop_index_info_list_.clear();
   topology_metadata_.ChangeStorageLocation();
 
   return katana::ResultSuccess();
 }
 
+void
+RDGPartHeader::RemoveStalePropIndexes() {
+  auto remove_stale = [](std::vector<PropIndexStorageInfo>* index_info,
+                         const std::vector<PropStorageInfo>& prop_info) {
+    index_info->erase(
+        std::remove_if(
+            index_info->begin(), index_info->end(),
+            [&](const PropIndexStorageInfo& index) {
+              return std::none_of(
+                  prop_info.begin(), prop_info.end(),
+                  [&](const PropStorageInfo& prop) {
+                    return index.IsCurrent(prop);
+                  });
+            }),
+        index_info->end());
+  };
+  remove_stale(&node_prop_index_info_list_, node_prop_info_list_);
+  remove_stale(&edge_prop_index_info_list_, edge_prop_info_list_);
+}
+
 PropStorageInfo*
 RDGPartHeader::find_node_prop_info(const std::string& name) {
   return find_prop_info(name, &node_prop_info_list());
@@ -313,6 +340,12 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kNodeEntityTypeIDNameKey, header.node_entity_type_id_name_},
       {kEdgeEntityTypeIDNameKey, header.edge_entity_type_id_name_},
       {kPartitionTopologyMetadataKey, header.topology_metadata_}};
+  if (!header.node_prop_index_info_list_.empty()) {
+    j[kNodePropertyIndexKey] = header.node_prop_index_info_list_;
+  }
+  if (!header.edge_prop_index_info_list_.empty()) {
+    j[kEdgePropertyIndexKey] = header.edge_prop_index_info_list_;
+  }
 }
 
 void
@@ -322,6 +355,13 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
   j.at(kPartPropertyFilesKey).get_to(header.part_prop_info_list_);
   j.at(kPartPropertyMetaKey).get_to(header.metadata_);
 
+  if (auto it = j.find(kNodePropertyIndexKey); it != j.end()) {
+    it->get_to(header.node_prop_index_info_list_);
+  }
+  if (auto it = j.find(kEdgePropertyIndexKey); it != j.end()) {
+    it->get_to(header.edge_prop_index_info_list_);
+  }
+
   if (auto it = j.find(kStorageFormatVersionKey); it != j.end()) {
     it->get_to(header.storage_format_version_);
   } else {
@@ -430,6 +470,18 @@ tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
   j = json{propmd.name(), propmd.path()};
 }
 
+void
+tsuba::from_json(const nlohmann::json& j, tsuba::PropIndexStorageInfo& index) {
+  j.at(0).get_to(index.name_);
+  j.at(1).get_to(index.path_);
+  j.at(2).get_to(index.prop_path_);
+}
+
+void
+tsuba::to_json(json& j, const tsuba::PropIndexStorageInfo& index) {
+  j = json{index.name(), index.path(), index.prop_path()};
+}
+
 void
 tsuba::from_json(
     const nlohmann::json& j, tsuba::PartitionTopologyMetadataEntry& topo) {
@@ -1,6 +1,7 @@
 #ifndef KATANA_LIBTSUBA_RDGPARTHEADER_H_
 #define KATANA_LIBTSUBA_RDGPARTHEADER_H_
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <memory>
@@ -126,6 +127,40 @@ private:
   State state_;
 };
 
+/// PropIndexStorageInfo records a persisted index over a single property: the
+/// name of the property, the file holding the index and the path of the
+/// property file the index was built from. An index is only usable while its
+/// property is still stored at prop_path; any change to the property gives it
+/// a new path (or none, until it is written), which makes the index stale.
+class PropIndexStorageInfo {
+public:
+  PropIndexStorageInfo(
+      std::string name, std::string path, std::string prop_path)
+      : name_(std::move(name)),
+        path_(std::move(path)),
+        prop_path_(std::move(prop_path)) {}
+
+  bool IsCurrent(const PropStorageInfo& prop) const {
+    return prop.name() == name_ && !prop.IsDirty() && !prop.path().empty() &&
+           prop.path() == prop_path_;
+  }
+
+  const std::string& name() const { return name_; }
+  const std::string& path() const { return path_; }
+  const std::string& prop_path() const { return prop_path_; }
+
+  friend void to_json(nlohmann::json& j, const PropIndexStorageInfo& index);
+  friend void from_json(const nlohmann::json& j, PropIndexStorageInfo& index);
+
+  // required for json
+  PropIndexStorageInfo() = default;
+
+private:
+  std::string name_;
+  std::string path_;
+  std::string prop_path_;
+};
+
 class KATANA_EXPORT RDGPartHeader {
 public:
   RDGPartHeader() = default;
@@ -229,6 +264,36 @@ public:
     return katana::ResultSuccess();
   }
 
+  //
+  // Property index manipulation
+  //
+
+  /// Returns the persisted index over node property `name`, or nullptr if
+  /// there is none or it does not match the stored property
+  const PropIndexStorageInfo* FindNodePropIndex(const std::string& name) const {
+    return FindPropIndex(
+        name, node_prop_index_info_list_, node_prop_info_list_);
+  }
+
+  /// Returns the persisted index over edge property `name`, or nullptr if
+  /// there is none or it does not match the stored property
+  const PropIndexStorageInfo* FindEdgePropIndex(const std::string& name) const {
+    return FindPropIndex(
+        name, edge_prop_index_info_list_, edge_prop_info_list_);
+  }
+
+  void UpsertNodePropIndex(PropIndexStorageInfo&& index) {
+    UpsertPropIndex(std::move(index), &node_prop_index_info_list_);
+  }
+
+  void UpsertEdgePropIndex(PropIndexStorageInfo&& index) {
+    UpsertPropIndex(std::move(index), &edge_prop_index_info_list_);
+  }
+
+  /// Forget persisted indexes whose property has changed or been removed
+  /// since the index was written
+  void RemoveStalePropIndexes();
+
   //
   // Accessors/Mutators
   //
@@ -300,6 +365,14 @@ public:
   }
   PropStorageInfo* find_edge_prop_info(const std::string& name);
 
+  const std::vector<PropIndexStorageInfo>& node_prop_index_info_list() const {
+    return node_prop_index_info_list_;
+  }
+
+  const std::vector<PropIndexStorageInfo>& edge_prop_index_info_list() const {
+    return edge_prop_index_info_list_;
+  }
+
   const std::vector<PropStorageInfo>& part_prop_info_list() const {
     return part_prop_info_list_;
   }
@@ -553,6 +626,40 @@ private:
     return DoSelectProperties(storage_info);
   }
 
+  static const PropIndexStorageInfo* FindPropIndex(
+      const std::string& name,
+      const std::vector<PropIndexStorageInfo>& index_info,
+      const std::vector<PropStorageInfo>& prop_info) {
+    auto index = std::find_if(
+        index_info.begin(), index_info.end(),
+        [&](const PropIndexStorageInfo& pisi) { return pisi.name() == name; });
+    if (index == index_info.end()) {
+      return nullptr;
+    }
+    auto prop = std::find_if(
+        prop_info.begin(), prop_info.end(),
+        [&](const PropStorageInfo& psi) { return psi.name() == name; });
+    if (prop == prop_info.end() || !index->IsCurrent(*prop)) {
+      return nullptr;
+    }
+    return &(*index);
+  }
+
+  static void UpsertPropIndex(
+      PropIndexStorageInfo&& index,
+      std::vector<PropIndexStorageInfo>* index_info) {
+    auto it = std::find_if(
+        index_info->begin(), index_info->end(),
+        [&](const PropIndexStorageInfo& pisi) {
+          return pisi.name() == index.name();
+        });
+    if (it == index_info->end()) {
+      index_info->emplace_back(std::move(index));
+    } else {
+      *it = std::move(index);
+    }
+  }
+
   static katana::Result<RDGPartHeader> MakeJson(
       const katana::Uri& partition_path);
 
@@ -581,6 +688,10 @@ private:
   std::vector<PropStorageInfo> part_prop_info_list_;
   std::vector<PropStorageInfo> node_prop_info_list_;
   std::vector<PropStorageInfo> edge_prop_info_list_;
+  // Persisted property indexes are optional; graphs without them, or with
+  // stale ones, are still valid
+  std::vector<PropIndexStorageInfo> node_prop_index_info_list_;
+  std::vector<PropIndexStorageInfo> edge_prop_index_info_list_;
 
   /// Metadata filled in by CuSP, or from storage (meta partition file)
   PartitionMetadata metadata_;
@@ -622,6 +733,9 @@ void from_json(const nlohmann::json& j, RDGPartHeader& header);
 void to_json(nlohmann::json& j, const PropStorageInfo& propmd);
 void from_json(const nlohmann::json& j, PropStorageInfo& propmd);
 
+void to_json(nlohmann::json& j, const PropIndexStorageInfo& index);
+void from_json(const nlohmann::json& j, PropIndexStorageInfo& index);
+
 void to_json(nlohmann::json& j, const PartitionMetadata& propmd);
 void from_json(const nlohmann::json& j, PartitionMetadata& propmd);
 
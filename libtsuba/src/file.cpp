@@ -46,6 +46,11 @@ tsuba::FileGetAsync(
       uri, begin, size, static_cast<uint8_t*>(result_buffer));
 }
 
+katana::Result<std::string>
+tsuba::FileLocalPath(const std::string& uri) {
+  return FS(uri)->LocalPath(uri);
+}
+
 katana::Result<void>
 tsuba::FileRemoteCopy(
     const std::string& source_uri, const std::string& dest_uri, uint64_t begin,
@@ -1,3 +1,6 @@
+#include <cstring>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "katana/Result.h"
@@ -31,9 +34,86 @@ TestEmpty(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestMapModes(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::Uri::MakeFromFile(path));
+  auto data_uri = uri.Join("data_file");
+
+  // Span more than one FileView page so that partial binds are exercised.
+  std::vector<uint64_t> data((3 << 20) / sizeof(uint64_t));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i * 7;
+  }
+  KATANA_CHECKED(tsuba::FileStore(data_uri.string(), data));
+
+  for (auto mode :
+       {tsuba::FileView::MapMode::kCopy, tsuba::FileView::MapMode::kPrivate,
+        tsuba::FileView::MapMode::kShared}) {
+    tsuba::FileView::MapOptions options;
+    options.mode = mode;
+    options.populate = mode == tsuba::FileView::MapMode::kShared;
+
+    tsuba::FileView fv(options);
+    KATANA_CHECKED(fv.Bind(data_uri.string(), true));
+    KATANA_LOG_ASSERT(
+        fv.mapped() == (mode != tsuba::FileView::MapMode::kCopy));
+    KATANA_LOG_ASSERT(fv.size() == data.size() * sizeof(uint64_t));
+    KATANA_LOG_ASSERT(
+        std::memcmp(fv.ptr<uint64_t>(), data.data(), fv.size()) == 0);
+
+    // Read past the bound prefix through the arrow interface.
+    tsuba::FileView partial(options);
+    KATANA_CHECKED(partial.Bind(data_uri.string(), 0, 64, false));
+    uint64_t offset = (2 << 20) + 8;
+    KATANA_LOG_ASSERT(partial.Seek(offset).ok());
+    uint64_t value = 0;
+    auto read_res = partial.Read(sizeof(value), &value);
+    KATANA_LOG_ASSERT(read_res.ok() && *read_res == sizeof(value));
+    KATANA_LOG_ASSERT(value == data[offset / sizeof(uint64_t)]);
+  }
+
+  return katana::ResultSuccess();
+}
+
+// Storing a shorter file over a mapped one must not truncate the mapping,
+// which would make reading past the new end raise SIGBUS.
+katana::Result<void>
+TestOverwriteMapped(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::Uri::MakeFromFile(path));
+  auto data_uri = uri.Join("overwritten_file");
+
+  std::vector<uint64_t> data((3 << 20) / sizeof(uint64_t));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i * 7;
+  }
+  KATANA_CHECKED(tsuba::FileStore(data_uri.string(), data));
+
+  for (auto mode :
+       {tsuba::FileView::MapMode::kPrivate,
+        tsuba::FileView::MapMode::kShared}) {
+    tsuba::FileView::MapOptions options;
+    options.mode = mode;
+
+    tsuba::FileView fv(options);
+    KATANA_CHECKED(fv.Bind(data_uri.string(), true));
+    KATANA_LOG_ASSERT(fv.mapped());
+
+    KATANA_CHECKED(tsuba::FileStore(data_uri.string(), std::string("short")));
+    KATANA_LOG_ASSERT(fv.size() == data.size() * sizeof(uint64_t));
+    KATANA_LOG_ASSERT(
+        std::memcmp(fv.ptr<uint64_t>(), data.data(), fv.size()) == 0);
+
+    KATANA_CHECKED(tsuba::FileStore(data_uri.string(), data));
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestEmpty(path), "TestEmpty");
+  KATANA_CHECKED_CONTEXT(TestMapModes(path), "TestMapModes");
+  KATANA_CHECKED_CONTEXT(TestOverwriteMapped(path), "TestOverwriteMapped");
 
   return katana::ResultSuccess();
 }
@@ -0,0 +1,193 @@
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// LocalStorage splits transfers into chunks of this size
+constexpr uint64_t kChunkSize = UINT64_C(8) << 20;
+constexpr uint64_t kAlignment = 4096;
+
+void
+FillPattern(uint8_t* data, uint64_t size, uint64_t seed) {
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = (i * 31 + seed) % 251;
+  }
+}
+
+katana::Result<void>
+CheckFile(const std::string& uri, const uint8_t* expected, uint64_t size) {
+  tsuba::StatBuf stat;
+  KATANA_CHECKED(tsuba::FileStat(uri, &stat));
+  KATANA_LOG_ASSERT(stat.size == size);
+
+  std::vector<uint8_t> data(size);
+  KATANA_CHECKED(tsuba::FileGet(uri, data.data(), 0, size));
+  KATANA_LOG_ASSERT(std::memcmp(data.data(), expected, size) == 0);
+  return katana::ResultSuccess();
+}
+
+/// Transfers of several chunks, including ranges that start and end in the
+/// middle of chunks, are split across the I/O threads
+katana::Result<void>
+TestSplit(const katana::Uri& dir) {
+  auto uri = dir.Join("split").string();
+  uint64_t size = 3 * kChunkSize + 4097;
+  std::vector<uint8_t> data(size);
+  FillPattern(data.data(), size, 1);
+
+  KATANA_CHECKED(tsuba::FileStore(uri, data.data(), size));
+  KATANA_CHECKED(CheckFile(uri, data.data(), size));
+
+  for (auto [begin, range_size] :
+       {std::pair<uint64_t, uint64_t>{kChunkSize - 3, kChunkSize + 10},
+        {1, 2 * kChunkSize},
+        {size - 5, 5}}) {
+    std::vector<uint8_t> range(range_size);
+    KATANA_CHECKED(tsuba::FileGet(uri, range.data(), begin, range_size));
+    KATANA_LOG_ASSERT(
+        std::memcmp(range.data(), data.data() + begin, range_size) == 0);
+
+    auto copy_uri = dir.Join("split-copy").string();
+    KATANA_CHECKED(tsuba::FileRemoteCopy(uri, copy_uri, begin, range_size));
+    KATANA_CHECKED(CheckFile(copy_uri, data.data() + begin, range_size));
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// With KATANA_LOCAL_STORAGE_DIRECT_IO set, aligned chunks bypass the page
+/// cache while unaligned ones, and file systems without O_DIRECT such as
+/// tmpfs, fall back to buffered I/O. Either way the data must round trip.
+katana::Result<void>
+TestAlignment(const katana::Uri& dir) {
+  uint64_t size = 2 * kChunkSize;
+  std::unique_ptr<uint8_t, decltype(&free)> buf(
+      static_cast<uint8_t*>(aligned_alloc(kAlignment, size + kAlignment)),
+      &free);
+  KATANA_LOG_ASSERT(buf);
+
+  struct Case {
+    const char* name;
+    uint64_t buf_offset;
+    uint64_t size;
+  };
+  for (const Case& c :
+       {Case{"aligned", 0, size}, Case{"unaligned-buffer", 1, size},
+        Case{"unaligned-size", 0, size - 100}}) {
+    auto uri = dir.Join(c.name).string();
+    uint8_t* data = buf.get() + c.buf_offset;
+    FillPattern(data, c.size, 2);
+    KATANA_CHECKED(tsuba::FileStore(uri, data, c.size));
+
+    std::vector<uint8_t> expected(data, data + c.size);
+    std::memset(data, 0, c.size);
+    KATANA_CHECKED(tsuba::FileGet(uri, data, 0, c.size));
+    KATANA_LOG_VASSERT(
+        std::memcmp(data, expected.data(), c.size) == 0, "{} differs",
+        c.name);
+  }
+
+  return katana::ResultSuccess();
+}
+
+/// More asynchronous requests than I/O threads, each of several chunks, all
+/// complete
+katana::Result<void>
+TestAsync(const katana::Uri& dir) {
+  constexpr int kNumFiles = 40;
+  uint64_t size = 2 * kChunkSize + 1;
+  std::vector<std::vector<uint8_t>> data(kNumFiles, std::vector<uint8_t>(size));
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  for (int i = 0; i < kNumFiles; ++i) {
+    FillPattern(data[i].data(), size, i);
+    futures.emplace_back(tsuba::FileStoreAsync(
+        dir.Join("async" + std::to_string(i)).string(), data[i].data(), size));
+  }
+  for (auto& future : futures) {
+    KATANA_CHECKED(future.get());
+  }
+
+  futures.clear();
+  std::vector<std::vector<uint8_t>> read(kNumFiles, std::vector<uint8_t>(size));
+  for (int i = 0; i < kNumFiles; ++i) {
+    futures.emplace_back(tsuba::FileGetAsync(
+        dir.Join("async" + std::to_string(i)).string(), read[i].data(), 0,
+        size));
+  }
+  for (int i = 0; i < kNumFiles; ++i) {
+    KATANA_CHECKED(futures[i].get());
+    KATANA_LOG_ASSERT(read[i] == data[i]);
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  std::vector<std::string> dirs{path};
+  // tmpfs did not support O_DIRECT before Linux 6.6
+  if (fs::is_directory("/dev/shm")) {
+    dirs.emplace_back(
+        (fs::path("/dev/shm") / fs::unique_path("local-storage-%%%%%%%%"))
+            .string());
+  }
+
+  for (const auto& dir_path : dirs) {
+    if (boost::system::error_code err;
+        !fs::create_directories(dir_path, err) && err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating directory: {}", err.message());
+    }
+    auto dir = KATANA_CHECKED(katana::Uri::MakeFromFile(dir_path));
+
+    KATANA_CHECKED_CONTEXT(TestSplit(dir), "TestSplit: {}", dir_path);
+    KATANA_CHECKED_CONTEXT(TestAlignment(dir), "TestAlignment: {}", dir_path);
+    KATANA_CHECKED_CONTEXT(TestAsync(dir), "TestAsync: {}", dir_path);
+
+    if (dir_path != path) {
+      fs::remove_all(dir_path);
+    }
+  }
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  // Use more than one I/O thread even on small machines
+  setenv("KATANA_LOCAL_STORAGE_IO_THREADS", "4", 0);
+
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -64,11 +64,30 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kApproximate, "Approximate",
+            "Adaptive sampling of sources (ignores source options)")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
 
+static cll::opt<double> epsilon(
+    "epsilon",
+    cll::desc("Largest error in normalized centrality for -algo=Approximate "
+              "(default 0.01)"),
+    cll::init(BetweennessCentralityPlan::kDefaultEpsilon));
+static cll::opt<double> delta(
+    "delta",
+    cll::desc("Probability of exceeding -epsilon for -algo=Approximate "
+              "(default 0.1)"),
+    cll::init(BetweennessCentralityPlan::kDefaultDelta));
+static cll::opt<unsigned int> topK(
+    "topK",
+    cll::desc("If nonzero, -algo=Approximate only needs the ranking of the "
+              "topK most central nodes to be accurate (default 0)"),
+    cll::init(BetweennessCentralityPlan::kDefaultTopK));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for work rather than use "
@@ -101,7 +120,9 @@ main(int argc, char** argv) {
       MakeFileGraph(inputFile, edge_property_name);
 
   BetweennessCentralityPlan plan =
-      BetweennessCentralityPlan::FromAlgorithm(algo);
+      algo == BetweennessCentralityPlan::kApproximate
+          ? BetweennessCentralityPlan::Approximate(epsilon, delta, topK)
+          : BetweennessCentralityPlan::FromAlgorithm(algo);
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->num_nodes();
@@ -44,6 +44,17 @@ static cll::opt<unsigned int> report_node(
     "reportNode",
     cll::desc("Node to report the similarity of (default value 1)"),
     cll::init(1));
+static cll::opt<unsigned int> top_k(
+    "topK",
+    cll::desc(
+        "If nonzero, find the topK most similar nodes of every node instead "
+        "(default value 0)"),
+    cll::init(0));
+static cll::opt<double> threshold(
+    "threshold",
+    cll::desc("Minimum similarity of the matches found by -topK (default value "
+              "0)"),
+    cll::init(0));
 
 using NodeValue = katana::PODProperty<double>;
 
@@ -77,6 +88,21 @@ main(int argc, char** argv) {
   }
 
   tsuba::TxnContext txn_ctx;
+  if (top_k > 0) {
+    auto similar_result = katana::analytics::JaccardTopK(
+        pg.get(), top_k, threshold, output_property_name, &txn_ctx,
+        katana::analytics::JaccardPlan());
+    if (!similar_result) {
+      KATANA_LOG_FATAL("JaccardTopK failed: {}", similar_result.error());
+    }
+    std::cout << "Found " << similar_result.value()->topology().num_edges()
+              << " similar pairs\n";
+
+    totalTime.stop();
+
+    return 0;
+  }
+
   if (auto r = katana::analytics::Jaccard(
           pg.get(), base_node, output_property_name, &txn_ctx,
           katana::analytics::JaccardPlan());
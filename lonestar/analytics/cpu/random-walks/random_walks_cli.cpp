@@ -82,16 +82,14 @@ AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
 }
 
 void
-PrintWalks(
-    const std::vector<std::vector<uint32_t>>& walks,
-    const std::string& output_file) {
+PrintWalks(const RandomWalksResult& walks, const std::string& output_file) {
   std::ofstream f(output_file);
 
-  for (auto walk : walks) {
-    for (auto node : walk) {
-      f << node << " ";
+  for (uint64_t i = 0; i < walks.num_walks(); ++i) {
+    for (auto it = walks.begin(i); it != walks.end(i); ++it) {
+      f << *it << " ";
     }
-    f << std::endl;
+    f << "\n";
   }
 }
 
@@ -94,7 +94,13 @@ from katana.local.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
-from katana.local.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
+from katana.local.analytics._pagerank import (
+    PagerankPlan,
+    PagerankStatistics,
+    pagerank,
+    pagerank_assert_valid,
+    pagerank_warm_start,
+)
 from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
 from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
 from katana.local.analytics._triangle_count import TriangleCountPlan, triangle_count
@@ -40,8 +40,12 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kApproximate "katana::analytics::BetweennessCentralityPlan::kApproximate"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        double epsilon() const
+        double delta() const
+        uint32_t top_k() const
 
         BetweennessCentralityPlan()
 
@@ -50,6 +54,8 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Approximate(double epsilon, double delta, uint32_t top_k)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
@@ -88,6 +94,7 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Approximate = _BetweennessCentralityPlan.Algorithm.kApproximate
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -128,6 +135,27 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def approximate(double epsilon = 0.01, double delta = 0.1, uint32_t top_k = 0):
+        """
+        Estimate centrality from randomly sampled sources, stopping once the normalized estimates are within epsilon
+        with probability 1 - delta. If top_k is nonzero, only the ranking of the top_k most central nodes must be that
+        accurate. The sources argument of betweenness_centrality is ignored.
+        """
+        return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Approximate(epsilon, delta, top_k))
+
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def delta(self) -> float:
+        return self.underlying_.delta()
+
+    @property
+    def top_k(self) -> int:
+        return self.underlying_.top_k()
+
 
 def betweenness_centrality(Graph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan(),
@@ -42,6 +42,7 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
             kPullResidual "katana::analytics::PagerankPlan::kPullResidual"
             kPushSynchronous "katana::analytics::PagerankPlan::kPushSynchronous"
             kPushAsynchronous "katana::analytics::PagerankPlan::kPushAsynchronous"
+            kPropagationBlocking "katana::analytics::PagerankPlan::kPropagationBlocking"
 
         # unsigned int kChunkSize
 
@@ -61,6 +62,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         _PagerankPlan PushAsynchronous(float tolerance, float alpha)
         @staticmethod
         _PagerankPlan PushSynchronous(float tolerance, unsigned int max_iterations, float alpha)
+        @staticmethod
+        _PagerankPlan PropagationBlocking(float tolerance, unsigned int max_iterations, float alpha)
 
     double kDefaultTolerance "katana::analytics::PagerankPlan::kDefaultTolerance"
     int kDefaultMaxIterations "katana::analytics::PagerankPlan::kDefaultMaxIterations"
@@ -68,6 +71,8 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
 
     Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, CTxnContext* txn_ctx, _PagerankPlan plan)
 
+    Result[void] PagerankWarmStart(_PropertyGraph* pg, string initial_property_name, string output_property_name, CTxnContext* txn_ctx, _PagerankPlan plan)
+
     Result[void] PagerankAssertValid(_PropertyGraph* pg, string output_property_name)
 
     cppclass _PagerankStatistics "katana::analytics::PagerankStatistics":
@@ -86,6 +91,7 @@ class _PagerankPlanAlgorithm(Enum):
     PullResidual = _PagerankPlan.Algorithm.kPullResidual
     PushSynchronous = _PagerankPlan.Algorithm.kPushSynchronous
     PushAsynchronous = _PagerankPlan.Algorithm.kPushAsynchronous
+    PropagationBlocking = _PagerankPlan.Algorithm.kPropagationBlocking
 
 
 cdef class PagerankPlan(Plan):
@@ -167,6 +173,17 @@ cdef class PagerankPlan(Plan):
         """
         return PagerankPlan.make(_PagerankPlan.PushSynchronous(tolerance, max_iterations, alpha))
 
+    @staticmethod
+    def propagation_blocking(float tolerance = kDefaultTolerance, unsigned int max_iterations = kDefaultMaxIterations, float alpha = kDefaultAlpha):
+        """
+        Propagation blocking algorithm
+
+        Computes the same ranks as the topological pull algorithm, but streams the contributions along the out-edges
+        into bins of destinations that fit in cache instead of reading the ranks of in-neighbors at random. It does not
+        need the transposed graph.
+        """
+        return PagerankPlan.make(_PagerankPlan.PropagationBlocking(tolerance, max_iterations, alpha))
+
 
 def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPlan(), *, TxnContext txn_ctx = None):
     """
@@ -206,6 +223,31 @@ def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPla
         handle_result_void(Pagerank(pg.underlying_property_graph(), output_property_name_cstr, &txn_ctx._txn_ctx, plan.underlying_))
 
 
+def pagerank_warm_start(Graph pg, str initial_property_name, str output_property_name, PagerankPlan plan = PagerankPlan.push_asynchronous(), *, TxnContext txn_ctx = None):
+    """
+    Compute the Page Rank of each node in the graph starting from the ranks in an existing property, e.g., the result
+    of a previous run before the graph was updated. The push asynchronous algorithm is always used; only the tolerance
+    and alpha of the plan are used.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type initial_property_name: str
+    :param initial_property_name: The property holding the initial ranks.
+    :type output_property_name: str
+    :param output_property_name: The output property to store the rank. This property must not already exist.
+    :type plan: PagerankPlan
+    :param plan: The execution plan to use.
+    :param txn_ctx: The tranaction context for passing read write sets.
+    """
+    initial_property_name_bytes = bytes(initial_property_name, "utf-8")
+    initial_property_name_cstr = <string>initial_property_name_bytes
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    txn_ctx = txn_ctx or TxnContext()
+    with nogil:
+        handle_result_void(PagerankWarmStart(pg.underlying_property_graph(), initial_property_name_cstr, output_property_name_cstr, &txn_ctx._txn_ctx, plan.underlying_))
+
+
 def pagerank_assert_valid(Graph pg, str output_property_name):
     """
     Raise an exception if the pagerank results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
@@ -21,6 +21,7 @@ from katana.local.analytics import (
     KTrussStatistics,
     LeidenClusteringStatistics,
     LouvainClusteringStatistics,
+    PagerankPlan,
     PagerankStatistics,
     SsspStatistics,
     TriangleCountPlan,
@@ -45,6 +46,7 @@ from katana.local.analytics import (
     louvain_clustering_assert_valid,
     pagerank,
     pagerank_assert_valid,
+    pagerank_warm_start,
     sort_all_edges_by_dest,
     sort_nodes_by_degree,
     sssp,
@@ -211,6 +213,33 @@ def test_pagerank(graph: Graph):
     assert stats.average_rank == approx(0.5215466022491455, abs=0.001)
 
 
+def test_pagerank_warm_start(graph: Graph):
+    pagerank(graph, "Initial", PagerankPlan.push_asynchronous())
+    pagerank_warm_start(graph, "Initial", "NewProp")
+
+    pagerank_assert_valid(graph, "NewProp")
+
+    initial = PagerankStatistics(graph, "Initial")
+    stats = PagerankStatistics(graph, "NewProp")
+
+    assert stats.max_rank == approx(initial.max_rank, rel=0.01)
+    assert stats.average_rank == approx(initial.average_rank, rel=0.01)
+
+
+def test_pagerank_propagation_blocking(graph: Graph):
+    pagerank(graph, "Topological", PagerankPlan.pull_topological())
+    pagerank(graph, "NewProp", PagerankPlan.propagation_blocking())
+
+    pagerank_assert_valid(graph, "NewProp")
+
+    topological = PagerankStatistics(graph, "Topological")
+    stats = PagerankStatistics(graph, "NewProp")
+
+    assert stats.min_rank == approx(topological.min_rank, rel=0.001)
+    assert stats.max_rank == approx(topological.max_rank, rel=0.001)
+    assert stats.average_rank == approx(topological.average_rank, rel=0.001)
+
+
 def test_betweenness_centrality_outer(graph: Graph):
     property_name = "NewProp"
 
@@ -245,6 +274,24 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_approximate(graph: Graph):
+    property_name = "NewProp"
+
+    plan = BetweennessCentralityPlan.approximate(epsilon=0.1, top_k=10)
+    assert plan.algorithm == BetweennessCentralityPlan.Algorithm.Approximate
+    assert plan.top_k == 10
+    betweenness_centrality(graph, property_name, plan=plan)
+
+    node_schema: Schema = graph.loaded_node_schema()
+    num_node_properties = len(node_schema)
+    new_property_id = num_node_properties - 1
+    assert node_schema.names[new_property_id] == property_name
+
+    stats = BetweennessCentralityStatistics(graph, property_name)
+
+    assert stats.min_centrality >= 0
+
+
 def test_triangle_count():
     graph = Graph(get_input("propertygraphs/rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dest(e) for e in graph.edge_ids(0)]
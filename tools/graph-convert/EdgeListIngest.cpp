@@ -0,0 +1,110 @@
+#include "EdgeListIngest.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <iomanip>
+#include <utility>
+
+#include "katana/Logging.h"
+
+namespace {
+
+/// The smallest chunk worth parsing on its own thread
+constexpr size_t kMinChunkBytes = size_t{1} << 20;
+/// Chunks per thread, so that threads that finish early can steal
+constexpr size_t kChunksPerThread = 16;
+
+}  // namespace
+
+katana::Result<katana::MappedFile>
+katana::MappedFile::Make(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "opening {}", std::quoted(path));
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    auto err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "stat of {}", std::quoted(path));
+  }
+  size_t size = st.st_size;
+
+  if (size == 0) {
+    close(fd);
+    return MappedFile(nullptr, 0);
+  }
+
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  auto err = katana::ResultErrno();
+  close(fd);
+  if (data == MAP_FAILED) {
+    return KATANA_ERROR(err, "mapping {}", std::quoted(path));
+  }
+  // the passes read the file front to back
+  if (madvise(data, size, MADV_SEQUENTIAL) != 0) {
+    KATANA_LOG_DEBUG("madvise of {} failed", path);
+  }
+
+  return MappedFile(static_cast<const char*>(data), size);
+}
+
+katana::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+katana::MappedFile&
+katana::MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+katana::MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+std::vector<size_t>
+katana::SplitLines(
+    const char* data, size_t size, size_t begin, size_t num_chunks) {
+  KATANA_LOG_DEBUG_ASSERT(num_chunks > 0);
+  std::vector<size_t> chunks(num_chunks + 1);
+  chunks[0] = begin;
+  chunks[num_chunks] = size;
+
+  katana::do_all(
+      katana::iterate(size_t{1}, num_chunks),
+      [&](size_t i) {
+        size_t pos = begin + (size - begin) / num_chunks * i;
+        // a chunk starts after the end of the line that pos is in
+        const char* line_end =
+            static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        chunks[i] = line_end ? line_end - data + 1 : size;
+      },
+      katana::no_stats());
+
+  // a line longer than a chunk moves the start of the next chunk past the
+  // start of the one after it
+  for (size_t i = 1; i <= num_chunks; ++i) {
+    chunks[i] = std::max(chunks[i], chunks[i - 1]);
+  }
+  return chunks;
+}
+
+size_t
+katana::internal::NumChunks(size_t size) {
+  size_t max_chunks = katana::getActiveThreads() * kChunksPerThread;
+  return std::clamp<size_t>(size / kMinChunkBytes, 1, max_chunks);
+}
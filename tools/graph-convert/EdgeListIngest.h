@@ -0,0 +1,391 @@
+#ifndef KATANA_TOOLS_GRAPH_CONVERT_EDGELISTINGEST_H
+#define KATANA_TOOLS_GRAPH_CONVERT_EDGELISTINGEST_H
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "katana/ErrorCode.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Result.h"
+
+/// \file EdgeListIngest.h
+///
+/// IngestEdgeList builds the CSR of a text edge list in parallel. It maps the
+/// file into memory and splits it into chunks that start and end at line
+/// boundaries. It then makes three parallel passes over the chunks:
+///
+///   1. count the edges and find the largest node id,
+///   2. count the degree of each node,
+///   3. place each edge at its slot of the CSR (a counting sort).
+///
+/// The edges of a node keep the order of the file: the slots that one chunk
+/// takes for a node are increasing, so a stable sort of the edges of a node
+/// by chunk only has to run for the nodes whose edges span chunks.
+
+namespace katana {
+
+/// A read-only memory map of a whole local file
+class MappedFile {
+public:
+  static Result<MappedFile> Make(const std::string& path);
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile();
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  MappedFile(const char* data, size_t size) : data_(data), size_(size) {}
+
+  const char* data_{nullptr};
+  size_t size_{0};
+};
+
+/// The layout of the lines of a text edge list. Lines that do not match it,
+/// e.g., blank lines and comments, are skipped.
+struct EdgeListFormat {
+  /// the separator between fields besides blanks, e.g., ',' for CSV
+  std::optional<char> delim;
+  /// whether the first line holds labels, e.g., the header of a CSV file
+  bool skip_first_line{false};
+  /// whether each line is "<node id> <num neighbors> <neighbor id>*" rather
+  /// than "<src> <dst> [<value>]"
+  bool node_list{false};
+};
+
+struct EdgeListStats {
+  uint64_t num_nodes{0};
+  uint64_t num_edges{0};
+  uint64_t num_skipped_lines{0};
+  uint64_t num_bytes{0};
+};
+
+/// \returns num_chunks + 1 offsets into data that split [begin, size) into
+/// chunks of about the same size, each of which starts at a line
+std::vector<size_t> SplitLines(
+    const char* data, size_t size, size_t begin, size_t num_chunks);
+
+namespace internal {
+
+/// The type that a parsed edge value is held in
+template <typename EdgeTy>
+using EdgeValueType =
+    std::conditional_t<std::is_void_v<EdgeTy>, char, EdgeTy>;
+
+inline bool
+IsBlank(char c) {
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+/// Reads the fields of one line of an edge list, i.e., numbers separated by
+/// blanks and, if there is one, by the delimiter
+class FieldReader {
+public:
+  FieldReader(const char* begin, const char* end, std::optional<char> delim)
+      : pos_(begin), end_(end), delim_(delim) {}
+
+  /// \returns false if the next field is missing or is not a T
+  template <typename T>
+  bool Read(T* value) {
+    if (!first_ && !ReadDelim()) {
+      return false;
+    }
+    first_ = false;
+    SkipBlanks();
+
+    if constexpr (std::is_integral_v<T>) {
+      auto [ptr, ec] = std::from_chars(pos_, end_, *value);
+      if (ec != std::errc()) {
+        return false;
+      }
+      pos_ = ptr;
+    } else {
+      // std::from_chars for floating point needs a newer standard library
+      // than we require, so parse a copy of the field with strtod
+      char field[kMaxFieldSize];
+      size_t len = 0;
+      while (pos_ + len != end_ && len + 1 < kMaxFieldSize &&
+             !IsBlank(pos_[len]) && !IsDelim(pos_[len])) {
+        field[len] = pos_[len];
+        ++len;
+      }
+      field[len] = '\0';
+      char* field_end = nullptr;
+      double parsed = std::strtod(field, &field_end);
+      if (field_end == field) {
+        return false;
+      }
+      *value = static_cast<T>(parsed);
+      pos_ += field_end - field;
+    }
+    return true;
+  }
+
+private:
+  static constexpr size_t kMaxFieldSize = 64;
+
+  bool IsDelim(char c) const { return delim_ && c == *delim_; }
+
+  void SkipBlanks() {
+    while (pos_ != end_ && IsBlank(*pos_)) {
+      ++pos_;
+    }
+  }
+
+  bool ReadDelim() {
+    if (!delim_) {
+      return true;
+    }
+    SkipBlanks();
+    if (pos_ == end_ || *pos_ != *delim_) {
+      return false;
+    }
+    ++pos_;
+    return true;
+  }
+
+  const char* pos_;
+  const char* end_;
+  std::optional<char> delim_;
+  bool first_{true};
+};
+
+/// Calls f(src, dst, value) for every edge of the line [begin, end) and
+/// returns the source node of the line, which a node list line declares even
+/// if it has no neighbors, or returns nullopt without calling f if the line
+/// does not match format
+template <typename EdgeTy, typename F>
+std::optional<uint64_t>
+ForEachEdgeOfLine(
+    const char* begin, const char* end, const EdgeListFormat& format,
+    const F& f) {
+  using Value = EdgeValueType<EdgeTy>;
+
+  FieldReader reader(begin, end, format.delim);
+  uint64_t src = 0;
+  if (!reader.Read(&src)) {
+    return std::nullopt;
+  }
+
+  if (format.node_list) {
+    uint64_t num_neighbors = 0;
+    if (!reader.Read(&num_neighbors)) {
+      return std::nullopt;
+    }
+    // check the whole line before calling f for any of its edges
+    FieldReader check = reader;
+    for (uint64_t i = 0; i < num_neighbors; ++i) {
+      uint64_t dst = 0;
+      if (!check.Read(&dst)) {
+        return std::nullopt;
+      }
+    }
+    for (uint64_t i = 0; i < num_neighbors; ++i) {
+      uint64_t dst = 0;
+      reader.Read(&dst);
+      f(src, dst, Value{});
+    }
+    return src;
+  }
+
+  uint64_t dst = 0;
+  if (!reader.Read(&dst)) {
+    return std::nullopt;
+  }
+  Value value{};
+  if constexpr (!std::is_void_v<EdgeTy>) {
+    if (!reader.Read(&value)) {
+      return std::nullopt;
+    }
+  }
+  f(src, dst, value);
+  return src;
+}
+
+/// Calls f(line_begin, line_end) for every line of [begin, end)
+template <typename F>
+void
+ForEachLine(const char* begin, const char* end, const F& f) {
+  while (begin < end) {
+    const char* line_end =
+        static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+    f(begin, line_end);
+    begin = line_end + 1;
+  }
+}
+
+/// The number of chunks to split size bytes into for parallel parsing
+size_t NumChunks(size_t size);
+
+}  // namespace internal
+
+/// Parses the text edge list at path in parallel and builds its CSR.
+/// Nodes are numbered 0 up to the largest node id in the file; there are no
+/// nodes if no line of the file matches format.
+template <typename EdgeTy>
+Result<void>
+IngestEdgeList(
+    const std::string& path, const EdgeListFormat& format,
+    NUMAArray<GraphTopology::Edge>* out_indices,
+    NUMAArray<GraphTopology::Node>* out_dests, NUMAArray<EdgeTy>* edge_data,
+    EdgeListStats* stats) {
+  using Edge = GraphTopology::Edge;
+  using Node = GraphTopology::Node;
+  using Value = internal::EdgeValueType<EdgeTy>;
+
+  MappedFile file = KATANA_CHECKED(MappedFile::Make(path));
+  const char* data = file.data();
+
+  size_t begin = 0;
+  if (format.skip_first_line && file.size() != 0) {
+    const char* first_line_end =
+        static_cast<const char*>(std::memchr(data, '\n', file.size()));
+    begin = first_line_end ? first_line_end - data + 1 : file.size();
+  }
+  std::vector<size_t> chunks = SplitLines(
+      data, file.size(), begin, internal::NumChunks(file.size() - begin));
+  const uint32_t num_chunks = chunks.size() - 1;
+
+  auto for_each_chunk = [&](const auto& f) {
+    katana::do_all(
+        katana::iterate(uint32_t{0}, num_chunks),
+        [&](uint32_t chunk) {
+          internal::ForEachLine(
+              data + chunks[chunk], data + chunks[chunk + 1],
+              [&](const char* line_begin, const char* line_end) {
+                f(chunk, line_begin, line_end);
+              });
+        },
+        katana::steal(), katana::chunk_size<1>(), katana::no_stats());
+  };
+
+  // 1. count the edges and find the largest node id
+  katana::GAccumulator<uint64_t> accum_num_edges;
+  katana::GAccumulator<uint64_t> accum_skipped_lines;
+  katana::GReduceMax<uint64_t> max_node;
+  katana::GReduceLogicalOr any_node;
+  for_each_chunk([&](uint32_t, const char* line_begin, const char* line_end) {
+    std::optional<uint64_t> src = internal::ForEachEdgeOfLine<EdgeTy>(
+        line_begin, line_end, format, [&](uint64_t, uint64_t dst, Value) {
+          accum_num_edges += 1;
+          max_node.update(dst);
+        });
+    if (!src) {
+      accum_skipped_lines += 1;
+      return;
+    }
+    max_node.update(*src);
+    any_node.update(true);
+  });
+
+  const uint64_t num_edges = accum_num_edges.reduce();
+  const uint64_t num_nodes = any_node.reduce() ? max_node.reduce() + 1 : 0;
+  if (num_nodes > std::numeric_limits<Node>::max()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "node id {} does not fit in a node",
+        num_nodes - 1);
+  }
+
+  // 2. count the degree of each node
+  NUMAArray<std::atomic<Edge>> degrees;
+  degrees.allocateBlocked(num_nodes);
+  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](uint64_t n) {
+    degrees.constructAt(n, Edge{0});
+  });
+  for_each_chunk([&](uint32_t, const char* line_begin, const char* line_end) {
+    internal::ForEachEdgeOfLine<EdgeTy>(
+        line_begin, line_end, format, [&](uint64_t src, uint64_t, Value) {
+          degrees[src].fetch_add(1, std::memory_order_relaxed);
+        });
+  });
+
+  out_indices->allocateInterleaved(num_nodes);
+  katana::do_all(katana::iterate(uint64_t{0}, num_nodes), [&](uint64_t n) {
+    (*out_indices)[n] = degrees[n].load(std::memory_order_relaxed);
+  });
+  katana::ParallelSTL::partial_sum(
+      out_indices->begin(), out_indices->end(), out_indices->begin());
+
+  // 3. place the edges of a node from its begin up, as its degree counts
+  // down to 0, and remember which chunk each came from
+  out_dests->allocateInterleaved(num_edges);
+  edge_data->allocateInterleaved(num_edges);
+  NUMAArray<uint32_t> edge_chunks;
+  edge_chunks.allocateInterleaved(num_edges);
+  for_each_chunk([&](uint32_t chunk, const char* line_begin,
+                     const char* line_end) {
+    internal::ForEachEdgeOfLine<EdgeTy>(
+        line_begin, line_end, format,
+        [&](uint64_t src, uint64_t dst, Value value) {
+          Edge remaining = degrees[src].fetch_sub(1, std::memory_order_relaxed);
+          Edge e = (*out_indices)[src] - remaining;
+          (*out_dests)[e] = dst;
+          edge_data->set(e, value);
+          edge_chunks[e] = chunk;
+        });
+  });
+
+  // restore the order of the file for nodes whose edges span chunks
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        Edge e_begin = n == 0 ? 0 : (*out_indices)[n - 1];
+        Edge e_end = (*out_indices)[n];
+        if (std::is_sorted(
+                edge_chunks.begin() + e_begin, edge_chunks.begin() + e_end)) {
+          return;
+        }
+        std::vector<Edge> order(e_end - e_begin);
+        std::iota(order.begin(), order.end(), e_begin);
+        std::stable_sort(order.begin(), order.end(), [&](Edge a, Edge b) {
+          return edge_chunks[a] < edge_chunks[b];
+        });
+
+        std::vector<Node> dests(order.size());
+        std::vector<Value> values(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+          dests[i] = (*out_dests)[order[i]];
+          if constexpr (!std::is_void_v<EdgeTy>) {
+            values[i] = (*edge_data)[order[i]];
+          }
+        }
+        for (size_t i = 0; i < order.size(); ++i) {
+          (*out_dests)[e_begin + i] = dests[i];
+          edge_data->set(e_begin + i, values[i]);
+        }
+      },
+      katana::steal());
+
+  stats->num_nodes = num_nodes;
+  stats->num_edges = num_edges;
+  stats->num_skipped_lines = accum_skipped_lines.reduce();
+  stats->num_bytes = file.size();
+  return ResultSuccess();
+}
+
+}  // namespace katana
+
+#endif
@@ -33,12 +33,14 @@
 #include <boost/mpl/if.hpp>
 #include <llvm/Support/CommandLine.h>
 
+#include "EdgeListIngest.h"
 #include "katana/ErrorCode.h"
 #include "katana/FileGraph.h"
 #include "katana/Galois.h"
 #include "katana/NUMAArray.h"
 #include "katana/SharedMemSys.h"
 #include "katana/Strings.h"
+#include "katana/Timer.h"
 #include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/RDGManifest.h"
@@ -52,7 +54,9 @@ enum ConvertMode {
   bipartitegr2sorteddegreegr,
   dimacs2gr,
   edgelist2gr,
+  edgelist2kg,
   csv2gr,
+  csv2kg,
   gr2biggr,
   gr2binarypbbs32,
   gr2binarypbbs64,
@@ -89,6 +93,7 @@ enum ConvertMode {
   gr2kg,
   mtx2gr,
   nodelist2gr,
+  nodelist2kg,
   pbbs2gr,
   svmlight2gr,
   edgelist2binary
@@ -140,7 +145,15 @@ static cll::opt<ConvertMode> convertMode(
             "Sort nodes of bipartite binary gr by degree"),
         clEnumVal(dimacs2gr, "Convert dimacs to binary gr"),
         clEnumVal(edgelist2gr, "Convert edge list to binary gr"),
+        clEnumVal(
+            edgelist2kg,
+            "Convert edge list to a property graph for katana graph, "
+            "parsing in parallel"),
         clEnumVal(csv2gr, "Convert csv to binary gr"),
+        clEnumVal(
+            csv2kg,
+            "Convert csv to a property graph for katana graph, parsing in "
+            "parallel"),
         clEnumVal(
             gr2biggr,
             "Convert binary gr with little-endian edge data to "
@@ -206,6 +219,10 @@ static cll::opt<ConvertMode> convertMode(
             gr2kg, "Convert binary gr to a property graph for katana graph"),
         clEnumVal(mtx2gr, "Convert matrix market format to binary gr"),
         clEnumVal(nodelist2gr, "Convert node list to binary gr"),
+        clEnumVal(
+            nodelist2kg,
+            "Convert node list (one node per line) to a property graph for "
+            "katana graph, parsing in parallel"),
         clEnumVal(pbbs2gr, "Convert pbbs graph to binary gr"),
         clEnumVal(svmlight2gr, "Convert svmlight file to binary gr"),
         clEnumVal(
@@ -3046,6 +3063,96 @@ struct Gr2Kg : public Conversion {
   }
 };
 
+/**
+ * Builds a katana graph property graph from a text edge list without an
+ * intermediate gr file. The input is parsed in parallel (see
+ * EdgeListIngest.h), so unlike convertEdgelist it expects every edge on
+ * one line, including the neighbors of a node in a node list.
+ */
+template <typename EdgeTy>
+void
+convertEdgelistToKg(
+    const std::string& infilename, const std::string& outfilename,
+    const katana::EdgeListFormat& format) {
+  katana::NUMAArray<katana::GraphTopology::Edge> out_indices;
+  katana::NUMAArray<katana::GraphTopology::Node> out_dests;
+  katana::NUMAArray<EdgeTy> edge_data;
+  katana::EdgeListStats stats;
+
+  katana::Timer timer;
+  timer.start();
+  if (auto r = katana::IngestEdgeList<EdgeTy>(
+          infilename, format, &out_indices, &out_dests, &edge_data, &stats);
+      !r) {
+    KATANA_LOG_FATAL("could not read {}: {}", infilename, r.error());
+  }
+  timer.stop();
+
+  if (stats.num_skipped_lines != 0) {
+    katana::gWarn(
+        "ignored ", stats.num_skipped_lines,
+        " lines because they did not match the expected format\n");
+  }
+  katana::gPrint(
+      "Parsed ", stats.num_bytes, " bytes in ", timer.get(), " ms (",
+      stats.num_bytes / std::max<uint64_t>(timer.get_usec(), 1), " MB/s)\n");
+
+  katana::GraphTopology topo{std::move(out_indices), std::move(out_dests)};
+  auto pg_res = katana::PropertyGraph::Make(std::move(topo));
+  if (!pg_res) {
+    KATANA_LOG_FATAL("Failed to create PropertyGraph: {}", pg_res.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+
+  if constexpr (!std::is_void_v<EdgeTy>) {
+    tsuba::TxnContext txn_ctx;
+    if (auto r = AppendEdgeData<EdgeTy>(pg.get(), edge_data, &txn_ctx); !r) {
+      KATANA_LOG_FATAL("could not add edge property: {}", r.error());
+    }
+  }
+
+  if (auto r = pg->Write(outfilename, kCommandLine); !r) {
+    KATANA_LOG_FATAL("Failed to write property file graph: {}", r.error());
+  }
+  printStatus(stats.num_nodes, stats.num_edges);
+}
+
+/**
+ * Assumption: First line has labels
+ * src,dst[,weight]
+ */
+struct CSV2Kg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    katana::EdgeListFormat format;
+    format.delim = ',';
+    format.skip_first_line = true;
+    convertEdgelistToKg<EdgeTy>(infilename, outfilename, format);
+  }
+};
+
+/**
+ * src dst [weight]
+ */
+struct Edgelist2Kg : public Conversion {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    convertEdgelistToKg<EdgeTy>(infilename, outfilename, {});
+  }
+};
+
+/**
+ * <node id> <num neighbors> <neighbor id>*
+ */
+struct Nodelist2Kg : public HasOnlyVoidSpecialization {
+  template <typename EdgeTy>
+  void convert(const std::string& infilename, const std::string& outfilename) {
+    katana::EdgeListFormat format;
+    format.node_list = true;
+    convertEdgelistToKg<EdgeTy>(infilename, outfilename, format);
+  }
+};
+
 /**
  * METIS format (1-indexed). See METIS 4.10 manual, section 4.5.
  *  % comment prefix
@@ -3322,9 +3429,15 @@ main(int argc, char** argv) {
   case edgelist2gr:
     convert<Edgelist2Gr>();
     break;
+  case edgelist2kg:
+    convert<Edgelist2Kg>();
+    break;
   case csv2gr:
     convert<CSV2Gr>();
     break;
+  case csv2kg:
+    convert<CSV2Kg>();
+    break;
   case gr2biggr:
     convert<ToBigEndian>();
     break;
@@ -3433,6 +3546,9 @@ main(int argc, char** argv) {
   case nodelist2gr:
     convert<Nodelist2Gr>();
     break;
+  case nodelist2kg:
+    convert<Nodelist2Kg>();
+    break;
   case pbbs2gr:
     convert<Pbbs2Gr>();
     break;
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "EdgeListIngest.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace {
+
+constexpr size_t kEdgeFactor = 16;
+
+struct TestEdge {
+  uint32_t src;
+  uint32_t dst;
+  uint32_t value;
+};
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long scale : {16, 20}) {
+    b->Args({scale});
+  }
+}
+
+std::string
+MakeTempPath() {
+  auto uri_res = katana::Uri::MakeRand("/tmp/edgelistingest");
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value().path();
+}
+
+/// Writes an edge list of kEdgeFactor << scale uniformly random edges with
+/// weights, in the format of format, to a new file
+std::string
+MakeEdgeListFile(
+    size_t scale, const katana::EdgeListFormat& format,
+    std::vector<TestEdge>* edges) {
+  std::string path = MakeTempPath();
+
+  std::mt19937_64 gen(scale);
+  std::uniform_int_distribution<uint32_t> node_dist(0, (1U << scale) - 1);
+  std::uniform_int_distribution<uint32_t> value_dist(1, 100);
+
+  std::ofstream out(path);
+  const char* sep = format.delim ? ", " : " ";
+  if (format.skip_first_line) {
+    out << "src" << sep << "dst" << sep << "value\n";
+  }
+  for (size_t i = 0; i < (kEdgeFactor << scale); ++i) {
+    TestEdge edge{node_dist(gen), node_dist(gen), value_dist(gen)};
+    out << edge.src << sep << edge.dst << sep << edge.value << "\n";
+    edges->emplace_back(edge);
+  }
+  KATANA_LOG_ASSERT(out.good());
+  return path;
+}
+
+/// Writes a node list of 1 << scale lines, each with a random node and up to
+/// 2 * kEdgeFactor random neighbors, to a new file. The last line declares
+/// node 1 << scale, which has no neighbors.
+std::string
+MakeNodeListFile(size_t scale, std::vector<TestEdge>* edges) {
+  std::string path = MakeTempPath();
+
+  std::mt19937_64 gen(scale);
+  std::uniform_int_distribution<uint32_t> node_dist(0, (1U << scale) - 1);
+  std::uniform_int_distribution<uint32_t> degree_dist(0, 2 * kEdgeFactor);
+
+  std::ofstream out(path);
+  for (size_t i = 0; i < (size_t{1} << scale); ++i) {
+    uint32_t src = node_dist(gen);
+    uint32_t degree = degree_dist(gen);
+    out << src << " " << degree;
+    for (uint32_t j = 0; j < degree; ++j) {
+      TestEdge edge{src, node_dist(gen), 0};
+      out << " " << edge.dst;
+      edges->emplace_back(edge);
+    }
+    out << "\n";
+  }
+  out << (1U << scale) << " 0\n";
+  KATANA_LOG_ASSERT(out.good());
+  return path;
+}
+
+/// Checks the CSR against the edges sorted by source in the order of the file
+template <typename EdgeTy>
+void
+CheckCSR(
+    std::vector<TestEdge> edges,
+    const katana::NUMAArray<katana::GraphTopology::Edge>& out_indices,
+    const katana::NUMAArray<katana::GraphTopology::Node>& out_dests,
+    const katana::NUMAArray<EdgeTy>& edge_data) {
+  std::stable_sort(
+      edges.begin(), edges.end(),
+      [](const TestEdge& a, const TestEdge& b) { return a.src < b.src; });
+
+  KATANA_LOG_ASSERT(out_dests.size() == edges.size());
+  for (size_t e = 0; e < edges.size(); ++e) {
+    KATANA_LOG_ASSERT(out_dests[e] == edges[e].dst);
+    if constexpr (!std::is_void_v<EdgeTy>) {
+      KATANA_LOG_ASSERT(edge_data[e] == edges[e].value);
+    }
+  }
+  for (size_t n = 0; n < out_indices.size(); ++n) {
+    auto end = std::partition_point(
+        edges.begin(), edges.end(),
+        [&](const TestEdge& edge) { return edge.src <= n; });
+    KATANA_LOG_ASSERT(out_indices[n] == size_t(end - edges.begin()));
+  }
+}
+
+void
+RunIngest(benchmark::State& state, const katana::EdgeListFormat& format) {
+  std::vector<TestEdge> edges;
+  std::string path = MakeEdgeListFile(state.range(0), format, &edges);
+
+  katana::EdgeListStats stats;
+  bool checked = false;
+  for (auto _ : state) {
+    katana::NUMAArray<katana::GraphTopology::Edge> out_indices;
+    katana::NUMAArray<katana::GraphTopology::Node> out_dests;
+    katana::NUMAArray<uint32_t> edge_data;
+    KATANA_LOG_ASSERT(katana::IngestEdgeList<uint32_t>(
+        path, format, &out_indices, &out_dests, &edge_data, &stats));
+
+    state.PauseTiming();
+    if (!checked) {
+      CheckCSR(edges, out_indices, out_dests, edge_data);
+      checked = true;
+    }
+    state.ResumeTiming();
+  }
+  KATANA_LOG_ASSERT(stats.num_skipped_lines == 0);
+
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * stats.num_bytes);
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+/// Files with no node ids have no nodes
+void
+CheckNoNodes() {
+  katana::EdgeListFormat node_list;
+  node_list.node_list = true;
+  for (const auto& [contents, format, num_skipped_lines] :
+       std::vector<std::tuple<std::string, katana::EdgeListFormat, uint64_t>>{
+           {"", {}, 0},
+           {"# comment\n\nnot an edge\n1\n", {}, 4},
+           {"1 2 3\n", node_list, 1},
+       }) {
+    std::string path = MakeTempPath();
+    std::ofstream out(path);
+    out << contents;
+    out.close();
+    KATANA_LOG_ASSERT(out.good());
+
+    katana::NUMAArray<katana::GraphTopology::Edge> out_indices;
+    katana::NUMAArray<katana::GraphTopology::Node> out_dests;
+    katana::NUMAArray<uint32_t> edge_data;
+    katana::EdgeListStats stats;
+    KATANA_LOG_ASSERT(katana::IngestEdgeList<uint32_t>(
+        path, format, &out_indices, &out_dests, &edge_data, &stats));
+    std::remove(path.c_str());
+
+    KATANA_LOG_VASSERT(
+        stats.num_nodes == 0 && out_indices.size() == 0,
+        "{} has {} nodes, expected none", std::quoted(contents),
+        stats.num_nodes);
+    KATANA_LOG_ASSERT(stats.num_edges == 0 && out_dests.size() == 0);
+    KATANA_LOG_ASSERT(stats.num_skipped_lines == num_skipped_lines);
+  }
+}
+
+void
+EdgeList(benchmark::State& state) {
+  RunIngest(state, {});
+}
+
+void
+CSV(benchmark::State& state) {
+  katana::EdgeListFormat format;
+  format.delim = ',';
+  format.skip_first_line = true;
+  RunIngest(state, format);
+}
+
+/// The format of -nodelist2kg of graph-convert
+void
+NodeList(benchmark::State& state) {
+  std::vector<TestEdge> edges;
+  std::string path = MakeNodeListFile(state.range(0), &edges);
+  katana::EdgeListFormat format;
+  format.node_list = true;
+
+  katana::EdgeListStats stats;
+  bool checked = false;
+  for (auto _ : state) {
+    katana::NUMAArray<katana::GraphTopology::Edge> out_indices;
+    katana::NUMAArray<katana::GraphTopology::Node> out_dests;
+    katana::NUMAArray<void> edge_data;
+    KATANA_LOG_ASSERT(katana::IngestEdgeList<void>(
+        path, format, &out_indices, &out_dests, &edge_data, &stats));
+
+    state.PauseTiming();
+    if (!checked) {
+      size_t num_nodes = (size_t{1} << state.range(0)) + 1;
+      KATANA_LOG_ASSERT(out_indices.size() == num_nodes);
+      CheckCSR(edges, out_indices, out_dests, edge_data);
+      checked = true;
+    }
+    state.ResumeTiming();
+  }
+  KATANA_LOG_ASSERT(stats.num_skipped_lines == 0);
+
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * stats.num_bytes);
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+/// Parsing alone the way convertEdgelist of graph-convert does
+void
+EdgeListBaseline(benchmark::State& state) {
+  std::vector<TestEdge> edges;
+  std::string path = MakeEdgeListFile(state.range(0), {}, &edges);
+
+  size_t num_bytes = 0;
+  for (auto _ : state) {
+    std::ifstream infile(path);
+    std::string line;
+    size_t num_edges = 0;
+    num_bytes = 0;
+    while (std::getline(infile, line)) {
+      num_bytes += line.size() + 1;
+      std::stringstream iss(line);
+      size_t src;
+      size_t dst;
+      uint32_t value;
+      if (iss >> src >> dst >> value) {
+        ++num_edges;
+      }
+    }
+    KATANA_LOG_ASSERT(num_edges == edges.size());
+  }
+
+  std::remove(path.c_str());
+  state.SetBytesProcessed(state.iterations() * num_bytes);
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+BENCHMARK(EdgeList)->Apply(MakeArguments)->UseRealTime()->Unit(
+    benchmark::kMillisecond);
+BENCHMARK(CSV)->Apply(MakeArguments)->UseRealTime()->Unit(
+    benchmark::kMillisecond);
+BENCHMARK(NodeList)->Apply(MakeArguments)->UseRealTime()->Unit(
+    benchmark::kMillisecond);
+BENCHMARK(EdgeListBaseline)
+    ->Apply(MakeArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  CheckNoNodes();
+  ::benchmark::RunSpecifiedBenchmarks();
+}